@@ -0,0 +1,169 @@
+#pragma once
+
+#include "Common.h"
+#include "Platform/Timer.h"
+#include "Math/Matrix.h"
+
+#include <math.h>
+
+// A test returns false at the first check that fails. A benchmark prints what it measured and only
+// fails when it couldn't run. The argument is what follows the case name on the command line, or NULL.
+typedef bool (*BenchFunc)(const char* argument);
+
+typedef enum _BenchKind
+{
+    BENCH_KIND_TEST,
+    BENCH_KIND_BENCHMARK
+} BenchKind;
+
+typedef struct _BenchCase
+{
+    const char* name;
+    BenchKind   kind;
+    BenchFunc   Run;
+} BenchCase;
+
+// Fails the case when x doesn't hold. Whatever the case allocated is left to the process exit.
+#define CHECK(x, ...)                                               \
+    if (!(x))                                                       \
+    {                                                               \
+        printf("  Check failed at %s:%d: ", __FILE__, __LINE__);    \
+        printf(__VA_ARGS__);                                        \
+        printf("\n");                                               \
+        return false;                                               \
+    }
+
+// Same sequence on every run and platform, benchmarks stay comparable.
+static inline u32 BenchRandom(u32* pState)
+{
+    u32 x   = *pState;
+    x      ^= x << 13;
+    x      ^= x >> 17;
+    x      ^= x << 5;
+    *pState = x;
+    return x;
+}
+
+// In [0, 1).
+static inline f32 BenchRandomFloat(u32* pState)
+{
+    return (f32) (BenchRandom(pState) >> 8) * (1.0f / 16777216.0f);
+}
+
+// D3D left handed perspective from the origin, looking down +z after a turn of yaw radians around y,
+// 60 degrees of vertical field of view, 16:9, depth from 0.1 to 1000.
+static inline void BenchViewProjection(f32 yaw, Mat4* pViewProjection)
+{
+    f32 nearZ  = 0.1f;
+    f32 farZ   = 1000.0f;
+    f32 yScale = 1.0f / tanf(0.5f * 1.0471976f);
+    f32 xScale = yScale * 9.0f / 16.0f;
+    f32 q      = farZ / (farZ - nearZ);
+
+    Mat4 view;
+    view.rows[0] = _mm_setr_ps(cosf(yaw), 0.0f, sinf(yaw), 0.0f);
+    view.rows[1] = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+    view.rows[2] = _mm_setr_ps(-sinf(yaw), 0.0f, cosf(yaw), 0.0f);
+    view.rows[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+    Mat4 projection;
+    projection.rows[0] = _mm_setr_ps(xScale, 0.0f, 0.0f, 0.0f);
+    projection.rows[1] = _mm_setr_ps(0.0f, yScale, 0.0f, 0.0f);
+    projection.rows[2] = _mm_setr_ps(0.0f, 0.0f, q, 1.0f);
+    projection.rows[3] = _mm_setr_ps(0.0f, 0.0f, -nearZ * q, 0.0f);
+
+    DROP_Mat4Multiply(&view, &projection, pViewProjection);
+}
+
+#ifdef _WIN32
+#include "Graphics/Graphics.h"
+
+// WARP rasterizes on the CPU, the D3D cases run headless on any machine and their times are comparable.
+static inline bool BenchCreateWarpDevice(_GfxHandle* pHandle)
+{
+    ZERO_MEM(pHandle, 1);
+    HRESULT hr = D3D11CreateDevice(
+        NULL, D3D_DRIVER_TYPE_WARP, NULL, 0, NULL, 0, D3D11_SDK_VERSION, &pHandle->pDevice, NULL, &pHandle->pContext);
+    return SUCCEEDED(hr) && pHandle->pDevice && pHandle->pContext;
+}
+#endif // _WIN32
+
+#ifdef _WIN32
+// Graphics/BatchRenderer, needs D3D.
+bool BenchBatchRenderer(const char* argument);
+
+// Graphics/RenderTargetPool, needs D3D.
+bool TestRenderTargetPool(const char* argument);
+#endif // _WIN32
+
+// Graphics/BatchQueue.
+bool BenchBatchQueue(const char* argument);
+
+// Graphics/Bloom.
+bool TestBloomReference(const char* argument);
+
+// Graphics/DynamicResolution.
+bool TestDynamicResolution(const char* argument);
+
+// Math/GaussianKernel.
+bool TestGaussianKernel(const char* argument);
+
+// Math/PackedFloat.
+bool TestPackedFloat(const char* argument);
+bool BenchPackedFloat(const char* argument);
+
+// Math/HalfFloat.
+bool TestHalfFloatExhaustive(const char* argument);
+bool BenchHalfFloat(const char* argument);
+
+// Utils/Counters.
+bool TestCounters(const char* argument);
+bool BenchCounters(const char* argument);
+
+// Utils/TaskGraph.
+bool TestTaskGraph(const char* argument);
+
+// Utils/FrameArenas.
+bool TestFrameArenas(const char* argument);
+
+// Utils/FrameEncoder.
+bool BenchFrameEncoder(const char* argument);
+
+// Platform/FrameTiming.
+bool TestFrameTiming(const char* argument);
+bool BenchFrameTiming(const char* argument);
+
+// Replay/CounterBackend.
+bool TestReplay(const char* argument);
+
+// Resources/ShaderReflection.
+bool TestShaderReflection(const char* argument);
+
+// Scene/Culling.
+bool TestCulling(const char* argument);
+bool BenchCulling(const char* argument);
+
+// Scene/Entity.
+bool TestEntity(const char* argument);
+
+// Scene/Occlusion.
+bool TestOcclusion(const char* argument);
+bool BenchOcclusion(const char* argument);
+
+// Scene/Scene.
+bool TestScene(const char* argument);
+bool BenchScene(const char* argument);
+
+// Utils/ArenaSnapshot.
+bool TestArenaSnapshot(const char* argument);
+
+// Utils/RadixSort.
+bool TestRadixSort(const char* argument);
+bool BenchRadixSort(const char* argument);
+
+// Utils/RingAllocator.
+bool TestRingAllocator(const char* argument);
+
+// Utils/Profiler.
+bool TestProfiler(const char* argument);
+bool BenchProfiler(const char* argument);
@@ -0,0 +1,131 @@
+#include "Bench.h"
+#include "Utils/ArenaSnapshot.h"
+
+#define SNAPSHOT_TEST_FILE "bench_snapshot.bin"
+#define SNAPSHOT_TEST_VERSION 3
+#define SNAPSHOT_TEST_SOURCE_HASH 0x1234ull
+#define SNAPSHOT_TEST_NODES 100
+
+typedef struct _SnapshotNode
+{
+    u32    value;
+    RelPtr next;
+    RelPtr name;
+} SnapshotNode;
+
+// The root, a list and a table of names pointing into it.
+typedef struct _SnapshotRoot
+{
+    u32    nodeCount;
+    RelPtr first;
+    RelPtr nodes[SNAPSHOT_TEST_NODES];
+} SnapshotRoot;
+
+#pragma region INTERNAL
+static void BuildSnapshotData(ArenaAllocator* pArena)
+{
+    SnapshotRoot* pRoot = (SnapshotRoot*) DROP_Allocate(pArena, sizeof(SnapshotRoot));
+    ZERO_MEM(pRoot, 1);
+
+    SnapshotNode* pPrevious = NULL;
+    for (u32 i = 0; i < SNAPSHOT_TEST_NODES; ++i)
+    {
+        SnapshotNode* pNode = (SnapshotNode*) DROP_Allocate(pArena, sizeof(SnapshotNode));
+        char*         name  = DROP_Allocate(pArena, 16);
+        snprintf(name, 16, "node %u", i);
+
+        pNode->value = i * 7;
+        pNode->next  = 0;
+        DROP_SetRelPtr(&pNode->name, name);
+        DROP_SetRelPtr(&pRoot->nodes[i], pNode);
+        DROP_SetRelPtr(pPrevious ? &pPrevious->next : &pRoot->first, pNode);
+        pPrevious = pNode;
+    }
+    pRoot->nodeCount = SNAPSHOT_TEST_NODES;
+}
+
+// Walks the list and the table, every pointer must land inside [pBegin, pEnd).
+static bool CheckSnapshotData(const SnapshotRoot* pRoot, const char* pBegin, const char* pEnd)
+{
+    CHECK(pRoot->nodeCount == SNAPSHOT_TEST_NODES, "Root has %u nodes.", pRoot->nodeCount);
+
+    const SnapshotNode* pNode = DROP_GetRelPtr(&pRoot->first);
+    for (u32 i = 0; i < SNAPSHOT_TEST_NODES; ++i)
+    {
+        CHECK((const char*) pNode >= pBegin && (const char*) pNode < pEnd, "Node %u points out of the data.", i);
+        CHECK(pNode == DROP_GetRelPtr(&pRoot->nodes[i]), "List and table disagree at node %u.", i);
+        CHECK(pNode->value == i * 7, "Node %u holds %u.", i, pNode->value);
+
+        char expected[16];
+        snprintf(expected, sizeof(expected), "node %u", i);
+        const char* name = DROP_GetRelPtr(&pNode->name);
+        CHECK(name >= pBegin && name < pEnd && !strcmp(name, expected), "Node %u has the wrong name.", i);
+
+        pNode = DROP_GetRelPtr(&pNode->next);
+    }
+    CHECK(!pNode, "The list doesn't end after %u nodes.", SNAPSHOT_TEST_NODES);
+
+    return true;
+}
+#pragma endregion
+
+// Saves data linked with relative pointers from one arena and loads it into another at a different
+// base and offset, then checks that stale and corrupt files are refused without touching the arena.
+bool TestArenaSnapshot(const char* argument)
+{
+    UNUSED(argument);
+
+    ArenaAllocator source;
+    ArenaAllocator target;
+    CHECK(DROP_MakeArena(&source, KB(64)) && DROP_MakeArena(&target, KB(64)), "Failed to make the arenas.");
+
+    DROP_Allocate(&source, 32);
+    u64 begin = source.used;
+    BuildSnapshotData(&source);
+    CHECK(CheckSnapshotData((const SnapshotRoot*) (source.memory + begin), source.memory + begin,
+                            source.memory + source.used),
+          "The data is wrong before saving.");
+    CHECK(DROP_SaveArenaSnapshot(SNAPSHOT_TEST_FILE, &source, begin, SNAPSHOT_TEST_VERSION, SNAPSHOT_TEST_SOURCE_HASH),
+          "Failed to save the snapshot.");
+    u64 dataSize = source.used - begin;
+
+    // Other data ahead of it in the target, so it lands at another offset of another block.
+    DROP_Allocate(&target, 80);
+    u64   used  = target.used;
+    char* pRoot = NULL;
+    CHECK(!DROP_LoadArenaSnapshot(SNAPSHOT_TEST_FILE, &target, SNAPSHOT_TEST_VERSION + 1, SNAPSHOT_TEST_SOURCE_HASH,
+                                  &pRoot) &&
+              target.used == used && !pRoot,
+          "A snapshot of another version loaded.");
+    CHECK(!DROP_LoadArenaSnapshot(SNAPSHOT_TEST_FILE, &target, SNAPSHOT_TEST_VERSION, SNAPSHOT_TEST_SOURCE_HASH + 1,
+                                  &pRoot) &&
+              target.used == used,
+          "A snapshot of other sources loaded.");
+
+    // Destroying the source makes sure nothing still points into it.
+    memset(source.memory, 0xCD, source.size);
+    FREE(source.memory);
+
+    CHECK(DROP_LoadArenaSnapshot(SNAPSHOT_TEST_FILE, &target, SNAPSHOT_TEST_VERSION, SNAPSHOT_TEST_SOURCE_HASH, &pRoot),
+          "Failed to load the snapshot.");
+    CHECK(pRoot == target.memory + used && target.used == used + dataSize, "The snapshot loaded at the wrong place.");
+    CHECK(CheckSnapshotData((const SnapshotRoot*) pRoot, pRoot, pRoot + dataSize), "The data is wrong after loading.");
+
+    // A flipped byte in the data.
+    FILE* file = fopen(SNAPSHOT_TEST_FILE, "r+b");
+    CHECK(file, "Failed to reopen the snapshot.");
+    fseek(file, (long) (sizeof(ArenaSnapshotHeader) + dataSize / 2), SEEK_SET);
+    fputc(0x5A, file);
+    fclose(file);
+
+    used = target.used;
+    CHECK(!DROP_LoadArenaSnapshot(SNAPSHOT_TEST_FILE, &target, SNAPSHOT_TEST_VERSION, SNAPSHOT_TEST_SOURCE_HASH,
+                                  &pRoot) &&
+              target.used == used,
+          "A corrupt snapshot loaded.");
+
+    remove(SNAPSHOT_TEST_FILE);
+    FREE(target.memory);
+
+    return true;
+}
@@ -0,0 +1,114 @@
+#include "Bench.h"
+#include "Graphics/BatchQueue.h"
+
+#define BATCH_QUEUE_BENCH_INSTANCES 100000
+#define BATCH_QUEUE_BENCH_REPEATS 20
+#define BATCH_QUEUE_BENCH_SHADERS 4
+#define BATCH_QUEUE_BENCH_TEXTURES 4
+
+// Stand-ins for the pixel shaders and textures, the queue only compares their addresses.
+static u8 s_fakeShaders[BATCH_QUEUE_BENCH_SHADERS];
+static u8 s_fakeTextures[BATCH_QUEUE_BENCH_TEXTURES];
+
+typedef struct _QueuedDraw
+{
+    BatchPrimitive primitive;
+    const void*    pPixelShader;
+    const void*    pSRV;
+} QueuedDraw;
+
+#pragma region INTERNAL
+// Runs of a few draws on the same material, the way a scene walks its objects.
+static void MakeDraws(QueuedDraw* pDraws, u32 count)
+{
+    u32 random = 17;
+    for (u32 i = 0; i < count;)
+    {
+        QueuedDraw draw = {
+            .primitive    = (BatchPrimitive) (BenchRandom(&random) % BATCH_PRIMITIVE_COUNT),
+            .pPixelShader = &s_fakeShaders[BenchRandom(&random) % BATCH_QUEUE_BENCH_SHADERS],
+            .pSRV         = &s_fakeTextures[BenchRandom(&random) % BATCH_QUEUE_BENCH_TEXTURES]};
+        for (u32 run = 1 + BenchRandom(&random) % 8; run > 0 && i < count; --run)
+            pDraws[i++] = draw;
+    }
+}
+
+// Every group is contiguous in the sorted instances, in draw order and without gaps.
+static bool IsSorted(const BatchQueue* pQueue)
+{
+    u32 first = 0;
+    for (u32 i = 0; i < pQueue->groupCount; ++i)
+    {
+        const BatchGroup* pGroup = &pQueue->groups[pQueue->groupOrder[i]];
+        if (pGroup->firstInstance != first)
+            return false;
+        for (u32 j = 0; j < pGroup->instanceCount; ++j)
+        {
+            if (pQueue->pSortedInstances[first + j].primitive != (u32) pGroup->primitive)
+                return false;
+        }
+        first += pGroup->instanceCount;
+
+        if (i > 0)
+        {
+            const BatchGroup* pPrevious = &pQueue->groups[pQueue->groupOrder[i - 1]];
+            if ((uintptr_t) pPrevious->pPixelShader > (uintptr_t) pGroup->pPixelShader)
+                return false;
+        }
+    }
+    return first == pQueue->instanceCount;
+}
+#pragma endregion
+
+// The CPU side of the batch renderer without a device: pushing 100k instances and bucketing them by
+// material, per instance.
+bool BenchBatchQueue(const char* argument)
+{
+    UNUSED(argument);
+
+    QueuedDraw* pDraws = (QueuedDraw*) ALLOC(QueuedDraw, BATCH_QUEUE_BENCH_INSTANCES);
+    BatchQueue  queue;
+    if (!pDraws || !DROP_MakeBatchQueue(&queue, BATCH_QUEUE_BENCH_INSTANCES))
+    {
+        if (pDraws)
+            FREE(pDraws);
+        return false;
+    }
+    MakeDraws(pDraws, BATCH_QUEUE_BENCH_INSTANCES);
+
+    static const f32 basis[4]       = {0.01f, 0.0f, 0.0f, 0.01f};
+    static const f32 translation[2] = {0.0f, 0.0f};
+    static const f32 color[4]       = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    u64  pushTicks = 0;
+    u64  sortTicks = 0;
+    bool isSorted  = true;
+    for (u32 r = 0; r < BATCH_QUEUE_BENCH_REPEATS; ++r)
+    {
+        u64 startTicks = DROP_GetTicks();
+        DROP_BatchQueueReset(&queue);
+        for (u32 i = 0; i < BATCH_QUEUE_BENCH_INSTANCES; ++i)
+        {
+            const QueuedDraw* pDraw = &pDraws[i];
+            DROP_BatchQueuePush(
+                &queue, pDraw->primitive, pDraw->pPixelShader, pDraw->pSRV, basis, translation, color);
+        }
+        u64 sortStartTicks = DROP_GetTicks();
+        DROP_BatchQueueSort(&queue);
+        u64 endTicks = DROP_GetTicks();
+
+        pushTicks += sortStartTicks - startTicks;
+        sortTicks += endTicks - sortStartTicks;
+        isSorted = isSorted && queue.instanceCount == BATCH_QUEUE_BENCH_INSTANCES && IsSorted(&queue);
+    }
+
+    f64 instanceCount = (f64) BATCH_QUEUE_BENCH_INSTANCES * BATCH_QUEUE_BENCH_REPEATS;
+    printf("  %u instances in %u groups: push %6.2f ns, sort %6.2f ns per instance\n", BATCH_QUEUE_BENCH_INSTANCES,
+           queue.groupCount, DROP_TicksToMilliseconds(pushTicks) * 1e6 / instanceCount,
+           DROP_TicksToMilliseconds(sortTicks) * 1e6 / instanceCount);
+
+    DROP_DestroyBatchQueue(&queue);
+    FREE(pDraws);
+
+    return isSorted;
+}
@@ -0,0 +1,152 @@
+#ifdef _WIN32
+#include "Bench.h"
+#include "Graphics/BatchRenderer.h"
+
+#define BATCH_BENCH_INSTANCES 100000
+#define BATCH_BENCH_REPEATS 5
+#define BATCH_BENCH_TARGET_SIZE 256
+
+// The descriptions EntryPoint.c loads the batch shaders with.
+static const GfxShaderDesc s_batchVertexShader = {.name = "batch", .inputClass = D3D11_INPUT_PER_INSTANCE_DATA};
+static const GfxShaderDesc s_batchPixelShader  = {.name = "batch"};
+
+#pragma region INTERNAL
+static void WaitForDevice(const GfxHandle handle, ID3D11Query* pQuery)
+{
+    ID3D11DeviceContext* pContext = handle->pContext;
+    pContext->lpVtbl->End(pContext, (ID3D11Asynchronous*) pQuery);
+    while (pContext->lpVtbl->GetData(pContext, (ID3D11Asynchronous*) pQuery, NULL, 0, 0) == S_FALSE)
+        YieldProcessor();
+}
+
+// Small primitives spread over the target, both kinds interleaved as a scene would submit them.
+static void MakeInstances(BatchInstance* pInstances, u32 count)
+{
+    u32 random = 11;
+    for (u32 i = 0; i < count; ++i)
+    {
+        BatchInstance* pInstance = &pInstances[i];
+        f32            angle     = BenchRandomFloat(&random) * 6.2831853f;
+        f32            size      = 0.01f + BenchRandomFloat(&random) * 0.02f;
+        pInstance->basis[0]       = cosf(angle) * size;
+        pInstance->basis[1]       = -sinf(angle) * size;
+        pInstance->basis[2]       = sinf(angle) * size;
+        pInstance->basis[3]       = cosf(angle) * size;
+        pInstance->translation[0] = BenchRandomFloat(&random) * 2.0f - 1.0f;
+        pInstance->translation[1] = BenchRandomFloat(&random) * 2.0f - 1.0f;
+        pInstance->primitive      = i & 1 ? BATCH_PRIMITIVE_QUAD : BATCH_PRIMITIVE_TRIANGLE;
+        for (u32 c = 0; c < 4; ++c)
+            pInstance->color[c] = BenchRandomFloat(&random);
+    }
+}
+#pragma endregion
+
+// 100k instances through the batch renderer, against the same instances drawn one call each from the
+// buffer the batch uploaded. Submit and flush are the CPU cost per instance, the GPU times wait for WARP to
+// finish. batch.sort measures the CPU side alone on every platform.
+bool BenchBatchRenderer(const char* argument)
+{
+    UNUSED(argument);
+
+    _GfxHandle          device;
+    GfxInputLayoutCache layoutCache = NULL;
+    GfxShaderCache      shaderCache = NULL;
+    BatchRenderer       batch       = NULL;
+    GfxRenderTarget     target      = {0};
+    ID3D11Query*        pQuery      = NULL;
+    BatchInstance*      pInstances  = (BatchInstance*) ALLOC(BatchInstance, BATCH_BENCH_INSTANCES);
+    GfxHandle           handle      = &device;
+
+    GfxRenderTargetDesc targetDesc = {
+        .width     = BATCH_BENCH_TARGET_SIZE,
+        .height    = BATCH_BENCH_TARGET_SIZE,
+        .format    = DXGI_FORMAT_R8G8B8A8_UNORM,
+        .bindFlags = D3D11_BIND_RENDER_TARGET};
+    D3D11_QUERY_DESC queryDesc  = {.Query = D3D11_QUERY_EVENT};
+    BatchInitProps   batchProps = {
+        .maxInstances      = BATCH_BENCH_INSTANCES,
+        .pVertexShaderDesc = &s_batchVertexShader,
+        .pPixelShaderDesc  = &s_batchPixelShader};
+
+    CHECK(pInstances && BenchCreateWarpDevice(&device), "Failed to create the WARP device.");
+    CHECK(DROP_CreateInputLayoutCache(&layoutCache) && DROP_CreateShaderCache(layoutCache, &shaderCache),
+          "Failed to create the caches.");
+    batchProps.shaderCache = shaderCache;
+    CHECK(DROP_CreateBatchRenderer(handle, &batchProps, &batch), "Failed to create the batch renderer.");
+    CHECK(DROP_CreateRenderTarget(handle, &targetDesc, &target), "Failed to create the render target.");
+    CHECK(SUCCEEDED(device.pDevice->lpVtbl->CreateQuery(device.pDevice, &queryDesc, &pQuery)),
+          "Failed to create the query.");
+
+    D3D11_VIEWPORT viewport = {
+        .Width    = BATCH_BENCH_TARGET_SIZE,
+        .Height   = BATCH_BENCH_TARGET_SIZE,
+        .MaxDepth = 1.0f};
+    device.pContext->lpVtbl->OMSetRenderTargets(device.pContext, 1, &target.pRTV, NULL);
+    device.pContext->lpVtbl->RSSetViewports(device.pContext, 1, &viewport);
+    MakeInstances(pInstances, BATCH_BENCH_INSTANCES);
+
+    u64 submitTicks  = 0;
+    u64 flushTicks   = 0;
+    u64 batchedTicks = 0;
+    u64 drawTicks    = 0;
+    u64 perDrawTicks = 0;
+    u32 batchedDraws = 0;
+    for (u32 r = 0; r < BATCH_BENCH_REPEATS; ++r)
+    {
+        u64 startTicks = DROP_GetTicks();
+        DROP_BatchBegin(batch);
+        for (u32 i = 0; i < BATCH_BENCH_INSTANCES; ++i)
+        {
+            const BatchInstance* pInstance = &pInstances[i];
+            DROP_BatchSubmit(
+                batch, (BatchPrimitive) pInstance->primitive, NULL, NULL, pInstance->basis, pInstance->translation,
+                pInstance->color);
+        }
+        u64 flushStartTicks = DROP_GetTicks();
+        DROP_BatchFlush(batch);
+        u64 flushEndTicks = DROP_GetTicks();
+        WaitForDevice(handle, pQuery);
+        submitTicks += flushStartTicks - startTicks;
+        flushTicks += flushEndTicks - flushStartTicks;
+        batchedTicks += DROP_GetTicks() - startTicks;
+        batchedDraws = batch->drawCount;
+
+        // Same pipeline, same buffer, the instances sorted by the flush, one call each.
+        startTicks = DROP_GetTicks();
+        for (u32 i = 0; i < BATCH_BENCH_INSTANCES; ++i)
+        {
+            u32 vertexCount = batch->queue.pSortedInstances[i].primitive == BATCH_PRIMITIVE_QUAD ? 6 : 3;
+            device.pContext->lpVtbl->DrawInstanced(device.pContext, vertexCount, 1, 0, i);
+        }
+        u64 drawEndTicks = DROP_GetTicks();
+        WaitForDevice(handle, pQuery);
+        drawTicks += drawEndTicks - startTicks;
+        perDrawTicks += DROP_GetTicks() - startTicks;
+
+        // The device is idle, the instance space is free again.
+        DROP_BatchEndFrame(batch, r + 1);
+        DROP_BatchRetireFrames(batch, r + 1);
+    }
+
+    // CPU times per instance, GPU times per repeat.
+    f64 instanceCount = (f64) BATCH_BENCH_INSTANCES * BATCH_BENCH_REPEATS;
+    printf("  %u instances, batched in %u draws: submit %6.1f ns, flush %6.1f ns per instance, %8.3f ms with the GPU\n",
+           BATCH_BENCH_INSTANCES, batchedDraws, DROP_TicksToMilliseconds(submitTicks) * 1e6 / instanceCount,
+           DROP_TicksToMilliseconds(flushTicks) * 1e6 / instanceCount,
+           DROP_TicksToMilliseconds(batchedTicks) / BATCH_BENCH_REPEATS);
+    printf("  %u instances, one draw each:    draws  %6.1f ns per instance,                 %8.3f ms with the GPU\n",
+           BATCH_BENCH_INSTANCES, DROP_TicksToMilliseconds(drawTicks) * 1e6 / instanceCount,
+           DROP_TicksToMilliseconds(perDrawTicks) / BATCH_BENCH_REPEATS);
+
+    RELEASE(pQuery);
+    DROP_DestroyRenderTarget(&target);
+    DROP_DestroyBatchRenderer(&batch);
+    DROP_DestroyShaderCache(&shaderCache);
+    DROP_DestroyInputLayoutCache(&layoutCache);
+    RELEASE(device.pContext);
+    RELEASE(device.pDevice);
+    FREE(pInstances);
+
+    return batchedDraws == BATCH_PRIMITIVE_COUNT;
+}
+#endif // _WIN32
@@ -0,0 +1,114 @@
+#include "Bench.h"
+#include "Graphics/Bloom.h"
+
+#include <math.h>
+
+#define BLOOM_TEST_WIDTH 64
+#define BLOOM_TEST_HEIGHT 48
+
+static f32 s_source[BLOOM_TEST_WIDTH * BLOOM_TEST_HEIGHT * 4];
+static f32 s_mirrored[BLOOM_TEST_WIDTH * BLOOM_TEST_HEIGHT * 4];
+// Level 0 is half the source size each way, with four floats a pixel.
+static f32 s_bloom[BLOOM_TEST_WIDTH * BLOOM_TEST_HEIGHT];
+static f32 s_mirroredBloom[BLOOM_TEST_WIDTH * BLOOM_TEST_HEIGHT];
+
+#pragma region INTERNAL
+static void FillSource(f32* pSource, f32 red, f32 green, f32 blue)
+{
+    for (u32 i = 0; i < BLOOM_TEST_WIDTH * BLOOM_TEST_HEIGHT; ++i)
+    {
+        pSource[i * 4 + 0] = red;
+        pSource[i * 4 + 1] = green;
+        pSource[i * 4 + 2] = blue;
+        pSource[i * 4 + 3] = 1.0f;
+    }
+}
+
+// R11G11B10 keeps 6 bits of mantissa for red and green and 5 for blue, every level rounds again.
+static bool IsClose(f32 value, f32 expected)
+{
+    return fabsf(value - expected) <= fabsf(expected) * 0.05f + 1e-4f;
+}
+#pragma endregion
+
+// The chain against what it must give by construction. The downsample, blur and tent weights each
+// sum to 1, so a flat image above the threshold ends up as the level count times its color, a flat
+// one below the threshold as black, and the chain commutes with a mirror of the source.
+bool TestBloomReference(const char* argument)
+{
+    UNUSED(argument);
+
+    GaussianKernel kernel;
+    CHECK(DROP_BuildGaussianKernel(BLOOM_DEFAULT_BLUR_SIGMA, DROP_GaussianRadius(BLOOM_DEFAULT_BLUR_SIGMA), &kernel),
+          "Failed to build the blur kernel.");
+
+    u32 width  = DROP_BloomLevelSize(BLOOM_TEST_WIDTH, 0);
+    u32 height = DROP_BloomLevelSize(BLOOM_TEST_HEIGHT, 0);
+
+    for (u32 levelCount = 1; levelCount <= BLOOM_DEFAULT_LEVELS; ++levelCount)
+    {
+        FillSource(s_source, 1.5f, 1.0f, 2.0f);
+        CHECK(DROP_ComputeBloomReference(s_source, BLOOM_TEST_WIDTH, BLOOM_TEST_HEIGHT, levelCount, &kernel, s_bloom),
+              "Failed to compute %u levels.", levelCount);
+        for (u32 i = 0; i < width * height; ++i)
+        {
+            const f32* pColor = &s_bloom[i * 4];
+            CHECK(IsClose(pColor[0], 1.5f * levelCount) && IsClose(pColor[1], 1.0f * levelCount) &&
+                      IsClose(pColor[2], 2.0f * levelCount),
+                  "%u levels give %f %f %f at pixel %u of a flat image.", levelCount, pColor[0], pColor[1], pColor[2],
+                  i);
+        }
+
+        FillSource(s_source, 0.8f, 0.5f, BLOOM_THRESHOLD);
+        CHECK(DROP_ComputeBloomReference(s_source, BLOOM_TEST_WIDTH, BLOOM_TEST_HEIGHT, levelCount, &kernel, s_bloom),
+              "Failed to compute %u levels.", levelCount);
+        for (u32 i = 0; i < width * height; ++i)
+        {
+            const f32* pColor = &s_bloom[i * 4];
+            CHECK(pColor[0] == 0.0f && pColor[1] == 0.0f && pColor[2] == 0.0f,
+                  "%u levels give %f %f %f below the threshold.", levelCount, pColor[0], pColor[1], pColor[2]);
+        }
+    }
+
+    // A few bright spots, one of them on an edge where the clamp addressing matters.
+    u32 random = 7;
+    FillSource(s_source, 0.0f, 0.0f, 0.0f);
+    for (u32 i = 0; i < 12; ++i)
+    {
+        u32 x = BenchRandom(&random) % BLOOM_TEST_WIDTH;
+        u32 y = i == 0 ? 0 : BenchRandom(&random) % BLOOM_TEST_HEIGHT;
+        for (u32 c = 0; c < 3; ++c)
+            s_source[(y * BLOOM_TEST_WIDTH + x) * 4 + c] = 1.0f + BenchRandomFloat(&random) * 8.0f;
+    }
+    for (u32 y = 0; y < BLOOM_TEST_HEIGHT; ++y)
+    {
+        for (u32 x = 0; x < BLOOM_TEST_WIDTH; ++x)
+            memcpy(&s_mirrored[(y * BLOOM_TEST_WIDTH + BLOOM_TEST_WIDTH - 1 - x) * 4],
+                   &s_source[(y * BLOOM_TEST_WIDTH + x) * 4], sizeof(f32) * 4);
+    }
+
+    CHECK(DROP_ComputeBloomReference(
+              s_source, BLOOM_TEST_WIDTH, BLOOM_TEST_HEIGHT, BLOOM_DEFAULT_LEVELS, &kernel, s_bloom),
+          "Failed to compute the spots.");
+    CHECK(DROP_ComputeBloomReference(
+              s_mirrored, BLOOM_TEST_WIDTH, BLOOM_TEST_HEIGHT, BLOOM_DEFAULT_LEVELS, &kernel, s_mirroredBloom),
+          "Failed to compute the mirrored spots.");
+
+    f32 peak = 0.0f;
+    for (u32 y = 0; y < height; ++y)
+    {
+        for (u32 x = 0; x < width; ++x)
+        {
+            const f32* pColor  = &s_bloom[(y * width + x) * 4];
+            const f32* pMirror  = &s_mirroredBloom[(y * width + width - 1 - x) * 4];
+            for (u32 c = 0; c < 3; ++c)
+            {
+                CHECK(IsClose(pMirror[c], pColor[c]), "Pixel %u %u is %f, mirrored %f.", x, y, pColor[c], pMirror[c]);
+                peak = fmaxf(peak, pColor[c]);
+            }
+        }
+    }
+    CHECK(peak > BLOOM_THRESHOLD, "The spots left no bloom.");
+
+    return true;
+}
@@ -0,0 +1,121 @@
+#include "Bench.h"
+#include "Utils/Counters.h"
+#include "Utils/JobSystem.h"
+
+#define COUNTERS_TEST_FILE "bench_counters"
+#define COUNTERS_TEST_ITEMS 10000
+#define COUNTERS_TEST_FRAMES 300 // Past the history, so it wraps.
+#define COUNTERS_BENCH_ADDS (1 << 22)
+
+#pragma region INTERNAL
+static void CountJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    UNUSED(pUserData);
+    UNUSED(threadIndex);
+
+    for (u32 i = begin; i < end; ++i)
+    {
+        DROP_AddCounter(COUNTER_DRAW_CALLS, 1);
+        DROP_AddCounter(COUNTER_UPLOADED_BYTES, i);
+    }
+}
+
+static void AddJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    UNUSED(pUserData);
+    UNUSED(threadIndex);
+
+    for (u32 i = begin; i < end; ++i)
+        DROP_AddCounter(COUNTER_STATE_CHANGES, 1);
+}
+
+static u32 CountLines(const char* fileName)
+{
+    FILE* file = fopen(fileName, "r");
+    if (!file)
+        return 0;
+
+    u32 lineCount = 0;
+    for (i32 c = fgetc(file); c != EOF; c = fgetc(file))
+        lineCount += c == '\n';
+    fclose(file);
+
+    return lineCount;
+}
+#pragma endregion
+
+// Counts added from the job system workers must all land in the frame they were added in.
+bool TestCounters(const char* argument)
+{
+    UNUSED(argument);
+
+    CHECK(DROP_CreateJobSystem(3), "Failed to create the job system.");
+
+    // Whatever the other cases counted goes into a frame of its own.
+    DROP_CountersEndFrame();
+
+    u64 expectedBytes = (u64) COUNTERS_TEST_ITEMS * (COUNTERS_TEST_ITEMS - 1) / 2;
+    for (u32 frame = 0; frame < COUNTERS_TEST_FRAMES; ++frame)
+    {
+        if (frame % 2 == 0)
+            DROP_ParallelFor(COUNTERS_TEST_ITEMS, 64, CountJob, NULL);
+        DROP_SetGauge(COUNTER_TRANSIENT_BYTES_USED, frame);
+        DROP_CountersEndFrame();
+
+        const CounterSnapshot* pSnapshot = DROP_GetCounterSnapshot(0);
+        u64                    drawCalls = frame % 2 == 0 ? COUNTERS_TEST_ITEMS : 0;
+        CHECK(pSnapshot->values[COUNTER_DRAW_CALLS] == drawCalls, "Frame %u counted %llu draw calls instead of %llu.",
+              frame, pSnapshot->values[COUNTER_DRAW_CALLS], drawCalls);
+        CHECK(pSnapshot->values[COUNTER_UPLOADED_BYTES] == (frame % 2 == 0 ? expectedBytes : 0),
+              "Frame %u counted %llu uploaded bytes.", frame, pSnapshot->values[COUNTER_UPLOADED_BYTES]);
+        CHECK(pSnapshot->values[COUNTER_TRANSIENT_BYTES_USED] == frame, "Frame %u gauge is %llu.", frame,
+              pSnapshot->values[COUNTER_TRANSIENT_BYTES_USED]);
+    }
+    DROP_DestroyJobSystem();
+
+    // The history keeps the last frames only, oldest first in the exports.
+    const CounterSnapshot* pNewest = DROP_GetCounterSnapshot(0);
+    const CounterSnapshot* pOldest = DROP_GetCounterSnapshot(COUNTER_HISTORY_FRAMES - 1);
+    CHECK(pOldest && !DROP_GetCounterSnapshot(COUNTER_HISTORY_FRAMES), "The history isn't %u frames long.",
+          COUNTER_HISTORY_FRAMES);
+    CHECK(pNewest->frame - pOldest->frame == COUNTER_HISTORY_FRAMES - 1, "The history skips frames.");
+
+    CHECK(DROP_ExportCounters(COUNTERS_TEST_FILE ".csv", COUNTER_FORMAT_CSV), "Failed to export CSV.");
+    CHECK(DROP_ExportCounters(COUNTERS_TEST_FILE ".json", COUNTER_FORMAT_JSON), "Failed to export JSON.");
+    u32 csvLines  = CountLines(COUNTERS_TEST_FILE ".csv");
+    u32 jsonLines = CountLines(COUNTERS_TEST_FILE ".json");
+    remove(COUNTERS_TEST_FILE ".csv");
+    remove(COUNTERS_TEST_FILE ".json");
+
+    // A header line in the CSV, the brackets on lines of their own in the JSON.
+    CHECK(csvLines == COUNTER_HISTORY_FRAMES + 1 && jsonLines == COUNTER_HISTORY_FRAMES + 2,
+          "Exported %u CSV and %u JSON lines.", csvLines, jsonLines);
+
+    return true;
+}
+
+// Cost of an add from one thread, then from every thread of the job system at once.
+bool BenchCounters(const char* argument)
+{
+    UNUSED(argument);
+
+    DROP_CountersEndFrame();
+    u64 startTicks = DROP_GetTicks();
+    AddJob(NULL, 0, COUNTERS_BENCH_ADDS, 0);
+    f64 singleNs = DROP_TicksToSeconds(DROP_GetTicks() - startTicks) * 1e9 / COUNTERS_BENCH_ADDS;
+
+    if (!DROP_CreateJobSystem(0))
+        return false;
+    startTicks = DROP_GetTicks();
+    DROP_ParallelFor(COUNTERS_BENCH_ADDS, 4096, AddJob, NULL);
+    f64 parallelSeconds = DROP_TicksToSeconds(DROP_GetTicks() - startTicks);
+    u32 threadCount     = DROP_GetJobThreadCount();
+    DROP_DestroyJobSystem();
+
+    DROP_CountersEndFrame();
+    bool isCounted = DROP_GetCounterSnapshot(0)->values[COUNTER_STATE_CHANGES] == COUNTERS_BENCH_ADDS * 2ull;
+
+    printf("  Add: %.2f ns on one thread, %.1f M adds/s on %u threads.\n", singleNs,
+           COUNTERS_BENCH_ADDS / parallelSeconds * 1e-6, threadCount);
+    return isCounted;
+}
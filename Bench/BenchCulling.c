@@ -0,0 +1,256 @@
+#include "Bench.h"
+#include "Scene/Culling.h"
+#include "Utils/JobSystem.h"
+
+#include <math.h>
+
+#define CULL_TEST_OBJECTS 50000
+#define CULL_BENCH_REPEATS 20
+#define CULL_WORLD_HALF_SIZE 500.0f
+
+static const u32 s_benchCounts[] = {10000, 100000, 500000};
+
+#pragma region INTERNAL
+static void RandomBox(u32* pRandom, f32 center[3], f32 extent[3])
+{
+    for (u32 i = 0; i < 3; ++i)
+    {
+        center[i] = (BenchRandomFloat(pRandom) * 2.0f - 1.0f) * CULL_WORLD_HALF_SIZE;
+        extent[i] = 0.5f + BenchRandomFloat(pRandom) * 2.0f;
+    }
+}
+
+// The test of the cull world one box at a time, same operations in the same order.
+static u32 CullLinear(const f32 (*pBoxes)[6], u32 count, const Frustum* pFrustum, u32* pVisible)
+{
+    u32 visibleCount = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        const f32* pBox      = pBoxes[i];
+        bool       isOutside = false;
+        for (u32 p = 0; p < 6 && !isOutside; ++p)
+        {
+            const f32* pPlane   = pFrustum->planes[p];
+            f32        distance = (pPlane[0] * pBox[0] + pPlane[1] * pBox[1]) + (pPlane[2] * pBox[2] + pPlane[3]);
+            f32        radius   = (fabsf(pPlane[0]) * pBox[3] + fabsf(pPlane[1]) * pBox[4]) + fabsf(pPlane[2]) * pBox[5];
+            isOutside           = distance + radius < 0.0f;
+        }
+        if (!isOutside)
+            pVisible[visibleCount++] = i;
+    }
+    return visibleCount;
+}
+
+static int CompareIds(const void* pA, const void* pB)
+{
+    u32 a = *(const u32*) pA;
+    u32 b = *(const u32*) pB;
+    return (a > b) - (a < b);
+}
+
+// The cull world emits ids in slot order, compared as sets.
+static bool MatchesLinear(CullWorld* pWorld, const f32 (*pBoxes)[6], const Frustum* pFrustum, u32* pExpected)
+{
+    u32 expectedCount = CullLinear(pBoxes, pWorld->objectCount, pFrustum, pExpected);
+    qsort(pWorld->pVisible, pWorld->visibleCount, sizeof(u32), CompareIds);
+    if (pWorld->visibleCount != expectedCount)
+    {
+        printf("  %u objects are visible, the linear test has %u.\n", pWorld->visibleCount, expectedCount);
+        return false;
+    }
+
+    for (u32 i = 0; i < expectedCount; ++i)
+    {
+        if (pWorld->pVisible[i] != pExpected[i])
+        {
+            printf("  Visible entry %u is object %u, the linear test has %u.\n", i, pWorld->pVisible[i], pExpected[i]);
+            return false;
+        }
+    }
+    return true;
+}
+#pragma endregion
+
+// Against the linear test from several directions, after a build, with objects added since the
+// build, after moving objects around and after the rebuild that follows.
+bool TestCulling(const char* argument)
+{
+    UNUSED(argument);
+
+    f32(*pBoxes)[6] = (f32(*)[6]) ALLOC(f32[6], CULL_TEST_OBJECTS);
+    u32*      pExpected = (u32*) ALLOC(u32, CULL_TEST_OBJECTS);
+    CullWorld world;
+    CHECK(pBoxes && pExpected && DROP_CreateCullWorld(CULL_TEST_OBJECTS, &world), "Failed to allocate the cull world.");
+    CHECK(DROP_CreateJobSystem(3), "Failed to create the job system.");
+
+    u32 random = 23;
+    for (u32 i = 0; i < CULL_TEST_OBJECTS; ++i)
+    {
+        RandomBox(&random, &pBoxes[i][0], &pBoxes[i][3]);
+        if (i == CULL_TEST_OBJECTS - 1000)
+            DROP_RebuildCullWorld(&world);
+
+        u32 object = DROP_CullAddObject(&world, &pBoxes[i][0], &pBoxes[i][3]);
+        CHECK(object == i, "Object %u got id %u.", i, object);
+    }
+    CHECK(world.builtCount == CULL_TEST_OBJECTS - 1000, "The last objects should be pending.");
+
+    for (u32 round = 0; round < 4; ++round)
+    {
+        // Round 0 culls with pending objects, the others after moving objects and updating.
+        if (round > 0)
+        {
+            for (u32 i = 0; i < CULL_TEST_OBJECTS / 50; ++i)
+            {
+                u32 object = BenchRandom(&random) % CULL_TEST_OBJECTS;
+                RandomBox(&random, &pBoxes[object][0], &pBoxes[object][3]);
+                DROP_CullSetBounds(&world, object, &pBoxes[object][0], &pBoxes[object][3]);
+            }
+            DROP_UpdateCullWorld(&world);
+            CHECK(!world.needsRefit, "The update left the tree stale.");
+        }
+        if (round == 3)
+            DROP_RebuildCullWorld(&world);
+
+        for (u32 view = 0; view < 8; ++view)
+        {
+            Mat4    viewProjection;
+            Frustum frustum;
+            BenchViewProjection(view * 0.785398f, &viewProjection);
+            DROP_ExtractFrustum(&viewProjection, &frustum);
+
+            DROP_CullObjects(&world, &frustum);
+            CHECK(world.visibleCount > 0 && world.visibleCount < CULL_TEST_OBJECTS, "The view %u sees %u objects.", view,
+                  world.visibleCount);
+            CHECK(MatchesLinear(&world, (const f32(*)[6]) pBoxes, &frustum, pExpected), "Round %u, view %u differs.", round,
+                  view);
+        }
+    }
+
+    // A box right behind the camera is out, one right in front is in.
+    DROP_DestroyCullWorld(&world);
+    CHECK(DROP_CreateCullWorld(2, &world), "Failed to allocate the small cull world.");
+    f32 extent[3] = {1.0f, 1.0f, 1.0f};
+    f32 behind[3] = {0.0f, 0.0f, -5.0f};
+    f32 front[3]  = {0.0f, 0.0f, 5.0f};
+    DROP_CullAddObject(&world, behind, extent);
+    u32 frontObject = DROP_CullAddObject(&world, front, extent);
+    DROP_RebuildCullWorld(&world);
+
+    Mat4    viewProjection;
+    Frustum frustum;
+    BenchViewProjection(0.0f, &viewProjection);
+    DROP_ExtractFrustum(&viewProjection, &frustum);
+    DROP_CullObjects(&world, &frustum);
+    CHECK(world.visibleCount == 1 && world.pVisible[0] == frontObject, "Only the box in front should be visible.");
+
+    DROP_DestroyJobSystem();
+    DROP_DestroyCullWorld(&world);
+    FREE(pExpected);
+    FREE(pBoxes);
+
+    return true;
+}
+
+// Culls a rotating view over objects spread in a cube around the camera, the tree on one thread and
+// on the job system against the linear test, plus the refit after 1% of the objects moved.
+bool BenchCulling(const char* argument)
+{
+    UNUSED(argument);
+
+    u32 maxCount    = s_benchCounts[ARRAY_COUNT(s_benchCounts) - 1];
+    f32(*pBoxes)[6] = (f32(*)[6]) ALLOC(f32[6], maxCount);
+    u32* pExpected  = (u32*) ALLOC(u32, maxCount);
+    if (!pBoxes || !pExpected)
+    {
+        if (pBoxes)
+            FREE(pBoxes);
+        if (pExpected)
+            FREE(pExpected);
+        return false;
+    }
+
+    bool isMatching = true;
+    for (u32 i = 0; i < ARRAY_COUNT(s_benchCounts) && isMatching; ++i)
+    {
+        u32       count = s_benchCounts[i];
+        CullWorld world;
+        if (!DROP_CreateCullWorld(count, &world))
+        {
+            isMatching = false;
+            break;
+        }
+
+        u32 random = 3;
+        for (u32 k = 0; k < count; ++k)
+        {
+            RandomBox(&random, &pBoxes[k][0], &pBoxes[k][3]);
+            DROP_CullAddObject(&world, &pBoxes[k][0], &pBoxes[k][3]);
+        }
+
+        u64 startTicks = DROP_GetTicks();
+        DROP_RebuildCullWorld(&world);
+        f64 buildMs = DROP_TicksToMilliseconds(DROP_GetTicks() - startTicks);
+
+        u64 linearTicks  = 0;
+        u64 refitTicks   = 0;
+        u64 cullTicks[2] = {0};
+        u32 threadCounts[2];
+        u64 visibleSum = 0;
+        for (u32 threaded = 0; threaded < 2; ++threaded)
+        {
+            if (threaded && !DROP_CreateJobSystem(0))
+                break;
+            threadCounts[threaded] = DROP_GetJobThreadCount();
+
+            for (u32 r = 0; r < CULL_BENCH_REPEATS; ++r)
+            {
+                Mat4    viewProjection;
+                Frustum frustum;
+                BenchViewProjection(r * 0.3f, &viewProjection);
+                DROP_ExtractFrustum(&viewProjection, &frustum);
+
+                startTicks = DROP_GetTicks();
+                DROP_CullObjects(&world, &frustum);
+                cullTicks[threaded] += DROP_GetTicks() - startTicks;
+                visibleSum += world.visibleCount;
+
+                if (threaded)
+                    continue;
+
+                startTicks = DROP_GetTicks();
+                CullLinear((const f32(*)[6]) pBoxes, count, &frustum, pExpected);
+                linearTicks += DROP_GetTicks() - startTicks;
+                isMatching = isMatching && MatchesLinear(&world, (const f32(*)[6]) pBoxes, &frustum, pExpected);
+
+                for (u32 k = 0; k < count / 100; ++k)
+                {
+                    u32 object = BenchRandom(&random) % count;
+                    pBoxes[object][0] += BenchRandomFloat(&random) - 0.5f;
+                    DROP_CullSetBounds(&world, object, &pBoxes[object][0], &pBoxes[object][3]);
+                }
+                startTicks = DROP_GetTicks();
+                DROP_UpdateCullWorld(&world);
+                refitTicks += DROP_GetTicks() - startTicks;
+            }
+
+            if (threaded)
+                DROP_DestroyJobSystem();
+        }
+
+        printf("  %6u objects, %5.1f%% visible: linear %7.3f ms, tree %7.3f ms on 1 thread, %7.3f ms on %u\n", count,
+               100.0 * visibleSum / (2.0 * CULL_BENCH_REPEATS * count),
+               DROP_TicksToMilliseconds(linearTicks) / CULL_BENCH_REPEATS,
+               DROP_TicksToMilliseconds(cullTicks[0]) / CULL_BENCH_REPEATS,
+               DROP_TicksToMilliseconds(cullTicks[1]) / CULL_BENCH_REPEATS, threadCounts[1]);
+        printf("  %6s  build %7.3f ms, refit after 1%% moved %7.3f ms\n", "", buildMs,
+               DROP_TicksToMilliseconds(refitTicks) / CULL_BENCH_REPEATS);
+
+        DROP_DestroyCullWorld(&world);
+    }
+
+    FREE(pExpected);
+    FREE(pBoxes);
+
+    return isMatching;
+}
@@ -0,0 +1,101 @@
+#include "Bench.h"
+#include "Graphics/DynamicResolution.h"
+
+#include <math.h>
+
+#define RESOLUTION_TEST_BUDGET_MS 16.0f
+
+// Same settings as EntryPoint.
+static const DynamicResolutionDesc s_resolutionDesc = {
+    .budgetMs       = RESOLUTION_TEST_BUDGET_MS,
+    .minScale       = 0.5f,
+    .maxScale       = 1.0f,
+    .scaleStep      = 0.05f,
+    .raiseThreshold = 0.8f,
+    .settleFrames   = 30};
+
+// A frame costs a fixed part and a part that follows the pixel count, with some noise on top.
+typedef struct _FrameTimeModel
+{
+    f32 fixedMs;
+    f32 pixelMs; // At scale 1.
+    f32 noise;   // Fraction of the frame time.
+    u32 random;
+} FrameTimeModel;
+
+#pragma region INTERNAL
+static f32 ModelFrameMs(FrameTimeModel* pModel, f32 scale)
+{
+    f32 frameMs = pModel->fixedMs + pModel->pixelMs * scale * scale;
+    return frameMs * (1.0f + (BenchRandomFloat(&pModel->random) * 2.0f - 1.0f) * pModel->noise);
+}
+
+// Runs the trace and returns how many times the scale changed after settleAfter frames.
+static u32 RunTrace(DynamicResolution* pResolution, FrameTimeModel* pModel, u32 frameCount, u32 settleAfter)
+{
+    u32 changeCount = 0;
+    for (u32 i = 0; i < frameCount; ++i)
+    {
+        f32 scale = pResolution->scale;
+        if (DROP_UpdateDynamicResolution(pResolution, ModelFrameMs(pModel, scale)) && i >= settleAfter)
+            ++changeCount;
+    }
+    return changeCount;
+}
+#pragma endregion
+
+bool TestDynamicResolution(const char* argument)
+{
+    UNUSED(argument);
+
+    DynamicResolution resolution;
+    DROP_InitDynamicResolution(&resolution, &s_resolutionDesc);
+
+    // 20 ms at full scale. The largest step that fits is 0.85 at 15.6 ms.
+    FrameTimeModel model = {.fixedMs = 4.0f, .pixelMs = 16.0f, .noise = 0.03f, .random = 42};
+    u32            moves = RunTrace(&resolution, &model, 2000, 200);
+    CHECK(fabsf(resolution.scale - 0.85f) < 1e-3f, "Converged to %.2f instead of 0.85.", resolution.scale);
+    CHECK(moves == 0, "The scale moved %u times once settled.", moves);
+
+    // One frame spikes to three times the budget. The average goes over for fewer frames than it
+    // takes to settle, so the scale stays.
+    DROP_UpdateDynamicResolution(&resolution, RESOLUTION_TEST_BUDGET_MS * 3.0f);
+    moves = RunTrace(&resolution, &model, 500, 0);
+    CHECK(moves == 0 && fabsf(resolution.scale - 0.85f) < 1e-3f, "A single spike moved the scale to %.2f.",
+          resolution.scale);
+
+    // The load doubles. The scale drops straight to where it fits instead of a step at a time, then
+    // settles at the largest step that still fits, 0.6 at 15.5 ms.
+    model.pixelMs   = 32.0f;
+    u32 frameCount  = 0;
+    u32 changeCount = 0;
+    while (frameCount < 200 && !changeCount)
+    {
+        changeCount += DROP_UpdateDynamicResolution(&resolution, ModelFrameMs(&model, resolution.scale));
+        ++frameCount;
+    }
+    CHECK(changeCount && frameCount <= s_resolutionDesc.settleFrames * 2,
+          "The scale took %u frames to react to twice the load.", frameCount);
+    CHECK(resolution.scale <= 0.65f + 1e-3f, "The first drop only went to %.2f.", resolution.scale);
+    moves = RunTrace(&resolution, &model, 2000, 500);
+    CHECK(fabsf(resolution.scale - 0.6f) < 1e-3f && moves == 0, "Settled at %.2f moving %u times.", resolution.scale,
+          moves);
+
+    // Back to the first load. The scale climbs a step at a time and stops as soon as the frame time is
+    // in the band between the raise threshold and the budget, at 0.75 and 13 ms, below where it came
+    // down from. That gap is the hysteresis.
+    model.pixelMs = 16.0f;
+    moves         = RunTrace(&resolution, &model, 2000, 1000);
+    CHECK(fabsf(resolution.scale - 0.75f) < 1e-3f && moves == 0, "Climbed back to %.2f moving %u times.",
+          resolution.scale, moves);
+
+    // Loads it can't meet or easily beats end up at the bounds.
+    model.pixelMs = 100.0f;
+    RunTrace(&resolution, &model, 1000, 0);
+    CHECK(resolution.scale == s_resolutionDesc.minScale, "An impossible load left the scale at %.2f.", resolution.scale);
+    model.pixelMs = 1.0f;
+    RunTrace(&resolution, &model, 2000, 0);
+    CHECK(resolution.scale == s_resolutionDesc.maxScale, "An idle load left the scale at %.2f.", resolution.scale);
+
+    return true;
+}
@@ -0,0 +1,158 @@
+#include "Bench.h"
+#include "Scene/Entity.h"
+#include "Utils/JobSystem.h"
+
+#define ENTITY_TEST_COUNT 2000 // Several chunks of the position and velocity archetype.
+
+typedef struct _ParallelVisits
+{
+    u8* pCounts; // One row of ENTITY_TEST_COUNT per thread, so the jobs never share a counter.
+    u32 threadCount;
+} ParallelVisits;
+
+#pragma region INTERNAL
+static f32 ReadX(const EntityWorld* pWorld, EntityId entity, ComponentId position)
+{
+    return ((const f32*) DROP_ReadComponent(pWorld, entity, position))[0];
+}
+
+static void CountVisits(void* pUserData, const EntityView* pView, u32 threadIndex)
+{
+    ParallelVisits* pVisits = (ParallelVisits*) pUserData;
+    if (threadIndex >= pVisits->threadCount)
+        return;
+
+    for (u32 i = 0; i < pView->count; ++i)
+        ++pVisits->pCounts[threadIndex * ENTITY_TEST_COUNT + pView->pEntities[i].index];
+}
+
+static void CountChunks(void* pUserData, const EntityView* pView, u32 threadIndex)
+{
+    UNUSED(pView);
+    UNUSED(threadIndex);
+    ++*(u32*) pUserData;
+}
+#pragma endregion
+
+// Archetype moves, swap-remove, stale ids, per-chunk change versions and the parallel query on a
+// world of a few thousand entities, each tagged with its creation index in the position x.
+bool TestEntity(const char* argument)
+{
+    UNUSED(argument);
+
+    EntityWorld world;
+    ComponentId position = 0;
+    ComponentId velocity = 0;
+    ComponentId tag      = 0;
+    CHECK(DROP_CreateEntityWorld(&world), "Failed to create the world.");
+    CHECK(DROP_RegisterComponent(&world, sizeof(f32) * 3, &position) &&
+              DROP_RegisterComponent(&world, sizeof(f32) * 3, &velocity) &&
+              DROP_RegisterComponent(&world, sizeof(u32), &tag),
+          "Failed to register the components.");
+
+    ComponentMask moving = COMPONENT_BIT(position) | COMPONENT_BIT(velocity);
+    EntityId      entities[ENTITY_TEST_COUNT];
+    for (u32 i = 0; i < ENTITY_TEST_COUNT; ++i)
+    {
+        CHECK(DROP_CreateEntity(&world, moving, &entities[i]), "Failed to create entity %u.", i);
+        ((f32*) DROP_WriteComponent(&world, entities[i], position))[0] = (f32) i;
+    }
+    const Archetype* pMoving = &world.archetypes[world.pRecords[entities[0].index].archetype];
+    CHECK(pMoving->chunkCount > 2, "%u entities fit in %u chunks.", ENTITY_TEST_COUNT, pMoving->chunkCount);
+
+    // Adding a component moves the entity and keeps its data, the new component starts zeroed. The last
+    // entity of the archetype fills the row it left.
+    u32           last    = ENTITY_TEST_COUNT - 1;
+    EntityRecord  leftRow = world.pRecords[entities[5].index];
+    ComponentMask tagged  = moving | COMPONENT_BIT(tag);
+    CHECK(DROP_SetEntityComponents(&world, entities[5], tagged), "Failed to add the tag.");
+    CHECK(world.pRecords[entities[5].index].archetype != leftRow.archetype, "Adding a component didn't move.");
+    CHECK(ReadX(&world, entities[5], position) == 5.0f, "The move lost the position.");
+    CHECK(*(const u32*) DROP_ReadComponent(&world, entities[5], tag) == 0, "The added component isn't zeroed.");
+    CHECK(world.pRecords[entities[last].index].chunk == leftRow.chunk &&
+              world.pRecords[entities[last].index].row == leftRow.row,
+          "The swapped entity's location wasn't fixed up.");
+    CHECK(ReadX(&world, entities[last], position) == (f32) last, "The swapped entity reads another entity.");
+
+    // Removing one moves it again, the removed component is gone.
+    CHECK(DROP_SetEntityComponents(&world, entities[5], COMPONENT_BIT(position) | COMPONENT_BIT(tag)),
+          "Failed to remove the velocity.");
+    CHECK(!DROP_ReadComponent(&world, entities[5], velocity), "The removed component is still there.");
+    CHECK(ReadX(&world, entities[5], position) == 5.0f, "The second move lost the position.");
+    CHECK(DROP_SetEntityComponents(&world, entities[5], moving), "Failed to move back.");
+    CHECK(world.pRecords[entities[5].index].archetype == leftRow.archetype, "Moving back used another archetype.");
+
+    // Destroying swaps the last entity in as well, and every entity still reads its own data.
+    EntityId destroyed = entities[10];
+    DROP_DestroyEntity(&world, destroyed);
+    for (u32 i = 0; i < ENTITY_TEST_COUNT; ++i)
+    {
+        if (i == 10)
+            continue;
+        CHECK(ReadX(&world, entities[i], position) == (f32) i, "Entity %u reads another entity.", i);
+    }
+
+    // The record is reused with a new generation, the old id stays dead.
+    EntityId reused;
+    EntityId zeroed = {0};
+    CHECK(DROP_CreateEntity(&world, moving, &reused), "Failed to create the reused entity.");
+    CHECK(reused.index == destroyed.index && reused.generation != destroyed.generation,
+          "Entity %u:%u was handed out after %u:%u.", reused.index, reused.generation, destroyed.index,
+          destroyed.generation);
+    CHECK(!DROP_IsEntityAlive(&world, destroyed) && !DROP_IsEntityAlive(&world, zeroed), "A stale id is alive.");
+    DROP_DestroyEntity(&world, destroyed);
+    CHECK(DROP_IsEntityAlive(&world, reused), "Destroying a stale id killed the entity reusing its record.");
+    ((f32*) DROP_WriteComponent(&world, reused, position))[0] = 10.0f;
+    entities[10] = reused;
+
+    // Reads leave the versions alone, a write bumps the one component in the one chunk.
+    u32 chunkVersions[64][2];
+    CHECK(pMoving->chunkCount <= ARRAY_COUNT(chunkVersions), "Too many chunks to track.");
+    for (u32 i = 0; i < pMoving->chunkCount; ++i)
+    {
+        chunkVersions[i][0] = pMoving->pChunks[i].versions[position];
+        chunkVersions[i][1] = pMoving->pChunks[i].versions[velocity];
+    }
+    u32 since = world.version;
+    for (u32 i = 0; i < ENTITY_TEST_COUNT; ++i)
+        ReadX(&world, entities[i], position);
+    CHECK(world.version == since, "Reads bumped the world version.");
+
+    u32 written = world.pRecords[entities[last].index].chunk;
+    ((f32*) DROP_WriteComponent(&world, entities[last], velocity))[1] = 1.0f;
+    for (u32 i = 0; i < pMoving->chunkCount; ++i)
+    {
+        const EntityChunk* pChunk      = &pMoving->pChunks[i];
+        bool               isBumped    = pChunk->versions[velocity] != chunkVersions[i][1];
+        bool               isUntouched = pChunk->versions[position] == chunkVersions[i][0];
+        CHECK(isUntouched && isBumped == (i == written), "Chunk %u has the wrong versions after the write.", i);
+    }
+
+    u32         changedChunks = 0;
+    EntityQuery changed       = {.all = moving, .changed = COMPONENT_BIT(velocity), .sinceVersion = since};
+    DROP_QueryEntities(&world, &changed, CountChunks, &changedChunks);
+    CHECK(changedChunks == 1, "The change query visited %u chunks.", changedChunks);
+
+    // The parallel query visits every entity once, whichever thread runs its chunk.
+    CHECK(DROP_CreateJobSystem(3), "Failed to create the job system.");
+    ParallelVisits visits = {.threadCount = DROP_GetJobThreadCount()};
+    visits.pCounts        = (u8*) ALLOC(u8, visits.threadCount * ENTITY_TEST_COUNT);
+    CHECK(visits.pCounts, "Failed to allocate the visit counts.");
+    memset(visits.pCounts, 0, visits.threadCount * ENTITY_TEST_COUNT);
+
+    EntityQuery all = {.all = COMPONENT_BIT(position)};
+    DROP_QueryEntitiesParallel(&world, &all, CountVisits, &visits);
+    for (u32 i = 0; i < ENTITY_TEST_COUNT; ++i)
+    {
+        u32 count = 0;
+        for (u32 t = 0; t < visits.threadCount; ++t)
+            count += visits.pCounts[t * ENTITY_TEST_COUNT + entities[i].index];
+        CHECK(count == 1, "Entity %u was visited %u times.", i, count);
+    }
+
+    FREE(visits.pCounts);
+    DROP_DestroyJobSystem();
+    DROP_DestroyEntityWorld(&world);
+
+    return true;
+}
@@ -0,0 +1,77 @@
+#include "Bench.h"
+#include "Utils/FrameArenas.h"
+
+#define FRAME_ARENAS_TEST_COUNT 4 // Three frames in flight plus the one being built.
+#define FRAME_ARENAS_TEST_FRAMES 32
+#define FRAME_ARENAS_TEST_SIZE 64 // Bytes each frame writes.
+#define FRAME_ARENAS_TEST_HELD 13 // Frame whose data is kept for as long as the arenas allow.
+
+#pragma region INTERNAL
+static bool IsFilled(const char* pData, u64 frameIndex)
+{
+    for (u32 i = 0; i < FRAME_ARENAS_TEST_SIZE; ++i)
+    {
+        if (pData[i] != (char) frameIndex)
+            return false;
+    }
+    return true;
+}
+#pragma endregion
+
+// Frames run against a fake fence that completes frames three behind, every frame fills its memory
+// with its index and the frames the GPU still reads are checked intact. One frame keeps its data for
+// the whole ring, so its arena is refused until the fence catches up with it.
+bool TestFrameArenas(const char* argument)
+{
+    UNUSED(argument);
+
+    FrameArenas arenas;
+    CHECK(DROP_MakeFrameArenas(&arenas, FRAME_ARENAS_TEST_COUNT, KB(1)), "Failed to make the frame arenas.");
+
+    char* pFrameData[FRAME_ARENAS_TEST_FRAMES + 1] = {0};
+
+    u32 framesAhead = FRAME_ARENAS_TEST_COUNT - 1;
+    u64 heldUntil   = FRAME_ARENAS_TEST_HELD + framesAhead;
+    u64 completed   = 0;
+    for (u64 frame = 1; frame <= FRAME_ARENAS_TEST_FRAMES; ++frame)
+    {
+        u32 slot = (u32) (frame % FRAME_ARENAS_TEST_COUNT);
+        if (frame > FRAME_ARENAS_TEST_COUNT && completed < frame - FRAME_ARENAS_TEST_COUNT)
+            completed = frame - FRAME_ARENAS_TEST_COUNT;
+
+        // The held frame's arena comes back before the fence reaches the last frame reading it.
+        if (frame == FRAME_ARENAS_TEST_HELD + FRAME_ARENAS_TEST_COUNT)
+        {
+            for (; completed < heldUntil; ++completed)
+            {
+                CHECK(!DROP_BeginFrameArenas(&arenas, frame, completed),
+                      "Frame %llu began with frame %llu in flight and %llu complete.", frame, heldUntil, completed);
+                CHECK(arenas.frameIndex == frame - 1, "A refused begin moved to frame %llu.", arenas.frameIndex);
+                CHECK(IsFilled(pFrameData[FRAME_ARENAS_TEST_HELD], FRAME_ARENAS_TEST_HELD),
+                      "A refused begin touched the held data.");
+            }
+        }
+
+        CHECK(DROP_BeginFrameArenas(&arenas, frame, completed), "Frame %llu didn't begin with %llu complete.", frame,
+              completed);
+        CHECK(arenas.arenas[slot].used == 0, "The arena of frame %llu wasn't cleared.", frame);
+
+        u32 ahead         = frame == FRAME_ARENAS_TEST_HELD ? framesAhead : 0;
+        pFrameData[frame] = DROP_AllocateFrame(&arenas, FRAME_ARENAS_TEST_SIZE, ahead);
+        CHECK(pFrameData[frame], "Frame %llu failed to allocate.", frame);
+        memset(pFrameData[frame], (char) frame, FRAME_ARENAS_TEST_SIZE);
+
+        // Every frame the fence hasn't completed still reads its data, and the held frame until its end.
+        for (u64 earlier = completed + 1; earlier < frame; ++earlier)
+            CHECK(IsFilled(pFrameData[earlier], earlier), "Frame %llu overwrote frame %llu.", frame, earlier);
+        if (frame > FRAME_ARENAS_TEST_HELD && frame <= heldUntil)
+        {
+            CHECK(IsFilled(pFrameData[FRAME_ARENAS_TEST_HELD], FRAME_ARENAS_TEST_HELD),
+                  "Frame %llu overwrote the held data.", frame);
+        }
+    }
+
+    DROP_DestroyFrameArenas(&arenas);
+
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "Bench.h"
+#include "Utils/FrameEncoder.h"
+#include "Math/HalfFloat.h"
+
+#define FRAME_BENCH_INPUT "bench_frames"
+#define FRAME_BENCH_OUTPUT "bench_encoded"
+#define FRAME_BENCH_WIDTH 1280
+#define FRAME_BENCH_HEIGHT 720
+#define FRAME_BENCH_COUNT 8
+
+static const char* s_encodingNames[] = {"pfm", "ppm", "raw"};
+
+#pragma region INTERNAL
+// A raw sequence like the capture writes, gradients past 1 so the 8-bit path clips some of it.
+static bool WriteSyntheticFrames(const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    u64          pixelCount = (u64) FRAME_BENCH_WIDTH * FRAME_BENCH_HEIGHT;
+    EncoderFrame frame      = {.width = FRAME_BENCH_WIDTH, .height = FRAME_BENCH_HEIGHT};
+    frame.pPixels           = (u16*) ALLOC(u16, pixelCount * 4);
+    f32* pRow               = (f32*) ALLOC(f32, FRAME_BENCH_WIDTH * 4);
+    bool isWritten          = frame.pPixels && pRow;
+
+    u64 bytesWritten = 0;
+    for (u32 i = 0; i < FRAME_BENCH_COUNT && isWritten; ++i)
+    {
+        for (u32 y = 0; y < FRAME_BENCH_HEIGHT; ++y)
+        {
+            for (u32 x = 0; x < FRAME_BENCH_WIDTH; ++x)
+            {
+                pRow[x * 4 + 0] = (f32) x / FRAME_BENCH_WIDTH * 2.0f;
+                pRow[x * 4 + 1] = (f32) y / FRAME_BENCH_HEIGHT;
+                pRow[x * 4 + 2] = (f32) i / FRAME_BENCH_COUNT * 4.0f;
+                pRow[x * 4 + 3] = 1.0f;
+            }
+            DROP_FloatToHalfArray(pRow, frame.pPixels + (u64) y * FRAME_BENCH_WIDTH * 4, FRAME_BENCH_WIDTH * 4,
+                                  HALF_ROUND_NEAREST_EVEN);
+        }
+
+        frame.frameIndex = i;
+        isWritten        = DROP_EncodeFrame(file, FRAME_ENCODING_RAW, &frame, pRow, &bytesWritten);
+    }
+
+    if (frame.pPixels)
+        FREE(frame.pPixels);
+    if (pRow)
+        FREE(pRow);
+    fclose(file);
+
+    return isWritten;
+}
+
+static bool ReadRawHeader(FILE* file, RawFrameHeader* pHeader)
+{
+    return fread(pHeader, sizeof(*pHeader), 1, file) == 1 && pHeader->magic == FRAME_ENCODER_RAW_MAGIC;
+}
+
+static void RemoveEncodedFiles(FrameEncoding encoding, u32 frameCount)
+{
+    char path[FRAME_ENCODER_NAME_LENGTH + 16];
+    if (encoding == FRAME_ENCODING_RAW)
+    {
+        snprintf(path, sizeof(path), "%s.raw", FRAME_BENCH_OUTPUT);
+        remove(path);
+        return;
+    }
+
+    for (u32 i = 0; i < frameCount; ++i)
+    {
+        snprintf(path, sizeof(path), "%s_%04u.%s", FRAME_BENCH_OUTPUT, i, s_encodingNames[encoding]);
+        remove(path);
+    }
+}
+
+// Reads every frame of the file into the encoder queue. The queue is flushed whenever it is full
+// instead of dropping frames, so the file is read while the previous frames are encoded.
+static bool EncodeFile(const char* path, FrameEncoding encoding)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        printf("  Failed to open %s.\n", path);
+        return false;
+    }
+
+    RawFrameHeader header;
+    if (!ReadRawHeader(file, &header))
+    {
+        printf("  %s is not a raw frame sequence.\n", path);
+        fclose(file);
+        return false;
+    }
+
+    FrameEncoderDesc desc = {
+        .fileName  = FRAME_BENCH_OUTPUT,
+        .encoding  = encoding,
+        .maxWidth  = header.width,
+        .maxHeight = header.height};
+
+    FrameEncoder encoder = NULL;
+    if (!DROP_CreateFrameEncoder(&desc, &encoder))
+    {
+        fclose(file);
+        return false;
+    }
+
+    u64  startTicks = DROP_GetTicks();
+    u64  bytesRead  = 0;
+    u32  frameCount = 0;
+    bool isRead     = true;
+    do
+    {
+        if (frameCount % FRAME_ENCODER_QUEUE_LENGTH == 0)
+            DROP_FlushFrameEncoder(encoder);
+
+        EncoderFrame* pFrame = DROP_AcquireEncoderFrame(encoder, header.width, header.height, header.frameIndex);
+        if (!pFrame)
+        {
+            isRead = false;
+            break;
+        }
+
+        u64 pixelCount = (u64) header.width * header.height;
+        if (fread(pFrame->pPixels, sizeof(u16) * 4, pixelCount, file) != pixelCount)
+        {
+            isRead = false;
+            break;
+        }
+
+        DROP_SubmitEncoderFrame(encoder);
+        bytesRead += sizeof(header) + sizeof(u16) * 4 * pixelCount;
+        ++frameCount;
+    } while (ReadRawHeader(file, &header));
+    DROP_FlushFrameEncoder(encoder);
+
+    f64  seconds   = DROP_TicksToSeconds(DROP_GetTicks() - startTicks);
+    bool isEncoded = isRead && !DROP_AtomicLoad32(&encoder->isFailed);
+    printf("  %s: %u frames, read %.1f MB/s, wrote %.1f MB/s, %.2f ms per frame on the encoder thread\n",
+           s_encodingNames[encoding], frameCount, bytesRead / seconds / (1024.0 * 1024.0),
+           encoder->bytesWritten / seconds / (1024.0 * 1024.0),
+           frameCount ? DROP_TicksToMilliseconds(encoder->encodeTicks) / frameCount : 0.0);
+
+    DROP_DestroyFrameEncoder(&encoder);
+    fclose(file);
+    RemoveEncodedFiles(encoding, frameCount);
+
+    return isEncoded;
+}
+#pragma endregion
+
+// The argument is a raw sequence written by the capture, a synthetic one is written when there is none.
+bool BenchFrameEncoder(const char* argument)
+{
+    const char* path = argument ? argument : FRAME_BENCH_INPUT ".raw";
+    if (!argument && !WriteSyntheticFrames(path))
+    {
+        printf("  Failed to write %s.\n", path);
+        return false;
+    }
+
+    bool isEncoded = true;
+    for (u32 encoding = 0; encoding < ARRAY_COUNT(s_encodingNames) && isEncoded; ++encoding)
+        isEncoded = EncodeFile(path, (FrameEncoding) encoding);
+
+    if (!argument)
+        remove(path);
+
+    return isEncoded;
+}
@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include "Platform/FrameTiming.h"
+#include "Platform/Thread.h"
+
+#include <math.h>
+
+#define FRAME_BENCH_RATE 120.0
+#define FRAME_BENCH_FRAMES 360
+#define FRAME_BENCH_WORK_MS 3.0
+
+#pragma region INTERNAL
+static bool IsNear(f64 value, f64 expected)
+{
+    return fabs(value - expected) < 1e-6;
+}
+
+// Stands in for the frame, a busy wait so the limiter only waits for the rest of the interval.
+static void SimulateWork(f64 milliseconds)
+{
+    u64 endTicks = DROP_GetTicks() + (u64) (milliseconds * DROP_GetTickFrequency() / 1000.0);
+    while (DROP_GetTicks() < endTicks)
+        DROP_YieldProcessor();
+}
+#pragma endregion
+
+// Statistics of a window filled with known frame times, 1 to 300 ms, of which only the last 256
+// are kept.
+bool TestFrameTiming(const char* argument)
+{
+    UNUSED(argument);
+
+    FrameTiming timing;
+    DROP_InitFrameTiming(&timing);
+
+    u64 ticksPerMs = DROP_GetTickFrequency() / 1000;
+    for (u32 i = 1; i <= 300; ++i)
+    {
+        timing.samples[timing.nextSample] = i * ticksPerMs;
+        timing.nextSample                 = (timing.nextSample + 1) & (FRAME_TIMING_WINDOW - 1);
+        if (timing.sampleCount < FRAME_TIMING_WINDOW)
+            ++timing.sampleCount;
+    }
+
+    FrameTimingStats stats;
+    DROP_GetFrameTimingStats(&timing, &stats);
+    CHECK(stats.sampleCount == FRAME_TIMING_WINDOW, "Window holds %u samples.", stats.sampleCount);
+    CHECK(IsNear(stats.minMs, 45.0) && IsNear(stats.maxMs, 300.0), "Range is %f to %f ms.", stats.minMs, stats.maxMs);
+    CHECK(IsNear(stats.averageMs, 172.5), "Average is %f ms.", stats.averageMs);
+    CHECK(IsNear(stats.medianMs, 173.0) && IsNear(stats.p95Ms, 288.0) && IsNear(stats.p99Ms, 298.0),
+          "Percentiles are %f, %f and %f ms.", stats.medianMs, stats.p95Ms, stats.p99Ms);
+    CHECK(IsNear(stats.targetMs, 0.0), "Limiter is on without a limit.");
+
+    // Everything past the buckets lands in the last one.
+    CHECK(stats.histogram[FRAME_TIMING_HISTOGRAM_BUCKETS - 1] == FRAME_TIMING_WINDOW &&
+              stats.histogram[FRAME_TIMING_HISTOGRAM_BUCKETS - 2] == 0,
+          "Histogram tail holds %u frames.", stats.histogram[FRAME_TIMING_HISTOGRAM_BUCKETS - 1]);
+
+    return true;
+}
+
+// The limiter holding a headless loop with a few milliseconds of work per frame to a fixed rate.
+bool BenchFrameTiming(const char* argument)
+{
+    UNUSED(argument);
+
+    FrameTiming timing;
+    DROP_InitFrameTiming(&timing);
+    DROP_SetFrameLimit(&timing, FRAME_BENCH_RATE);
+
+    // The frame times of the last window only, the first frames still learn the sleep jitter.
+    for (u32 i = 0; i < FRAME_BENCH_FRAMES; ++i)
+    {
+        SimulateWork(FRAME_BENCH_WORK_MS);
+        DROP_EndFrameTiming(&timing);
+    }
+
+    FrameTimingStats stats;
+    DROP_GetFrameTimingStats(&timing, &stats);
+    DROP_SetFrameLimit(&timing, 0.0);
+
+    printf("  Target %.3f ms: median %.3f ms, p99 %.3f ms, min %.3f ms, max %.3f ms.\n", stats.targetMs,
+           stats.medianMs, stats.p99Ms, stats.minMs, stats.maxMs);
+    printf("  Sleep oversleeps %.3f ms on average, the wait ends %.3f ms past its deadline.\n", stats.sleepJitterMs,
+           stats.wakeErrorMs);
+
+    return true;
+}
@@ -0,0 +1,42 @@
+#include "Bench.h"
+#include "Math/GaussianKernel.h"
+
+#include <math.h>
+
+bool TestGaussianKernel(const char* argument)
+{
+    UNUSED(argument);
+
+    for (u32 radius = 1; radius <= GAUSSIAN_MAX_RADIUS; ++radius)
+    {
+        GaussianKernel kernel;
+        CHECK(DROP_BuildGaussianKernel(radius / 3.0f, radius, &kernel), "Radius %u failed to build.", radius);
+        CHECK(kernel.tapCount == (radius + 1) / 2, "Radius %u has %u taps.", radius, kernel.tapCount);
+
+        // The taps stand for texels on both sides, the center for one.
+        f32 sum = kernel.centerWeight;
+        for (u32 i = 0; i < kernel.tapCount; ++i)
+        {
+            sum += kernel.weights[i] * 2.0f;
+            CHECK(kernel.offsets[i] >= i * 2 + 1 && kernel.offsets[i] <= i * 2 + 2,
+                  "Radius %u tap %u is at %f, outside of its texels.", radius, i, kernel.offsets[i]);
+        }
+        CHECK(fabsf(sum - 1.0f) < 1e-5f, "Radius %u weights sum to %f.", radius, sum);
+    }
+
+    GaussianKernelCache cache;
+    DROP_InitGaussianKernelCache(&cache);
+
+    const GaussianKernel* pFirst  = NULL;
+    const GaussianKernel* pSecond = NULL;
+    CHECK(DROP_GetGaussianKernel(&cache, 2.0f, 6, &pFirst), "Sigma 2 failed to build.");
+    CHECK(DROP_GetGaussianKernel(&cache, 2.0f + 0.004f, 6, &pSecond), "Sigma 2.004 failed to build.");
+    CHECK(pFirst == pSecond && cache.kernelCount == 1, "Sigmas within a step built %u kernels.", cache.kernelCount);
+
+    CHECK(DROP_GetGaussianKernel(&cache, 2.0f + 1.0f / GAUSSIAN_SIGMA_STEPS, 6, &pSecond), "Next step failed.");
+    CHECK(pSecond->id != pFirst->id && cache.kernelCount == 2, "The next step reused the kernel.");
+
+    // A tiny sigma still gets a kernel, a sigma of zero doesn't.
+    CHECK(DROP_GetGaussianKernel(&cache, 0.001f, 1, &pSecond) && pSecond->sigma > 0.0f, "Tiny sigma failed.");
+    return true;
+}
@@ -0,0 +1,189 @@
+#include "Bench.h"
+#include "Math/HalfFloat.h"
+
+#include <math.h>
+
+#define HALF_COUNT 65536
+// Every half exactly, and for every gap between two neighbours its midpoint and the floats on each side.
+#define HALF_CASE_COUNT (HALF_COUNT * 4)
+#define HALF_BENCH_COUNT (1 << 20)
+#define HALF_BENCH_REPEATS 50
+
+static const char* s_pathNames[HALF_FLOAT_PATH_COUNT] = {"scalar", "sse2", "f16c"};
+
+static u16 s_halves[HALF_COUNT];
+static f32 s_floats[HALF_COUNT];
+static f32 s_pathFloats[HALF_COUNT];
+static f32 s_caseInputs[HALF_CASE_COUNT];
+static u16 s_caseExpected[HALF_CASE_COUNT];
+static u16 s_caseOutputs[HALF_CASE_COUNT];
+
+#pragma region INTERNAL
+static u32 FloatBits(f32 value)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Decodes the fields on their own, nothing shared with the library.
+static u32 ReferenceHalfToFloatBits(u16 half)
+{
+    u32 sign     = (u32) (half & 0x8000) << 16;
+    u32 exponent = (half >> 10) & 0x1F;
+    u32 mantissa = half & 0x3FF;
+    if (exponent == 0x1F)
+        return sign | 0x7F800000 | (mantissa ? 0x400000 | (mantissa << 13) : 0);
+
+    f32 magnitude = exponent ? ldexpf((f32) (mantissa | 0x400), (i32) exponent - 25) : ldexpf((f32) mantissa, -24);
+    return sign | FloatBits(magnitude);
+}
+
+// A value strictly between the magnitudes of lower and lower + 1, going from below to above the midpoint.
+static u16 ReferenceRoundGap(u16 lower, HalfRounding rounding, bool isAboveMidpoint, bool isMidpoint)
+{
+    u16  upper      = lower + 1;
+    bool isNegative = (lower & 0x8000) != 0;
+    switch (rounding)
+    {
+    case HALF_ROUND_NEAREST_EVEN:
+        if (isMidpoint)
+            return (lower & 1) ? upper : lower;
+        return isAboveMidpoint ? upper : lower;
+    case HALF_ROUND_TOWARD_ZERO:
+        return lower;
+    case HALF_ROUND_UP:
+        return isNegative ? lower : upper;
+    case HALF_ROUND_DOWN:
+        return isNegative ? upper : lower;
+    }
+    return 0;
+}
+
+// The floats of the cases and what every one of them rounds to.
+static u32 BuildRoundingCases(HalfRounding rounding)
+{
+    u32 caseCount = 0;
+    for (u32 i = 0; i < HALF_COUNT; ++i)
+    {
+        u16 half                  = (u16) i;
+        s_caseInputs[caseCount]   = s_floats[i];
+        s_caseExpected[caseCount] = (half & 0x7FFF) > 0x7C00 ? half | 0x200 : half;
+        ++caseCount;
+
+        // The gap above 0x7BFF ends at infinity, it rounds like any other.
+        if ((half & 0x7FFF) >= 0x7C00)
+            continue;
+
+        f32 lower    = s_floats[i];
+        f32 upper    = s_floats[i + 1];
+        // Exact, a half has 11 significant bits. Past 65504 the step is still 32, to 65536.
+        f32 midpoint = isinf(upper) ? lower + copysignf(16.0f, lower) : (lower + upper) * 0.5f;
+
+        s_caseInputs[caseCount]       = nextafterf(midpoint, lower);
+        s_caseExpected[caseCount]     = ReferenceRoundGap(half, rounding, false, false);
+        s_caseInputs[caseCount + 1]   = midpoint;
+        s_caseExpected[caseCount + 1] = ReferenceRoundGap(half, rounding, false, true);
+        s_caseInputs[caseCount + 2]   = nextafterf(midpoint, upper);
+        s_caseExpected[caseCount + 2] = ReferenceRoundGap(half, rounding, true, false);
+        caseCount += 3;
+    }
+    return caseCount;
+}
+#pragma endregion
+
+bool TestHalfFloatExhaustive(const char* argument)
+{
+    UNUSED(argument);
+
+    for (u32 i = 0; i < HALF_COUNT; ++i)
+    {
+        s_halves[i] = (u16) i;
+        f32 value       = DROP_HalfToFloat((u16) i);
+        CHECK(FloatBits(value) == ReferenceHalfToFloatBits((u16) i), "Half %04x decodes to %08x, expected %08x.", i,
+              FloatBits(value), ReferenceHalfToFloatBits((u16) i));
+        s_floats[i] = value;
+    }
+
+    HalfFloatPath bestPath = DROP_GetHalfFloatPath();
+    for (u32 path = 0; path < HALF_FLOAT_PATH_COUNT; ++path)
+    {
+        DROP_SetHalfFloatPath((HalfFloatPath) path);
+        if ((u32) DROP_GetHalfFloatPath() != path)
+        {
+            printf("  %s is not available on this CPU.\n", s_pathNames[path]);
+            continue;
+        }
+
+        DROP_HalfToFloatArray(s_halves, s_pathFloats, HALF_COUNT);
+        for (u32 i = 0; i < HALF_COUNT; ++i)
+            CHECK(FloatBits(s_pathFloats[i]) == FloatBits(s_floats[i]), "%s decodes half %04x to %08x, expected %08x.",
+                  s_pathNames[path], i, FloatBits(s_pathFloats[i]), FloatBits(s_floats[i]));
+
+        for (u32 rounding = 0; rounding <= HALF_ROUND_DOWN; ++rounding)
+        {
+            u32 caseCount = BuildRoundingCases((HalfRounding) rounding);
+            DROP_FloatToHalfArray(s_caseInputs, s_caseOutputs, caseCount, (HalfRounding) rounding);
+            for (u32 i = 0; i < caseCount; ++i)
+            {
+                u16 scalar = DROP_FloatToHalf(s_caseInputs[i], (HalfRounding) rounding);
+                CHECK(scalar == s_caseExpected[i], "Scalar rounds %08x to %04x in mode %u, expected %04x.",
+                      FloatBits(s_caseInputs[i]), scalar, rounding, s_caseExpected[i]);
+                CHECK(s_caseOutputs[i] == s_caseExpected[i], "%s rounds %08x to %04x in mode %u, expected %04x.",
+                      s_pathNames[path], FloatBits(s_caseInputs[i]), s_caseOutputs[i], rounding, s_caseExpected[i]);
+            }
+        }
+    }
+    DROP_SetHalfFloatPath(bestPath);
+
+    return true;
+}
+
+bool BenchHalfFloat(const char* argument)
+{
+    UNUSED(argument);
+
+    f32* pFloats = ALLOC(f32, HALF_BENCH_COUNT);
+    u16* pHalves = ALLOC(u16, HALF_BENCH_COUNT);
+    if (!pFloats || !pHalves)
+    {
+        if (pFloats)
+            FREE(pFloats);
+        if (pHalves)
+            FREE(pHalves);
+        return false;
+    }
+
+    u32 random = 0x9E3779B9;
+    for (u32 i = 0; i < HALF_BENCH_COUNT; ++i)
+        pFloats[i] = (BenchRandomFloat(&random) - 0.5f) * 200.0f;
+
+    // Both directions move 6 bytes per value, 2 of half and 4 of float.
+    f64 bytes = (f64) HALF_BENCH_REPEATS * HALF_BENCH_COUNT * (sizeof(u16) + sizeof(f32));
+
+    HalfFloatPath bestPath = DROP_GetHalfFloatPath();
+    for (u32 path = 0; path < HALF_FLOAT_PATH_COUNT; ++path)
+    {
+        DROP_SetHalfFloatPath((HalfFloatPath) path);
+        if ((u32) DROP_GetHalfFloatPath() != path)
+            continue;
+
+        u64 startTicks = DROP_GetTicks();
+        for (u32 i = 0; i < HALF_BENCH_REPEATS; ++i)
+            DROP_FloatToHalfArray(pFloats, pHalves, HALF_BENCH_COUNT, HALF_ROUND_NEAREST_EVEN);
+        u64 encodeTicks = DROP_GetTicks() - startTicks;
+
+        startTicks = DROP_GetTicks();
+        for (u32 i = 0; i < HALF_BENCH_REPEATS; ++i)
+            DROP_HalfToFloatArray(pHalves, pFloats, HALF_BENCH_COUNT);
+        u64 decodeTicks = DROP_GetTicks() - startTicks;
+
+        printf("  %-6s float to half %6.2f GB/s, half to float %6.2f GB/s\n", s_pathNames[path],
+               bytes / DROP_TicksToSeconds(encodeTicks) * 1e-9, bytes / DROP_TicksToSeconds(decodeTicks) * 1e-9);
+    }
+    DROP_SetHalfFloatPath(bestPath);
+
+    FREE(pFloats);
+    FREE(pHalves);
+    return true;
+}
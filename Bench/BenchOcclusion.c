@@ -0,0 +1,303 @@
+#include "Bench.h"
+#include "Scene/Occlusion.h"
+#include "Utils/JobSystem.h"
+
+#include <math.h>
+
+#define OCCLUSION_TEST_WIDTH 256
+#define OCCLUSION_TEST_HEIGHT 128
+#define OCCLUSION_TEST_BOXES 20000
+#define OCCLUSION_BENCH_OCCLUDERS 100
+#define OCCLUSION_BENCH_BOXES 100000
+#define OCCLUSION_BENCH_REPEATS 20
+
+typedef struct _BufferSize
+{
+    u32 width;
+    u32 height;
+} BufferSize;
+
+static const BufferSize s_benchSizes[] = {{256, 128}, {512, 256}, {1024, 512}};
+
+// Unit cube from -1 to 1, 12 triangles.
+static const f32 s_cubePositions[] = {
+    -1.0f, -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f,
+    -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+static const u32 s_cubeIndices[] = {
+    0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+    2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+
+#pragma region INTERNAL
+static Mat4 MakeBoxWorld(const f32 center[3], const f32 extent[3])
+{
+    Mat4 world;
+    world.rows[0] = _mm_setr_ps(extent[0], 0.0f, 0.0f, 0.0f);
+    world.rows[1] = _mm_setr_ps(0.0f, extent[1], 0.0f, 0.0f);
+    world.rows[2] = _mm_setr_ps(0.0f, 0.0f, extent[2], 0.0f);
+    world.rows[3] = _mm_setr_ps(center[0], center[1], center[2], 1.0f);
+    return world;
+}
+
+static void AddBoxOccluder(OcclusionBuffer* pBuffer, const f32 center[3], const f32 extent[3])
+{
+    Mat4 world = MakeBoxWorld(center, extent);
+    DROP_OcclusionAddOccluder(pBuffer, &world, s_cubePositions, s_cubeIndices, ARRAY_COUNT(s_cubeIndices));
+}
+
+static bool TestCenteredBox(const OcclusionBuffer* pBuffer, const f32 center[3], const f32 extent[3])
+{
+    f32 boxMin[3] = {center[0] - extent[0], center[1] - extent[1], center[2] - extent[2]};
+    f32 boxMax[3] = {center[0] + extent[0], center[1] + extent[1], center[2] + extent[2]};
+    return DROP_OcclusionTestBox(pBuffer, boxMin, boxMax);
+}
+
+// Boxes in front of the camera, inside the view most of the time.
+static void RandomBox(u32* pRandom, f32 nearZ, f32 farZ, f32 center[3], f32 extent[3])
+{
+    center[2] = nearZ + BenchRandomFloat(pRandom) * (farZ - nearZ);
+    center[0] = (BenchRandomFloat(pRandom) * 2.0f - 1.0f) * center[2] * 0.6f;
+    center[1] = (BenchRandomFloat(pRandom) * 2.0f - 1.0f) * center[2] * 0.4f;
+    for (u32 i = 0; i < 3; ++i)
+        extent[i] = 0.5f + BenchRandomFloat(pRandom) * 1.5f;
+}
+
+// A hidden box must be behind the occluders at every pixel its corners span, which the block
+// max depths only ever overestimate.
+static bool IsHiddenPerPixel(const OcclusionBuffer* pBuffer, const f32 center[3], const f32 extent[3])
+{
+    f32 minX = INFINITY, maxX = -INFINITY;
+    f32 minY = INFINITY, maxY = -INFINITY;
+    f32 minZ = INFINITY;
+    for (u32 corner = 0; corner < 8; ++corner)
+    {
+        f32 point[4] = {
+            center[0] + ((corner & 1) ? extent[0] : -extent[0]),
+            center[1] + ((corner & 2) ? extent[1] : -extent[1]),
+            center[2] + ((corner & 4) ? extent[2] : -extent[2]), 1.0f};
+
+        f32 clip[4];
+        _mm_storeu_ps(clip, DROP_Mat4TransformRow(_mm_loadu_ps(point), &pBuffer->viewProjection));
+        if (clip[3] <= 0.0f)
+            return false;
+
+        minX = fminf(minX, (clip[0] / clip[3] + 1.0f) * 0.5f * (f32) pBuffer->width);
+        maxX = fmaxf(maxX, (clip[0] / clip[3] + 1.0f) * 0.5f * (f32) pBuffer->width);
+        minY = fminf(minY, (1.0f - clip[1] / clip[3]) * 0.5f * (f32) pBuffer->height);
+        maxY = fmaxf(maxY, (1.0f - clip[1] / clip[3]) * 0.5f * (f32) pBuffer->height);
+        minZ = fminf(minZ, clip[2] / clip[3]);
+    }
+
+    i32 x0 = (i32) fmaxf(floorf(minX), 0.0f), x1 = (i32) fminf(floorf(maxX), (f32) pBuffer->width - 1.0f);
+    i32 y0 = (i32) fmaxf(floorf(minY), 0.0f), y1 = (i32) fminf(floorf(maxY), (f32) pBuffer->height - 1.0f);
+    for (i32 y = y0; y <= y1; ++y)
+    {
+        for (i32 x = x0; x <= x1; ++x)
+        {
+            if (pBuffer->pDepth[y * pBuffer->width + x] >= minZ)
+                return false;
+        }
+    }
+    return true;
+}
+#pragma endregion
+
+// An empty buffer hides nothing, a wall over the whole view fills every pixel with its depth and
+// hides exactly what is behind it, and random boxes behind a few cubes are only reported hidden when
+// every pixel they cover is closer. Tiles rasterized on the job system match the inline ones.
+bool TestOcclusion(const char* argument)
+{
+    UNUSED(argument);
+
+    OcclusionBuffer buffer;
+    Mat4            viewProjection;
+    BenchViewProjection(0.0f, &viewProjection);
+    f32* pInlineDepth = (f32*) ALLOC(f32, OCCLUSION_TEST_WIDTH * OCCLUSION_TEST_HEIGHT);
+    CHECK(pInlineDepth && DROP_CreateOcclusionBuffer(OCCLUSION_TEST_WIDTH, OCCLUSION_TEST_HEIGHT, 256, &buffer),
+          "Failed to allocate the occlusion buffer.");
+
+    u32 random = 29;
+    DROP_OcclusionBegin(&buffer, &viewProjection);
+    DROP_OcclusionRasterize(&buffer);
+    for (u32 i = 0; i < 1000; ++i)
+    {
+        f32 center[3], extent[3];
+        RandomBox(&random, 1.0f, 500.0f, center, extent);
+        CHECK(TestCenteredBox(&buffer, center, extent), "Box %u is hidden by nothing.", i);
+    }
+
+    // Wall at z = 10, far wider than the view there.
+    static const f32 wallPositions[] = {-50.0f, -50.0f, 10.0f, 50.0f, -50.0f, 10.0f, -50.0f, 50.0f, 10.0f, 50.0f, 50.0f, 10.0f};
+    static const u32 wallIndices[]   = {0, 2, 1, 1, 2, 3};
+    Mat4             identity        = DROP_Mat4Identity();
+    DROP_OcclusionBegin(&buffer, &viewProjection);
+    DROP_OcclusionAddOccluder(&buffer, &identity, wallPositions, wallIndices, ARRAY_COUNT(wallIndices));
+    DROP_OcclusionRasterize(&buffer);
+
+    f32 q         = 1000.0f / (1000.0f - 0.1f);
+    f32 wallDepth = q - 0.1f * q / 10.0f;
+    for (u32 i = 0; i < OCCLUSION_TEST_WIDTH * OCCLUSION_TEST_HEIGHT; ++i)
+        CHECK(fabsf(buffer.pDepth[i] - wallDepth) < 1e-4f, "Pixel %u has depth %f, the wall %f.", i, buffer.pDepth[i], wallDepth);
+
+    f32 unit[3]     = {1.0f, 1.0f, 1.0f};
+    f32 behind[3]   = {3.0f, -2.0f, 20.0f};
+    f32 front[3]    = {3.0f, -2.0f, 5.0f};
+    f32 crossing[3] = {0.0f, 0.0f, 10.5f};
+    f32 camera[3]   = {0.0f, 0.0f, 0.0f};
+    CHECK(!TestCenteredBox(&buffer, behind, unit), "The box behind the wall is visible.");
+    CHECK(TestCenteredBox(&buffer, front, unit), "The box in front of the wall is hidden.");
+    CHECK(TestCenteredBox(&buffer, crossing, unit), "The box through the wall is hidden.");
+    CHECK(TestCenteredBox(&buffer, camera, unit), "The box around the camera is hidden.");
+
+    // The same through the visible list of a cull world.
+    CullWorld world;
+    CHECK(DROP_CreateCullWorld(3, &world), "Failed to allocate the cull world.");
+    DROP_CullAddObject(&world, behind, unit);
+    u32 frontObject    = DROP_CullAddObject(&world, front, unit);
+    u32 crossingObject = DROP_CullAddObject(&world, crossing, unit);
+    DROP_RebuildCullWorld(&world);
+
+    Frustum frustum;
+    DROP_ExtractFrustum(&viewProjection, &frustum);
+    DROP_CullObjects(&world, &frustum);
+    CHECK(world.visibleCount == 3, "The frustum should keep all 3 boxes, it kept %u.", world.visibleCount);
+    DROP_OcclusionCullVisible(&buffer, &world);
+    CHECK(world.visibleCount == 2 &&
+              ((world.pVisible[0] == frontObject && world.pVisible[1] == crossingObject) ||
+               (world.pVisible[0] == crossingObject && world.pVisible[1] == frontObject)),
+          "Only the boxes in front of and through the wall should be left.");
+    DROP_DestroyCullWorld(&world);
+
+    // A few cubes, inline then on the job system.
+    f32 occluders[8][6];
+    for (u32 i = 0; i < ARRAY_COUNT(occluders); ++i)
+    {
+        RandomBox(&random, 20.0f, 60.0f, &occluders[i][0], &occluders[i][3]);
+        for (u32 k = 3; k < 6; ++k)
+            occluders[i][k] *= 4.0f;
+    }
+
+    for (u32 threaded = 0; threaded < 2; ++threaded)
+    {
+        CHECK(!threaded || DROP_CreateJobSystem(3), "Failed to create the job system.");
+
+        DROP_OcclusionBegin(&buffer, &viewProjection);
+        for (u32 i = 0; i < ARRAY_COUNT(occluders); ++i)
+            AddBoxOccluder(&buffer, &occluders[i][0], &occluders[i][3]);
+        DROP_OcclusionRasterize(&buffer);
+
+        if (!threaded)
+        {
+            memcpy(pInlineDepth, buffer.pDepth, sizeof(f32) * OCCLUSION_TEST_WIDTH * OCCLUSION_TEST_HEIGHT);
+            continue;
+        }
+        CHECK(!memcmp(pInlineDepth, buffer.pDepth, sizeof(f32) * OCCLUSION_TEST_WIDTH * OCCLUSION_TEST_HEIGHT),
+              "The tiles rasterized on the job system differ.");
+        DROP_DestroyJobSystem();
+    }
+
+    u32 hiddenCount = 0;
+    for (u32 i = 0; i < OCCLUSION_TEST_BOXES; ++i)
+    {
+        f32 center[3], extent[3];
+        RandomBox(&random, 1.0f, 200.0f, center, extent);
+        if (TestCenteredBox(&buffer, center, extent))
+            continue;
+
+        CHECK(IsHiddenPerPixel(&buffer, center, extent), "Box %u is reported hidden but a pixel shows it.", i);
+        ++hiddenCount;
+    }
+    CHECK(hiddenCount > OCCLUSION_TEST_BOXES / 20, "Only %u boxes of %u are hidden.", hiddenCount, OCCLUSION_TEST_BOXES);
+
+    DROP_DestroyOcclusionBuffer(&buffer);
+    FREE(pInlineDepth);
+
+    return true;
+}
+
+// A hundred cubes in front of the camera and a hundred thousand boxes behind and among them. Times
+// the transform and binning, the rasterization on one thread and on the job system, and the tests.
+bool BenchOcclusion(const char* argument)
+{
+    UNUSED(argument);
+
+    f32(*pBoxes)[6] = (f32(*)[6]) ALLOC(f32[6], OCCLUSION_BENCH_BOXES);
+    if (!pBoxes)
+        return false;
+
+    u32 random = 31;
+    f32 occluders[OCCLUSION_BENCH_OCCLUDERS][6];
+    for (u32 i = 0; i < OCCLUSION_BENCH_OCCLUDERS; ++i)
+    {
+        RandomBox(&random, 20.0f, 100.0f, &occluders[i][0], &occluders[i][3]);
+        for (u32 k = 3; k < 6; ++k)
+            occluders[i][k] *= 3.0f;
+    }
+    for (u32 i = 0; i < OCCLUSION_BENCH_BOXES; ++i)
+        RandomBox(&random, 1.0f, 400.0f, &pBoxes[i][0], &pBoxes[i][3]);
+
+    u32 triangleCount = OCCLUSION_BENCH_OCCLUDERS * ARRAY_COUNT(s_cubeIndices) / 3;
+    for (u32 s = 0; s < ARRAY_COUNT(s_benchSizes); ++s)
+    {
+        OcclusionBuffer buffer;
+        if (!DROP_CreateOcclusionBuffer(s_benchSizes[s].width, s_benchSizes[s].height, triangleCount, &buffer))
+        {
+            FREE(pBoxes);
+            return false;
+        }
+
+        u64 setupTicks      = 0;
+        u64 testTicks       = 0;
+        u64 rasterTicks[2]  = {0};
+        u32 threadCounts[2] = {1, 1};
+        u32 hiddenCount     = 0;
+        for (u32 threaded = 0; threaded < 2; ++threaded)
+        {
+            if (threaded && !DROP_CreateJobSystem(0))
+                break;
+            threadCounts[threaded] = DROP_GetJobThreadCount();
+
+            for (u32 r = 0; r < OCCLUSION_BENCH_REPEATS; ++r)
+            {
+                Mat4 viewProjection;
+                BenchViewProjection(r * 0.01f, &viewProjection);
+
+                u64 startTicks = DROP_GetTicks();
+                DROP_OcclusionBegin(&buffer, &viewProjection);
+                for (u32 i = 0; i < OCCLUSION_BENCH_OCCLUDERS; ++i)
+                    AddBoxOccluder(&buffer, &occluders[i][0], &occluders[i][3]);
+                u64 rasterStartTicks = DROP_GetTicks();
+                DROP_OcclusionRasterize(&buffer);
+                u64 endTicks = DROP_GetTicks();
+
+                setupTicks += rasterStartTicks - startTicks;
+                rasterTicks[threaded] += endTicks - rasterStartTicks;
+
+                if (threaded)
+                    continue;
+
+                startTicks = DROP_GetTicks();
+                for (u32 i = 0; i < OCCLUSION_BENCH_BOXES; ++i)
+                    hiddenCount += !TestCenteredBox(&buffer, &pBoxes[i][0], &pBoxes[i][3]);
+                testTicks += DROP_GetTicks() - startTicks;
+            }
+
+            if (threaded)
+                DROP_DestroyJobSystem();
+        }
+
+        f64 testMs = DROP_TicksToMilliseconds(testTicks) / OCCLUSION_BENCH_REPEATS;
+        printf("  %4ux%-4u %u triangles: begin and bin %6.3f ms, rasterize %6.3f ms on 1 thread, %6.3f ms on %u\n",
+               buffer.width, buffer.height, buffer.triangleCount,
+               DROP_TicksToMilliseconds(setupTicks) / (2 * OCCLUSION_BENCH_REPEATS),
+               DROP_TicksToMilliseconds(rasterTicks[0]) / OCCLUSION_BENCH_REPEATS,
+               DROP_TicksToMilliseconds(rasterTicks[1]) / OCCLUSION_BENCH_REPEATS, threadCounts[1]);
+        printf("  %9s %u boxes tested in %6.3f ms, %.1f ns per box, %.1f%% hidden\n", "", OCCLUSION_BENCH_BOXES, testMs,
+               testMs * 1e6 / OCCLUSION_BENCH_BOXES, 100.0 * hiddenCount / ((f64) OCCLUSION_BENCH_BOXES * OCCLUSION_BENCH_REPEATS));
+
+        DROP_DestroyOcclusionBuffer(&buffer);
+    }
+
+    FREE(pBoxes);
+
+    return true;
+}
@@ -0,0 +1,272 @@
+#include "Bench.h"
+#include "Math/PackedFloat.h"
+
+#include <math.h>
+
+#define R11_CODE_COUNT 2048
+#define RGB9E5_MANTISSA_COUNT 512
+#define RGB9E5_EXPONENT_COUNT 32
+#define PACKED_BENCH_COUNT (1 << 20)
+#define PACKED_BENCH_REPEATS 20
+
+typedef u32 (*PackFunc)(f32 r, f32 g, f32 b);
+typedef void (*UnpackFunc)(u32 packed, f32* pRGB);
+typedef void (*PackPixelsFunc)(const f32* pPixels, u32* pPacked, u32 count);
+typedef void (*UnpackPixelsFunc)(const u32* pPacked, f32* pPixels, u32 count);
+
+typedef struct _PackedCase
+{
+    f32 value;
+    u32 r11;    // Red and green channels.
+    u32 b10;    // Blue channel.
+    u32 rgb9e5; // The value in all three channels.
+} PackedCase;
+
+typedef struct _PackedFormat
+{
+    const char*      name;
+    PackFunc         Pack;
+    UnpackFunc       Unpack;
+    PackPixelsFunc   PackPixels;
+    UnpackPixelsFunc UnpackPixels;
+} PackedFormat;
+
+static const PackedFormat s_formats[] = {
+    {"R11G11B10", DROP_PackR11G11B10, DROP_UnpackR11G11B10, DROP_PackR11G11B10Pixels, DROP_UnpackR11G11B10Pixels},
+    {"RGB9E5", DROP_PackRGB9E5, DROP_UnpackRGB9E5, DROP_PackRGB9E5Pixels, DROP_UnpackRGB9E5Pixels}};
+
+// Encodings worked out by hand from the formats. R11 and B10 exponents are biased by 15, the RGB9E5
+// exponent by 15 plus the 9 mantissa bits, so its smallest step is 2^-24.
+static const PackedCase s_knownCases[] = {
+    {0.0f, 0x000, 0x000, 0x00000000},
+    {1.0f, 0x3C0, 0x1E0, 0x84020100},
+    {0.5f, 0x380, 0x1C0, 0x7C020100},
+    {2.0f, 0x400, 0x200, 0x8C020100},
+    {65024.0f, 0x7BF, 0x3DF, 0xFFF3F9FC},          // Largest finite R11, past the largest finite B10.
+    {1e9f, 0x7BF, 0x3DF, 0xFFFFFFFF},              // Clamped to the largest finite values.
+    {1.0f / 1048576.0f, 0x001, 0x000, 0x00402010}, // 2^-20, the smallest R11 denormal, half of the B10 one.
+    {1e-40f, 0x000, 0x000, 0x00000000},            // Float denormals are below every format.
+    {-1.0f, 0x000, 0x000, 0x00000000},
+    {-INFINITY, 0x000, 0x000, 0x00000000},
+    {INFINITY, 0x7C0, 0x3E0, 0xFFFFFFFF},
+    {NAN, 0x7C1, 0x3E1, 0x00000000},
+    {-NAN, 0x7C1, 0x3E1, 0x00000000}};
+
+static u32 s_rgb9e5Codes[RGB9E5_MANTISSA_COUNT];
+static u32 s_rgb9e5Repacked[RGB9E5_MANTISSA_COUNT];
+static f32 s_rgb9e5Pixels[RGB9E5_MANTISSA_COUNT * 4];
+static f32 s_rgb9e5Again[RGB9E5_MANTISSA_COUNT * 4];
+
+#pragma region INTERNAL
+static u32 FloatBits(f32 value)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static bool IsSameFloat(f32 a, f32 b)
+{
+    return FloatBits(a) == FloatBits(b) || (isnan(a) && isnan(b));
+}
+
+// Decodes the fields on their own, nothing shared with the library.
+static f32 ReferenceSmallFloat(u32 code, u32 mantissaBits)
+{
+    u32 exponent = code >> mantissaBits;
+    u32 mantissa = code & ((1u << mantissaBits) - 1);
+    if (exponent == 0x1F)
+        return mantissa ? NAN : INFINITY;
+    if (exponent == 0)
+        return ldexpf((f32) mantissa, -14 - (i32) mantissaBits);
+    return ldexpf((f32) (mantissa | (1u << mantissaBits)), (i32) exponent - 15 - (i32) mantissaBits);
+}
+
+// Four copies of the color through the pixel version, so the SSE2 loop is the one that runs.
+static u32 PackPixels(const PackedFormat* pFormat, f32 r, f32 g, f32 b)
+{
+    f32 pixels[16];
+    u32 packed[4];
+    for (u32 i = 0; i < 4; ++i)
+    {
+        pixels[i * 4 + 0] = r;
+        pixels[i * 4 + 1] = g;
+        pixels[i * 4 + 2] = b;
+        pixels[i * 4 + 3] = 1.0f;
+    }
+    pFormat->PackPixels(pixels, packed, 4);
+    return packed[3];
+}
+
+static void PrintThroughput(const char* name, const char* direction, u64 ticks)
+{
+    // A pixel is 16 bytes of floats and 4 packed, whichever way it goes.
+    f64 seconds = DROP_TicksToSeconds(ticks);
+    f64 pixels  = (f64) PACKED_BENCH_REPEATS * PACKED_BENCH_COUNT;
+    printf("  %-10s %-13s %8.1f Mpixels/s %6.2f GB/s\n", name, direction, pixels / seconds * 1e-6,
+           pixels * (sizeof(f32) * 4 + sizeof(u32)) / seconds * 1e-9);
+}
+#pragma endregion
+
+// Known encodings and special values, every R11 and B10 code through unpack and pack, and every RGB9E5
+// exponent with every mantissa of two channels. The pixel versions give the same bits throughout.
+bool TestPackedFloat(const char* argument)
+{
+    UNUSED(argument);
+
+    const PackedFormat* pR11G11B10 = &s_formats[0];
+    const PackedFormat* pRGB9E5    = &s_formats[1];
+    for (u32 i = 0; i < ARRAY_COUNT(s_knownCases); ++i)
+    {
+        const PackedCase* pCase    = &s_knownCases[i];
+        f32               value    = pCase->value;
+        u32               expected = pCase->r11 | (pCase->r11 << 11) | (pCase->b10 << 22);
+        u32               scalar   = DROP_PackR11G11B10(value, value, value);
+        u32               pixel    = PackPixels(pR11G11B10, value, value, value);
+        CHECK(scalar == expected && pixel == expected, "%g packs to R11G11B10 %08x and %08x, expected %08x.", value,
+              scalar, pixel, expected);
+
+        scalar = DROP_PackRGB9E5(value, value, value);
+        pixel  = PackPixels(pRGB9E5, value, value, value);
+        CHECK(scalar == pCase->rgb9e5 && pixel == pCase->rgb9e5, "%g packs to RGB9E5 %08x and %08x, expected %08x.",
+              value, scalar, pixel, pCase->rgb9e5);
+    }
+
+    // Red and green take every 11-bit code, blue every 10-bit one. NaN codes come back as the one NaN.
+    for (u32 code = 0; code < R11_CODE_COUNT; ++code)
+    {
+        u32 blue   = code >> 1;
+        u32 packed = code | (code << 11) | (blue << 22);
+        f32 rgb[3];
+        f32 pixels[16];
+        u32 pixelCodes[4] = {packed, packed, packed, packed};
+        DROP_UnpackR11G11B10(packed, rgb);
+        DROP_UnpackR11G11B10Pixels(pixelCodes, pixels, 4);
+        CHECK(IsSameFloat(rgb[0], ReferenceSmallFloat(code, 6)) && IsSameFloat(rgb[2], ReferenceSmallFloat(blue, 5)),
+              "R11G11B10 %08x unpacks to %g %g.", packed, rgb[0], rgb[2]);
+        CHECK(IsSameFloat(pixels[12], rgb[0]) && IsSameFloat(pixels[14], rgb[2]) && pixels[15] == 1.0f,
+              "The pixel version unpacks R11G11B10 %08x to %g %g.", packed, pixels[12], pixels[14]);
+
+        u32 red      = isnan(rgb[0]) ? 0x7C1 : code;
+        u32 expected = red | (red << 11) | ((isnan(rgb[2]) ? 0x3E1 : blue) << 22);
+        u32 scalar   = DROP_PackR11G11B10(rgb[0], rgb[1], rgb[2]);
+        u32 pixel    = PackPixels(pR11G11B10, rgb[0], rgb[1], rgb[2]);
+        CHECK(scalar == expected && pixel == expected, "R11G11B10 %08x packs back to %08x and %08x.", packed,
+              scalar, pixel);
+    }
+
+    // Every value comes back exactly. The encoding is only unique when the largest mantissa uses its top
+    // bit or the exponent can't go lower, those codes come back bit for bit.
+    for (u32 exponent = 0; exponent < RGB9E5_EXPONENT_COUNT; ++exponent)
+    {
+        for (u32 red = 0; red < RGB9E5_MANTISSA_COUNT; ++red)
+        {
+            for (u32 green = 0; green < RGB9E5_MANTISSA_COUNT; ++green)
+                s_rgb9e5Codes[green] = red | (green << 9) | (((red ^ green) & 0x1FF) << 18) | (exponent << 27);
+
+            DROP_UnpackRGB9E5Pixels(s_rgb9e5Codes, s_rgb9e5Pixels, RGB9E5_MANTISSA_COUNT);
+            DROP_PackRGB9E5Pixels(s_rgb9e5Pixels, s_rgb9e5Repacked, RGB9E5_MANTISSA_COUNT);
+            DROP_UnpackRGB9E5Pixels(s_rgb9e5Repacked, s_rgb9e5Again, RGB9E5_MANTISSA_COUNT);
+            f32 scale = ldexpf(1.0f, (i32) exponent - 24);
+            for (u32 green = 0; green < RGB9E5_MANTISSA_COUNT; ++green)
+            {
+                u32 code = s_rgb9e5Codes[green];
+                u32 blue = (red ^ green) & 0x1FF;
+                f32 rgb[3];
+                DROP_UnpackRGB9E5(code, rgb);
+                CHECK(rgb[0] == red * scale && rgb[1] == green * scale && rgb[2] == blue * scale,
+                      "RGB9E5 %08x unpacks to %g %g %g.", code, rgb[0], rgb[1], rgb[2]);
+                CHECK(!memcmp(rgb, &s_rgb9e5Pixels[green * 4], sizeof(rgb)), "The pixel version unpacks %08x apart.",
+                      code);
+
+                u32 scalar = DROP_PackRGB9E5(rgb[0], rgb[1], rgb[2]);
+                CHECK(scalar == s_rgb9e5Repacked[green], "RGB9E5 %08x packs back to %08x and %08x.", code, scalar,
+                      s_rgb9e5Repacked[green]);
+                CHECK(!memcmp(rgb, &s_rgb9e5Again[green * 4], sizeof(rgb)),
+                      "RGB9E5 %08x packs back to %08x, another value.", code, scalar);
+
+                u32 largest = red > green ? red : green;
+                largest     = largest > blue ? largest : blue;
+                CHECK(scalar == code || (largest < 256 && exponent > 0), "RGB9E5 %08x packs back to %08x.", code,
+                      scalar);
+            }
+        }
+    }
+
+    return true;
+}
+
+// The SSE2 pixel versions against the scalar versions over the same HDR pixels.
+bool BenchPackedFloat(const char* argument)
+{
+    UNUSED(argument);
+
+    f32* pPixels    = (f32*) ALLOC(f32, (u64) PACKED_BENCH_COUNT * 4);
+    f32* pUnpacked  = (f32*) ALLOC(f32, (u64) PACKED_BENCH_COUNT * 4);
+    u32* pPacked    = (u32*) ALLOC(u32, PACKED_BENCH_COUNT);
+    u32* pScalar    = (u32*) ALLOC(u32, PACKED_BENCH_COUNT);
+    bool isMatching = pPixels && pUnpacked && pPacked && pScalar;
+    if (!isMatching)
+    {
+        if (pPixels)
+            FREE(pPixels);
+        if (pUnpacked)
+            FREE(pUnpacked);
+        if (pPacked)
+            FREE(pPacked);
+        if (pScalar)
+            FREE(pScalar);
+        return false;
+    }
+
+    // Mostly below 1 with a tail up to 64, like a lit HDR frame.
+    u32 random = 0xBADC0DE;
+    for (u32 i = 0; i < PACKED_BENCH_COUNT * 4; ++i)
+    {
+        f32 value  = BenchRandomFloat(&random);
+        pPixels[i] = value * value * value * 64.0f;
+    }
+
+    for (u32 f = 0; f < ARRAY_COUNT(s_formats) && isMatching; ++f)
+    {
+        const PackedFormat* pFormat = &s_formats[f];
+
+        u64 startTicks = DROP_GetTicks();
+        for (u32 r = 0; r < PACKED_BENCH_REPEATS; ++r)
+        {
+            for (u32 i = 0; i < PACKED_BENCH_COUNT; ++i)
+                pScalar[i] = pFormat->Pack(pPixels[i * 4 + 0], pPixels[i * 4 + 1], pPixels[i * 4 + 2]);
+        }
+        PrintThroughput(pFormat->name, "scalar pack", DROP_GetTicks() - startTicks);
+
+        startTicks = DROP_GetTicks();
+        for (u32 r = 0; r < PACKED_BENCH_REPEATS; ++r)
+            pFormat->PackPixels(pPixels, pPacked, PACKED_BENCH_COUNT);
+        PrintThroughput(pFormat->name, "sse2 pack", DROP_GetTicks() - startTicks);
+
+        isMatching = !memcmp(pScalar, pPacked, sizeof(u32) * PACKED_BENCH_COUNT);
+
+        startTicks = DROP_GetTicks();
+        for (u32 r = 0; r < PACKED_BENCH_REPEATS; ++r)
+        {
+            for (u32 i = 0; i < PACKED_BENCH_COUNT; ++i)
+                pFormat->Unpack(pPacked[i], &pUnpacked[i * 4]);
+        }
+        PrintThroughput(pFormat->name, "scalar unpack", DROP_GetTicks() - startTicks);
+
+        startTicks = DROP_GetTicks();
+        for (u32 r = 0; r < PACKED_BENCH_REPEATS; ++r)
+            pFormat->UnpackPixels(pPacked, pUnpacked, PACKED_BENCH_COUNT);
+        PrintThroughput(pFormat->name, "sse2 unpack", DROP_GetTicks() - startTicks);
+    }
+
+    if (!isMatching)
+        printf("  The pixel versions packed other bits than the scalar versions.\n");
+
+    FREE(pPixels);
+    FREE(pUnpacked);
+    FREE(pPacked);
+    FREE(pScalar);
+
+    return isMatching;
+}
@@ -0,0 +1,146 @@
+#include "Bench.h"
+#include "Utils/Profiler.h"
+#include "Utils/JobSystem.h"
+
+#define PROFILER_TEST_FILE "bench_trace.json"
+#define PROFILER_TEST_FRAMES 8
+#define PROFILER_TEST_ITEMS 64
+#define PROFILER_BENCH_PAIRS 4096 // Per frame, well inside a thread's event ring.
+#define PROFILER_BENCH_FRAMES 256
+
+#pragma region INTERNAL
+static void ProfiledJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    UNUSED(pUserData);
+    UNUSED(threadIndex);
+
+    for (u32 i = begin; i < end; ++i)
+    {
+        DROP_ProfileBegin("Item");
+        DROP_ProfileBegin("Inner");
+        DROP_ProfileEnd();
+        DROP_ProfileEnd();
+    }
+}
+
+static const ProfileZone* FindZone(const char* name, u32 parent, u32* pIndex)
+{
+    u32                zoneCount = 0;
+    const ProfileZone* pZones    = DROP_GetProfileZones(&zoneCount);
+    for (u32 i = 0; i < zoneCount; ++i)
+    {
+        if (!strcmp(pZones[i].name, name) && pZones[i].parent == parent)
+        {
+            if (pIndex)
+                *pIndex = i;
+            return &pZones[i];
+        }
+    }
+    return NULL;
+}
+
+static u32 CountOccurrences(const char* text, const char* pattern)
+{
+    u32 count = 0;
+    for (const char* p = strstr(text, pattern); p; p = strstr(p + 1, pattern))
+        ++count;
+    return count;
+}
+
+static f64 TimeZonePairs()
+{
+    u64 ticks = 0;
+    for (u32 frame = 0; frame < PROFILER_BENCH_FRAMES; ++frame)
+    {
+        u64 startTicks = DROP_GetTicks();
+        for (u32 i = 0; i < PROFILER_BENCH_PAIRS; ++i)
+        {
+            DROP_ProfileBegin("Pair");
+            DROP_ProfileEnd();
+        }
+        ticks += DROP_GetTicks() - startTicks;
+        DROP_ProfileEndFrame();
+    }
+    return DROP_TicksToSeconds(ticks) * 1e9 / ((f64) PROFILER_BENCH_FRAMES * PROFILER_BENCH_PAIRS);
+}
+#pragma endregion
+
+// Zones opened on the main thread and on the job system workers. The zone tree of the last frame
+// must count every call under the right parent and the trace must hold every zone of its frames.
+bool TestProfiler(const char* argument)
+{
+    UNUSED(argument);
+
+    CHECK(DROP_CreateProfiler(), "Failed to create the profiler.");
+    CHECK(DROP_CreateJobSystem(3), "Failed to create the job system.");
+
+    CHECK(DROP_BeginProfileTrace(PROFILER_TEST_FILE, 2), "Failed to begin the trace.");
+    for (u32 frame = 0; frame < PROFILER_TEST_FRAMES; ++frame)
+    {
+        DROP_ProfileBegin("Frame");
+        DROP_ProfileBegin("Update");
+        DROP_ProfileEnd();
+        DROP_ParallelFor(PROFILER_TEST_ITEMS, 1, ProfiledJob, NULL);
+        DROP_ProfileEnd();
+        DROP_ProfileEndFrame();
+    }
+
+    u32                frameIndex = 0;
+    const ProfileZone* pFrame     = FindZone("Frame", PROFILE_NO_PARENT, &frameIndex);
+    const ProfileZone* pUpdate    = FindZone("Update", frameIndex, NULL);
+    CHECK(pFrame && pFrame->callCount == 1 && pFrame->depth == 0, "Frame zone is missing or counted wrong.");
+    CHECK(pUpdate && pUpdate->callCount == 1 && pUpdate->depth == 1, "Update zone is missing or counted wrong.");
+    CHECK(pFrame->selfTicks <= pFrame->inclusiveTicks && pUpdate->inclusiveTicks <= pFrame->inclusiveTicks,
+          "Frame times don't add up.");
+
+    // Items that ran on the calling thread sit under Frame, the ones of the workers at the root.
+    u32                mainIndex  = 0;
+    u32                rootIndex  = 0;
+    const ProfileZone* pMainItem  = FindZone("Item", frameIndex, &mainIndex);
+    const ProfileZone* pRootItem  = FindZone("Item", PROFILE_NO_PARENT, &rootIndex);
+    u32                itemCount  = (pMainItem ? pMainItem->callCount : 0) + (pRootItem ? pRootItem->callCount : 0);
+    const ProfileZone* pMainInner = pMainItem ? FindZone("Inner", mainIndex, NULL) : NULL;
+    const ProfileZone* pRootInner = pRootItem ? FindZone("Inner", rootIndex, NULL) : NULL;
+    u32 innerCount = (pMainInner ? pMainInner->callCount : 0) + (pRootInner ? pRootInner->callCount : 0);
+    CHECK(itemCount == PROFILER_TEST_ITEMS && innerCount == PROFILER_TEST_ITEMS,
+          "Counted %u items and %u inner zones instead of %u.", itemCount, innerCount, PROFILER_TEST_ITEMS);
+
+    DROP_DestroyJobSystem();
+    DROP_DestroyProfiler();
+
+    // Two frames of Frame, Update, and an Item and an Inner per item.
+    FILE* file = fopen(PROFILER_TEST_FILE, "rb");
+    CHECK(file, "The trace wasn't written.");
+    char* pText = (char*) ALLOC(char, 1 << 20);
+    CHECK(pText, "Failed to allocate the trace text.");
+    size_t size  = fread(pText, 1, (1 << 20) - 1, file);
+    pText[size]  = '\0';
+    fclose(file);
+    remove(PROFILER_TEST_FILE);
+
+    u32  eventCount = CountOccurrences(pText, "\"ph\":\"X\"");
+    u32  itemEvents = CountOccurrences(pText, "\"name\":\"Item\"");
+    bool isClosed   = size > 4 && !strcmp(pText + size - 4, "\n]}\n");
+    FREE(pText);
+
+    CHECK(eventCount == 2 * (2 + PROFILER_TEST_ITEMS * 2) && itemEvents == 2 * PROFILER_TEST_ITEMS && isClosed,
+          "The trace holds %u events, %u items.", eventCount, itemEvents);
+
+    return true;
+}
+
+// Cost of a begin and end pair while the profiler records, and with it destroyed, which is what a
+// build without PROFILE pays when the functions are still called directly.
+bool BenchProfiler(const char* argument)
+{
+    UNUSED(argument);
+
+    if (!DROP_CreateProfiler())
+        return false;
+    f64 recordingNs = TimeZonePairs();
+    DROP_DestroyProfiler();
+    f64 idleNs = TimeZonePairs();
+
+    printf("  Zone begin and end: %.1f ns recording, %.1f ns without a profiler.\n", recordingNs, idleNs);
+    return true;
+}
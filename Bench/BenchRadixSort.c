@@ -0,0 +1,168 @@
+#include "Bench.h"
+#include "Utils/RadixSort.h"
+#include "Utils/JobSystem.h"
+
+#define RADIX_BENCH_REPEATS 10
+
+static const u32 s_benchCounts[] = {100000, 1000000};
+
+typedef struct _KeyValue
+{
+    u64 key;
+    u32 value;
+} KeyValue;
+
+#pragma region INTERNAL
+// Equal keys compare by value, the submission index, so qsort gives the stable order.
+static int CompareKeyValues(const void* pA, const void* pB)
+{
+    const KeyValue* a = (const KeyValue*) pA;
+    const KeyValue* b = (const KeyValue*) pB;
+    if (a->key != b->key)
+        return a->key < b->key ? -1 : 1;
+    return (a->value > b->value) - (a->value < b->value);
+}
+
+// Laid out like an opaque render key, pass (4) | pipeline (8) | material (16) | mesh (16) | depth (20),
+// with few passes, pipelines and materials so many keys share their top bits.
+static u64 MakeDrawKey(u32* pRandom)
+{
+    u64 key = BenchRandom(pRandom) % 3;
+    key     = (key << 8) | BenchRandom(pRandom) % 12;
+    key     = (key << 16) | BenchRandom(pRandom) % 200;
+    key     = (key << 16) | BenchRandom(pRandom) % 1000;
+    key     = (key << 20) | (BenchRandom(pRandom) & 0xFFFFF);
+    return key;
+}
+
+static void FillKeys(RadixSort* pSort, KeyValue* pReference, u32 count, u32 seed, u64 keyMask)
+{
+    u32 random = seed;
+    for (u32 i = 0; i < count; ++i)
+    {
+        u64 key = keyMask ? ((u64) BenchRandom(&random) << 32 | BenchRandom(&random)) & keyMask : MakeDrawKey(&random);
+        pSort->pKeys[i]     = key;
+        pSort->pValues[i]   = i;
+        pReference[i].key   = key;
+        pReference[i].value = i;
+    }
+}
+
+static bool MatchesReference(const RadixSort* pSort, const KeyValue* pReference, u32 count)
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (pSort->pKeys[i] != pReference[i].key || pSort->pValues[i] != pReference[i].value)
+        {
+            printf("  Entry %u is %llx from %u, the stable sort has %llx from %u.\n", i, pSort->pKeys[i],
+                   pSort->pValues[i], pReference[i].key, pReference[i].value);
+            return false;
+        }
+    }
+    return true;
+}
+#pragma endregion
+
+// Against qsort with the index as a tie break, over counts around the block size, key widths
+// that take an odd and an even number of passes, and keys that are all equal.
+bool TestRadixSort(const char* argument)
+{
+    UNUSED(argument);
+
+    static const u32 counts[] = {0, 1, 2, 1000, 4096, 4097, 70000, 200003};
+    static const u64 masks[]  = {0, 0xFF, 0xFFFF00, 0xFFFFFFFFFFFFFFFF, 0x8000000000000001};
+
+    RadixSort sort;
+    KeyValue* pReference = (KeyValue*) ALLOC(KeyValue, 200003);
+    CHECK(pReference && DROP_MakeRadixSort(&sort, 200003), "Failed to allocate the sort.");
+    CHECK(DROP_CreateJobSystem(3), "Failed to create the job system.");
+
+    for (u32 i = 0; i < ARRAY_COUNT(counts); ++i)
+    {
+        for (u32 j = 0; j < ARRAY_COUNT(masks) + 1; ++j)
+        {
+            // The extra round has every key equal.
+            u64 mask = j < ARRAY_COUNT(masks) ? masks[j] : 0;
+            FillKeys(&sort, pReference, counts[i], i * 31 + j, mask);
+            if (j == ARRAY_COUNT(masks))
+            {
+                for (u32 k = 0; k < counts[i]; ++k)
+                    sort.pKeys[k] = pReference[k].key = 42;
+            }
+
+            DROP_RadixSort(&sort, counts[i]);
+            qsort(pReference, counts[i], sizeof(KeyValue), CompareKeyValues);
+            CHECK(MatchesReference(&sort, pReference, counts[i]), "%u keys masked with %llx differ.", counts[i], mask);
+        }
+    }
+
+    DROP_DestroyJobSystem();
+    DROP_DestroyRadixSort(&sort);
+    FREE(pReference);
+
+    return true;
+}
+
+// Render keys sorted with the radix sort on one thread and on the job system, against qsort.
+bool BenchRadixSort(const char* argument)
+{
+    UNUSED(argument);
+
+    u32       maxCount   = s_benchCounts[ARRAY_COUNT(s_benchCounts) - 1];
+    KeyValue* pReference = (KeyValue*) ALLOC(KeyValue, maxCount);
+    RadixSort sort;
+    if (!pReference || !DROP_MakeRadixSort(&sort, maxCount))
+    {
+        if (pReference)
+            FREE(pReference);
+        return false;
+    }
+
+    bool isSorted = true;
+    for (u32 i = 0; i < ARRAY_COUNT(s_benchCounts) && isSorted; ++i)
+    {
+        u32 count = s_benchCounts[i];
+
+        u64 qsortTicks = 0;
+        for (u32 r = 0; r < RADIX_BENCH_REPEATS; ++r)
+        {
+            FillKeys(&sort, pReference, count, r, 0);
+            u64 startTicks = DROP_GetTicks();
+            qsort(pReference, count, sizeof(KeyValue), CompareKeyValues);
+            qsortTicks += DROP_GetTicks() - startTicks;
+        }
+
+        // Without the job system the sort runs inline.
+        u64 radixTicks[2] = {0};
+        u32 threadCounts[2];
+        for (u32 threaded = 0; threaded < 2; ++threaded)
+        {
+            if (threaded && !DROP_CreateJobSystem(0))
+                break;
+            threadCounts[threaded] = DROP_GetJobThreadCount();
+
+            for (u32 r = 0; r < RADIX_BENCH_REPEATS; ++r)
+            {
+                FillKeys(&sort, pReference, count, r, 0);
+                u64 startTicks = DROP_GetTicks();
+                DROP_RadixSort(&sort, count);
+                radixTicks[threaded] += DROP_GetTicks() - startTicks;
+            }
+
+            qsort(pReference, count, sizeof(KeyValue), CompareKeyValues);
+            isSorted = isSorted && MatchesReference(&sort, pReference, count);
+            if (threaded)
+                DROP_DestroyJobSystem();
+        }
+
+        printf("  %7u keys: qsort %7.3f ms, radix %7.3f ms on 1 thread, %7.3f ms on %u\n", count,
+               DROP_TicksToMilliseconds(qsortTicks) / RADIX_BENCH_REPEATS,
+               DROP_TicksToMilliseconds(radixTicks[0]) / RADIX_BENCH_REPEATS,
+               DROP_TicksToMilliseconds(radixTicks[1]) / RADIX_BENCH_REPEATS, threadCounts[1]);
+    }
+
+    DROP_DestroyRadixSort(&sort);
+    FREE(pReference);
+
+    return isSorted;
+}
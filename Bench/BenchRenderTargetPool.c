@@ -0,0 +1,145 @@
+#ifdef _WIN32
+#include "Bench.h"
+#include "Graphics/RenderTargetPool.h"
+
+#define POOL_TEST_SIZE 64
+#define POOL_DRAG_FROM 1280 // Window widths of the drag, the height stays.
+#define POOL_DRAG_TO 1000
+#define POOL_DRAG_HEIGHT 720
+#define POOL_DRAG_STEP 8 // Pixels per frame.
+
+#pragma region INTERNAL
+static GfxRenderTargetDesc MakeDesc(u32 width, u32 height, DXGI_FORMAT format)
+{
+    GfxRenderTargetDesc desc = {
+        .width     = width,
+        .height    = height,
+        .format    = format,
+        .bindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE};
+    return desc;
+}
+
+// What EntryPoint.c does with the hdr target on a resize, then the end of the frame.
+static bool ResizeFrame(GfxRenderTargetPool pool, GfxRenderTarget* pTarget, u32 width, u32 height)
+{
+    GfxRenderTargetDesc desc = MakeDesc(
+        DROP_RenderTargetSizeClass(width), DROP_RenderTargetSizeClass(height), DXGI_FORMAT_R16G16B16A16_FLOAT);
+    if (!pTarget->pTexture || pTarget->width != desc.width || pTarget->height != desc.height)
+    {
+        DROP_ReleaseRenderTarget(pool, pTarget);
+        if (!DROP_AcquireRenderTarget(pool, &desc, pTarget))
+            return false;
+    }
+
+    DROP_RenderTargetPoolEndFrame(pool);
+    return true;
+}
+#pragma endregion
+
+// Reuse by exact description, eviction of idle and least recently used targets, and a window drag
+// that only creates a target per size class it crosses.
+bool TestRenderTargetPool(const char* argument)
+{
+    UNUSED(argument);
+
+    _GfxHandle          device;
+    GfxRenderTargetPool pool   = NULL;
+    GfxHandle           handle = &device;
+    CHECK(BenchCreateWarpDevice(&device), "Failed to create the WARP device.");
+    CHECK(DROP_CreateRenderTargetPool(handle, &pool), "Failed to create the pool.");
+
+    // A released target comes back for the same description only.
+    GfxRenderTargetDesc hdrDesc = MakeDesc(POOL_TEST_SIZE, POOL_TEST_SIZE, DXGI_FORMAT_R16G16B16A16_FLOAT);
+    GfxRenderTargetDesc ldrDesc = MakeDesc(POOL_TEST_SIZE, POOL_TEST_SIZE, DXGI_FORMAT_R8G8B8A8_UNORM);
+    GfxRenderTarget     first   = {0};
+    GfxRenderTarget     second  = {0};
+    GfxRenderTarget     other   = {0};
+    CHECK(DROP_AcquireRenderTarget(pool, &hdrDesc, &first), "Failed to acquire a target.");
+    ID3D11Texture2D* pFirstTexture = first.pTexture;
+    DROP_ReleaseRenderTarget(pool, &first);
+    CHECK(!first.pTexture, "Release left the target set.");
+    CHECK(DROP_AcquireRenderTarget(pool, &hdrDesc, &first) && first.pTexture == pFirstTexture,
+          "The released target wasn't reused.");
+    CHECK(pool->createCount == 1 && pool->reuseCount == 1, "%llu created, %llu reused.", pool->createCount,
+          pool->reuseCount);
+
+    // Targets in use are never handed out twice, other formats never share.
+    CHECK(DROP_AcquireRenderTarget(pool, &hdrDesc, &second) && second.pTexture != first.pTexture,
+          "A target in use was handed out again.");
+    CHECK(DROP_AcquireRenderTarget(pool, &ldrDesc, &other) && other.pTexture != first.pTexture &&
+              other.pTexture != second.pTexture,
+          "A target of another format was reused.");
+    CHECK(pool->createCount == 3 && pool->entryCount == 3, "%llu created, %u entries.", pool->createCount,
+          pool->entryCount);
+
+    // Free targets idle for too long go, the ones in use stay however old they are.
+    DROP_ReleaseRenderTarget(pool, &second);
+    DROP_ReleaseRenderTarget(pool, &other);
+    for (u32 i = 0; i <= GFX_RENDER_TARGET_MAX_IDLE_FRAMES; ++i)
+    {
+        CHECK(pool->entryCount == 3, "A target idle for %u frames was destroyed.", i);
+        DROP_RenderTargetPoolEndFrame(pool);
+    }
+    DROP_RenderTargetPoolEndFrame(pool);
+    CHECK(pool->entryCount == 1 && pool->entries[0].target.pTexture == first.pTexture,
+          "%u entries left after the idle frames.", pool->entryCount);
+    DROP_ReleaseRenderTarget(pool, &first);
+
+    // A full pool makes room by destroying the free target used the longest time ago. The free target
+    // left by the idle frames is the first one to go while filling it.
+    GfxRenderTarget targets[GFX_RENDER_TARGET_POOL_SIZE] = {0};
+    for (u32 i = 0; i < GFX_RENDER_TARGET_POOL_SIZE; ++i)
+    {
+        GfxRenderTargetDesc desc = MakeDesc(POOL_TEST_SIZE * (i + 1), POOL_TEST_SIZE, DXGI_FORMAT_R8G8B8A8_UNORM);
+        CHECK(DROP_AcquireRenderTarget(pool, &desc, &targets[i]), "Failed to fill the pool at %u.", i);
+        DROP_RenderTargetPoolEndFrame(pool);
+    }
+    CHECK(pool->entryCount == GFX_RENDER_TARGET_POOL_SIZE, "%u entries in the full pool.", pool->entryCount);
+    CHECK(!DROP_AcquireRenderTarget(pool, &hdrDesc, &first), "A pool with every target in use handed one out.");
+
+    ID3D11Texture2D* pOldest = targets[0].pTexture;
+    ID3D11Texture2D* pNewest = targets[GFX_RENDER_TARGET_POOL_SIZE - 1].pTexture;
+    DROP_ReleaseRenderTarget(pool, &targets[0]);
+    DROP_RenderTargetPoolEndFrame(pool);
+    DROP_ReleaseRenderTarget(pool, &targets[GFX_RENDER_TARGET_POOL_SIZE - 1]);
+    CHECK(DROP_AcquireRenderTarget(pool, &hdrDesc, &first), "The full pool didn't make room.");
+    bool isOldestLeft = false;
+    bool isNewestLeft = false;
+    for (u32 i = 0; i < pool->entryCount; ++i)
+    {
+        isOldestLeft |= pool->entries[i].target.pTexture == pOldest;
+        isNewestLeft |= pool->entries[i].target.pTexture == pNewest;
+    }
+    CHECK(!isOldestLeft && isNewestLeft, "The pool evicted another target than the least recently used.");
+
+    DROP_ReleaseRenderTarget(pool, &first);
+    for (u32 i = 1; i < GFX_RENDER_TARGET_POOL_SIZE - 1; ++i)
+        DROP_ReleaseRenderTarget(pool, &targets[i]);
+    DROP_DestroyRenderTargetPool(&pool);
+
+    // A drag there and back creates a target per size class once, the way back reuses them all.
+    CHECK(DROP_CreateRenderTargetPool(handle, &pool), "Failed to create the pool.");
+    GfxRenderTarget hdr        = {0};
+    u32             frameCount = 0;
+    u32             classCount = 0;
+    u32             lastClass  = 0;
+    for (u32 width = POOL_DRAG_FROM; width >= POOL_DRAG_TO; width -= POOL_DRAG_STEP, ++frameCount)
+    {
+        CHECK(ResizeFrame(pool, &hdr, width, POOL_DRAG_HEIGHT), "Failed to resize to %u.", width);
+        classCount += DROP_RenderTargetSizeClass(width) != lastClass;
+        lastClass   = DROP_RenderTargetSizeClass(width);
+    }
+    CHECK(pool->createCount == classCount, "%llu targets for %u size classes.", pool->createCount, classCount);
+    for (u32 width = POOL_DRAG_TO; width <= POOL_DRAG_FROM; width += POOL_DRAG_STEP, ++frameCount)
+        CHECK(ResizeFrame(pool, &hdr, width, POOL_DRAG_HEIGHT), "Failed to resize to %u.", width);
+    CHECK(pool->createCount == classCount, "The way back created %llu targets.", pool->createCount - classCount);
+    printf("  A drag over %u frames created %llu targets.\n", frameCount, pool->createCount);
+
+    DROP_ReleaseRenderTarget(pool, &hdr);
+    DROP_DestroyRenderTargetPool(&pool);
+    RELEASE(device.pContext);
+    RELEASE(device.pDevice);
+
+    return true;
+}
+#endif // _WIN32
@@ -0,0 +1,220 @@
+#include "Bench.h"
+#include "Replay.h"
+
+#define REPLAY_TEST_FILE "bench_capture.dxcp"
+#define REPLAY_TEST_FRAMES 2
+#define REPLAY_TEST_MAX_OBJECTS 8
+#define REPLAY_TEST_MAX_DATA 256
+#define REPLAY_TEST_MAX_WORDS 512
+#define REPLAY_TEST_BUFFER_SIZE 256
+#define REPLAY_TEST_UPLOAD_SIZE 42 // Not a whole number of words, the payload is padded.
+
+// What is wrong with the capture, each one has to be refused on load.
+typedef enum _ReplayTestFault
+{
+    REPLAY_TEST_FAULT_NONE,
+    REPLAY_TEST_FAULT_VERSION,
+    REPLAY_TEST_FAULT_DATA_PAST_END,
+    REPLAY_TEST_FAULT_BUFFER_DATA_SIZE,
+    REPLAY_TEST_FAULT_UPDATE_PAST_END,
+    REPLAY_TEST_FAULT_SHADER_KIND,
+    REPLAY_TEST_FAULT_COUNT
+} ReplayTestFault;
+
+// Ids of the objects of the test capture.
+enum
+{
+    REPLAY_TEST_VERTEX_BUFFER = 1,
+    REPLAY_TEST_CONSTANT_BUFFER,
+    REPLAY_TEST_TEXTURE,
+    REPLAY_TEST_RTV,
+    REPLAY_TEST_SRV,
+    REPLAY_TEST_VERTEX_SHADER,
+    REPLAY_TEST_PIXEL_SHADER,
+    REPLAY_TEST_QUERY
+};
+
+typedef struct _TestCapture
+{
+    CaptureHeader header;
+    CaptureObject objects[REPLAY_TEST_MAX_OBJECTS];
+    u8            data[REPLAY_TEST_MAX_DATA];
+    u32           commands[REPLAY_TEST_MAX_WORDS];
+    u32           commandWords;
+} TestCapture;
+
+#pragma region INTERNAL
+static void AddTestObject(
+    TestCapture* pCapture, CaptureObjectKind kind, u32 parent, u32 param0, u32 param1, const void* pData, u32 dataSize)
+{
+    CaptureObject* pObject = &pCapture->objects[pCapture->header.objectCount++];
+    pObject->kind          = kind;
+    pObject->parent        = parent;
+    pObject->params[0]     = param0;
+    pObject->params[1]     = param1;
+
+    if (dataSize)
+    {
+        pObject->dataOffset = (u32) pCapture->header.dataBytes;
+        pObject->dataSize   = dataSize;
+        memcpy(&pCapture->data[pCapture->header.dataBytes], pData, dataSize);
+        pCapture->header.dataBytes += (dataSize + 3) & ~3u;
+    }
+}
+
+static void PushTestCommand(TestCapture* pCapture, CaptureCommandType type, const u32* pPayload, u32 wordCount)
+{
+    CaptureCommand command = {.type = (u16) type, .size = (u32) (sizeof(CaptureCommand) + wordCount * sizeof(u32))};
+    memcpy(&pCapture->commands[pCapture->commandWords], &command, sizeof(command));
+    pCapture->commandWords += sizeof(command) / sizeof(u32);
+
+    memcpy(&pCapture->commands[pCapture->commandWords], pPayload, wordCount * sizeof(u32));
+    pCapture->commandWords += wordCount;
+}
+
+// Two frames binding the same state, so every bind of the second one is redundant. Each frame
+// uploads to the dynamic buffer at another offset and draws twice.
+static void BuildTestCapture(TestCapture* pCapture, ReplayTestFault fault)
+{
+    ZERO_MEM(pCapture, 1);
+    pCapture->header.magic      = CAPTURE_MAGIC;
+    pCapture->header.version    = fault == REPLAY_TEST_FAULT_VERSION ? CAPTURE_VERSION - 1 : CAPTURE_VERSION;
+    pCapture->header.frameCount = REPLAY_TEST_FRAMES;
+
+    u8 constants[16];
+    u8 texels[4 * 4 * 4];
+    u8 bytecode[12];
+    for (u32 i = 0; i < sizeof(texels); ++i)
+        texels[i] = (u8) i;
+    memset(constants, 0x3F, sizeof(constants));
+    memset(bytecode, 0xBC, sizeof(bytecode));
+
+    u32 constantsSize = fault == REPLAY_TEST_FAULT_BUFFER_DATA_SIZE ? sizeof(constants) - 4 : sizeof(constants);
+    AddTestObject(pCapture, CAPTURE_OBJECT_BUFFER, 0, REPLAY_TEST_BUFFER_SIZE, 2, NULL, 0);
+    AddTestObject(pCapture, CAPTURE_OBJECT_BUFFER, 0, sizeof(constants), 0, constants, constantsSize);
+    AddTestObject(pCapture, CAPTURE_OBJECT_TEXTURE2D, 0, 4, 4, texels, sizeof(texels));
+    AddTestObject(pCapture, CAPTURE_OBJECT_RTV, REPLAY_TEST_TEXTURE, 0, 0, NULL, 0);
+    AddTestObject(pCapture, CAPTURE_OBJECT_SRV, REPLAY_TEST_TEXTURE, 0, 0, NULL, 0);
+    AddTestObject(pCapture, CAPTURE_OBJECT_VERTEX_SHADER, 0, 0, 0, bytecode, sizeof(bytecode));
+    AddTestObject(pCapture, CAPTURE_OBJECT_PIXEL_SHADER, 0, 0, 0, NULL, 0);
+    AddTestObject(pCapture, CAPTURE_OBJECT_QUERY, 0, 0, 0, NULL, 0);
+    if (fault == REPLAY_TEST_FAULT_DATA_PAST_END)
+        pCapture->objects[REPLAY_TEST_VERTEX_SHADER - 1].dataOffset = (u32) pCapture->header.dataBytes;
+
+    for (u32 frame = 0; frame < REPLAY_TEST_FRAMES; ++frame)
+    {
+        u32 pixelShader = fault == REPLAY_TEST_FAULT_SHADER_KIND ? REPLAY_TEST_VERTEX_SHADER : REPLAY_TEST_PIXEL_SHADER;
+        u32 renderTargets[]   = {1, 0, REPLAY_TEST_RTV};
+        u32 vertexShader[]    = {CAPTURE_STAGE_VS, REPLAY_TEST_VERTEX_SHADER};
+        u32 pixelShaders[]    = {CAPTURE_STAGE_PS, pixelShader};
+        u32 constantBuffers[] = {CAPTURE_STAGE_PS, 0, 1, REPLAY_TEST_CONSTANT_BUFFER};
+        u32 shaderResources[] = {CAPTURE_STAGE_PS, 0, 1, REPLAY_TEST_SRV};
+        u32 vertexBuffers[]   = {0, 1, REPLAY_TEST_VERTEX_BUFFER, 12, 0};
+        u32 draw[]            = {3, 0};
+        u32 drawInstanced[]   = {3, 4, 0, 0};
+        u32 query[]           = {REPLAY_TEST_QUERY};
+
+        // The second upload goes right to the end of the buffer, or one byte past it.
+        u32 update[5 + (REPLAY_TEST_UPLOAD_SIZE + 3) / 4] = {
+            REPLAY_TEST_VERTEX_BUFFER, 0, 4, frame * (REPLAY_TEST_BUFFER_SIZE - REPLAY_TEST_UPLOAD_SIZE),
+            REPLAY_TEST_UPLOAD_SIZE};
+        if (fault == REPLAY_TEST_FAULT_UPDATE_PAST_END && frame == 1)
+            update[3] += 1;
+        memset(&update[5], (int) frame + 1, REPLAY_TEST_UPLOAD_SIZE);
+
+        PushTestCommand(pCapture, CAPTURE_CMD_SET_RENDER_TARGETS, renderTargets, ARRAY_COUNT(renderTargets));
+        PushTestCommand(pCapture, CAPTURE_CMD_SET_SHADER, vertexShader, ARRAY_COUNT(vertexShader));
+        PushTestCommand(pCapture, CAPTURE_CMD_SET_SHADER, pixelShaders, ARRAY_COUNT(pixelShaders));
+        PushTestCommand(pCapture, CAPTURE_CMD_SET_CONSTANT_BUFFERS, constantBuffers, ARRAY_COUNT(constantBuffers));
+        PushTestCommand(pCapture, CAPTURE_CMD_SET_SHADER_RESOURCES, shaderResources, ARRAY_COUNT(shaderResources));
+        PushTestCommand(pCapture, CAPTURE_CMD_UPDATE_RESOURCE, update, ARRAY_COUNT(update));
+        PushTestCommand(pCapture, CAPTURE_CMD_SET_VERTEX_BUFFERS, vertexBuffers, ARRAY_COUNT(vertexBuffers));
+        PushTestCommand(pCapture, CAPTURE_CMD_BEGIN_QUERY, query, ARRAY_COUNT(query));
+        PushTestCommand(pCapture, CAPTURE_CMD_DRAW, draw, ARRAY_COUNT(draw));
+        PushTestCommand(pCapture, CAPTURE_CMD_DRAW_INSTANCED, drawInstanced, ARRAY_COUNT(drawInstanced));
+        PushTestCommand(pCapture, CAPTURE_CMD_END_QUERY, query, ARRAY_COUNT(query));
+        PushTestCommand(pCapture, CAPTURE_CMD_FRAME_END, NULL, 0);
+    }
+    pCapture->header.commandBytes = pCapture->commandWords * sizeof(u32);
+}
+
+static bool WriteTestCapture(const TestCapture* pCapture)
+{
+    FILE* file = fopen(REPLAY_TEST_FILE, "wb");
+    if (!file)
+        return false;
+
+    u32  objectCount = pCapture->header.objectCount;
+    u64  dataBytes   = pCapture->header.dataBytes;
+    u32  wordCount   = pCapture->commandWords;
+    bool isWritten   = fwrite(&pCapture->header, sizeof(CaptureHeader), 1, file) == 1;
+    isWritten        = isWritten && fwrite(pCapture->objects, sizeof(CaptureObject), objectCount, file) == objectCount;
+    isWritten        = isWritten && fwrite(pCapture->data, 1, dataBytes, file) == dataBytes;
+    isWritten        = isWritten && fwrite(pCapture->commands, sizeof(u32), wordCount, file) == wordCount;
+    fclose(file);
+    return isWritten;
+}
+#pragma endregion
+
+// A capture written by hand loads, keeps the object data and replays through the counter backend
+// with the expected calls and uploads. The same capture with one thing wrong in it doesn't load.
+bool TestReplay(const char* argument)
+{
+    UNUSED(argument);
+
+    static TestCapture testCapture;
+    Capture            capture;
+
+    for (u32 fault = REPLAY_TEST_FAULT_VERSION; fault < REPLAY_TEST_FAULT_COUNT; ++fault)
+    {
+        BuildTestCapture(&testCapture, (ReplayTestFault) fault);
+        CHECK(WriteTestCapture(&testCapture), "Failed to write the capture.");
+        CHECK(!DROP_LoadCapture(REPLAY_TEST_FILE, &capture) && !capture.pData, "A capture with fault %u loaded.",
+              fault);
+    }
+
+    BuildTestCapture(&testCapture, REPLAY_TEST_FAULT_NONE);
+    CHECK(WriteTestCapture(&testCapture), "Failed to write the capture.");
+    CHECK(DROP_LoadCapture(REPLAY_TEST_FILE, &capture), "Failed to load the capture.");
+    remove(REPLAY_TEST_FILE);
+
+    u32         dataSize  = 0;
+    const u8*   pTexels   = (const u8*) DROP_GetObjectData(&capture, REPLAY_TEST_TEXTURE, &dataSize);
+    const void* pBytecode = NULL;
+    CHECK(pTexels && dataSize == 64 && pTexels[0] == 0 && pTexels[63] == 63, "The texture data is wrong.");
+    pBytecode = DROP_GetObjectData(&capture, REPLAY_TEST_VERTEX_SHADER, &dataSize);
+    CHECK(pBytecode && dataSize == 12 && *(const u8*) pBytecode == 0xBC, "The bytecode is wrong.");
+    CHECK(!DROP_GetObjectData(&capture, REPLAY_TEST_PIXEL_SHADER, &dataSize) && dataSize == 0,
+          "A shader without bytecode has data.");
+
+    ReplayBackend backend;
+    CHECK(DROP_CreateCounterBackend(&capture, &backend), "Failed to create the counter backend.");
+    for (u32 frame = 0; frame < REPLAY_TEST_FRAMES; ++frame)
+        DROP_ReplayFrame(&capture, frame, &backend);
+
+    const ReplayCounters* pCounters = DROP_GetCounters(&backend);
+    CHECK(pCounters->frameCount == REPLAY_TEST_FRAMES, "%llu frames replayed.", pCounters->frameCount);
+    CHECK(pCounters->commandCounts[CAPTURE_CMD_SET_SHADER] == 2 * REPLAY_TEST_FRAMES &&
+              pCounters->commandCounts[CAPTURE_CMD_UPDATE_RESOURCE] == REPLAY_TEST_FRAMES &&
+              pCounters->commandCounts[CAPTURE_CMD_BEGIN_QUERY] == REPLAY_TEST_FRAMES &&
+              pCounters->commandCounts[CAPTURE_CMD_FRAME_END] == REPLAY_TEST_FRAMES,
+          "The command counts are wrong.");
+    CHECK(pCounters->drawCount == 2 * REPLAY_TEST_FRAMES && pCounters->vertexCount == (3 + 3 * 4) * REPLAY_TEST_FRAMES,
+          "%llu draws of %llu vertices.", pCounters->drawCount, pCounters->vertexCount);
+    CHECK(pCounters->bindCount == 6 * REPLAY_TEST_FRAMES && pCounters->redundantBindCount == 6,
+          "%llu binds, %llu redundant.", pCounters->bindCount, pCounters->redundantBindCount);
+    CHECK(pCounters->uploadBytes == REPLAY_TEST_UPLOAD_SIZE * REPLAY_TEST_FRAMES, "%llu bytes uploaded.",
+          pCounters->uploadBytes);
+
+    // Replaying again counts from zero after a reset.
+    DROP_ResetCounters(&backend);
+    DROP_ReplayFrame(&capture, 1, &backend);
+    CHECK(pCounters->frameCount == 1 && pCounters->redundantBindCount == 6 &&
+              pCounters->uploadBytes == REPLAY_TEST_UPLOAD_SIZE,
+          "The counters weren't reset.");
+
+    DROP_DestroyCounterBackend(&backend);
+    DROP_DestroyCapture(&capture);
+
+    return true;
+}
@@ -0,0 +1,121 @@
+#include "Bench.h"
+#include "Utils/RingAllocator.h"
+
+#define RING_TEST_SIZE 4096
+#define RING_TEST_FRAMES 20000
+#define RING_TEST_LAG 3 // Frames the fake GPU is behind.
+#define RING_TEST_MAX_ALLOCATIONS 16
+
+typedef struct _RingRange
+{
+    u64 begin;
+    u64 end;
+} RingRange;
+
+// What each frame still in flight was handed, by frame index modulo the pending limit.
+static RingRange s_ranges[RING_MAX_PENDING_FRAMES][RING_TEST_MAX_ALLOCATIONS];
+static u32       s_rangeCounts[RING_MAX_PENDING_FRAMES];
+
+#pragma region INTERNAL
+static bool Overlaps(const RingRange* pRange, u64 begin, u64 end)
+{
+    return begin < pRange->end && pRange->begin < end;
+}
+#pragma endregion
+
+bool TestRingAllocator(const char* argument)
+{
+    UNUSED(argument);
+
+    RingAllocator ring;
+    DROP_MakeRing(&ring, 1024);
+
+    // Alignment, then a ring filled to its last byte.
+    u64 offset = 0;
+    CHECK(DROP_RingAllocate(&ring, 100, 1, &offset) && offset == 0, "First allocation at %llu.", offset);
+    CHECK(DROP_RingAllocate(&ring, 100, 256, &offset) && offset == 256, "Aligned allocation at %llu.", offset);
+    CHECK(DROP_RingAllocate(&ring, 656, 16, &offset) && offset == 368, "Third allocation at %llu.", offset);
+    CHECK(!DROP_RingAllocate(&ring, 100, 16, &offset), "The ring handed out memory that is in flight.");
+    DROP_RingEndFrame(&ring, 1);
+    CHECK(!DROP_RingAllocate(&ring, 16, 16, &offset), "Ending a frame released its memory.");
+
+    // Retiring an older frame releases nothing, retiring frame 1 releases all of it.
+    DROP_RingRetireFrames(&ring, 0);
+    CHECK(!DROP_RingAllocate(&ring, 16, 16, &offset), "Retiring frame 0 released frame 1.");
+    DROP_RingRetireFrames(&ring, 1);
+    CHECK(DROP_RingAllocate(&ring, 100, 16, &offset) && offset == 0, "Wrapped allocation at %llu.", offset);
+    CHECK(!DROP_RingAllocate(&ring, 1025, 1, &offset), "The ring handed out more than its size.");
+
+    // Past RING_MAX_PENDING_FRAMES in flight, the newest pending frame is held until the later ones
+    // complete instead of a slot being overwritten.
+    DROP_MakeRing(&ring, 1024);
+    for (u64 frame = 1; frame <= RING_MAX_PENDING_FRAMES + 2; ++frame)
+    {
+        CHECK(DROP_RingAllocate(&ring, 64, 1, &offset), "Frame %llu failed to allocate.", frame);
+        CHECK(DROP_RingEndFrame(&ring, frame) == (frame <= RING_MAX_PENDING_FRAMES),
+              "Frame %llu was tracked wrongly.", frame);
+    }
+    DROP_RingRetireFrames(&ring, RING_MAX_PENDING_FRAMES + 1);
+    CHECK(ring.pendingCount == 1 && ring.head - ring.tail == 3 * 64,
+          "%llu bytes left in flight, the last three frames hold 192.", ring.head - ring.tail);
+    DROP_RingRetireFrames(&ring, RING_MAX_PENDING_FRAMES + 2);
+    CHECK(ring.pendingCount == 0 && ring.head == ring.tail, "The held frames were never released.");
+
+    // Frames of random allocations while the fake GPU completes them a few frames late. Nothing handed
+    // out may overlap what a frame in flight was given, and every allocation must fit once the GPU
+    // has caught up.
+    DROP_MakeRing(&ring, RING_TEST_SIZE);
+    ZERO_MEM(s_rangeCounts, RING_MAX_PENDING_FRAMES);
+
+    u32 random      = 0xC0FFEE;
+    u64 failedCount = 0;
+    for (u64 frame = 1; frame <= RING_TEST_FRAMES; ++frame)
+    {
+        if (frame > RING_TEST_LAG)
+        {
+            u64 completed = frame - RING_TEST_LAG;
+            DROP_RingRetireFrames(&ring, completed);
+            s_rangeCounts[completed % RING_MAX_PENDING_FRAMES] = 0;
+        }
+
+        u32        slot         = frame % RING_MAX_PENDING_FRAMES;
+        RingRange* pFrameRanges = s_ranges[slot];
+        u32        count        = 1 + BenchRandom(&random) % RING_TEST_MAX_ALLOCATIONS;
+        for (u32 i = 0; i < count; ++i)
+        {
+            u64 size      = 1 + BenchRandom(&random) % (RING_TEST_SIZE / 32);
+            u64 alignment = (u64) 1 << (BenchRandom(&random) % 9);
+            if (!DROP_RingAllocate(&ring, size, alignment, &offset))
+            {
+                ++failedCount;
+                continue;
+            }
+
+            CHECK((offset & (alignment - 1)) == 0 && offset + size <= RING_TEST_SIZE,
+                  "Frame %llu got %llu bytes at %llu aligned to %llu.", frame, size, offset, alignment);
+            for (u32 f = 0; f < RING_MAX_PENDING_FRAMES; ++f)
+            {
+                for (u32 j = 0; j < s_rangeCounts[f]; ++j)
+                    CHECK(!Overlaps(&s_ranges[f][j], offset, offset + size),
+                          "Frame %llu got memory that a frame in flight uses.", frame);
+            }
+
+            pFrameRanges[s_rangeCounts[slot]].begin = offset;
+            pFrameRanges[s_rangeCounts[slot]].end   = offset + size;
+            ++s_rangeCounts[slot];
+        }
+        DROP_RingEndFrame(&ring, frame);
+    }
+    printf("  %llu of the allocations waited on the GPU.\n", failedCount);
+
+    DROP_RingRetireFrames(&ring, RING_TEST_FRAMES);
+    CHECK(ring.pendingCount == 0 && ring.head == ring.tail, "Memory is left in flight after the last frame.");
+
+    // Once idle every byte is free again, up to the end and then from the start.
+    u64 rest = RING_TEST_SIZE - ring.head % RING_TEST_SIZE;
+    CHECK(DROP_RingAllocate(&ring, rest, 1, &offset) && DROP_RingAllocate(&ring, RING_TEST_SIZE - rest, 1, &offset) &&
+              offset == 0,
+          "The whole ring isn't free once idle.");
+
+    return true;
+}
@@ -0,0 +1,259 @@
+#include "Bench.h"
+#include "Scene/Scene.h"
+#include "Utils/JobSystem.h"
+
+#include <math.h>
+
+#define SCENE_TEST_NODES 20000
+#define SCENE_BENCH_REPEATS 10
+#define SCENE_BENCH_BRANCHING 8
+#define SCENE_BENCH_DIRTY_PERCENT 1
+
+static const u32 s_benchCounts[] = {1000, 10000, 100000, 1000000};
+
+typedef struct _NodeLocal
+{
+    f32 position[3];
+    f32 rotation[4];
+    f32 scale[3];
+} NodeLocal;
+
+#pragma region INTERNAL
+static void RandomLocal(u32* pRandom, NodeLocal* pLocal)
+{
+    for (u32 i = 0; i < 3; ++i)
+    {
+        pLocal->position[i] = BenchRandomFloat(pRandom) * 4.0f - 2.0f;
+        pLocal->scale[i]    = 0.5f + BenchRandomFloat(pRandom);
+    }
+
+    f32 length = 0.0f;
+    for (u32 i = 0; i < 4; ++i)
+    {
+        pLocal->rotation[i] = BenchRandomFloat(pRandom) * 2.0f - 1.0f;
+        length += pLocal->rotation[i] * pLocal->rotation[i];
+    }
+    length = sqrtf(length);
+    for (u32 i = 0; i < 4; ++i)
+        pLocal->rotation[i] /= length;
+}
+
+// Scalar, row vector convention: rows 0 to 2 are the scaled rotated axes, row 3 the position.
+static void LocalMatrix(const NodeLocal* pLocal, f32 m[4][4])
+{
+    f32 x = pLocal->rotation[0], y = pLocal->rotation[1], z = pLocal->rotation[2], w = pLocal->rotation[3];
+
+    f32 axes[3][3] = {
+        {1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y)},
+        {2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x)},
+        {2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y)}};
+
+    for (u32 row = 0; row < 3; ++row)
+    {
+        for (u32 column = 0; column < 3; ++column)
+            m[row][column] = axes[row][column] * pLocal->scale[row];
+        m[row][3] = 0.0f;
+    }
+    m[3][0] = pLocal->position[0];
+    m[3][1] = pLocal->position[1];
+    m[3][2] = pLocal->position[2];
+    m[3][3] = 1.0f;
+}
+
+// Parents are added before their children, so one pass in node order computes every world matrix.
+static void ReferenceWorlds(const u32* pParents, const NodeLocal* pLocals, u32 count, f32 (*pWorlds)[4][4])
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        f32 local[4][4];
+        LocalMatrix(&pLocals[i], local);
+        if (pParents[i] == SCENE_NO_PARENT)
+        {
+            memcpy(pWorlds[i], local, sizeof(local));
+            continue;
+        }
+
+        const f32(*parent)[4] = pWorlds[pParents[i]];
+        for (u32 row = 0; row < 4; ++row)
+        {
+            for (u32 column = 0; column < 4; ++column)
+            {
+                pWorlds[i][row][column] = local[row][0] * parent[0][column] + local[row][1] * parent[1][column] +
+                                          local[row][2] * parent[2][column] + local[row][3] * parent[3][column];
+            }
+        }
+    }
+}
+
+static bool MatchesReference(const Scene* pScene, f32 (*pWorlds)[4][4], u32 count)
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        f32 world[4][4];
+        memcpy(world, DROP_SceneGetWorld(pScene, i), sizeof(world));
+        for (u32 row = 0; row < 4; ++row)
+        {
+            for (u32 column = 0; column < 4; ++column)
+            {
+                f32 expected = pWorlds[i][row][column];
+                if (fabsf(world[row][column] - expected) > 1e-3f * fmaxf(1.0f, fabsf(expected)))
+                {
+                    printf("  Node %u has %f at [%u][%u], the reference %f.\n", i, world[row][column], row, column,
+                           expected);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// A tree of the given branching with one root, like a level with nested props.
+static bool BuildTree(Scene* pScene, u32 count, NodeLocal* pLocal)
+{
+    if (!DROP_CreateScene(count, pScene))
+        return false;
+
+    u32 random = 5;
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 node = DROP_SceneAddNode(pScene, i == 0 ? SCENE_NO_PARENT : (i - 1) / SCENE_BENCH_BRANCHING);
+        RandomLocal(&random, pLocal);
+        DROP_SceneSetLocal(pScene, node, pLocal->position, pLocal->rotation, pLocal->scale);
+    }
+    return true;
+}
+#pragma endregion
+
+// Random forests against a scalar reference, nodes added out of depth order so the scene sorts,
+// then updates where only a few subtrees are dirty.
+bool TestScene(const char* argument)
+{
+    UNUSED(argument);
+
+    u32*       pParents = (u32*) ALLOC(u32, SCENE_TEST_NODES);
+    NodeLocal* pLocals  = (NodeLocal*) ALLOC(NodeLocal, SCENE_TEST_NODES);
+    f32(*pWorlds)[4][4] = (f32(*)[4][4]) ALLOC(f32, SCENE_TEST_NODES * 16);
+    Scene scene;
+    CHECK(pParents && pLocals && pWorlds && DROP_CreateScene(SCENE_TEST_NODES, &scene), "Failed to allocate the scene.");
+    CHECK(DROP_CreateJobSystem(3), "Failed to create the job system.");
+
+    // Half of the nodes hang under one of the last 16 so chains get deep and the depths go up and down,
+    // a node that would go past the depth limit becomes a root.
+    u32 random = 17;
+    u8  depths[SCENE_TEST_NODES];
+    for (u32 i = 0; i < SCENE_TEST_NODES; ++i)
+    {
+        u32 parent = SCENE_NO_PARENT;
+        if (i > 0 && BenchRandom(&random) % 64)
+        {
+            u32 range = BenchRandom(&random) % 2 ? 16 : i;
+            parent    = i - 1 - BenchRandom(&random) % (range < i ? range : i);
+            if (depths[parent] + 1 >= SCENE_MAX_DEPTH)
+                parent = SCENE_NO_PARENT;
+        }
+        depths[i]   = parent == SCENE_NO_PARENT ? 0 : depths[parent] + 1;
+        pParents[i] = parent;
+
+        u32 node = DROP_SceneAddNode(&scene, parent);
+        CHECK(node == i, "Node %u got id %u.", i, node);
+        RandomLocal(&random, &pLocals[i]);
+        DROP_SceneSetLocal(&scene, node, pLocals[i].position, pLocals[i].rotation, pLocals[i].scale);
+    }
+
+    DROP_UpdateScene(&scene);
+    ReferenceWorlds(pParents, pLocals, SCENE_TEST_NODES, pWorlds);
+    CHECK(!scene.needsSort && !scene.hasDirty, "The update left work behind.");
+    CHECK(MatchesReference(&scene, pWorlds, SCENE_TEST_NODES), "The world matrices differ after the full update.");
+    for (u32 i = 1; i < scene.count; ++i)
+        CHECK(scene.pDepths[i - 1] <= scene.pDepths[i], "Index %u is out of depth order.", i);
+
+    for (u32 round = 0; round < 4; ++round)
+    {
+        for (u32 i = 0; i < SCENE_TEST_NODES / 100; ++i)
+        {
+            u32 node = BenchRandom(&random) % SCENE_TEST_NODES;
+            RandomLocal(&random, &pLocals[node]);
+            DROP_SceneSetLocal(&scene, node, pLocals[node].position, pLocals[node].rotation, pLocals[node].scale);
+        }
+
+        DROP_UpdateScene(&scene);
+        ReferenceWorlds(pParents, pLocals, SCENE_TEST_NODES, pWorlds);
+        CHECK(MatchesReference(&scene, pWorlds, SCENE_TEST_NODES), "The world matrices differ after round %u.", round);
+    }
+
+    // Nothing dirty, nothing written.
+    Mat4 before = *DROP_SceneGetWorld(&scene, 0);
+    scene.pWorld[scene.pIndexOfNode[0]].rows[3] = _mm_set1_ps(42.0f);
+    DROP_UpdateScene(&scene);
+    CHECK(_mm_movemask_ps(_mm_cmpeq_ps(DROP_SceneGetWorld(&scene, 0)->rows[3], _mm_set1_ps(42.0f))) == 0xF,
+          "A clean scene was updated.");
+    scene.pWorld[scene.pIndexOfNode[0]] = before;
+
+    DROP_DestroyJobSystem();
+    DROP_DestroyScene(&scene);
+    FREE(pWorlds);
+    FREE(pLocals);
+    FREE(pParents);
+
+    return true;
+}
+
+// Full updates from a dirty root and updates with a few nodes dirty, on one thread and on the job system.
+bool BenchScene(const char* argument)
+{
+    UNUSED(argument);
+
+    for (u32 i = 0; i < ARRAY_COUNT(s_benchCounts); ++i)
+    {
+        u32       count = s_benchCounts[i];
+        NodeLocal local;
+        Scene     scene;
+        if (!BuildTree(&scene, count, &local))
+            return false;
+        DROP_UpdateScene(&scene);
+
+        f64 fullMs[2]    = {0.0};
+        f64 partialMs[2] = {0.0};
+        u32 threadCounts[2];
+        for (u32 threaded = 0; threaded < 2; ++threaded)
+        {
+            if (threaded && !DROP_CreateJobSystem(0))
+                break;
+            threadCounts[threaded] = DROP_GetJobThreadCount();
+
+            u32 random = 11;
+            for (u32 r = 0; r < SCENE_BENCH_REPEATS; ++r)
+            {
+                DROP_SceneSetLocal(&scene, 0, local.position, local.rotation, local.scale);
+                u64 startTicks = DROP_GetTicks();
+                DROP_UpdateScene(&scene);
+                fullMs[threaded] += DROP_TicksToMilliseconds(DROP_GetTicks() - startTicks);
+
+                for (u32 k = 0; k < count * SCENE_BENCH_DIRTY_PERCENT / 100; ++k)
+                {
+                    // Leaves and small subtrees, like props moving around a static level.
+                    u32 node = count / 2 + BenchRandom(&random) % (count - count / 2);
+                    DROP_SceneSetLocal(&scene, node, local.position, local.rotation, local.scale);
+                }
+                startTicks = DROP_GetTicks();
+                DROP_UpdateScene(&scene);
+                partialMs[threaded] += DROP_TicksToMilliseconds(DROP_GetTicks() - startTicks);
+            }
+
+            if (threaded)
+                DROP_DestroyJobSystem();
+        }
+
+        printf("  %7u nodes: full %8.3f ms, %d%% dirty %7.3f ms on 1 thread, full %8.3f ms, %d%% dirty %7.3f ms on %u\n",
+               count, fullMs[0] / SCENE_BENCH_REPEATS, SCENE_BENCH_DIRTY_PERCENT, partialMs[0] / SCENE_BENCH_REPEATS,
+               fullMs[1] / SCENE_BENCH_REPEATS, SCENE_BENCH_DIRTY_PERCENT, partialMs[1] / SCENE_BENCH_REPEATS,
+               threadCounts[1]);
+        printf("  %7s        %.1f ns per node for a full update on 1 thread.\n", "",
+               fullMs[0] * 1e6 / SCENE_BENCH_REPEATS / count);
+
+        DROP_DestroyScene(&scene);
+    }
+
+    return true;
+}
@@ -0,0 +1,141 @@
+#include "Bench.h"
+#include "Resources/ShaderReflection.h"
+#include "Math/GaussianKernel.h"
+#include "Utils/FileIO.h"
+
+#define SHADER_TEST_DIRECTORY "assets/shaders/" // The default when no argument is given, run from the repo root.
+#define SHADER_TEST_PATH_LENGTH 256
+#define SHADER_TEST_MAX_BINDINGS 4
+// Sizes of the C structs in EntryPoint.c the cbuffers mirror.
+#define INTENSITY_PARAMS_SIZE 16
+#define VIEW_PARAMS_SIZE 16
+#define BLOOM_PARAMS_SIZE (GAUSSIAN_MAX_TAPS * 16 + 16)
+
+typedef struct _ShippedShader
+{
+    const char* fileName;
+    const char* vertexFileName; // The one it's drawn with, NULL for a vertex shader.
+    const char* bindings[SHADER_TEST_MAX_BINDINGS];
+    const char* cbufferName;
+    u32         cbufferSize;
+} ShippedShader;
+
+// Every .cso the application loads, with what the code binds for it.
+static const ShippedShader s_shaders[] = {
+    {"basic_vs", NULL, {NULL}, NULL, 0},
+    {"basic_ps", "basic_vs", {"IntensityParams"}, "IntensityParams", INTENSITY_PARAMS_SIZE},
+    {"batch_vs", NULL, {NULL}, NULL, 0},
+    {"batch_ps", "batch_vs", {NULL}, NULL, 0},
+    {"copy_vs", NULL, {"ViewParams"}, "ViewParams", VIEW_PARAMS_SIZE},
+    {"copy_ps", "copy_vs", {"linearSampler", "hdrTexture", "bloomTexture", "ViewParams"}, "ViewParams",
+     VIEW_PARAMS_SIZE},
+    {"brightpass_ps", "copy_vs", {"linearSampler", "hdrTexture"}, NULL, 0},
+    {"downsample_ps", "copy_vs", {"linearSampler", "sourceTexture"}, NULL, 0},
+    {"upsample_ps", "copy_vs", {"linearSampler", "levelTexture", "lowerTexture"}, NULL, 0},
+    {"bloom_ps", "copy_vs", {"linearSampler", "hdrTexture", "BloomParams"}, "BloomParams", BLOOM_PARAMS_SIZE},
+    {"bloom_ps_BLOOM_VERTICAL", "copy_vs", {"linearSampler", "hdrTexture", "BloomParams"}, "BloomParams",
+     BLOOM_PARAMS_SIZE}};
+
+#pragma region INTERNAL
+static bool ReflectFile(
+    const char* directory, const char* fileName, ArenaAllocator* pArena, ShaderReflection* pReflection)
+{
+    char path[SHADER_TEST_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s%s.cso", directory, fileName);
+
+    u64   size      = 0;
+    char* pByteCode = DROP_ReadFile(path, &size, pArena);
+    if (!pByteCode)
+    {
+        printf("  Failed to read %s.\n", path);
+        return false;
+    }
+    return DROP_ReflectShader(pByteCode, size, pReflection);
+}
+
+// The rasterizer feeds the pixel shader what the vertex shader wrote, same semantic in the same
+// register with every component it reads.
+static bool LinksTo(const ShaderReflection* pVertex, const ShaderReflection* pPixel)
+{
+    for (u32 i = 0; i < pPixel->inputCount; ++i)
+    {
+        const ShaderSignatureElement* pInput    = &pPixel->inputs[i];
+        bool                          isWritten = false;
+        for (u32 j = 0; j < pVertex->outputCount && !isWritten; ++j)
+        {
+            const ShaderSignatureElement* pOutput = &pVertex->outputs[j];
+            isWritten = !strcmp(pOutput->semanticName, pInput->semanticName) &&
+                        pOutput->semanticIndex == pInput->semanticIndex && pOutput->reg == pInput->reg &&
+                        (pOutput->mask & pInput->mask) == pInput->mask;
+        }
+        if (!isWritten)
+        {
+            printf("  The vertex shader doesn't write %s%u.\n", pInput->semanticName, pInput->semanticIndex);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool HasBindings(const ShaderReflection* pReflection, const char* const* pNames)
+{
+    u32 count = 0;
+    while (count < SHADER_TEST_MAX_BINDINGS && pNames[count])
+        ++count;
+
+    if (pReflection->bindingCount != count)
+    {
+        printf("  %u bindings, the code binds %u.\n", pReflection->bindingCount, count);
+        return false;
+    }
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (strcmp(pReflection->bindings[i].name, pNames[i]))
+        {
+            printf("  Binding %u is %s, expected %s.\n", i, pReflection->bindings[i].name, pNames[i]);
+            return false;
+        }
+    }
+    return true;
+}
+#pragma endregion
+
+// Every compiled shader reflects, has the bindings and cbuffer size the code expects and links to the
+// vertex shader it is drawn with. Stale .cso files left behind by an .hlsl change fail here, without a
+// device. The argument is the shader directory, with its trailing slash.
+bool TestShaderReflection(const char* argument)
+{
+    const char* directory = argument ? argument : SHADER_TEST_DIRECTORY;
+
+    ArenaAllocator arena;
+    CHECK(DROP_MakeArena(&arena, KB(64)), "Failed to make the arena.");
+
+    for (u32 i = 0; i < ARRAY_COUNT(s_shaders); ++i)
+    {
+        const ShippedShader* pShader = &s_shaders[i];
+        ShaderReflection     reflection;
+        CHECK(ReflectFile(directory, pShader->fileName, &arena, &reflection), "Failed to reflect %s.",
+              pShader->fileName);
+        CHECK(!reflection.isDXIL && reflection.hasResources, "%s is not an fxc container.", pShader->fileName);
+        CHECK(HasBindings(&reflection, pShader->bindings), "%s binds other resources.", pShader->fileName);
+        if (pShader->cbufferName)
+        {
+            CHECK(DROP_ValidateConstantBuffer(&reflection, pShader->cbufferName, pShader->cbufferSize),
+                  "%s has a stale %s.", pShader->fileName, pShader->cbufferName);
+        }
+
+        if (pShader->vertexFileName)
+        {
+            ShaderReflection vertexReflection;
+            CHECK(ReflectFile(directory, pShader->vertexFileName, &arena, &vertexReflection), "Failed to reflect %s.",
+                  pShader->vertexFileName);
+            CHECK(LinksTo(&vertexReflection, &reflection), "%s doesn't link to %s.", pShader->fileName,
+                  pShader->vertexFileName);
+        }
+        DROP_ClearArena(&arena);
+    }
+
+    FREE(arena.memory);
+
+    return true;
+}
@@ -0,0 +1,157 @@
+#include "Bench.h"
+#include "Utils/TaskGraph.h"
+#include "Utils/JobSystem.h"
+
+#define TASK_TEST_MAX 8
+
+typedef struct _TestTask
+{
+    Atomic32* pSequence; // Shared by the tasks, orders every start, end and cleanup.
+    i32       startIndex;
+    i32       endIndex;
+    i32       cleanupIndex; // 0 while not cleaned up.
+    bool      isFailing;
+} TestTask;
+
+typedef struct _TestGraph
+{
+    TaskGraph graph;
+    TestTask  tasks[TASK_TEST_MAX];
+    Atomic32  sequence;
+} TestGraph;
+
+#pragma region INTERNAL
+static bool RunTestTask(void* pUserData)
+{
+    TestTask* pTask   = (TestTask*) pUserData;
+    pTask->startIndex = DROP_AtomicIncrement32(pTask->pSequence);
+    DROP_SleepMilliseconds(1); // Long enough for the other threads to race for what becomes ready.
+    pTask->endIndex = DROP_AtomicIncrement32(pTask->pSequence);
+    return !pTask->isFailing;
+}
+
+static void CleanupTestTask(void* pUserData)
+{
+    TestTask* pTask     = (TestTask*) pUserData;
+    pTask->cleanupIndex = DROP_AtomicIncrement32(pTask->pSequence);
+}
+
+static bool AddTestTask(
+    TestGraph* pTest, const char* name, bool isMainThread, bool isFailing, const u32* pDependencies,
+    u32 dependencyCount)
+{
+    u32       id    = pTest->graph.taskCount;
+    TestTask* pTask = &pTest->tasks[id];
+    pTask->pSequence = &pTest->sequence;
+    pTask->isFailing = isFailing;
+
+    TaskDesc desc = {
+        .name         = name,
+        .Run          = RunTestTask,
+        .Cleanup      = CleanupTestTask,
+        .pUserData    = pTask,
+        .isMainThread = isMainThread};
+    return DROP_AddTask(&pTest->graph, &desc, pDependencies, dependencyCount, NULL);
+}
+
+// Dependents start after what they depend on ends, main thread tasks run on thread 0.
+static bool CheckRunOrder(const TestGraph* pTest)
+{
+    for (u32 i = 0; i < pTest->graph.taskCount; ++i)
+    {
+        const Task*     pTask   = &pTest->graph.tasks[i];
+        const TestTask* pRecord = &pTest->tasks[i];
+        if (pTask->state == TASK_STATE_PENDING)
+            continue;
+
+        CHECK(!pTask->desc.isMainThread || pTask->threadIndex == 0, "Main thread task %s ran on thread %u.",
+              pTask->desc.name, pTask->threadIndex);
+        for (u32 j = 0; j < pTask->dependencyCount; ++j)
+        {
+            u32             dependency  = pTask->dependencies[j];
+            const TestTask* pDependency = &pTest->tasks[dependency];
+            CHECK(pDependency->endIndex && pDependency->endIndex < pRecord->startIndex,
+                  "Task %s started before %s ended.", pTask->desc.name, pTest->graph.tasks[dependency].desc.name);
+        }
+    }
+    return true;
+}
+
+// Exactly the doneCount tasks of doneOrder are cleaned up, the last one done first.
+static bool CheckCleanupOrder(const TestGraph* pTest, u32 doneCount)
+{
+    u32 cleanedCount = 0;
+    for (u32 i = 0; i < pTest->graph.taskCount; ++i)
+    {
+        const Task* pTask     = &pTest->graph.tasks[i];
+        bool        isCleaned = pTest->tasks[i].cleanupIndex != 0;
+        CHECK(isCleaned == (pTask->state == TASK_STATE_DONE), "Task %s was %s.", pTask->desc.name,
+              isCleaned ? "cleaned up without being done" : "done but not cleaned up");
+        cleanedCount += isCleaned;
+    }
+    CHECK(cleanedCount == doneCount, "%u tasks cleaned up for %u done.", cleanedCount, doneCount);
+
+    for (u32 i = 1; i < doneCount; ++i)
+    {
+        const TestTask* pEarlier = &pTest->tasks[pTest->graph.doneOrder[i - 1]];
+        const TestTask* pLater   = &pTest->tasks[pTest->graph.doneOrder[i]];
+        CHECK(pEarlier->endIndex < pLater->endIndex && pEarlier->cleanupIndex > pLater->cleanupIndex,
+              "Cleanup isn't in reverse completion order at %u.", i);
+    }
+    return true;
+}
+#pragma endregion
+
+// A diamond with main thread tasks hanging off it runs in dependency order and cleans up backwards,
+// then the same diamond with its middle task failing stops and only cleans up what finished.
+bool TestTaskGraph(const char* argument)
+{
+    UNUSED(argument);
+
+    CHECK(DROP_CreateJobSystem(3), "Failed to create the job system.");
+
+    static const u32 root[]   = {0};
+    static const u32 middle[] = {1, 2};
+    static const u32 joined[] = {3, 4};
+
+    TestGraph test;
+    for (u32 isFailing = 0; isFailing < 2; ++isFailing)
+    {
+        ZERO_MEM(&test, 1);
+        DROP_InitTaskGraph(&test.graph);
+        CHECK(AddTestTask(&test, "root", false, false, NULL, 0) &&
+                  AddTestTask(&test, "left", false, isFailing, root, 1) &&
+                  AddTestTask(&test, "right", true, false, root, 1) &&
+                  AddTestTask(&test, "bottom", false, false, middle, 2) &&
+                  AddTestTask(&test, "window", true, false, NULL, 0) &&
+                  AddTestTask(&test, "last", true, false, joined, 2),
+              "Failed to build the graph.");
+
+        bool isDone = DROP_RunTaskGraph(&test.graph);
+        CHECK(isDone != isFailing, "The run returned %s.", isDone ? "true" : "false");
+        CHECK(CheckRunOrder(&test), "The tasks ran out of order.");
+
+        u32 doneCount = 0;
+        for (u32 i = 0; i < test.graph.taskCount; ++i)
+            doneCount += test.graph.tasks[i].state == TASK_STATE_DONE;
+
+        if (isFailing)
+        {
+            // The failed run cleaned up on its own, and nothing behind the failed task started.
+            CHECK(test.graph.tasks[1].state == TASK_STATE_FAILED, "The failing task is %d.", test.graph.tasks[1].state);
+            CHECK(test.graph.tasks[3].state == TASK_STATE_PENDING && test.graph.tasks[5].state == TASK_STATE_PENDING,
+                  "A task behind the failed one started.");
+        }
+        else
+        {
+            CHECK(doneCount == test.graph.taskCount, "%u of %u tasks done.", doneCount, test.graph.taskCount);
+            CHECK(test.tasks[0].cleanupIndex == 0, "A successful run cleaned up.");
+            DROP_CleanupTaskGraph(&test.graph);
+        }
+        CHECK(CheckCleanupOrder(&test, doneCount), "The %s run cleaned up wrong.", isFailing ? "failed" : "full");
+    }
+
+    DROP_DestroyJobSystem();
+
+    return true;
+}
@@ -0,0 +1,90 @@
+#include "Bench.h"
+
+static const BenchCase s_cases[] = {
+    {"bloom.reference", BENCH_KIND_TEST, TestBloomReference},
+    {"dynamicresolution", BENCH_KIND_TEST, TestDynamicResolution},
+    {"gaussiankernel", BENCH_KIND_TEST, TestGaussianKernel},
+    {"halffloat.exhaustive", BENCH_KIND_TEST, TestHalfFloatExhaustive},
+    {"packedfloat.exhaustive", BENCH_KIND_TEST, TestPackedFloat},
+    {"frametiming", BENCH_KIND_TEST, TestFrameTiming},
+    {"shaderreflection", BENCH_KIND_TEST, TestShaderReflection},
+    {"scene", BENCH_KIND_TEST, TestScene},
+    {"entity", BENCH_KIND_TEST, TestEntity},
+    {"culling", BENCH_KIND_TEST, TestCulling},
+    {"occlusion", BENCH_KIND_TEST, TestOcclusion},
+    {"arenasnapshot", BENCH_KIND_TEST, TestArenaSnapshot},
+    {"framearenas", BENCH_KIND_TEST, TestFrameArenas},
+    {"radixsort", BENCH_KIND_TEST, TestRadixSort},
+    {"ringallocator", BENCH_KIND_TEST, TestRingAllocator},
+    {"profiler", BENCH_KIND_TEST, TestProfiler},
+    {"taskgraph", BENCH_KIND_TEST, TestTaskGraph},
+    {"counters", BENCH_KIND_TEST, TestCounters},
+    {"replay", BENCH_KIND_TEST, TestReplay},
+#ifdef _WIN32
+    {"rendertargetpool", BENCH_KIND_TEST, TestRenderTargetPool},
+#endif // _WIN32
+    {"halffloat.throughput", BENCH_KIND_BENCHMARK, BenchHalfFloat},
+    {"packedfloat.throughput", BENCH_KIND_BENCHMARK, BenchPackedFloat},
+    {"profiler.overhead", BENCH_KIND_BENCHMARK, BenchProfiler},
+    {"counters.overhead", BENCH_KIND_BENCHMARK, BenchCounters},
+    {"frametiming.limiter", BENCH_KIND_BENCHMARK, BenchFrameTiming},
+    {"scene.update", BENCH_KIND_BENCHMARK, BenchScene},
+    {"culling.throughput", BENCH_KIND_BENCHMARK, BenchCulling},
+    {"occlusion.throughput", BENCH_KIND_BENCHMARK, BenchOcclusion},
+    {"radixsort.throughput", BENCH_KIND_BENCHMARK, BenchRadixSort},
+    {"batch.sort", BENCH_KIND_BENCHMARK, BenchBatchQueue},
+#ifdef _WIN32
+    {"batch.drawcalls", BENCH_KIND_BENCHMARK, BenchBatchRenderer},
+#endif // _WIN32
+    {"frameencoder.throughput", BENCH_KIND_BENCHMARK, BenchFrameEncoder}};
+
+static bool IsSelected(const BenchCase* pCase, const char* filter)
+{
+    if (!filter || !strcmp(filter, "test"))
+        return pCase->kind == BENCH_KIND_TEST;
+    if (!strcmp(filter, "bench"))
+        return pCase->kind == BENCH_KIND_BENCHMARK;
+    if (!strcmp(filter, "all"))
+        return true;
+    return strstr(pCase->name, filter) != NULL;
+}
+
+// Runs every test by default, every benchmark with "bench", or the cases whose name contains the
+// filter. The argument goes to each case that runs, e.g. a file to read frames from.
+// Usage: Bench [test | bench | all | <filter>] [argument]
+int main(int argc, char** argv)
+{
+    const char* filter   = argc > 1 ? argv[1] : NULL;
+    const char* argument = argc > 2 ? argv[2] : NULL;
+
+    u32 runCount    = 0;
+    u32 failedCount = 0;
+    for (u32 i = 0; i < ARRAY_COUNT(s_cases); ++i)
+    {
+        const BenchCase* pCase = &s_cases[i];
+        if (!IsSelected(pCase, filter))
+            continue;
+
+        printf("[%s] %s\n", pCase->kind == BENCH_KIND_TEST ? "test" : "bench", pCase->name);
+
+        u64  startTicks = DROP_GetTicks();
+        bool isPassed   = pCase->Run(argument);
+        f64  seconds    = DROP_TicksToSeconds(DROP_GetTicks() - startTicks);
+
+        printf("  %s in %.2f s.\n", isPassed ? "Passed" : "FAILED", seconds);
+        ++runCount;
+        failedCount += !isPassed;
+    }
+
+    if (!runCount)
+    {
+        printf("No case matches %s.\n", filter);
+        return 1;
+    }
+
+    printf("%u of %u cases passed.\n", runCount - failedCount, runCount);
+    PRINT_LEAKS();
+    CLEANUP();
+
+    return failedCount ? 1 : 0;
+}
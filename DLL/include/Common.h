@@ -13,6 +13,7 @@ typedef signed long long i64;
 typedef float  f32;
 typedef double f64;
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
@@ -79,11 +80,23 @@ typedef double f64;
 #define KB(x) (x * 1024)
 #define MB(x) (KB(x) * 1024)
 
+// Element count of a fixed-size array, not of a pointer.
+#define ARRAY_COUNT(x) (sizeof(x) / sizeof((x)[0]))
+#define UNUSED(x) (void) (x)
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif // _MSC_VER
+
+#include "Utils/Counters.h"
 #include "Utils/ArenaAllocator.h"
 
 #define PERSISTENT g_memory->pPersistentStorage
 #define TRANSIENT g_memory->pTransientStorage
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <Windows.h>
@@ -94,4 +107,5 @@ typedef double f64;
 
 #define RELEASE(x) x->lpVtbl->Release(x)
 #define SAFE_RELEASE(x) \
-    if (x) x->lpVtbl->Release(x)
\ No newline at end of file
+    if (x) x->lpVtbl->Release(x)
+#endif // _WIN32
\ No newline at end of file
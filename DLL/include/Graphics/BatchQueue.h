@@ -0,0 +1,59 @@
+#pragma once
+
+#define BATCH_MAX_GROUPS 64
+
+typedef enum _BatchPrimitive
+{
+    BATCH_PRIMITIVE_TRIANGLE,
+    BATCH_PRIMITIVE_QUAD,
+    BATCH_PRIMITIVE_COUNT
+} BatchPrimitive;
+
+// Per-instance data in the order of the batch.hlsl input signature, the input layout is built from it.
+typedef struct _BatchInstance
+{
+    f32 basis[4]; // 2x2 rotation/scale, row major.
+    f32 translation[2];
+    u32 primitive;
+    f32 color[4];
+} BatchInstance;
+
+// Draws sharing the same pixel shader, texture and primitive end up in one DrawInstanced call.
+typedef struct _BatchGroup
+{
+    // The ID3D11PixelShader and ID3D11ShaderResourceView of the renderer, only compared here.
+    const void*    pPixelShader;
+    const void*    pSRV;
+    BatchPrimitive primitive;
+
+    u32 firstInstance;
+    u32 instanceCount;
+} BatchGroup;
+
+// CPU side of the batch renderer, without a device. Instances are appended unsorted and bucketed by
+// group on sort, so it can be measured and tested on its own.
+typedef struct _BatchQueue
+{
+    BatchInstance* pInstances;
+    BatchInstance* pSortedInstances;
+    u8*            pGroupIndices;
+    u32            instanceCount;
+    u32            maxInstances;
+
+    BatchGroup groups[BATCH_MAX_GROUPS];
+    u8         groupOrder[BATCH_MAX_GROUPS]; // Draw order, filled by DROP_BatchQueueSort.
+    u32        groupCount;
+    u32        lastGroup;
+} BatchQueue;
+
+bool DROP_MakeBatchQueue(BatchQueue* pQueue, u32 maxInstances);
+void DROP_DestroyBatchQueue(BatchQueue* pQueue);
+
+void DROP_BatchQueueReset(BatchQueue* pQueue);
+// Returns false when the instances or the group table are full, nothing is queued then.
+bool DROP_BatchQueuePush(
+    BatchQueue* pQueue, BatchPrimitive primitive, const void* pPixelShader, const void* pSRV, const f32 basis[4],
+    const f32 translation[2], const f32 color[4]);
+// Buckets the queued instances into pSortedInstances by group, groups sharing a pixel shader then a
+// texture next to each other. Submission order is kept inside a group.
+void DROP_BatchQueueSort(BatchQueue* pQueue);
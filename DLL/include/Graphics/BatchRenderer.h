@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/FrameFence.h"
+#include "Resources/DynamicBuffer.h"
+#include "Graphics/BatchQueue.h"
+
+#define BATCH_BUFFER_FRAMES (GFX_MAX_FRAMES_IN_FLIGHT + 1) // Frames the GPU reads plus the one being written.
+
+typedef struct _BatchRenderer
+{
+    GfxHandle gfxHandle;
+
+    // Owned by the shader and input layout caches.
+    ID3D11VertexShader* pVertexShader;
+    ID3D11PixelShader*  pDefaultPixelShader;
+    ID3D11InputLayout*  pInputLayout;
+
+    // Flushes append to it, room for maxInstances in every buffered frame.
+    GfxDynamicBuffer instanceBuffer;
+
+    // CPU side staging, sorted on flush. The group shaders and textures are the D3D objects submitted.
+    BatchQueue queue;
+
+    // Stats of the last flush.
+    u32 drawCount;
+    u32 flushedInstances;
+} _BatchRenderer;
+
+typedef _BatchRenderer* BatchRenderer;
+
+typedef struct _BatchInitProps
+{
+    u32                  maxInstances;
+    GfxShaderCache       shaderCache;
+    const GfxShaderDesc* pVertexShaderDesc; // Per instance input class, see batch.hlsl.
+    const GfxShaderDesc* pPixelShaderDesc;  // The default, color only.
+} BatchInitProps;
+
+bool DROP_CreateBatchRenderer(const GfxHandle handle, const BatchInitProps* pProps, BatchRenderer* pBatch);
+void DROP_DestroyBatchRenderer(BatchRenderer* pBatch);
+
+// Resets the batch. Call once before submitting the primitives of a frame.
+void DROP_BatchBegin(BatchRenderer batch);
+// Queues a primitive. A NULL pixel shader uses the default color-only shader.
+// Flushes on its own when the instance buffer or the group table is full.
+void DROP_BatchSubmit(
+    BatchRenderer batch, BatchPrimitive primitive, ID3D11PixelShader* pPixelShader, ID3D11ShaderResourceView* pSRV,
+    const f32 basis[4], const f32 translation[2], const f32 color[4]);
+// Sorts the queue, uploads the instances and issues one DrawInstanced per group. Binds the pipeline behind the
+// back of the pipeline cache, invalidate it after the last flush.
+void DROP_BatchFlush(BatchRenderer batch);
+// Tags the instances flushed since the previous call with frameIndex (from DROP_FrameFenceSignal).
+void DROP_BatchEndFrame(BatchRenderer batch, u64 frameIndex);
+// Makes the space of frames up to completedFrame (from DROP_FrameFencePoll) writable again.
+void DROP_BatchRetireFrames(BatchRenderer batch, u64 completedFrame);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Math/GaussianKernel.h"
+
+// Bloom over a chain of levels, each half the size of the one before. Level 0 is the bright pass
+// at half the source size, every next level a 13-tap downsample of the previous one. The smallest
+// level gets a separable blur, then going back up every level adds a tent upsample of the level
+// below it, so level 0 ends up holding the sum of them all.
+#define BLOOM_MAX_LEVELS 6 // Sizes come from a 64 size class, every level stays at least a pixel.
+#define BLOOM_DEFAULT_LEVELS 5
+#define BLOOM_DEFAULT_BLUR_SIGMA 2.0f // Texels of the smallest level at full render scale.
+#define BLOOM_THRESHOLD 0.9f          // Same as brightpass.hlsl.
+
+// Size of a level of the chain for a source dimension.
+static inline u32 DROP_BloomLevelSize(u32 size, u32 level)
+{
+    u32 levelSize = size >> (level + 1);
+    return levelSize ? levelSize : 1;
+}
+
+// CPU version of the GPU chain, to check its output without a device. Pixels are four floats, the
+// bloom is level 0 sized and alpha 1. Every level goes through R11G11B10 like the GPU targets.
+// Pass the size class extent with the window part filled and the rest black to match the GPU.
+bool DROP_ComputeBloomReference(
+    const f32* pSource, u32 width, u32 height, u32 levelCount, const GaussianKernel* pBlurKernel, f32* pBloom);
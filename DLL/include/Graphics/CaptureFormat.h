@@ -0,0 +1,107 @@
+#pragma once
+
+// Layout of a command capture file, shared by the recorder and the replayer.
+// It only depends on the integer types so it builds without the D3D headers.
+//
+// File:    CaptureHeader | CaptureObject[objectCount] | object data (dataBytes) | commands (commandBytes)
+// Command: CaptureCommand followed by its payload in 32-bit words, size includes the header.
+// Objects are referenced by id, which is their index in the table + 1. Id 0 is a null binding.
+// The data of each object starts on a word, the padding is not part of its dataSize.
+
+#define CAPTURE_MAGIC 0x50435844 // "DXCP"
+#define CAPTURE_VERSION 2
+#define CAPTURE_OBJECT_PARAM_COUNT 6
+#define CAPTURE_SEMANTIC_NAME_SIZE 32
+
+typedef struct _CaptureHeader
+{
+    u32 magic;
+    u32 version;
+    u32 frameCount;
+    u32 objectCount;
+    u64 dataBytes;
+    u64 commandBytes;
+} CaptureHeader;
+
+// Params, then the object data. Data is only there for objects created after DROP_KeepCaptureData.
+typedef enum _CaptureObjectKind
+{
+    CAPTURE_OBJECT_BUFFER,        // byteWidth, usage, bindFlags, cpuAccessFlags, miscFlags, structureStride.
+                                  // Initial contents, all byteWidth bytes.
+    CAPTURE_OBJECT_TEXTURE2D,     // width, height, mipLevels, arraySize, format, bindFlags.
+                                  // Initial contents of mip 0 of the first slice, rows tightly packed.
+    CAPTURE_OBJECT_RTV,           // format, mipSlice. Parent is the texture.
+    CAPTURE_OBJECT_SRV,           // format, mostDetailedMip, mipLevels. Parent is the texture.
+    CAPTURE_OBJECT_SAMPLER,       // filter, addressU, addressV, addressW.
+    CAPTURE_OBJECT_VERTEX_SHADER, // Bytecode.
+    CAPTURE_OBJECT_PIXEL_SHADER,  // Bytecode.
+    CAPTURE_OBJECT_INPUT_LAYOUT,  // CaptureInputLayout, its elements and the bytecode it was created against.
+    CAPTURE_OBJECT_QUERY,         // query, miscFlags.
+    CAPTURE_OBJECT_KIND_COUNT
+} CaptureObjectKind;
+
+typedef struct _CaptureObject
+{
+    u32 kind;
+    u32 parent;
+    u32 params[CAPTURE_OBJECT_PARAM_COUNT];
+    u32 dataOffset; // Into the object data.
+    u32 dataSize;   // 0 without data.
+} CaptureObject;
+
+typedef struct _CaptureInputLayout
+{
+    u32 elementCount;
+    u32 bytecodeSize;
+} CaptureInputLayout;
+
+typedef struct _CaptureInputElement
+{
+    char semanticName[CAPTURE_SEMANTIC_NAME_SIZE]; // Null terminated.
+    u32  semanticIndex;
+    u32  format;
+    u32  inputSlot;
+    u32  alignedByteOffset;
+    u32  inputSlotClass;
+    u32  instanceDataStepRate;
+} CaptureInputElement;
+
+typedef enum _CaptureStage
+{
+    CAPTURE_STAGE_VS,
+    CAPTURE_STAGE_PS,
+    CAPTURE_STAGE_COUNT
+} CaptureStage;
+
+// Payloads, every field is one word.
+typedef enum _CaptureCommandType
+{
+    CAPTURE_CMD_FRAME_END,              // -
+    CAPTURE_CMD_SET_VIEWPORTS,          // count, count * {x, y, width, height, minDepth, maxDepth} as f32.
+    CAPTURE_CMD_SET_RENDER_TARGETS,     // count, dsv, count * rtv.
+    CAPTURE_CMD_CLEAR_RENDER_TARGET,    // rtv, rgba as f32.
+    CAPTURE_CMD_SET_SHADER,             // stage, shader.
+    CAPTURE_CMD_SET_SHADER_RESOURCES,   // stage, start, count, count * srv.
+    CAPTURE_CMD_SET_SAMPLERS,           // stage, start, count, count * sampler.
+    CAPTURE_CMD_SET_CONSTANT_BUFFERS,   // stage, start, count, count * buffer.
+    CAPTURE_CMD_SET_INPUT_LAYOUT,       // layout.
+    CAPTURE_CMD_SET_VERTEX_BUFFERS,     // start, count, count * {buffer, stride, offset}.
+    CAPTURE_CMD_SET_INDEX_BUFFER,       // buffer, format, offset.
+    CAPTURE_CMD_SET_TOPOLOGY,           // topology.
+    CAPTURE_CMD_DRAW,                   // vertexCount, startVertex.
+    CAPTURE_CMD_DRAW_INDEXED,           // indexCount, startIndex, baseVertex.
+    CAPTURE_CMD_DRAW_INSTANCED,         // vertexCount, instanceCount, startVertex, startInstance.
+    CAPTURE_CMD_DRAW_INDEXED_INSTANCED, // indexCount, instanceCount, startIndex, baseVertex, startInstance.
+    CAPTURE_CMD_UPDATE_RESOURCE,        // resource, subresource, mapType, offset, byteCount, bytes padded to a word.
+    CAPTURE_CMD_COPY_RESOURCE,          // destination, source.
+    CAPTURE_CMD_BEGIN_QUERY,            // query.
+    CAPTURE_CMD_END_QUERY,              // query.
+    CAPTURE_CMD_COUNT
+} CaptureCommandType;
+
+typedef struct _CaptureCommand
+{
+    u16 type;
+    u16 reserved;
+    u32 size;
+} CaptureCommand;
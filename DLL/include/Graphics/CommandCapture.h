@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+#include "Graphics/CaptureFormat.h"
+
+#define CAPTURE_MAX_OBJECTS 1024
+
+// Records every call made on the immediate context of the handle for the next frameCount frames,
+// then writes them to fileName. The context vtable is swapped for a recording one while it runs,
+// so any code going through handle->pContext is captured without changes. One capture at a time.
+bool DROP_BeginCapture(const GfxHandle handle, const char* fileName, u32 frameCount);
+// Call once per frame after Present. Writes the file and restores the context after the last frame.
+void DROP_CaptureEndFrame(const GfxHandle handle);
+// Stops early, the complete frames are written. Call before releasing anything the capture has seen.
+void DROP_EndCapture(const GfxHandle handle);
+bool DROP_IsCapturing();
+
+// The context doesn't see how objects were created, so what a replay needs to recreate them is
+// attached to the objects as private data. Only kept after this call, make it before creating the
+// resources of a run that may be captured.
+void DROP_KeepCaptureData();
+// Bytecode of a shader, or initial contents of a buffer or texture (see CaptureFormat.h).
+void DROP_SetCaptureData(ID3D11DeviceChild* pObject, const void* pData, u32 byteCount);
+void DROP_SetCaptureInputLayoutData(
+    ID3D11InputLayout* pLayout, const D3D11_INPUT_ELEMENT_DESC* pElements, u32 elementCount, const void* pBytecode,
+    u32 bytecodeSize);
+// Narrows the update recorded at the next unmap of the resource to what was written, the whole
+// buffer is recorded otherwise. Can be called more than once per mapping.
+void DROP_CaptureWrittenRange(ID3D11Resource* pResource, u32 subresource, u32 offset, u32 byteCount);
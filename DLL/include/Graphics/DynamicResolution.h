@@ -0,0 +1,26 @@
+#pragma once
+
+// Picks the internal render scale from the frame time. Only CPU logic, feed it any trace of frame
+// times to see how it reacts.
+typedef struct _DynamicResolutionDesc
+{
+    f32 budgetMs;
+    f32 minScale;
+    f32 maxScale;
+    f32 scaleStep;      // Scales are multiples of it, so tiny corrections don't churn.
+    f32 raiseThreshold; // Fraction of the budget the average must stay under to raise the scale.
+    u32 settleFrames;   // Frames a condition must hold before the scale moves.
+} DynamicResolutionDesc;
+
+typedef struct _DynamicResolution
+{
+    DynamicResolutionDesc desc;
+    f32                   scale;
+    f32                   averageMs;
+    u32                   overBudgetFrames;
+    u32                   underBudgetFrames;
+} DynamicResolution;
+
+void DROP_InitDynamicResolution(DynamicResolution* pResolution, const DynamicResolutionDesc* pDesc);
+// Returns true when the scale changed.
+bool DROP_UpdateDynamicResolution(DynamicResolution* pResolution, f32 frameMs);
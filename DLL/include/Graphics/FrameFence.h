@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#define GFX_MAX_FRAMES_IN_FLIGHT 3
+
+// Tracks which frames the GPU has finished with event queries.
+// Frames are numbered from 1, a completed value of 0 means nothing has finished yet.
+typedef struct _GfxFrameFence
+{
+    ID3D11Query* pQueries[GFX_MAX_FRAMES_IN_FLIGHT];
+    u64          submitted;
+    u64          completed;
+} GfxFrameFence;
+
+bool DROP_CreateFrameFence(const GfxHandle handle, GfxFrameFence* pFence);
+void DROP_DestroyFrameFence(GfxFrameFence* pFence);
+
+// Closes the current frame and returns its index. Blocks when GFX_MAX_FRAMES_IN_FLIGHT frames are still pending.
+u64 DROP_FrameFenceSignal(const GfxHandle handle, GfxFrameFence* pFence);
+// Polls the pending queries without blocking and returns the last completed frame.
+u64 DROP_FrameFencePoll(const GfxHandle handle, GfxFrameFence* pFence);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+#include "Graphics/FrameFence.h"
+
+// A frame is only built once the one GFX_MAX_FRAMES_IN_FLIGHT before it completed, so a slot more
+// than the frames in flight is never reused before it can be read.
+#define GFX_GPU_TIMER_SLOTS (GFX_MAX_FRAMES_IN_FLIGHT + 1)
+
+// GPU time of a span of each frame from timestamp queries, read back a few frames late through the
+// frame fence. Frames are numbered like the frame fence.
+typedef struct _GfxGpuTimer
+{
+    ID3D11Query* pDisjointQueries[GFX_GPU_TIMER_SLOTS];
+    ID3D11Query* pBeginQueries[GFX_GPU_TIMER_SLOTS];
+    ID3D11Query* pEndQueries[GFX_GPU_TIMER_SLOTS];
+    u64          frames[GFX_GPU_TIMER_SLOTS]; // Frame measured in each slot, 0 when empty or read.
+} GfxGpuTimer;
+
+bool DROP_CreateGpuTimer(const GfxHandle handle, GfxGpuTimer* pTimer);
+void DROP_DestroyGpuTimer(GfxGpuTimer* pTimer);
+
+// Brackets the GPU work of frameIndex (the next DROP_FrameFenceSignal) to measure.
+void DROP_GpuTimerBegin(const GfxHandle handle, GfxGpuTimer* pTimer, u64 frameIndex);
+void DROP_GpuTimerEnd(const GfxHandle handle, GfxGpuTimer* pTimer, u64 frameIndex);
+// Newest measurement of the frames up to completedFrame (from DROP_FrameFencePoll) not read yet.
+// Returns false when there is none, or when the GPU clock changed frequency during it.
+bool DROP_GpuTimerRead(const GfxHandle handle, GfxGpuTimer* pTimer, u64 completedFrame, f32* pMilliseconds);
@@ -26,9 +26,18 @@ typedef struct _GfxRenderTarget
     u32 width, height;
 } GfxRenderTarget;
 
+typedef struct _GfxRenderTargetDesc
+{
+    u32         width;
+    u32         height;
+    DXGI_FORMAT format;
+    u32         bindFlags; // D3D11_BIND_RENDER_TARGET and D3D11_BIND_SHADER_RESOURCE are the ones given a view.
+} GfxRenderTargetDesc;
+
 bool DROP_CreateGraphics(const GfxInitProps* pProps, GfxHandle* pHandle);
 void DROP_DestroyGraphics(GfxHandle* pHandle);
 bool DROP_ResizeGraphics(GfxHandle handle, u32 width, u32 height);
 
+bool DROP_CreateRenderTarget(const GfxHandle handle, const GfxRenderTargetDesc* pDesc, GfxRenderTarget* pRenderTarget);
 bool DROP_CreateHDRRenderTarget(const GfxHandle handle, u32 width, u32 height, GfxRenderTarget* pRenderTarget);
 void DROP_DestroyRenderTarget(GfxRenderTarget* pRenderTarget);
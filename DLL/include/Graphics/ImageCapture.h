@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+#include "Utils/FrameEncoder.h"
+
+// Staging textures in flight, readbacks happen this many frames after their copy at the latest.
+#define GFX_IMAGE_CAPTURE_LATENCY 3
+
+typedef struct _GfxCaptureStaging
+{
+    ID3D11Texture2D* pTexture;
+    u32              width;  // Of the texture.
+    u32              height;
+    u32              copyWidth; // Of the region copied into it.
+    u32              copyHeight;
+    u64              frameIndex;
+    bool             isPending;
+} GfxCaptureStaging;
+
+// Copies a RGBA16F texture into staging textures and reads them back frames later without ever
+// waiting on the GPU, the pixels then go to a frame encoder. A frame whose staging texture or
+// encoder slot is still busy is dropped rather than stalling the frame.
+typedef struct _GfxImageCapture
+{
+    FrameEncoder      encoder;
+    GfxCaptureStaging staging[GFX_IMAGE_CAPTURE_LATENCY];
+    u32               next;      // Staging texture of the next copy.
+    u32               oldest;    // Staging texture of the next readback.
+    u32               remaining; // Frames left to copy.
+    u64               frameIndex;
+} _GfxImageCapture;
+
+typedef _GfxImageCapture* GfxImageCapture;
+
+// The encoder is borrowed and must outlive the capture.
+bool DROP_CreateImageCapture(FrameEncoder encoder, u32 frameCount, GfxImageCapture* pCapture);
+// Waits for the copies still in flight and hands them to the encoder.
+void DROP_DestroyImageCapture(const GfxHandle handle, GfxImageCapture* pCapture);
+
+// Once per frame, after the source is rendered. Reads back the copies that are done, then copies the
+// top left width * height of the source while frames are left to capture.
+void DROP_CaptureImage(
+    const GfxHandle handle, GfxImageCapture capture, ID3D11Texture2D* pSource, u32 width, u32 height);
+bool DROP_IsImageCaptureDone(GfxImageCapture capture);
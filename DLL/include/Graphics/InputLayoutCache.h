@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+#include "Resources/ShaderReflection.h"
+
+#define GFX_MAX_INPUT_LAYOUTS 16
+
+// Built from the input signature of a vertex shader, so the C side only has to lay its vertices
+// out in signature order: one slot, every element packed after the previous one, 32 bit components.
+typedef struct _GfxInputLayout
+{
+    ShaderSignatureElement     inputs[SHADER_MAX_SIGNATURE_ELEMENTS];
+    u32                        inputCount;
+    u64                        hash;
+    D3D11_INPUT_CLASSIFICATION slotClass;
+    ID3D11InputLayout*         pInputLayout;
+} GfxInputLayout;
+
+typedef struct _GfxInputLayoutCache
+{
+    GfxInputLayout layouts[GFX_MAX_INPUT_LAYOUTS];
+    u32            layoutCount;
+} _GfxInputLayoutCache;
+
+typedef _GfxInputLayoutCache* GfxInputLayoutCache;
+
+bool DROP_CreateInputLayoutCache(GfxInputLayoutCache* pCache);
+void DROP_DestroyInputLayoutCache(GfxInputLayoutCache* pCache);
+
+// Returns the layout for the input signature, creating it on first request. Shaders with equal
+// signatures share it and the cache keeps the reference. A signature of system values only needs
+// no layout, it gives NULL. The byte code is only read when the layout is created.
+bool DROP_GetInputLayout(
+    const GfxHandle handle, GfxInputLayoutCache cache, const ShaderReflection* pReflection, const void* pByteCode,
+    u64 byteCodeSize, D3D11_INPUT_CLASSIFICATION slotClass, ID3D11InputLayout** ppInputLayout);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#define GFX_MAX_PIPELINE_STATES 64
+#define GFX_PIPELINE_SAMPLER_COUNT 2
+
+// Everything a draw needs besides its resources. Unused members are left NULL,
+// samplers are bound to the pixel shader slots [0, GFX_PIPELINE_SAMPLER_COUNT).
+typedef struct _GfxPipelineDesc
+{
+    ID3D11VertexShader*      pVertexShader;
+    ID3D11PixelShader*       pPixelShader;
+    ID3D11InputLayout*       pInputLayout;
+    D3D11_PRIMITIVE_TOPOLOGY topology;
+    ID3D11SamplerState*      pSamplers[GFX_PIPELINE_SAMPLER_COUNT];
+} GfxPipelineDesc;
+
+// Immutable once created. The cache holds a reference on every object of the description.
+typedef struct _GfxPipelineState
+{
+    GfxPipelineDesc desc;
+    u64             hash;
+    u32             id; // Creation order, small enough to go in a sort key.
+} GfxPipelineState;
+
+typedef struct _GfxPipelineCache
+{
+    GfxPipelineState states[GFX_MAX_PIPELINE_STATES];
+    u32              stateCount;
+    u8               buckets[GFX_MAX_PIPELINE_STATES * 2]; // Open addressing, index + 1 or 0 when empty.
+
+    const GfxPipelineState* pBound;
+
+    u32 switchCount;          // Binds that changed the pipeline this frame.
+    u32 lastFrameSwitchCount;
+} _GfxPipelineCache;
+
+typedef _GfxPipelineCache* GfxPipelineCache;
+
+bool DROP_CreatePipelineCache(GfxPipelineCache* pCache);
+void DROP_DestroyPipelineCache(GfxPipelineCache* pCache);
+
+// Returns the state matching the description, creating it on first request.
+bool DROP_GetPipelineState(GfxPipelineCache cache, const GfxPipelineDesc* pDesc, const GfxPipelineState** ppState);
+// Only issues the calls for the parts that differ from the bound state.
+void DROP_BindPipelineState(const GfxHandle handle, GfxPipelineCache cache, const GfxPipelineState* pState);
+// Forgets the bound state, call after touching the pipeline without the cache.
+void DROP_InvalidatePipelineState(GfxPipelineCache cache);
+// Returns the switch count of the frame and starts a new one.
+u32 DROP_PipelineCacheEndFrame(GfxPipelineCache cache);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Graphics/PipelineState.h"
+#include "Utils/FrameArenas.h"
+#include "Utils/RadixSort.h"
+
+// Sort keys, most significant bits first.
+// Opaque:      pass (4) | pipeline (8) | material (16) | mesh (16) | depth (20), front to back.
+// Transparent: pass (4) | depth (20), back to front | pipeline (8) | material (16) | mesh (16).
+#define RENDER_KEY_PASS_BITS 4
+#define RENDER_KEY_PIPELINE_BITS 8
+#define RENDER_KEY_MATERIAL_BITS 16
+#define RENDER_KEY_MESH_BITS 16
+#define RENDER_KEY_DEPTH_BITS 20
+
+// One draw. Resources are bound to the input assembler slot 0 and the pixel shader slot 0.
+typedef struct _RenderPacket
+{
+    const GfxPipelineState*   pPipeline;
+    ID3D11Buffer*             pVertexBuffer;
+    ID3D11Buffer*             pConstantBuffer;
+    ID3D11ShaderResourceView* pSRV;
+    u32                       stride;
+    u32                       vertexCount;
+    u32                       startVertex;
+} RenderPacket;
+
+typedef struct _RenderQueue
+{
+    RenderPacket* pPackets; // In the frame arena of the frame that began the queue.
+    RadixSort     sort; // The key of every packet, its index as the value.
+    u32           packetCount;
+    u32           maxPackets;
+
+    // Stats of the last execute.
+    u32 drawCount;
+    u32 bindCount;
+} _RenderQueue;
+
+typedef _RenderQueue* RenderQueue;
+
+bool DROP_CreateRenderQueue(u32 maxPackets, RenderQueue* pQueue);
+void DROP_DestroyRenderQueue(RenderQueue* pQueue);
+
+// Depth is in [0, 1], ids are truncated to their field.
+u64 DROP_MakeOpaqueKey(u32 pass, u32 pipeline, u32 material, u32 mesh, f32 depth);
+u64 DROP_MakeTransparentKey(u32 pass, u32 pipeline, u32 material, u32 mesh, f32 depth);
+
+// Main thread, after DROP_BeginFrameArenas. Takes room for maxPackets from the frame arena, the packets
+// are only read until the execute of the same frame.
+void DROP_RenderQueueBegin(RenderQueue queue, FrameArenas* pArenas);
+// Not thread safe. Returns false when the queue is full.
+bool DROP_RenderQueueSubmit(RenderQueue queue, u64 key, const RenderPacket* pPacket);
+// Sorts the packets by key with a parallel LSD radix sort, equal keys keep their submission order.
+void DROP_RenderQueueSort(RenderQueue queue);
+// Issues the sorted draws, only binding what differs from the previous packet.
+void DROP_RenderQueueExecute(const GfxHandle handle, GfxPipelineCache cache, RenderQueue queue);
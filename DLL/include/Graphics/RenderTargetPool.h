@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#define GFX_RENDER_TARGET_POOL_SIZE 32
+#define GFX_RENDER_TARGET_SIZE_CLASS 64    // Power of two.
+#define GFX_RENDER_TARGET_MAX_IDLE_FRAMES 120 // Free targets unused for longer are destroyed.
+
+typedef struct _GfxPooledTarget
+{
+    GfxRenderTarget     target;
+    GfxRenderTargetDesc desc;
+    u64                 lastUsedFrame;
+    bool                isInUse;
+} GfxPooledTarget;
+
+// Owns every target it hands out. Released targets stay alive for a while, so a size that comes
+// back soon, e.g. dragging a window back and forth, gets its textures without creating any.
+typedef struct _GfxRenderTargetPool
+{
+    GfxHandle       handle;
+    GfxPooledTarget entries[GFX_RENDER_TARGET_POOL_SIZE];
+    u32             entryCount;
+    u64             frameIndex;
+
+    u64 createCount;
+    u64 reuseCount;
+} _GfxRenderTargetPool;
+
+typedef _GfxRenderTargetPool* GfxRenderTargetPool;
+
+bool DROP_CreateRenderTargetPool(const GfxHandle handle, GfxRenderTargetPool* pPool);
+void DROP_DestroyRenderTargetPool(GfxRenderTargetPool* pPool);
+
+// Returns a free target matching the description exactly, the most recently used one first,
+// creating it when there is none. The target belongs to the pool, never destroy it directly.
+bool DROP_AcquireRenderTarget(GfxRenderTargetPool pool, const GfxRenderTargetDesc* pDesc, GfxRenderTarget* pTarget);
+// Gives the target back and clears it.
+void DROP_ReleaseRenderTarget(GfxRenderTargetPool pool, GfxRenderTarget* pTarget);
+// Destroys the free targets idle for more than GFX_RENDER_TARGET_MAX_IDLE_FRAMES.
+void DROP_RenderTargetPoolEndFrame(GfxRenderTargetPool pool);
+
+// Rounds a size up to its size class. Sizing targets from the class of the window instead of the
+// window itself lets most resizes keep the targets they have.
+static inline u32 DROP_RenderTargetSizeClass(u32 size)
+{
+    return (size + GFX_RENDER_TARGET_SIZE_CLASS - 1) & ~(GFX_RENDER_TARGET_SIZE_CLASS - 1);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+#include "Graphics/InputLayoutCache.h"
+
+#define GFX_MAX_SHADER_VARIANTS 32
+#define GFX_SHADER_NAME_LENGTH 32
+#define GFX_SHADER_DEFINES_LENGTH 64
+#define GFX_SHADER_DIRECTORY "assets/shaders/"
+
+typedef enum _GfxShaderStage
+{
+    GFX_SHADER_STAGE_VERTEX,
+    GFX_SHADER_STAGE_PIXEL
+} GfxShaderStage;
+
+// One permutation of a shader file. Every file gets a base variant without defines, the others are
+// listed in assets/shaders/permutations.txt and compiled by compile_shader.bat with each define set
+// to 1, into <name>_<vs|ps>_<define>_<define>.cso.
+typedef struct _GfxShaderDesc
+{
+    const char* name;        // File name without extension, "bloom" for bloom.hlsl.
+    const char* defines;     // Separated by single spaces in the order of permutations.txt, NULL for the base.
+    const char* cbufferName; // Checked against cbufferSize when the variant is created, NULL for none.
+    u32         cbufferSize;
+    // Vertex shaders only, how the layout from their input signature steps, per vertex when left zero.
+    // It belongs to the shader file, a variant is looked up by name and defines alone.
+    D3D11_INPUT_CLASSIFICATION inputClass;
+} GfxShaderDesc;
+
+// A variant read and reflected, its cbuffer checked, waiting for the device.
+typedef struct _GfxShaderBinary
+{
+    GfxShaderStage             stage;
+    char                       name[GFX_SHADER_NAME_LENGTH];
+    char                       defines[GFX_SHADER_DEFINES_LENGTH];
+    D3D11_INPUT_CLASSIFICATION inputClass;
+    ID3DBlob*                  pByteCode;
+    ShaderReflection           reflection;
+} GfxShaderBinary;
+
+typedef struct _GfxShaderVariant
+{
+    u64                 hash;
+    GfxShaderStage      stage;
+    char                name[GFX_SHADER_NAME_LENGTH];
+    char                defines[GFX_SHADER_DEFINES_LENGTH];
+    ID3D11VertexShader* pVertexShader;
+    ID3D11PixelShader*  pPixelShader;
+    ID3D11InputLayout*  pInputLayout; // Owned by the input layout cache.
+} GfxShaderVariant;
+
+typedef struct _GfxShaderCache
+{
+    GfxShaderVariant    variants[GFX_MAX_SHADER_VARIANTS];
+    u32                 variantCount;
+    u8                  buckets[GFX_MAX_SHADER_VARIANTS * 2]; // Open addressing, index + 1 or 0 when empty.
+    GfxInputLayoutCache layoutCache;
+} _GfxShaderCache;
+
+typedef _GfxShaderCache* GfxShaderCache;
+
+// Vertex shader layouts come from the layout cache, which must outlive this one.
+bool DROP_CreateShaderCache(GfxInputLayoutCache layoutCache, GfxShaderCache* pCache);
+void DROP_DestroyShaderCache(GfxShaderCache* pCache);
+
+// Any thread, no device needed. Splits the file work from the device work, to do it ahead.
+bool DROP_LoadShaderBinary(GfxShaderStage stage, const GfxShaderDesc* pDesc, GfxShaderBinary* pBinary);
+void DROP_ReleaseShaderBinary(GfxShaderBinary* pBinary);
+// Creates the variant of a loaded binary unless the cache has it already. The binary can be released after.
+bool DROP_AddShaderVariant(const GfxHandle handle, GfxShaderCache cache, const GfxShaderBinary* pBinary);
+
+// Return the variant, loading and creating it on first request only. The cache keeps the references,
+// the byte code is released once the shader and its input layout exist.
+bool DROP_GetVertexShader(
+    const GfxHandle handle, GfxShaderCache cache, const GfxShaderDesc* pDesc, ID3D11VertexShader** ppVertexShader,
+    ID3D11InputLayout** ppInputLayout);
+bool DROP_GetPixelShader(
+    const GfxHandle handle, GfxShaderCache cache, const GfxShaderDesc* pDesc, ID3D11PixelShader** ppPixelShader);
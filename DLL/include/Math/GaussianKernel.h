@@ -0,0 +1,45 @@
+#pragma once
+
+#define GAUSSIAN_MAX_TAPS 8 // Bilinear taps on each side of the center.
+#define GAUSSIAN_MAX_RADIUS (GAUSSIAN_MAX_TAPS * 2)
+#define GAUSSIAN_KERNEL_CACHE_SIZE 8
+#define GAUSSIAN_SIGMA_STEPS 64 // The cache rounds sigma to 1 / 64 of a texel.
+
+// One side of a normalized, symmetric Gaussian, with the texels around the center folded in pairs
+// into bilinear taps. A tap lands between its two texels where the linear sampler weighs them as
+// the Gaussian does, so a radius of r takes 1 + 2 * ceil(r / 2) fetches instead of 1 + 2 * r.
+typedef struct _GaussianKernel
+{
+    f32 sigma;
+    u32 radius; // Texels on each side of the center.
+    u32 id;     // Unique per kernel built by a cache, to tell when an upload is stale.
+    u32 tapCount;
+    f32 centerWeight;
+    f32 weights[GAUSSIAN_MAX_TAPS];
+    f32 offsets[GAUSSIAN_MAX_TAPS]; // In texels from the center.
+} GaussianKernel;
+
+// The last kernels asked for, the oldest one is replaced when full.
+typedef struct _GaussianKernelCache
+{
+    GaussianKernel kernels[GAUSSIAN_KERNEL_CACHE_SIZE];
+    u32            kernelCount;
+    u32            nextKernel;
+    u32            nextId;
+} GaussianKernelCache;
+
+// Covers three sigmas, past that the weights are too small to matter.
+static inline u32 DROP_GaussianRadius(f32 sigma)
+{
+    u32 radius = (u32) (sigma * 3.0f + 0.999f);
+    if (radius < 1)
+        return 1;
+    return radius > GAUSSIAN_MAX_RADIUS ? GAUSSIAN_MAX_RADIUS : radius;
+}
+
+bool DROP_BuildGaussianKernel(f32 sigma, u32 radius, GaussianKernel* pKernel);
+
+void DROP_InitGaussianKernelCache(GaussianKernelCache* pCache);
+// Builds the kernel only the first time a sigma and radius are asked for. Sigma is rounded to the
+// nearest step first, so a sigma computed each frame doesn't build a kernel every time it drifts.
+bool DROP_GetGaussianKernel(GaussianKernelCache* pCache, f32 sigma, u32 radius, const GaussianKernel** ppKernel);
@@ -0,0 +1,35 @@
+#pragma once
+
+// IEEE 754 binary16, the channels of DXGI_FORMAT_R16G16B16A16_FLOAT. Every half has an exact float,
+// infinities included. NaN keeps its sign and payload and comes out quiet both ways, like F16C.
+// Every path gives the same bits as the scalar versions for every input.
+
+typedef enum _HalfRounding
+{
+    HALF_ROUND_NEAREST_EVEN,
+    HALF_ROUND_TOWARD_ZERO,
+    HALF_ROUND_UP,   // Toward +infinity.
+    HALF_ROUND_DOWN  // Toward -infinity.
+} HalfRounding;
+
+typedef enum _HalfFloatPath
+{
+    HALF_FLOAT_PATH_SCALAR,
+    HALF_FLOAT_PATH_SSE2,
+    HALF_FLOAT_PATH_F16C,
+    HALF_FLOAT_PATH_COUNT
+} HalfFloatPath;
+
+// Scalar reference versions. Values past the largest half become infinity or 65504 depending on the
+// rounding, like any other rounding of a finite value.
+f32 DROP_HalfToFloat(u16 half);
+u16 DROP_FloatToHalf(f32 value, HalfRounding rounding);
+
+// Eight values per iteration on the selected path, the remainder with the scalar versions.
+void DROP_HalfToFloatArray(const u16* pHalves, f32* pFloats, u32 count);
+void DROP_FloatToHalfArray(const f32* pFloats, u16* pHalves, u32 count, HalfRounding rounding);
+
+// The path the array versions use, the fastest one the CPU has unless set otherwise.
+HalfFloatPath DROP_GetHalfFloatPath();
+// Selects a slower path, e.g. to compare them. A path the CPU doesn't have falls back to SSE2.
+void DROP_SetHalfFloatPath(HalfFloatPath path);
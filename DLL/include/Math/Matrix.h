@@ -0,0 +1,49 @@
+#pragma once
+
+#include <xmmintrin.h>
+
+// Row major 4x4 matrix, row vector convention (v' = v * M) like the rest of D3D.
+// A world matrix is local * parentWorld.
+typedef struct _Mat4
+{
+    __m128 rows[4];
+} Mat4;
+
+static inline Mat4 DROP_Mat4Identity()
+{
+    Mat4 m;
+    m.rows[0] = _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    m.rows[1] = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+    m.rows[2] = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+    m.rows[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    return m;
+}
+
+// Row of a times b, the building block of both vector and matrix products.
+static inline __m128 DROP_Mat4TransformRow(__m128 row, const Mat4* pB)
+{
+    __m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), pB->rows[0]);
+    result        = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), pB->rows[1]));
+    result        = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), pB->rows[2]));
+    result        = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), pB->rows[3]));
+    return result;
+}
+
+static inline void DROP_Mat4Multiply(const Mat4* pA, const Mat4* pB, Mat4* pOut)
+{
+    // Computed into locals first so pOut may alias pA or pB.
+    __m128 r0 = DROP_Mat4TransformRow(pA->rows[0], pB);
+    __m128 r1 = DROP_Mat4TransformRow(pA->rows[1], pB);
+    __m128 r2 = DROP_Mat4TransformRow(pA->rows[2], pB);
+    __m128 r3 = DROP_Mat4TransformRow(pA->rows[3], pB);
+
+    pOut->rows[0] = r0;
+    pOut->rows[1] = r1;
+    pOut->rows[2] = r2;
+    pOut->rows[3] = r3;
+}
+
+static inline void DROP_Mat4Transpose(Mat4* pM)
+{
+    _MM_TRANSPOSE4_PS(pM->rows[0], pM->rows[1], pM->rows[2], pM->rows[3]);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// CPU side of the compact HDR formats, to decode readbacks and captures or build reference images.
+// DXGI_FORMAT_R11G11B10_FLOAT: unsigned floats with a 5-bit exponent and 6/6/5-bit mantissas.
+// DXGI_FORMAT_R9G9B9E5_SHAREDEXP: three 9-bit mantissas sharing one 5-bit exponent.
+// Negative values and NaN pack to 0 in RGB9E5, R11G11B10 keeps NaN and infinity and clamps negatives to 0.
+// Scalar and pixel versions give the same bits for every input.
+
+u32  DROP_PackR11G11B10(f32 r, f32 g, f32 b);
+void DROP_UnpackR11G11B10(u32 packed, f32* pRGB);
+u32  DROP_PackRGB9E5(f32 r, f32 g, f32 b);
+void DROP_UnpackRGB9E5(u32 packed, f32* pRGB);
+
+// Pixels are four floats, alpha is ignored when packing and unpacked as 1.
+// Four pixels are converted per iteration with SSE2, the remainder with the scalar versions.
+void DROP_PackR11G11B10Pixels(const f32* pPixels, u32* pPacked, u32 count);
+void DROP_UnpackR11G11B10Pixels(const u32* pPacked, f32* pPixels, u32 count);
+void DROP_PackRGB9E5Pixels(const f32* pPixels, u32* pPacked, u32 count);
+void DROP_UnpackRGB9E5Pixels(const u32* pPacked, f32* pPixels, u32 count);
@@ -0,0 +1,46 @@
+#pragma once
+
+#define FRAME_TIMING_WINDOW 256 // Power of two.
+#define FRAME_TIMING_HISTOGRAM_BUCKETS 34
+#define FRAME_TIMING_BUCKET_MS 1.0 // The last bucket also counts every longer frame.
+
+typedef struct _FrameTimingStats
+{
+    u32 sampleCount;
+    f64 minMs;
+    f64 maxMs;
+    f64 averageMs;
+    f64 medianMs;
+    f64 p95Ms;
+    f64 p99Ms;
+    f64 targetMs;      // 0 when the limiter is off.
+    f64 sleepJitterMs; // Average oversleep of the limiter, what the spin wait has to cover.
+    f64 wakeErrorMs;   // Average distance between the end of the wait and its deadline.
+    u32 histogram[FRAME_TIMING_HISTOGRAM_BUCKETS];
+} FrameTimingStats;
+
+// Rolling window of CPU frame times, measured from one DROP_EndFrameTiming to the next, and an
+// optional limiter that holds frames to a fixed interval.
+typedef struct _FrameTiming
+{
+    u64 samples[FRAME_TIMING_WINDOW]; // Ticks.
+    u32 sampleCount;
+    u32 nextSample;
+    u64 lastFrameTicks;
+
+    // Limiter, disabled while targetTicks is 0.
+    u64 targetTicks;
+    u64 deadlineTicks;
+    f64 sleepJitterTicks;    // Running average of how late Sleep returns.
+    f64 sleepDeviationTicks; // Running average of the distance to that average.
+    f64 wakeErrorTicks;
+} FrameTiming;
+
+void DROP_InitFrameTiming(FrameTiming* pTiming);
+// 0 turns the limiter off.
+void DROP_SetFrameLimit(FrameTiming* pTiming, f64 framesPerSecond);
+// Call once per frame, after Present. Waits for the next slot when the limiter is on, then records
+// the frame time.
+void DROP_EndFrameTiming(FrameTiming* pTiming);
+void DROP_GetFrameTimingStats(const FrameTiming* pTiming, FrameTimingStats* pStats);
+void DROP_PrintFrameTimingStats(const FrameTimingStats* pStats);
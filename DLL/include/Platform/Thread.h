@@ -0,0 +1,160 @@
+#pragma once
+
+#include <immintrin.h>
+
+// Threads and semaphores for the modules that work off the main thread. Win32Thread.c and
+// PosixThread.c implement them, only the one of the platform being built compiles to anything.
+typedef struct _Thread*    Thread;
+typedef struct _Semaphore* Semaphore;
+
+typedef void (*ThreadFunc)(void* pUserData);
+
+bool DROP_CreateThread(ThreadFunc func, void* pUserData, Thread* pThread);
+// Waits for the thread to return, then releases it.
+void DROP_JoinThread(Thread* pThread);
+
+bool DROP_CreateSemaphore(u32 initialCount, Semaphore* pSemaphore);
+void DROP_DestroySemaphore(Semaphore* pSemaphore);
+// Blocks until the count is above zero, then takes one.
+void DROP_WaitSemaphore(Semaphore semaphore);
+void DROP_SignalSemaphore(Semaphore semaphore, u32 count);
+
+// Logical processors of the machine.
+u32  DROP_GetProcessorCount();
+void DROP_SleepMilliseconds(u32 milliseconds);
+
+// Spin wait hint, the loop around it should still look at memory through the atomics below.
+static inline void DROP_YieldProcessor()
+{
+    _mm_pause();
+}
+
+// Sequentially consistent read-modify-writes, acquire loads and release stores. The values are only
+// ever touched through these, the add, increment and decrement return the new value.
+typedef volatile i32 Atomic32;
+typedef volatile i64 Atomic64;
+
+#ifdef _MSC_VER
+static inline i32 DROP_AtomicLoad32(const Atomic32* p)
+{
+    return *p;
+}
+
+static inline void DROP_AtomicStore32(Atomic32* p, i32 value)
+{
+    *p = value;
+}
+
+static inline i32 DROP_AtomicAdd32(Atomic32* p, i32 value)
+{
+    return (i32) InterlockedExchangeAdd((volatile LONG*) p, (LONG) value) + value;
+}
+
+static inline i32 DROP_AtomicIncrement32(Atomic32* p)
+{
+    return (i32) InterlockedIncrement((volatile LONG*) p);
+}
+
+static inline i32 DROP_AtomicDecrement32(Atomic32* p)
+{
+    return (i32) InterlockedDecrement((volatile LONG*) p);
+}
+
+static inline i32 DROP_AtomicExchange32(Atomic32* p, i32 value)
+{
+    return (i32) InterlockedExchange((volatile LONG*) p, (LONG) value);
+}
+
+// Returns the value before the call, the exchange happened when it equals comparand.
+static inline i32 DROP_AtomicCompareExchange32(Atomic32* p, i32 exchange, i32 comparand)
+{
+    return (i32) InterlockedCompareExchange((volatile LONG*) p, (LONG) exchange, (LONG) comparand);
+}
+
+static inline i64 DROP_AtomicLoad64(const Atomic64* p)
+{
+    return *p;
+}
+
+static inline i64 DROP_AtomicAdd64(Atomic64* p, i64 value)
+{
+    return InterlockedExchangeAdd64(p, value) + value;
+}
+
+static inline i64 DROP_AtomicExchange64(Atomic64* p, i64 value)
+{
+    return InterlockedExchange64(p, value);
+}
+
+static inline void* DROP_AtomicLoadPointer(void* volatile const* p)
+{
+    return *p;
+}
+
+static inline void* DROP_AtomicExchangePointer(void* volatile* p, void* value)
+{
+    return InterlockedExchangePointer(p, value);
+}
+#else
+static inline i32 DROP_AtomicLoad32(const Atomic32* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void DROP_AtomicStore32(Atomic32* p, i32 value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+static inline i32 DROP_AtomicAdd32(Atomic32* p, i32 value)
+{
+    return __atomic_add_fetch(p, value, __ATOMIC_SEQ_CST);
+}
+
+static inline i32 DROP_AtomicIncrement32(Atomic32* p)
+{
+    return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline i32 DROP_AtomicDecrement32(Atomic32* p)
+{
+    return __atomic_sub_fetch(p, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline i32 DROP_AtomicExchange32(Atomic32* p, i32 value)
+{
+    return __atomic_exchange_n(p, value, __ATOMIC_SEQ_CST);
+}
+
+// Returns the value before the call, the exchange happened when it equals comparand.
+static inline i32 DROP_AtomicCompareExchange32(Atomic32* p, i32 exchange, i32 comparand)
+{
+    __atomic_compare_exchange_n(p, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+
+static inline i64 DROP_AtomicLoad64(const Atomic64* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline i64 DROP_AtomicAdd64(Atomic64* p, i64 value)
+{
+    return __atomic_add_fetch(p, value, __ATOMIC_SEQ_CST);
+}
+
+static inline i64 DROP_AtomicExchange64(Atomic64* p, i64 value)
+{
+    return __atomic_exchange_n(p, value, __ATOMIC_SEQ_CST);
+}
+
+static inline void* DROP_AtomicLoadPointer(void* volatile const* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void* DROP_AtomicExchangePointer(void* volatile* p, void* value)
+{
+    return __atomic_exchange_n(p, value, __ATOMIC_SEQ_CST);
+}
+#endif // _MSC_VER
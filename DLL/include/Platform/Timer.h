@@ -0,0 +1,7 @@
+#pragma once
+
+// Ticks of the high resolution performance counter, of the monotonic clock off Windows.
+u64 DROP_GetTicks();
+u64 DROP_GetTickFrequency();
+f64 DROP_TicksToSeconds(u64 ticks);
+f64 DROP_TicksToMilliseconds(u64 ticks);
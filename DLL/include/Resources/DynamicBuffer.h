@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+#include "Utils/RingAllocator.h"
+
+// Large dynamic vertex/index buffer that per-frame geometry is streamed into.
+// Writes are suballocated from a ring and mapped with NO_OVERWRITE, space is given back
+// once the frame fence reports that the GPU is done with the frame that used it.
+typedef struct _GfxDynamicBuffer
+{
+    ID3D11Buffer* pBuffer;
+    RingAllocator ring;
+    bool          isMapped; // First map of a dynamic buffer has to be a DISCARD.
+} GfxDynamicBuffer;
+
+bool DROP_CreateDynamicBuffer(const GfxHandle handle, u32 size, u32 bindFlags, GfxDynamicBuffer* pBuffer);
+void DROP_DestroyDynamicBuffer(GfxDynamicBuffer* pBuffer);
+
+// Copies size bytes into the buffer. pOffset receives the byte offset to pass to
+// IASetVertexBuffers/IASetIndexBuffer. Returns false when the ring has no free space left.
+bool DROP_DynamicBufferWrite(
+    const GfxHandle handle, GfxDynamicBuffer* pBuffer, const void* data, u32 size, u32 alignment, u32* pOffset);
+// Tags everything written since the previous call with frameIndex (from DROP_FrameFenceSignal).
+void DROP_DynamicBufferEndFrame(GfxDynamicBuffer* pBuffer, u64 frameIndex);
+// Makes the space of frames up to completedFrame (from DROP_FrameFencePoll) writable again.
+void DROP_DynamicBufferRetire(GfxDynamicBuffer* pBuffer, u64 completedFrame);
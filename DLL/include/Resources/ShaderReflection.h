@@ -0,0 +1,86 @@
+#pragma once
+
+#define SHADER_NAME_LENGTH 32
+#define SHADER_MAX_SIGNATURE_ELEMENTS 16
+#define SHADER_MAX_CONSTANT_BUFFERS 8
+#define SHADER_MAX_VARIABLES 16
+#define SHADER_MAX_BINDINGS 16
+
+// Same values as D3D_REGISTER_COMPONENT_TYPE.
+typedef enum _ShaderComponentType
+{
+    SHADER_COMPONENT_UNKNOWN = 0,
+    SHADER_COMPONENT_UINT32  = 1,
+    SHADER_COMPONENT_SINT32  = 2,
+    SHADER_COMPONENT_FLOAT32 = 3
+} ShaderComponentType;
+
+// Same values as D3D_SHADER_INPUT_TYPE for the ones the shaders use.
+typedef enum _ShaderBindingType
+{
+    SHADER_BINDING_CBUFFER = 0,
+    SHADER_BINDING_TBUFFER = 1,
+    SHADER_BINDING_TEXTURE = 2,
+    SHADER_BINDING_SAMPLER = 3
+} ShaderBindingType;
+
+typedef struct _ShaderSignatureElement
+{
+    char semanticName[SHADER_NAME_LENGTH];
+    u32  semanticIndex;
+    u32  systemValue; // D3D_NAME, 0 for the ones the input assembler feeds.
+    u32  componentType;
+    u32  reg;
+    u8   mask;
+    u8   componentCount;
+} ShaderSignatureElement;
+
+typedef struct _ShaderVariable
+{
+    char name[SHADER_NAME_LENGTH];
+    u32  offset;
+    u32  size;
+} ShaderVariable;
+
+typedef struct _ShaderConstantBuffer
+{
+    char           name[SHADER_NAME_LENGTH];
+    u32            size; // Rounded up to 16 bytes by the compiler.
+    u32            variableCount;
+    ShaderVariable variables[SHADER_MAX_VARIABLES];
+} ShaderConstantBuffer;
+
+typedef struct _ShaderBinding
+{
+    char name[SHADER_NAME_LENGTH];
+    u32  type;
+    u32  bindPoint;
+    u32  bindCount;
+} ShaderBinding;
+
+// What the runtime would tell through ID3D11ShaderReflection, read straight from the .cso container
+// so it works without d3dcompiler and on any platform. DXBC containers carry everything, DXIL ones
+// keep their resources in the bitcode, so only the signatures are filled for them.
+typedef struct _ShaderReflection
+{
+    ShaderSignatureElement inputs[SHADER_MAX_SIGNATURE_ELEMENTS];
+    ShaderSignatureElement outputs[SHADER_MAX_SIGNATURE_ELEMENTS];
+    ShaderConstantBuffer   constantBuffers[SHADER_MAX_CONSTANT_BUFFERS];
+    ShaderBinding          bindings[SHADER_MAX_BINDINGS];
+    u32                    inputCount;
+    u32                    outputCount;
+    u32                    constantBufferCount;
+    u32                    bindingCount;
+    u64                    inputHash; // Of the input signature, equal signatures can share an input layout.
+    bool                   isDXIL;
+    bool                   hasResources; // False when the container has no RDEF chunk.
+} ShaderReflection;
+
+// Fails on anything that is not a well formed container, every offset is checked against its chunk.
+bool DROP_ReflectShader(const void* pByteCode, u64 size, ShaderReflection* pReflection);
+
+bool DROP_FindConstantBuffer(
+    const ShaderReflection* pReflection, const char* name, const ShaderConstantBuffer** ppConstantBuffer);
+// Checks the C struct mirroring a cbuffer has its size. Passes when the shader has no resource
+// information to check against, fails when it does and the cbuffer is missing or differs.
+bool DROP_ValidateConstantBuffer(const ShaderReflection* pReflection, const char* name, u32 size);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Math/Matrix.h"
+
+#define CULL_LEAF_SIZE 8
+#define CULL_MAX_TASKS 64
+
+// Planes as (nx, ny, nz, d) with the normal pointing inside, a point p is inside when dot(n, p) + d >= 0.
+typedef struct _Frustum
+{
+    f32 planes[6][4];
+} Frustum;
+
+// BVH node with four children, bounds stored as structure of arrays so one node is tested in one pass.
+// Objects are stored in slot order so every subtree covers the contiguous slot range [first, first + count).
+typedef struct _CullNode
+{
+    f32 minX[4], minY[4], minZ[4];
+    f32 maxX[4], maxY[4], maxZ[4];
+    u32 children[4]; // Node index, or CULL_LEAF.
+    u32 first[4];
+    u32 count[4]; // 0 for an empty child.
+} CullNode;
+
+#define CULL_LEAF 0xFFFFFFFF
+
+typedef struct _CullTask
+{
+    u32 node;
+    u32 child;
+} CullTask;
+
+typedef struct _CullWorld
+{
+    u32 capacity;
+    u32 objectCount;
+    u32 builtCount; // Slots [builtCount, objectCount) were added after the last build and are tested linearly.
+
+    // Axis aligned boxes as center/extent, indexed by slot.
+    f32* pCenterX;
+    f32* pCenterY;
+    f32* pCenterZ;
+    f32* pExtentX;
+    f32* pExtentY;
+    f32* pExtentZ;
+    u32* pObjectOfSlot;
+    u32* pSlotOfObject;
+
+    CullNode* pNodes;
+    u32       nodeCount;
+
+    // Root subtrees handed out to the job system, rebuilt with the tree.
+    CullTask tasks[CULL_MAX_TASKS];
+    u32      taskCount;
+
+    // Surface area heuristic of the tree, used to decide when refitting is no longer good enough.
+    f32  builtCost;
+    f32  currentCost;
+    bool needsRefit;
+
+    // Object ids that survived the last DROP_CullObjects.
+    u32* pVisible;
+    u32  visibleCount;
+
+    void* pMemory;
+} CullWorld;
+
+bool DROP_CreateCullWorld(u32 capacity, CullWorld* pWorld);
+void DROP_DestroyCullWorld(CullWorld* pWorld);
+
+// Returns the object id. New objects are culled linearly until the next rebuild picks them up.
+u32  DROP_CullAddObject(CullWorld* pWorld, const f32 center[3], const f32 extent[3]);
+void DROP_CullSetBounds(CullWorld* pWorld, u32 object, const f32 center[3], const f32 extent[3]);
+// Refits the tree after bounds changed, rebuilds it when it degraded or too many objects are pending.
+void DROP_UpdateCullWorld(CullWorld* pWorld);
+void DROP_RebuildCullWorld(CullWorld* pWorld);
+
+void DROP_ExtractFrustum(const Mat4* pViewProjection, Frustum* pFrustum);
+// Fills pWorld->pVisible with the ids of the objects intersecting the frustum, in slot order.
+void DROP_CullObjects(CullWorld* pWorld, const Frustum* pFrustum);
@@ -0,0 +1,111 @@
+#pragma once
+
+#define ENTITY_CHUNK_SIZE KB(16)
+#define ENTITY_MAX_COMPONENTS 64
+#define ENTITY_MAX_ARCHETYPES 64
+#define ENTITY_ABSENT 0xFFFFFFFF
+
+typedef u32 ComponentId;
+typedef u64 ComponentMask;
+
+#define COMPONENT_BIT(id) (1ull << (id))
+
+typedef struct _EntityId
+{
+    u32 index;
+    u32 generation; // 0 is never handed out, so a zeroed id is always dead.
+} EntityId;
+
+// 16 KB of component data. Every component of the archetype is a contiguous array in the block,
+// followed by the ids of the entities, so a system walks each array linearly.
+typedef struct _EntityChunk
+{
+    u8* pData;
+    u32 count;
+    u32 versions[ENTITY_MAX_COMPONENTS]; // World version of the last write to each component array.
+} EntityChunk;
+
+typedef struct _Archetype
+{
+    ComponentMask mask;
+    u32           capacity; // Entities per chunk.
+    u32           offsets[ENTITY_MAX_COMPONENTS]; // Offset of the component array in the chunk, or ENTITY_ABSENT.
+    u32           entityOffset;
+
+    EntityChunk* pChunks;
+    u32          chunkCount;
+    u32          chunkCapacity;
+} Archetype;
+
+typedef struct _EntityRecord
+{
+    u32 generation;
+    u32 archetype;
+    u32 chunk;
+    u32 row; // Next free record while the entity is dead.
+} EntityRecord;
+
+typedef struct _EntityWorld
+{
+    u32 componentSizes[ENTITY_MAX_COMPONENTS];
+    u32 componentCount;
+
+    Archetype archetypes[ENTITY_MAX_ARCHETYPES];
+    u32       archetypeCount;
+
+    EntityRecord* pRecords;
+    u32           recordCount;
+    u32           recordCapacity;
+    u32           freeRecord;
+
+    // Bumped by every query that writes, chunk versions are compared against it.
+    u32 version;
+
+    // Chunks matched by the last parallel query.
+    EntityChunk** pQueryChunks;
+    Archetype**   pQueryArchetypes;
+    u32           queryCapacity;
+} EntityWorld;
+
+typedef struct _EntityQuery
+{
+    ComponentMask all;  // Components the archetype must have.
+    ComponentMask none; // Components the archetype must not have.
+    ComponentMask write; // Components the system writes, their chunk versions are bumped.
+    // When not zero, only chunks where one of these components was written after sinceVersion are visited.
+    ComponentMask changed;
+    u32           sinceVersion;
+} EntityQuery;
+
+typedef struct _EntityView
+{
+    const Archetype* pArchetype;
+    EntityChunk*     pChunk;
+    u32              count;
+    const EntityId*  pEntities;
+} EntityView;
+
+// Called once per matching chunk. threadIndex comes from the job system for parallel queries.
+typedef void (*EntitySystemFunc)(void* pUserData, const EntityView* pView, u32 threadIndex);
+
+bool DROP_CreateEntityWorld(EntityWorld* pWorld);
+void DROP_DestroyEntityWorld(EntityWorld* pWorld);
+bool DROP_RegisterComponent(EntityWorld* pWorld, u32 size, ComponentId* pId);
+
+// Components start zeroed.
+bool DROP_CreateEntity(EntityWorld* pWorld, ComponentMask mask, EntityId* pEntity);
+void DROP_DestroyEntity(EntityWorld* pWorld, EntityId entity);
+bool DROP_IsEntityAlive(const EntityWorld* pWorld, EntityId entity);
+// Moves the entity to the archetype of the new mask, keeping the components both have.
+bool DROP_SetEntityComponents(EntityWorld* pWorld, EntityId entity, ComponentMask mask);
+
+const void* DROP_ReadComponent(const EntityWorld* pWorld, EntityId entity, ComponentId component);
+// Marks the component array of the entity's chunk as written.
+void* DROP_WriteComponent(EntityWorld* pWorld, EntityId entity, ComponentId component);
+// Component array of a chunk, NULL when the archetype doesn't have it.
+void* DROP_ViewComponent(const EntityView* pView, ComponentId component);
+
+// Visits the matching chunks in archetype order on the calling thread.
+void DROP_QueryEntities(EntityWorld* pWorld, const EntityQuery* pQuery, EntitySystemFunc func, void* pUserData);
+// Visits the matching chunks on the job system, one chunk per job. Systems must only touch their own chunk.
+void DROP_QueryEntitiesParallel(EntityWorld* pWorld, const EntityQuery* pQuery, EntitySystemFunc func, void* pUserData);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Math/Matrix.h"
+#include "Scene/Culling.h"
+
+#define OCCLUSION_TILE_WIDTH 64
+#define OCCLUSION_TILE_HEIGHT 32
+#define OCCLUSION_BLOCK_SIZE 8
+#define OCCLUSION_MAX_TILES 256
+
+// Low resolution CPU depth buffer. A few large occluders are rasterized into it every frame,
+// then object boxes are tested against the farthest occluder depth of every 8x8 block they cover.
+// Depth follows D3D: 0 is near, 1 is far.
+typedef struct _OcclusionBuffer
+{
+    u32 width;
+    u32 height;
+    u32 tilesX;
+    u32 tilesY;
+
+    f32* pDepth;
+    f32* pHiZ; // Max depth of every OCCLUSION_BLOCK_SIZE square.
+
+    Mat4 viewProjection;
+
+    // Screen space triangles of the current frame, 3 vertices of (x, y, z).
+    f32 (*pTriangles)[9];
+    u32 triangleCount;
+    u32 triangleCapacity;
+
+    // Triangle indices binned per tile.
+    u32* pBins;
+    u32  binCounts[OCCLUSION_MAX_TILES];
+
+    void* pMemory;
+} OcclusionBuffer;
+
+// width must be a multiple of OCCLUSION_TILE_WIDTH and height of OCCLUSION_TILE_HEIGHT.
+bool DROP_CreateOcclusionBuffer(u32 width, u32 height, u32 maxTriangles, OcclusionBuffer* pBuffer);
+void DROP_DestroyOcclusionBuffer(OcclusionBuffer* pBuffer);
+
+// Clears the buffer and the occluders of the previous frame.
+void DROP_OcclusionBegin(OcclusionBuffer* pBuffer, const Mat4* pViewProjection);
+// Transforms and bins an indexed triangle list. Triangles crossing the near plane are dropped,
+// which can only make fewer objects occluded.
+void DROP_OcclusionAddOccluder(
+    OcclusionBuffer* pBuffer, const Mat4* pWorld, const f32* positions, const u32* indices, u32 indexCount);
+// Rasterizes the binned occluders, one tile per job, and builds the block max depths.
+void DROP_OcclusionRasterize(OcclusionBuffer* pBuffer);
+
+// Returns false only when the box is fully hidden behind the rasterized occluders.
+bool DROP_OcclusionTestBox(const OcclusionBuffer* pBuffer, const f32 boxMin[3], const f32 boxMax[3]);
+// Removes the occluded objects from the visible list of the last DROP_CullObjects.
+void DROP_OcclusionCullVisible(const OcclusionBuffer* pBuffer, CullWorld* pWorld);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Math/Matrix.h"
+
+#define SCENE_NO_PARENT 0xFFFFFFFF
+#define SCENE_MAX_DEPTH 32
+
+typedef enum _SceneLocal
+{
+    SCENE_LOCAL_POSITION_X,
+    SCENE_LOCAL_POSITION_Y,
+    SCENE_LOCAL_POSITION_Z,
+    SCENE_LOCAL_ROTATION_X,
+    SCENE_LOCAL_ROTATION_Y,
+    SCENE_LOCAL_ROTATION_Z,
+    SCENE_LOCAL_ROTATION_W,
+    SCENE_LOCAL_SCALE_X,
+    SCENE_LOCAL_SCALE_Y,
+    SCENE_LOCAL_SCALE_Z,
+    SCENE_LOCAL_COUNT
+} SceneLocal;
+
+// Transform hierarchy stored as structure of arrays.
+// Nodes are addressed by a stable node id. Internally they live at an index that is re-sorted by depth
+// whenever the structure changes, so every level is one contiguous range and parents come before children.
+typedef struct _Scene
+{
+    u32 count;
+    u32 capacity;
+
+    u32* pIndexOfNode;
+    u32* pNodeOfIndex;
+
+    // Indexed by index.
+    u32*  pParents; // Parent index or SCENE_NO_PARENT.
+    u8*   pDepths;
+    u8*   pDirty;
+    f32*  pLocal[SCENE_LOCAL_COUNT];
+    Mat4* pWorld;
+
+    u32  levelStart[SCENE_MAX_DEPTH + 1];
+    u32  levelCount;
+    bool needsSort;
+    bool hasDirty;
+
+    void* pMemory;
+} Scene;
+
+bool DROP_CreateScene(u32 capacity, Scene* pScene);
+void DROP_DestroyScene(Scene* pScene);
+
+// Adds a node with an identity local transform and returns its id. The parent has to exist already.
+u32 DROP_SceneAddNode(Scene* pScene, u32 parentNode);
+// Sets the local transform (rotation as a unit quaternion xyzw) and marks the node's subtree dirty.
+void DROP_SceneSetLocal(Scene* pScene, u32 node, const f32 position[3], const f32 rotation[4], const f32 scale[3]);
+const Mat4* DROP_SceneGetWorld(const Scene* pScene, u32 node);
+
+// Recomputes the world matrices of the dirty subtrees, level by level, each level split across the job system.
+void DROP_UpdateScene(Scene* pScene);
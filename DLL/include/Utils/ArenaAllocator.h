@@ -1,10 +1,34 @@
 #pragma once
 
+#define ARENA_ALIGNMENT 16
+#define ARENA_MAX_RECORDS 32
+
+#ifdef DEBUG
+// What one callsite or tag holds in an arena since it was last cleared.
+typedef struct _ArenaRecord
+{
+    const char* tag; // NULL for untagged allocations, which are told apart by their callsite.
+    const char* file;
+    i32         line;
+    u32         count;
+    u64         bytes;
+    u64         padding;
+} ArenaRecord;
+#endif // DEBUG
+
 typedef struct _ArenaAllocator
 {
     char* memory;
     u64   size;
     u64   used;
+#ifdef DEBUG
+    u64         highWater;      // Most ever used, clears included.
+    u64         lastClearUsed;  // Used when last cleared, the frame peak of TRANSIENT.
+    u64         padding;        // Lost to the alignment since the last clear.
+    u64         untrackedBytes; // Allocated once the records were full.
+    ArenaRecord records[ARENA_MAX_RECORDS];
+    u32         recordCount;
+#endif // DEBUG
 } ArenaAllocator;
 
 typedef struct _Memory
@@ -28,6 +52,7 @@ static inline bool DROP_MakeArena(ArenaAllocator* pArena, u64 size)
     }
 
     ZERO_MEM(memory, size);
+    ZERO_MEM(pArena, 1);
 
     pArena->memory = memory;
     pArena->size   = size;
@@ -36,18 +61,119 @@ static inline bool DROP_MakeArena(ArenaAllocator* pArena, u64 size)
     return true;
 }
 
-static inline char* DROP_Allocate(ArenaAllocator* pArena, u64 size)
+#ifdef DEBUG
+static inline void _ArenaPrintReport(const ArenaAllocator* pArena, const char* name)
+{
+    _Log("[ARENA]", __FILE__, __LINE__, TEXT_COLOR_BRIGHT_BLUE,
+         "%s: %llu of %llu bytes used, high-water %llu (%.1f%%), last clear at %llu, %llu bytes of padding.",
+         name, pArena->used, pArena->size, pArena->highWater, 100.0 * pArena->highWater / pArena->size,
+         pArena->lastClearUsed, pArena->padding);
+
+    for (u32 i = 0; i < pArena->recordCount; ++i)
+    {
+        const ArenaRecord* pRecord = &pArena->records[i];
+        _Log("[ARENA]", __FILE__, __LINE__, TEXT_COLOR_BRIGHT_BLUE,
+             "  %8llu bytes in %4u allocations, %4llu of padding: %s (%s:%d)",
+             pRecord->bytes, pRecord->count, pRecord->padding, pRecord->tag ? pRecord->tag : "untagged",
+             pRecord->file, pRecord->line);
+    }
+
+    if (pArena->untrackedBytes)
+    {
+        _Log("[ARENA]", __FILE__, __LINE__, TEXT_COLOR_BRIGHT_YELLOW,
+             "  %8llu bytes past the last of %d records.", pArena->untrackedBytes, ARENA_MAX_RECORDS);
+    }
+}
+
+static inline void _ArenaTrack(
+    ArenaAllocator* pArena, u64 size, u64 alignedSize, const char* tag, const char* file, i32 line)
 {
-    u64 allignedSize = (size + 15) & ~15; // Aligned to 16-byte.
+    // Tagged allocations add up under their tag wherever they come from.
+    ArenaRecord* pRecord = NULL;
+    for (u32 i = 0; i < pArena->recordCount && !pRecord; ++i)
+    {
+        ArenaRecord* pCandidate = &pArena->records[i];
+        if (tag ? pCandidate->tag && strcmp(pCandidate->tag, tag) == 0
+                : !pCandidate->tag && pCandidate->line == line && strcmp(pCandidate->file, file) == 0)
+            pRecord = pCandidate;
+    }
+
+    if (!pRecord && pArena->recordCount < ARENA_MAX_RECORDS)
+    {
+        pRecord = &pArena->records[pArena->recordCount++];
+        ZERO_MEM(pRecord, 1);
+        pRecord->tag  = tag;
+        pRecord->file = file;
+        pRecord->line = line;
+    }
+
+    if (pRecord)
+    {
+        ++pRecord->count;
+        pRecord->bytes += alignedSize;
+        pRecord->padding += alignedSize - size;
+    }
+    else
+    {
+        pArena->untrackedBytes += alignedSize;
+    }
+
+    pArena->padding += alignedSize - size;
+    if (pArena->used > pArena->highWater)
+        pArena->highWater = pArena->used;
+}
+#endif // DEBUG
+
+#ifdef DEBUG
+static inline char* _ArenaAllocate(ArenaAllocator* pArena, u64 size, const char* tag, const char* file, i32 line)
+#else
+static inline char* _ArenaAllocate(ArenaAllocator* pArena, u64 size)
+#endif // DEBUG
+{
+    u64 allignedSize = (size + ARENA_ALIGNMENT - 1) & ~(u64) (ARENA_ALIGNMENT - 1);
+
+#ifdef DEBUG
+    if (pArena->used + allignedSize >= pArena->size)
+    {
+        _Log("[ARENA]", __FILE__, __LINE__, TEXT_COLOR_BRIGHT_RED,
+             "Overflow: %llu bytes at %s:%d with %llu of %llu bytes left.", allignedSize, file, line,
+             pArena->size - pArena->used, pArena->size);
+        _ArenaPrintReport(pArena, "Overflowed arena");
+    }
+#endif // DEBUG
     ASSERT_MSG(pArena->used + allignedSize < pArena->size, "The size are greater than remaining memory in arena.");
 
     char* memory = pArena->memory + pArena->used;
     pArena->used += allignedSize;
 
+    DROP_AddCounter(COUNTER_ALLOCATIONS, 1);
+    DROP_AddCounter(COUNTER_ALLOCATED_BYTES, allignedSize);
+#ifdef DEBUG
+    _ArenaTrack(pArena, size, allignedSize, tag, file, line);
+#endif // DEBUG
+
     return memory;
 }
 
+// Tags group allocations by subsystem in the reports, untagged ones are grouped by callsite. Only
+// Debug keeps track of them.
+#ifdef DEBUG
+#define DROP_Allocate(pArena, size) _ArenaAllocate(pArena, size, NULL, __FILE__, __LINE__)
+#define DROP_AllocateTagged(pArena, size, tag) _ArenaAllocate(pArena, size, tag, __FILE__, __LINE__)
+#define PRINT_ARENA_REPORT(pArena, name) _ArenaPrintReport(pArena, name)
+#else
+#define DROP_Allocate(pArena, size) _ArenaAllocate(pArena, size)
+#define DROP_AllocateTagged(pArena, size, tag) _ArenaAllocate(pArena, size)
+#define PRINT_ARENA_REPORT(pArena, name)
+#endif // DEBUG
+
 static inline void DROP_ClearArena(ArenaAllocator* pArena)
 {
+#ifdef DEBUG
+    pArena->lastClearUsed  = pArena->used;
+    pArena->padding        = 0;
+    pArena->untrackedBytes = 0;
+    pArena->recordCount    = 0;
+#endif // DEBUG
     pArena->used = 0;
 }
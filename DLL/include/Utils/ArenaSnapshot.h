@@ -0,0 +1,42 @@
+#pragma once
+
+// Self-relative pointer, the distance from the field to its target or 0 for null. Data linked with
+// them holds no address, it stays valid wherever it is copied to as a whole.
+typedef i64 RelPtr;
+
+static inline void DROP_SetRelPtr(RelPtr* pField, const void* pTarget)
+{
+    ASSERT_MSG(pField, "Field pointer is null.");
+    ASSERT_MSG(pTarget != (const void*) pField, "A relative pointer can't point to itself.");
+
+    *pField = pTarget ? (i64) ((const char*) pTarget - (const char*) pField) : 0;
+}
+
+static inline void* DROP_GetRelPtr(const RelPtr* pField)
+{
+    ASSERT_MSG(pField, "Field pointer is null.");
+
+    return *pField ? (void*) ((const char*) pField + *pField) : NULL;
+}
+
+#define ARENA_SNAPSHOT_MAGIC 0x504E5341 // "ASNP"
+
+typedef struct _ArenaSnapshotHeader
+{
+    u32 magic;
+    u32 version;    // Layout of the data, bumped whenever a struct in it changes.
+    u64 sourceHash; // Whatever the data was derived from, e.g. the timestamps of its files.
+    u64 size;
+    u64 dataHash;   // Catches truncated and corrupt files.
+} ArenaSnapshotHeader;
+
+// Snapshots hold the part of an arena allocated since begin, a value of pArena->used taken before
+// building the data. Pointers inside it must be RelPtr, pointers out of it or to device objects
+// can't be saved. The first allocation of the region is the root of the data.
+bool DROP_SaveArenaSnapshot(
+    const char* fileName, const ArenaAllocator* pArena, u64 begin, u32 version, u64 sourceHash);
+// Reads the region back into pArena in a single read, nothing needs fixing up. Fails when the file is
+// missing, was saved with another version or source hash, or doesn't fit, and leaves the arena as it
+// was, the caller then builds the data from scratch and saves it again.
+bool DROP_LoadArenaSnapshot(
+    const char* fileName, ArenaAllocator* pArena, u32 version, u64 sourceHash, char** ppRoot);
@@ -0,0 +1,51 @@
+#pragma once
+
+#define COUNTER_MAX_THREADS 64
+#define COUNTER_HISTORY_FRAMES 256 // Power of two.
+
+// Counters are summed over the frame, gauges keep the last value set.
+typedef enum _CounterId
+{
+    COUNTER_DRAW_CALLS,
+    COUNTER_STATE_CHANGES,
+    COUNTER_UPLOADED_BYTES, // Written through Map and UpdateSubresource.
+    COUNTER_ALLOCATIONS,
+    COUNTER_ALLOCATED_BYTES,
+    COUNTER_FILE_BYTES_READ,
+    COUNTER_PERSISTENT_BYTES_USED, // Gauge.
+    COUNTER_TRANSIENT_BYTES_USED,  // Gauge.
+    COUNTER_COUNT
+} CounterId;
+
+typedef enum _CounterKind
+{
+    COUNTER_KIND_COUNTER,
+    COUNTER_KIND_GAUGE
+} CounterKind;
+
+typedef enum _CounterFormat
+{
+    COUNTER_FORMAT_CSV,
+    COUNTER_FORMAT_JSON
+} CounterFormat;
+
+typedef struct _CounterSnapshot
+{
+    u64 frame;
+    u64 values[COUNTER_COUNT];
+} CounterSnapshot;
+
+// Any thread, no lock is taken. Each thread adds into its own shard, the shards are only summed
+// when the frame ends.
+void DROP_AddCounter(CounterId id, u64 value);
+void DROP_SetGauge(CounterId id, u64 value);
+
+const char* DROP_GetCounterName(CounterId id);
+CounterKind DROP_GetCounterKind(CounterId id);
+
+// Main thread, once per frame. Pushes the values of the frame into the history.
+void DROP_CountersEndFrame();
+// 0 is the last completed frame. Returns NULL past the recorded history.
+const CounterSnapshot* DROP_GetCounterSnapshot(u32 framesAgo);
+// Writes the history from the oldest to the newest frame.
+bool DROP_ExportCounters(const char* fileName, CounterFormat format);
@@ -0,0 +1,29 @@
+#pragma once
+
+#define FRAME_ARENA_MAX_COUNT 8
+
+// Ring of arenas for data that outlives the frame it is written in, e.g. what async work or the GPU
+// reads a few frames later. Frame f allocates from arena f % count, which is only cleared once the
+// frame fence reports every frame that uses its memory as complete. Frames are numbered like the
+// frame fence, from 1.
+typedef struct _FrameArenas
+{
+    ArenaAllocator arenas[FRAME_ARENA_MAX_COUNT];
+    u64            lastUseFrames[FRAME_ARENA_MAX_COUNT]; // Last frame reading the memory of each arena.
+    u32            count;
+    u64            frameIndex; // Frame being built, 0 before the first begin.
+} FrameArenas;
+
+// count is the frames in flight plus the one being built, then frames that allocate for themselves
+// only never wait.
+bool DROP_MakeFrameArenas(FrameArenas* pArenas, u32 count, u64 sizePerFrame);
+void DROP_DestroyFrameArenas(FrameArenas* pArenas);
+
+// Main thread, before anything is allocated for frameIndex (the next DROP_FrameFenceSignal). Clears
+// its arena and returns true once completedFrame (from DROP_FrameFencePoll) covers every frame still
+// reading it, returns false and changes nothing otherwise.
+bool DROP_BeginFrameArenas(FrameArenas* pArenas, u64 frameIndex, u64 completedFrame);
+// Main thread. Memory that stays valid until frame frameIndex + framesAhead is complete, 0 for data
+// only the current frame reads. framesAhead must be below the count, anything past the frames in
+// flight makes a later frame wait on the GPU before it can begin.
+char* DROP_AllocateFrame(FrameArenas* pArenas, u64 size, u32 framesAhead);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Platform/Thread.h"
+
+#define FRAME_ENCODER_QUEUE_LENGTH 4
+#define FRAME_ENCODER_NAME_LENGTH 128
+
+typedef enum _FrameEncoding
+{
+    FRAME_ENCODING_PFM, // RGB floats, one file per frame.
+    FRAME_ENCODING_PPM, // 8-bit sRGB, one file per frame, values past 1 are clipped.
+    FRAME_ENCODING_RAW  // The halves as they are, every frame appended to one file.
+} FrameEncoding;
+
+// Written ahead of every frame of a raw file, the pixels follow it.
+#define FRAME_ENCODER_RAW_MAGIC 0x46524448 // "HDRF"
+
+typedef struct _RawFrameHeader
+{
+    u32 magic;
+    u32 width;
+    u32 height;
+    u32 padding;
+    u64 frameIndex;
+} RawFrameHeader;
+
+// Four halves per pixel, rows tightly packed.
+typedef struct _EncoderFrame
+{
+    u16* pPixels;
+    u32  width;
+    u32  height;
+    u64  frameIndex;
+} EncoderFrame;
+
+typedef struct _FrameEncoderDesc
+{
+    const char*   fileName; // Without extension, files of single frames get their number appended.
+    FrameEncoding encoding;
+    u32           maxWidth;
+    u32           maxHeight;
+} FrameEncoderDesc;
+
+// Converts and writes RGBA16F frames on a thread of its own, the frames given to it are copied into a
+// queue of buffers allocated up front. Only the thread that creates it hands it frames.
+typedef struct _FrameEncoder
+{
+    char          fileName[FRAME_ENCODER_NAME_LENGTH];
+    FrameEncoding encoding;
+    u32           maxWidth;
+    u32           maxHeight;
+    EncoderFrame  frames[FRAME_ENCODER_QUEUE_LENGTH];
+    Atomic32      submitCount; // Written by the submitting thread only.
+    Atomic32      encodeCount; // Written by the encoder thread only.
+    Atomic32      isFailed;
+    Thread        thread;
+    Semaphore     semaphore; // One count per submitted frame, one more to stop.
+    FILE*         pRawFile;
+    f32*          pRow;      // A row of the frame being encoded as floats.
+    u64           droppedCount;
+    u64           bytesWritten;
+    u64           encodeTicks;
+} _FrameEncoder;
+
+typedef _FrameEncoder* FrameEncoder;
+
+bool DROP_CreateFrameEncoder(const FrameEncoderDesc* pDesc, FrameEncoder* pEncoder);
+// Encodes whatever was submitted before returning.
+void DROP_DestroyFrameEncoder(FrameEncoder* pEncoder);
+
+// A free frame to fill, NULL when the queue is full or the frame is too large. The frame is dropped
+// then, the caller never waits on the disk.
+EncoderFrame* DROP_AcquireEncoderFrame(FrameEncoder encoder, u32 width, u32 height, u64 frameIndex);
+// Hands the last acquired frame to the encoder thread.
+void DROP_SubmitEncoderFrame(FrameEncoder encoder);
+// Waits until every submitted frame is written.
+void DROP_FlushFrameEncoder(FrameEncoder encoder);
+
+// Any thread, no device needed. Converts and writes one frame, pRow holds width * 4 floats.
+bool DROP_EncodeFrame(FILE* file, FrameEncoding encoding, const EncoderFrame* pFrame, f32* pRow, u64* pBytesWritten);
+void DROP_PrintFrameEncoderStats(FrameEncoder encoder);
@@ -0,0 +1,15 @@
+#pragma once
+
+// Processes the items [begin, end). threadIndex is 0 for the calling thread and 1..N for the workers,
+// so it can index per-thread scratch memory.
+typedef void (*JobFunc)(void* pUserData, u32 begin, u32 end, u32 threadIndex);
+
+// Starts the worker threads. A workerCount of 0 uses one worker per core minus the calling thread.
+bool DROP_CreateJobSystem(u32 workerCount);
+void DROP_DestroyJobSystem();
+// Number of threads that can run a job, the calling thread included.
+u32 DROP_GetJobThreadCount();
+
+// Splits [0, count) in batches of batchSize items and runs them on the workers and the calling thread.
+// Returns once every batch is done. Runs inline when the job system was not created.
+void DROP_ParallelFor(u32 count, u32 batchSize, JobFunc func, void* pUserData);
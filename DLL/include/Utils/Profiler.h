@@ -0,0 +1,48 @@
+#pragma once
+
+#define PROFILE_MAX_ZONES 128
+#define PROFILE_MAX_THREADS 64
+#define PROFILE_NO_PARENT 0xFFFFFFFF
+
+// Zones only exist when PROFILE is defined, otherwise the macros compile to nothing.
+// Names must outlive the profiler, use string literals.
+#ifdef PROFILE
+#define PROFILE_BEGIN(name) DROP_ProfileBegin(name)
+#define PROFILE_END() DROP_ProfileEnd()
+// Times the statement or block that follows, leaving it with break or return skips the end.
+#define PROFILE_SCOPE(name) \
+    for (int _profileScope = (DROP_ProfileBegin(name), 0); !_profileScope; _profileScope = (DROP_ProfileEnd(), 1))
+#else
+#define PROFILE_BEGIN(name)
+#define PROFILE_END()
+#define PROFILE_SCOPE(name)
+#endif // PROFILE
+
+// A node of the zone tree, the same name under another parent is another zone.
+// Times are for the last completed frame, summed over every call and thread.
+typedef struct _ProfileZone
+{
+    const char* name;
+    u32         parent; // Index of the parent zone or PROFILE_NO_PARENT.
+    u32         depth;
+    u32         callCount;
+    u64         inclusiveTicks;
+    u64         selfTicks; // Inclusive minus the time spent in child zones.
+} ProfileZone;
+
+bool DROP_CreateProfiler();
+void DROP_DestroyProfiler();
+
+// Any thread. Events go to a buffer owned by the calling thread, no lock is taken.
+void DROP_ProfileBegin(const char* name);
+void DROP_ProfileEnd();
+
+// Main thread, once per frame outside any zone. Folds the events of every thread into the zone
+// tree and feeds the trace when one is recording.
+void DROP_ProfileEndFrame();
+const ProfileZone* DROP_GetProfileZones(u32* pCount);
+void DROP_PrintProfileZones();
+
+// Records the next frameCount frames and writes them to fileName as Chrome trace JSON,
+// which chrome://tracing and Perfetto open.
+bool DROP_BeginProfileTrace(const char* fileName, u32 frameCount);
@@ -0,0 +1,27 @@
+#pragma once
+
+#define RADIX_SORT_MAX_BLOCKS 32
+
+// Stable LSD radix sort of 64-bit keys carrying a 32-bit value each, a byte per pass. The count
+// is split in blocks that the job system histograms and scatters in parallel, a pass is skipped
+// when that byte is the same in every key.
+typedef struct _RadixSort
+{
+    u64* pKeys;
+    u32* pValues;
+    u64* pScratchKeys;
+    u32* pScratchValues;
+    u32  maxCount;
+
+    // Digit counts, one row per block.
+    u32 (*pHistograms)[256];
+    u32 blockCount;
+    u32 blockSize;
+} RadixSort;
+
+bool DROP_MakeRadixSort(RadixSort* pSort, u32 maxCount);
+void DROP_DestroyRadixSort(RadixSort* pSort);
+
+// Main thread. Sorts the first count keys and values in place, equal keys keep their order. Only the
+// arrays move, pKeys and pValues may point elsewhere afterwards.
+void DROP_RadixSort(RadixSort* pSort, u32 count);
@@ -0,0 +1,106 @@
+#pragma once
+
+// Linear suballocator over a fixed size ring, e.g. a dynamic GPU buffer.
+// It only hands out offsets, it never touches the memory itself, so it can be used without a device.
+// head and tail are monotonic byte counters, the real offset is the counter modulo the size.
+
+#define RING_MAX_PENDING_FRAMES 8
+
+typedef struct _RingFrame
+{
+    u64 frameIndex;
+    u64 end; // head when the frame was closed.
+} RingFrame;
+
+typedef struct _RingAllocator
+{
+    u64 size;
+    u64 head;
+    u64 tail;
+
+    RingFrame pendingFrames[RING_MAX_PENDING_FRAMES];
+    u32       pendingFirst;
+    u32       pendingCount;
+} RingAllocator;
+
+static inline void DROP_MakeRing(RingAllocator* pRing, u64 size)
+{
+    ASSERT_MSG(pRing, "Ring pointer is null.");
+    ASSERT_MSG(size > 0, "Size must be greater than zero.");
+
+    ZERO_MEM(pRing, 1);
+    pRing->size = size;
+}
+
+// Reserves size bytes aligned to alignment (power of two). Returns false when the ring is full,
+// which means the GPU is still reading everything that would be overwritten.
+static inline bool DROP_RingAllocate(RingAllocator* pRing, u64 size, u64 alignment, u64* pOffset)
+{
+    ASSERT_MSG(pRing, "Ring pointer is null.");
+    ASSERT_MSG(pOffset, "Offset pointer is null.");
+    ASSERT_MSG(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two.");
+
+    if (size > pRing->size)
+        return false;
+
+    u64 head    = pRing->head;
+    u64 offset  = head % pRing->size;
+    u64 aligned = (offset + alignment - 1) & ~(alignment - 1);
+    head += aligned - offset;
+
+    // Allocations never straddle the end of the ring, skip the leftover and start over at zero.
+    if (aligned + size > pRing->size)
+    {
+        head += pRing->size - aligned;
+        aligned = 0;
+    }
+
+    if (head + size - pRing->tail > pRing->size)
+        return false;
+
+    pRing->head = head + size;
+    *pOffset    = aligned;
+
+    return true;
+}
+
+// Marks everything allocated so far as used by frameIndex. With RING_MAX_PENDING_FRAMES already in
+// flight, the newest pending frame is extended to frameIndex instead and false is returned: its memory
+// is then only released once frameIndex completes, later than needed but never too early.
+static inline bool DROP_RingEndFrame(RingAllocator* pRing, u64 frameIndex)
+{
+    ASSERT_MSG(pRing, "Ring pointer is null.");
+
+    if (pRing->pendingCount == RING_MAX_PENDING_FRAMES)
+    {
+        u32 newest = (pRing->pendingFirst + pRing->pendingCount - 1) % RING_MAX_PENDING_FRAMES;
+        pRing->pendingFrames[newest].frameIndex = frameIndex;
+        pRing->pendingFrames[newest].end        = pRing->head;
+        return false;
+    }
+
+    u32 slot = (pRing->pendingFirst + pRing->pendingCount) % RING_MAX_PENDING_FRAMES;
+
+    pRing->pendingFrames[slot].frameIndex = frameIndex;
+    pRing->pendingFrames[slot].end        = pRing->head;
+    ++pRing->pendingCount;
+
+    return true;
+}
+
+// Releases the memory of every frame up to and including completedFrame.
+static inline void DROP_RingRetireFrames(RingAllocator* pRing, u64 completedFrame)
+{
+    ASSERT_MSG(pRing, "Ring pointer is null.");
+
+    while (pRing->pendingCount > 0)
+    {
+        const RingFrame* pFrame = &pRing->pendingFrames[pRing->pendingFirst];
+        if (pFrame->frameIndex > completedFrame)
+            break;
+
+        pRing->tail         = pFrame->end;
+        pRing->pendingFirst = (pRing->pendingFirst + 1) % RING_MAX_PENDING_FRAMES;
+        --pRing->pendingCount;
+    }
+}
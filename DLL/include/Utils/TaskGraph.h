@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Platform/Thread.h"
+
+#define TASK_GRAPH_MAX_TASKS 32
+#define TASK_GRAPH_MAX_DEPENDENCIES 16
+#define TASK_GRAPH_MAX_THREADS 64
+
+typedef bool (*TaskFunc)(void* pUserData);
+typedef void (*TaskCleanupFunc)(void* pUserData);
+
+typedef struct _TaskDesc
+{
+    const char*     name; // Must outlive the graph, use string literals.
+    TaskFunc        Run;
+    TaskCleanupFunc Cleanup; // Undoes Run, NULL when there is nothing to undo.
+    void*           pUserData;
+    // For the window, the arenas and the tracked allocations, none of them take a lock. Main thread
+    // tasks never overlap each other.
+    bool isMainThread;
+} TaskDesc;
+
+typedef enum _TaskState
+{
+    TASK_STATE_PENDING,
+    TASK_STATE_RUNNING,
+    TASK_STATE_DONE,
+    TASK_STATE_FAILED
+} TaskState;
+
+typedef struct _Task
+{
+    TaskDesc desc;
+    u32      dependencies[TASK_GRAPH_MAX_DEPENDENCIES];
+    u32      dependencyCount;
+    Atomic32 state;
+    u32      threadIndex;
+    u64      startTicks;
+    u64      endTicks;
+} Task;
+
+// Work that runs once, like startup, as tasks that start as soon as the ones they depend on are done.
+typedef struct _TaskGraph
+{
+    Task      tasks[TASK_GRAPH_MAX_TASKS];
+    u32       taskCount;
+    u32       doneOrder[TASK_GRAPH_MAX_TASKS]; // Cleanup goes through it backwards.
+    Atomic32  doneCount;
+    Atomic32  isFailed;
+    Semaphore wakeSemaphores[TASK_GRAPH_MAX_THREADS]; // Per thread, signaled whenever a task ends.
+    u64       startTicks;
+    u64       endTicks;
+} TaskGraph;
+
+void DROP_InitTaskGraph(TaskGraph* pGraph);
+// Dependencies are ids given by earlier calls, so the graph can't have a cycle.
+bool DROP_AddTask(
+    TaskGraph* pGraph, const TaskDesc* pDesc, const u32* pDependencies, u32 dependencyCount, u32* pTaskId);
+// Main thread. Runs the tasks on the job system workers and the calling thread. When a task fails
+// no other one starts, the running ones finish and every done task is cleaned up before returning.
+bool DROP_RunTaskGraph(TaskGraph* pGraph);
+// Cleans up the done tasks in reverse completion order, dependents before what they depend on.
+void DROP_CleanupTaskGraph(TaskGraph* pGraph);
+// Start and end of every task relative to the start of the run, and the thread it ran on.
+void DROP_PrintTaskGraph(const TaskGraph* pGraph);
@@ -2,11 +2,37 @@
 #include "EntryPoint.h"
 
 #include "Platform/Window.h"
+#include "Platform/FrameTiming.h"
+#include "Platform/Timer.h"
 #include "Graphics/Graphics.h"
+#include "Graphics/PipelineState.h"
+#include "Graphics/InputLayoutCache.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/RenderQueue.h"
+#include "Graphics/CommandCapture.h"
+#include "Graphics/DynamicResolution.h"
+#include "Graphics/RenderTargetPool.h"
+#include "Graphics/Bloom.h"
+#include "Graphics/FrameFence.h"
+#include "Graphics/GpuTimer.h"
+#include "Graphics/ImageCapture.h"
+#include "Graphics/BatchRenderer.h"
 
-#include "Resources/Shaders.h"
 #include "Resources/Mesh.h"
 
+#include "Utils/JobSystem.h"
+#include "Utils/Profiler.h"
+#include "Utils/TaskGraph.h"
+#include "Utils/FrameArenas.h"
+#include "Utils/FrameEncoder.h"
+
+#include "Scene/Entity.h"
+#include "Scene/Scene.h"
+#include "Scene/Culling.h"
+#include "Scene/Occlusion.h"
+
+#include <math.h>
+
 #pragma region GLOBAL_MEMORY
 static bool InitializeGlobalMemory(u64 size);
 static void CleanupGlobalMemory();
@@ -15,69 +41,252 @@ static void CleanupGlobalMemory();
 #pragma region CORE
 static bool      InitializeCore();
 static void      CleanupCore();
-static WndHandle s_wndHandle = NULL;
-static GfxHandle s_gfxHandle = NULL;
-static bool      s_isRunning = true;
+static bool      InitializeWindow(void* pUserData);
+static void      CleanupWindow(void* pUserData);
+static bool      InitializeGraphics(void* pUserData);
+static void      CleanupGraphics(void* pUserData);
+static bool      InitializeCaches(void* pUserData);
+static void      CleanupCaches(void* pUserData);
+static bool      InitializeFrameResources(void* pUserData);
+static void      CleanupFrameResources(void* pUserData);
+static bool      ApplyResize();
+static WndHandle           s_wndHandle        = NULL;
+static GfxHandle           s_gfxHandle        = NULL;
+static GfxPipelineCache    s_pipelineCache    = NULL;
+static GfxInputLayoutCache s_inputLayoutCache = NULL;
+static GfxShaderCache      s_shaderCache      = NULL;
+static RenderQueue         s_renderQueue      = NULL;
+static GfxFrameFence       s_frameFence;
+static GfxGpuTimer         s_gpuTimer;
+static FrameArenas         s_frameArenas;
+static bool                s_isRunning        = true;
+static bool                s_isResizePending  = false;
+static FrameTiming         s_frameTiming;
 #pragma endregion CORE
 
 #pragma region RESOURCES
-static bool                 InitializeViewports();
-static bool                 InitializeShadersAndMeshes();
-static void                 CleanupShadersAndMeshes();
-static bool                 InitializeRenderTargets();
-static void                 CleanupRenderTargets();
+static bool                 InitializeViewports(void* pUserData);
+static void                 UpdateViewports(u32 width, u32 height);
+static bool                 InitializeShadersAndMeshes(void* pUserData);
+static void                 CleanupShadersAndMeshes(void* pUserData);
+static bool                 InitializeBatch(void* pUserData);
+static void                 CleanupBatch(void* pUserData);
+static bool                 InitializeSprites(void* pUserData);
+static void                 CleanupSprites(void* pUserData);
+static bool                 InitializeRenderTargets(void* pUserData);
+static bool                 AcquireRenderTargets(u32 width, u32 height);
+static void                 CleanupRenderTargets(void* pUserData);
 static D3D11_VIEWPORT*      s_viewportTable       = NULL;
 static f32*                 s_viewportDivider     = NULL;
-static ID3D11VertexShader** s_pVSTable            = NULL;
-static ID3D11PixelShader**  s_pPSTable            = NULL;
-static ID3D11Buffer*        s_pTriangleVB         = NULL;
-static ID3D11InputLayout*   s_pBasicVSLayout      = NULL;
 static GfxRenderTarget*     s_renderTargetsTable  = NULL;
 static u32*                 s_renderTargetDivider = NULL;
-#define VIEWPORT_TABLE_COUNT 3
-#define VS_TABLE_COUNT 2
-#define PS_TABLE_COUNT 4
-#define RENDER_TARGET_TABLE_COUNT 6
-#define VIEWPORT_FULLSIZE_INDEX 0
-#define VIEWPORT_HALFSIZE_INDEX 1
-#define VIEWPORT_QUARTERSIZE_INDEX 2
+static DXGI_FORMAT*         s_renderTargetFormat  = NULL;
+static GfxRenderTargetPool  s_renderTargetPool    = NULL;
+static f32                  s_renderScale         = 1.0f;
+static u32                  s_bloomLevelCount     = BLOOM_DEFAULT_LEVELS;
+static EntityWorld          s_entityWorld;
+static ComponentId          s_meshComponent;
+static ComponentId          s_materialComponent;
+static BatchRenderer        s_batchRenderer       = NULL;
+static Scene                s_spriteScene;
+static CullWorld            s_spriteCullWorld; // Object i is sprite i.
+static OcclusionBuffer      s_spriteOcclusion;
+#define VIEWPORT_TABLE_COUNT (VIEWPORT_BLOOM_INDEX + BLOOM_MAX_LEVELS)
+#define RENDER_TARGET_TABLE_COUNT (BLOOM_UP_RENDER_TARGET_INDEX + BLOOM_MAX_LEVELS)
+#define VIEWPORT_COMPOSITE_INDEX 0
+#define VIEWPORT_SCENE_INDEX 1
+#define VIEWPORT_BLOOM_INDEX 2 // First of BLOOM_MAX_LEVELS, one per level of the chain.
 #define HDR_RENDER_TARGET_INDEX 0
-#define BRIGHTPASS_RENDER_TARGET_INDEX 1
-#define BLOOM0_LARGE_RENDER_TARGET_INDEX 2
-#define BLOOM1_LARGE_RENDER_TARGET_INDEX 3
-#define BLOOM0_MEDIUM_RENDER_TARGET_INDEX 4
-#define BLOOM1_MEDIUM_RENDER_TARGET_INDEX 5
-#define BASIC_VS_INDEX 0
-#define BASIC_PS_INDEX 0
-#define COPY_VS_INDEX 1
-#define COPY_PS_INDEX 1
-#define BRIGHTPASS_PS_INDEX 2
-#define BLOOM_PS_INDEX 3
+#define BLOOM_BLUR_RENDER_TARGET_INDEX 1
+#define BLOOM_DOWN_RENDER_TARGET_INDEX 2 // First of BLOOM_MAX_LEVELS, level 0 holds the bright pass.
+#define BLOOM_UP_RENDER_TARGET_INDEX (BLOOM_DOWN_RENDER_TARGET_INDEX + BLOOM_MAX_LEVELS)
 #define TRIANGLE_VB_STRIDE 24
-
+#define RENDER_QUEUE_CAPACITY 4096
+#define BATCH_MAX_INSTANCES 1024
+#define SPRITE_RING_COUNT 8
+#define SPRITES_PER_RING 32
+#define SPRITE_COUNT (SPRITE_RING_COUNT * SPRITES_PER_RING)
+#define SPRITE_NODE_COUNT (1 + SPRITE_RING_COUNT + SPRITE_COUNT)
+#define SPRITE_ROOT_NODE 0 // Nodes are numbered in the order they are added: the root, the rings, the sprites.
+#define SPRITE_FIRST_RING_NODE 1
+#define SPRITE_FIRST_NODE (SPRITE_FIRST_RING_NODE + SPRITE_RING_COUNT)
+#define SPRITE_SIZE 0.04f
+#define SPRITE_ORBIT_RADIUS 0.9f // The rings sweep past the top and bottom edges, out of the frustum.
+#define SPRITE_RING_RADIUS 0.2f
+#define SPRITE_ORBIT_SPEED 0.25f // Radians per second.
+#define SPRITE_SPIN_SPEED 1.0f
+#define SPRITE_DEPTH 0.5f
+#define SPRITE_OCCLUSION_WIDTH 256
+#define SPRITE_OCCLUSION_HEIGHT 128
+#define PANEL_WIDTH 1.2f // A bar in front of the sprites, over the bottom of the orbit.
+#define PANEL_HEIGHT 0.3f
+#define PANEL_CENTER_Y -0.75f
+#define PANEL_DEPTH -0.25f
+#define OPAQUE_PASS 0
+#define FRAME_ARENA_SIZE (RENDER_QUEUE_CAPACITY * sizeof(RenderPacket) + KB(64)) // Mostly render queue packets.
+#define CAPTURE_FILE_NAME "Frame.dxcp"
+#define TRACE_FILE_NAME "Frame.json"
+#define HDR_CAPTURE_FILE_NAME "HdrCapture"
+
+// Shared by both blur directions, the direction is a permutation of bloom.hlsl.
 typedef struct
 {
-    f32 weights[4];
-    f32 texelSize[2];
+    f32 taps[GAUSSIAN_MAX_TAPS][4]; // Weight, offset and padding.
     f32 weightCenter;
-    i32 horizontal;
+    u32 tapCount;
+    f32 padding[2];
 } BloomParams;
 
+typedef struct
+{
+    f32 uvScale[2];
+    f32 bloomIntensity;
+    f32 padding;
+} ViewParams;
+
 typedef struct
 {
     f32 intensity;
     f32 padding[3];
 } IntensityParams;
+
+typedef struct
+{
+    ID3D11Buffer*      pVertexBuffer;
+    ID3D11InputLayout* pInputLayout; // Owned by the input layout cache.
+    u32                stride;
+    u32                vertexCount;
+    u32                id;
+} MeshComponent;
+
+typedef struct
+{
+    const GfxPipelineState* pPipeline;
+    ID3D11Buffer*           pConstantBuffer;
+    u32                     id;
+} MaterialComponent;
+#pragma endregion
+
+#pragma region STARTUP
+static bool BuildStartupGraph(TaskGraph* pGraph);
+static bool LoadShader(void* pUserData);
+static void ReleaseShader(void* pUserData);
+static bool CreateShaders(void* pUserData);
+static bool InitializePostResources(void* pUserData);
+static void CleanupPostResources(void* pUserData);
+static bool InitializePostPipelines(void* pUserData);
+#define BASIC_VS_SHADER_INDEX 0
+#define BASIC_PS_SHADER_INDEX 1
+#define COPY_VS_SHADER_INDEX 2
+#define COPY_PS_SHADER_INDEX 3
+#define BRIGHT_PASS_SHADER_INDEX 4
+#define DOWNSAMPLE_SHADER_INDEX 5
+#define UPSAMPLE_SHADER_INDEX 6
+#define BLOOM_HORIZONTAL_SHADER_INDEX 7
+#define BLOOM_VERTICAL_SHADER_INDEX 8
+#define BATCH_VS_SHADER_INDEX 9
+#define BATCH_PS_SHADER_INDEX 10
+#define SHADER_LOAD_COUNT 11
+
+typedef struct
+{
+    const char*     taskName;
+    GfxShaderStage  stage;
+    GfxShaderDesc   desc;
+    GfxShaderBinary binary;
+} ShaderLoad;
+
+// Every variant the startup creates, read and reflected on the workers while the window and the device
+// come up. Full screen passes draw a generated triangle without an input layout, the batch steps its
+// layout per instance, each shader only checks the cbuffer it reads and the blur direction is a
+// permutation of bloom.hlsl.
+static ShaderLoad s_shaderLoads[SHADER_LOAD_COUNT] = {
+    [BASIC_VS_SHADER_INDEX] = {
+        .taskName = "LoadBasicVS",
+        .stage    = GFX_SHADER_STAGE_VERTEX,
+        .desc     = {.name = "basic"}},
+    [BASIC_PS_SHADER_INDEX] = {
+        .taskName = "LoadBasicPS",
+        .stage    = GFX_SHADER_STAGE_PIXEL,
+        .desc     = {.name = "basic", .cbufferName = "IntensityParams", .cbufferSize = sizeof(IntensityParams)}},
+    [COPY_VS_SHADER_INDEX] = {
+        .taskName = "LoadCopyVS",
+        .stage    = GFX_SHADER_STAGE_VERTEX,
+        .desc     = {.name = "copy", .cbufferName = "ViewParams", .cbufferSize = sizeof(ViewParams)}},
+    [COPY_PS_SHADER_INDEX] = {
+        .taskName = "LoadCopyPS",
+        .stage    = GFX_SHADER_STAGE_PIXEL,
+        .desc     = {.name = "copy", .cbufferName = "ViewParams", .cbufferSize = sizeof(ViewParams)}},
+    [BRIGHT_PASS_SHADER_INDEX] = {
+        .taskName = "LoadBrightPassPS",
+        .stage    = GFX_SHADER_STAGE_PIXEL,
+        .desc     = {.name = "brightpass"}},
+    [DOWNSAMPLE_SHADER_INDEX] = {
+        .taskName = "LoadDownsamplePS",
+        .stage    = GFX_SHADER_STAGE_PIXEL,
+        .desc     = {.name = "downsample"}},
+    [UPSAMPLE_SHADER_INDEX] = {
+        .taskName = "LoadUpsamplePS",
+        .stage    = GFX_SHADER_STAGE_PIXEL,
+        .desc     = {.name = "upsample"}},
+    [BLOOM_HORIZONTAL_SHADER_INDEX] = {
+        .taskName = "LoadBloomHorizontalPS",
+        .stage    = GFX_SHADER_STAGE_PIXEL,
+        .desc     = {.name = "bloom", .cbufferName = "BloomParams", .cbufferSize = sizeof(BloomParams)}},
+    [BLOOM_VERTICAL_SHADER_INDEX] = {
+        .taskName = "LoadBloomVerticalPS",
+        .stage    = GFX_SHADER_STAGE_PIXEL,
+        .desc     = {
+            .name        = "bloom",
+            .defines     = "BLOOM_VERTICAL",
+            .cbufferName = "BloomParams",
+            .cbufferSize = sizeof(BloomParams)}},
+    [BATCH_VS_SHADER_INDEX] = {
+        .taskName = "LoadBatchVS",
+        .stage    = GFX_SHADER_STAGE_VERTEX,
+        .desc     = {.name = "batch", .inputClass = D3D11_INPUT_PER_INSTANCE_DATA}},
+    [BATCH_PS_SHADER_INDEX] = {
+        .taskName = "LoadBatchPS",
+        .stage    = GFX_SHADER_STAGE_PIXEL,
+        .desc     = {.name = "batch"}}};
+
+static ID3D11SamplerState*     s_pLinearSampler           = NULL;
+static ID3D11Buffer*           s_pBloomCBuffer            = NULL;
+static ID3D11Buffer*           s_pViewCBuffer             = NULL;
+static ViewParams              s_viewParams;
+static const GfxPipelineState* s_pBrightPassPipeline      = NULL;
+static const GfxPipelineState* s_pBloomHorizontalPipeline = NULL;
+static const GfxPipelineState* s_pBloomVerticalPipeline   = NULL;
+static const GfxPipelineState* s_pDownsamplePipeline      = NULL;
+static const GfxPipelineState* s_pUpsamplePipeline        = NULL;
+static const GfxPipelineState* s_pCopyPipeline            = NULL;
 #pragma endregion
 
 #pragma region ENTRYPOINT
-static void RenderBloomPass(
-    const GfxRenderTarget* pCurrent, const GfxRenderTarget* pFormer, i32 horizontal,
-    ID3D11ShaderResourceView* pNullSRV, ID3D11Buffer* pBloomCBuffer, const f32* clearColor);
+static void UploadBlurKernel(const GaussianKernel* pKernel, ID3D11Buffer* pBloomCBuffer);
+static bool GetPostPipeline(
+    const GfxShaderDesc* pPixelShaderDesc, GfxPipelineDesc* pDesc, const GfxPipelineState** ppPipeline);
+static void RenderPostPass(
+    const GfxRenderTarget* pTarget, ID3D11ShaderResourceView* const* ppSources, u32 sourceCount,
+    const GfxPipelineState* pPipeline, const f32* clearColor);
+static void SubmitMeshes(void* pUserData, const EntityView* pView, u32 threadIndex);
+static void MakeSpriteViewProjection(Mat4* pViewProjection);
+static void AnimateSprites(f32 seconds);
+static void GetSpriteBounds(u32 sprite, f32 center[3], f32 extent[3]);
+static void CullSprites(const Mat4* pViewProjection);
+static void OccludeSprites(const Mat4* pViewProjection);
+static Mat4 MakePanelWorld();
+static void SubmitBatchPrimitive(
+    BatchRenderer batch, BatchPrimitive primitive, const Mat4* pWorld, const Mat4* pViewProjection, const f32 color[4]);
+static void SubmitSprites(BatchRenderer batch, const Mat4* pViewProjection);
+static void ReleaseMeshes(void* pUserData, const EntityView* pView, u32 threadIndex);
 
 int EntryPoint()
 {
-    if (!InitializeGlobalMemory(KB(1)))
+    // Only read by the time to first frame trace.
+    DEBUG_OP(u64 startTicks = DROP_GetTicks());
+
+    if (!InitializeGlobalMemory(KB(2)))
     {
         ASSERT_MSG(false, "Failed to initialize global memory.");
         return 1;
@@ -90,7 +299,15 @@ int EntryPoint()
         return 1;
     }
 
-    if (!InitializeViewports())
+    // CAPTURE_FRAMES=N records the first N frames for the replayer. The resources remember how they
+    // were created so the replayer can create them again.
+    const char* captureFrames = getenv("CAPTURE_FRAMES");
+    if (captureFrames && atoi(captureFrames) > 0)
+        DROP_KeepCaptureData();
+
+    // The graph unwinds whatever it got done when a task fails.
+    TaskGraph startupGraph;
+    if (!BuildStartupGraph(&startupGraph) || !DROP_RunTaskGraph(&startupGraph))
     {
         ASSERT_MSG(false, "Failed to initialize resources.");
         CleanupCore();
@@ -98,211 +315,315 @@ int EntryPoint()
         return 1;
     }
 
-    if (!InitializeShadersAndMeshes())
+    ID3D11ShaderResourceView* pNullSRV = NULL;
+
+    ShowWindow(s_wndHandle->hwnd, SW_SHOW);
+
+    if (captureFrames && atoi(captureFrames) > 0)
     {
-        ASSERT_MSG(false, "Failed to initialize resources.");
-        CleanupCore();
-        CleanupGlobalMemory();
-        return 1;
+        if (!DROP_BeginCapture(s_gfxHandle, CAPTURE_FILE_NAME, (u32) atoi(captureFrames)))
+        {
+            LOG_WARN("Failed to start the frame capture.");
+        }
     }
 
-    if (!InitializeRenderTargets())
+    // HDR_CAPTURE_FRAMES=N writes the hdr target of the first N frames, HDR_CAPTURE_FORMAT=pfm|ppm|raw
+    // picks the files, pfm when unset.
+    const char*     hdrCaptureFrames = getenv("HDR_CAPTURE_FRAMES");
+    const char*     hdrCaptureFormat = getenv("HDR_CAPTURE_FORMAT");
+    FrameEncoder    hdrEncoder       = NULL;
+    GfxImageCapture hdrCapture       = NULL;
+    if (hdrCaptureFrames && atoi(hdrCaptureFrames) > 0)
     {
-        ASSERT_MSG(false, "Failed to initialize resources.");
-        CleanupShadersAndMeshes();
-        CleanupCore();
-        CleanupGlobalMemory();
-        return 1;
+        FrameEncoderDesc encoderDesc = {
+            .fileName  = HDR_CAPTURE_FILE_NAME,
+            .encoding  = FRAME_ENCODING_PFM,
+            .maxWidth  = DROP_RenderTargetSizeClass(s_wndHandle->width),
+            .maxHeight = DROP_RenderTargetSizeClass(s_wndHandle->height)};
+        if (hdrCaptureFormat && !strcmp(hdrCaptureFormat, "ppm"))
+            encoderDesc.encoding = FRAME_ENCODING_PPM;
+        else if (hdrCaptureFormat && !strcmp(hdrCaptureFormat, "raw"))
+            encoderDesc.encoding = FRAME_ENCODING_RAW;
+
+        if (!DROP_CreateFrameEncoder(&encoderDesc, &hdrEncoder) ||
+            !DROP_CreateImageCapture(hdrEncoder, (u32) atoi(hdrCaptureFrames), &hdrCapture))
+        {
+            LOG_WARN("Failed to start the hdr capture.");
+        }
     }
 
-    D3D11_SAMPLER_DESC samplerDesc = {
-        .Filter         = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
-        .AddressU       = D3D11_TEXTURE_ADDRESS_CLAMP,
-        .AddressV       = D3D11_TEXTURE_ADDRESS_CLAMP,
-        .AddressW       = D3D11_TEXTURE_ADDRESS_CLAMP,
-        .MipLODBias     = 0.0f,
-        .MaxAnisotropy  = 1,
-        .ComparisonFunc = D3D11_COMPARISON_ALWAYS,
-        .MinLOD         = 0,
-        .MaxLOD         = D3D11_FLOAT32_MAX};
-
-    ID3D11SamplerState* plinearSampler = NULL;
-
-    HRESULT hr = s_gfxHandle->pDevice->lpVtbl->CreateSamplerState(
-        s_gfxHandle->pDevice, &samplerDesc, &plinearSampler);
-    if (FAILED(hr) || !plinearSampler)
+#ifdef PROFILE
+    // PROFILE_TRACE_FRAMES=N writes a Chrome trace of the first N frames.
+    const char* traceFrames = getenv("PROFILE_TRACE_FRAMES");
+    if (traceFrames && atoi(traceFrames) > 0)
     {
-        ASSERT_MSG(false, "Failed to create sampler state.");
-        CleanupRenderTargets();
-        CleanupShadersAndMeshes();
-        CleanupCore();
-        CleanupGlobalMemory();
-        return 1;
+        if (!DROP_BeginProfileTrace(TRACE_FILE_NAME, (u32) atoi(traceFrames)))
+        {
+            LOG_WARN("Failed to start the profile trace.");
+        }
     }
+#endif // PROFILE
 
-    D3D11_BUFFER_DESC bloomBufferDesc = {
-        .ByteWidth           = sizeof(BloomParams),
-        .Usage               = D3D11_USAGE_DYNAMIC,
-        .BindFlags           = D3D11_BIND_CONSTANT_BUFFER,
-        .CPUAccessFlags      = D3D11_CPU_ACCESS_WRITE,
-        .MiscFlags           = 0,
-        .StructureByteStride = 0};
-
-    ID3D11Buffer* pBloomCBuffer = NULL;
-
-    hr = s_gfxHandle->pDevice->lpVtbl->CreateBuffer(
-        s_gfxHandle->pDevice, &bloomBufferDesc, NULL, &pBloomCBuffer);
-
-    if (FAILED(hr) || !pBloomCBuffer)
+    // FRAME_LIMIT=N turns vsync off and paces frames to N per second.
+    DROP_InitFrameTiming(&s_frameTiming);
+    const char* frameLimit   = getenv("FRAME_LIMIT");
+    UINT        syncInterval = 1;
+    if (frameLimit && atof(frameLimit) > 0.0)
     {
-        ASSERT_MSG(false, "Failed to create bloom constant buffer.");
-        RELEASE(plinearSampler);
-        CleanupRenderTargets();
-        CleanupShadersAndMeshes();
-        CleanupCore();
-        CleanupGlobalMemory();
-        return 1;
+        DROP_SetFrameLimit(&s_frameTiming, atof(frameLimit));
+        syncInterval = 0;
     }
 
-    D3D11_BUFFER_DESC intensityBufferDesc = {
-        .ByteWidth           = sizeof(IntensityParams),
-        .Usage               = D3D11_USAGE_DYNAMIC,
-        .BindFlags           = D3D11_BIND_CONSTANT_BUFFER,
-        .CPUAccessFlags      = D3D11_CPU_ACCESS_WRITE,
-        .MiscFlags           = 0,
-        .StructureByteStride = 0};
-
-    ID3D11Buffer* pIntensityCBuffer = NULL;
-
-    hr = s_gfxHandle->pDevice->lpVtbl->CreateBuffer(
-        s_gfxHandle->pDevice, &intensityBufferDesc, NULL, &pIntensityCBuffer);
-    if (FAILED(hr) || !pIntensityCBuffer)
+    // DYNAMIC_RESOLUTION=N lowers the render scale whenever the GPU takes longer than N ms on the passes
+    // rendered at that scale. Present and the vsync wait don't count.
+    const char*       resolutionBudget    = getenv("DYNAMIC_RESOLUTION");
+    bool              isDynamicResolution = resolutionBudget && atof(resolutionBudget) > 0.0;
+    DynamicResolution dynamicResolution;
+    if (isDynamicResolution)
     {
-        ASSERT_MSG(false, "Failed to create intensity constant buffer");
-        RELEASE(pBloomCBuffer);
-        RELEASE(plinearSampler);
-        CleanupRenderTargets();
-        CleanupShadersAndMeshes();
-        CleanupCore();
-        CleanupGlobalMemory();
+        DynamicResolutionDesc resolutionDesc = {
+            .budgetMs       = (f32) atof(resolutionBudget),
+            .minScale       = 0.5f,
+            .maxScale       = 1.0f,
+            .scaleStep      = 0.05f,
+            .raiseThreshold = 0.8f,
+            .settleFrames   = 30};
+        DROP_InitDynamicResolution(&dynamicResolution, &resolutionDesc);
     }
 
-    ID3D11ShaderResourceView* pNullSRV = NULL;
+    // BLOOM_BLUR_SIGMA=N sets the blur of the smallest bloom level, in its texels.
+    const char*         blurSigma        = getenv("BLOOM_BLUR_SIGMA");
+    f32                 bloomBlurSigma   = blurSigma && atof(blurSigma) > 0.0 ? (f32) atof(blurSigma) : BLOOM_DEFAULT_BLUR_SIGMA;
+    u32                 uploadedKernelId = 0;
+    GaussianKernelCache blurKernelCache;
+    DROP_InitGaussianKernelCache(&blurKernelCache);
 
-    ShowWindow(s_wndHandle->hwnd, SW_SHOW);
+    bool isFirstFrame        = true;
+    u64  animationStartTicks = DROP_GetTicks();
 
     while (s_isRunning)
     {
+        if (s_isResizePending && !ApplyResize())
+        {
+            s_isRunning = false;
+            break;
+        }
+
+        PROFILE_BEGIN("Frame");
+        u64 frameStartTicks = DROP_GetTicks();
+
+        // The arena of this frame is reused once the GPU is done with the frames reading it.
+        u64 frameIndex     = s_frameFence.submitted + 1;
+        u64 completedFrame = DROP_FrameFencePoll(s_gfxHandle, &s_frameFence);
+        while (!DROP_BeginFrameArenas(&s_frameArenas, frameIndex, completedFrame))
+        {
+            YieldProcessor();
+            completedFrame = DROP_FrameFencePoll(s_gfxHandle, &s_frameFence);
+        }
+        DROP_BatchRetireFrames(s_batchRenderer, completedFrame);
+
+        PROFILE_BEGIN("PollEvents");
         DROP_PollEvents();
+        PROFILE_END();
+
+        PROFILE_BEGIN("AnimateSprites");
+        Mat4 spriteViewProjection;
+        MakeSpriteViewProjection(&spriteViewProjection);
+        AnimateSprites((f32) DROP_TicksToSeconds(frameStartTicks - animationStartTicks));
+        PROFILE_END();
+
+        PROFILE_BEGIN("CullSprites");
+        CullSprites(&spriteViewProjection);
+        PROFILE_END();
+
+        PROFILE_BEGIN("OccludeSprites");
+        OccludeSprites(&spriteViewProjection);
+        PROFILE_END();
 
         f32 clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
-        s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_FULLSIZE_INDEX]);
+        s_gfxHandle->pContext->lpVtbl->VSSetConstantBuffers(s_gfxHandle->pContext, 0, 1, &s_pViewCBuffer);
+        s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_SCENE_INDEX]);
 
         // Draw normal meshes on HDR render target.
+        DROP_GpuTimerBegin(s_gfxHandle, &s_gpuTimer, frameIndex);
+        PROFILE_BEGIN("ScenePass");
         s_gfxHandle->pContext->lpVtbl->OMSetRenderTargets(
             s_gfxHandle->pContext, 1, &s_renderTargetsTable[HDR_RENDER_TARGET_INDEX].pRTV, NULL);
         s_gfxHandle->pContext->lpVtbl->ClearRenderTargetView(
             s_gfxHandle->pContext, s_renderTargetsTable[HDR_RENDER_TARGET_INDEX].pRTV, clearColor);
 
-        s_gfxHandle->pContext->lpVtbl->VSSetShader(s_gfxHandle->pContext, s_pVSTable[BASIC_VS_INDEX], NULL, 0);
-        s_gfxHandle->pContext->lpVtbl->PSSetShader(s_gfxHandle->pContext, s_pPSTable[BASIC_PS_INDEX], NULL, 0);
-
-        D3D11_MAPPED_SUBRESOURCE mappedResource;
+        EntityQuery meshQuery = {
+            .all = COMPONENT_BIT(s_meshComponent) | COMPONENT_BIT(s_materialComponent)};
+        DROP_RenderQueueBegin(s_renderQueue, &s_frameArenas);
+        DROP_QueryEntities(&s_entityWorld, &meshQuery, SubmitMeshes, s_renderQueue);
+        DROP_RenderQueueSort(s_renderQueue);
+        DROP_RenderQueueExecute(s_gfxHandle, s_pipelineCache, s_renderQueue);
+
+        DROP_BatchBegin(s_batchRenderer);
+        SubmitSprites(s_batchRenderer, &spriteViewProjection);
+        DROP_BatchFlush(s_batchRenderer);
+        DROP_InvalidatePipelineState(s_pipelineCache);
+        PROFILE_END();
+
+        // Bright pass into level 0 of the bloom chain.
+        PROFILE_BEGIN("BrightPass");
+        GfxRenderTarget* pBloomDown = &s_renderTargetsTable[BLOOM_DOWN_RENDER_TARGET_INDEX];
+        GfxRenderTarget* pBloomUp   = &s_renderTargetsTable[BLOOM_UP_RENDER_TARGET_INDEX];
+
+        s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_BLOOM_INDEX]);
+        RenderPostPass(
+            &pBloomDown[0], &s_renderTargetsTable[HDR_RENDER_TARGET_INDEX].pSRV, 1, s_pBrightPassPipeline, clearColor);
+        PROFILE_END();
+
+        // Bloom pass, down the chain, blur the smallest level and back up adding every level.
+        PROFILE_BEGIN("BloomPass");
+        for (u32 i = 1; i < s_bloomLevelCount; ++i)
+        {
+            s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_BLOOM_INDEX + i]);
+            RenderPostPass(&pBloomDown[i], &pBloomDown[i - 1].pSRV, 1, s_pDownsamplePipeline, clearColor);
+        }
 
-        s_gfxHandle->pContext->lpVtbl->Map(
-            s_gfxHandle->pContext, (ID3D11Resource*) pIntensityCBuffer, 0,
-            D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-        if (SUCCEEDED(hr))
+        u32 bottom = s_bloomLevelCount - 1;
+        s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_BLOOM_INDEX + bottom]);
+        // The blur covers the same part of the screen whatever the render scale, similar scales
+        // come back often enough for their kernels to stay cached.
+        const GaussianKernel* pBlurKernel = NULL;
+        f32                   blurSigma   = bloomBlurSigma * s_renderScale;
+        if (DROP_GetGaussianKernel(&blurKernelCache, blurSigma, DROP_GaussianRadius(blurSigma), &pBlurKernel) &&
+            pBlurKernel->id != uploadedKernelId)
         {
-            IntensityParams* pParams = (IntensityParams*) mappedResource.pData;
-            pParams->intensity       = 3.0f;
-            s_gfxHandle->pContext->lpVtbl->Unmap(s_gfxHandle->pContext, (ID3D11Resource*) pIntensityCBuffer, 0);
+            UploadBlurKernel(pBlurKernel, s_pBloomCBuffer);
+            uploadedKernelId = pBlurKernel->id;
         }
-        s_gfxHandle->pContext->lpVtbl->PSSetConstantBuffers(s_gfxHandle->pContext, 0, 1, &pIntensityCBuffer);
 
-        s_gfxHandle->pContext->lpVtbl->IASetInputLayout(s_gfxHandle->pContext, s_pBasicVSLayout);
-        u32 stride = TRIANGLE_VB_STRIDE;
-        u32 offset = 0;
-        s_gfxHandle->pContext->lpVtbl->IASetVertexBuffers(s_gfxHandle->pContext, 0, 1, &s_pTriangleVB, &stride, &offset);
+        s_gfxHandle->pContext->lpVtbl->PSSetConstantBuffers(s_gfxHandle->pContext, 0, 1, &s_pBloomCBuffer);
+        RenderPostPass(
+            &s_renderTargetsTable[BLOOM_BLUR_RENDER_TARGET_INDEX], &pBloomDown[bottom].pSRV, 1, s_pBloomHorizontalPipeline,
+            clearColor);
+        RenderPostPass(
+            &pBloomUp[bottom], &s_renderTargetsTable[BLOOM_BLUR_RENDER_TARGET_INDEX].pSRV, 1, s_pBloomVerticalPipeline,
+            clearColor);
 
-        s_gfxHandle->pContext->lpVtbl->IASetPrimitiveTopology(s_gfxHandle->pContext, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        s_gfxHandle->pContext->lpVtbl->Draw(s_gfxHandle->pContext, 3, 0);
+        for (u32 i = bottom; i-- > 0;)
+        {
+            ID3D11ShaderResourceView* pSources[] = {pBloomDown[i].pSRV, pBloomUp[i + 1].pSRV};
+            s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_BLOOM_INDEX + i]);
+            RenderPostPass(&pBloomUp[i], pSources, 2, s_pUpsamplePipeline, clearColor);
+        }
+        PROFILE_END();
+        DROP_GpuTimerEnd(s_gfxHandle, &s_gpuTimer, frameIndex);
 
-        // Bright pass.
-        s_gfxHandle->pContext->lpVtbl->OMSetRenderTargets(
-            s_gfxHandle->pContext, 1, &s_renderTargetsTable[BRIGHTPASS_RENDER_TARGET_INDEX].pRTV, NULL);
+        s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_COMPOSITE_INDEX]);
+        // Copy hdr texture to back buffer, upscaling it when the render scale is lower.
+        PROFILE_BEGIN("CompositePass");
+        s_gfxHandle->pContext->lpVtbl->OMSetRenderTargets(s_gfxHandle->pContext, 1, &s_gfxHandle->pBackBufferRTV, NULL);
         s_gfxHandle->pContext->lpVtbl->ClearRenderTargetView(
-            s_gfxHandle->pContext, s_renderTargetsTable[BRIGHTPASS_RENDER_TARGET_INDEX].pRTV, clearColor);
+            s_gfxHandle->pContext, s_gfxHandle->pBackBufferRTV, clearColor);
 
-        s_gfxHandle->pContext->lpVtbl->VSSetShader(
-            s_gfxHandle->pContext, s_pVSTable[COPY_VS_INDEX], NULL, 0);
-        s_gfxHandle->pContext->lpVtbl->PSSetShader(
-            s_gfxHandle->pContext, s_pPSTable[BRIGHTPASS_PS_INDEX], NULL, 0);
+        DROP_BindPipelineState(s_gfxHandle, s_pipelineCache, s_pCopyPipeline);
 
         s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(
             s_gfxHandle->pContext, 0, 1, &s_renderTargetsTable[HDR_RENDER_TARGET_INDEX].pSRV);
-        s_gfxHandle->pContext->lpVtbl->PSSetSamplers(s_gfxHandle->pContext, 0, 1, &plinearSampler);
-
-        s_gfxHandle->pContext->lpVtbl->IASetInputLayout(s_gfxHandle->pContext, NULL);
+        s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 1, 1, &pBloomUp[0].pSRV);
+        s_gfxHandle->pContext->lpVtbl->PSSetConstantBuffers(s_gfxHandle->pContext, 0, 1, &s_pViewCBuffer);
 
         s_gfxHandle->pContext->lpVtbl->Draw(s_gfxHandle->pContext, 3, 0);
+        DROP_AddCounter(COUNTER_DRAW_CALLS, 1);
 
         s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 0, 1, &pNullSRV);
+        s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 1, 1, &pNullSRV);
+        PROFILE_END();
 
-        // Bloom pass.
-        s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_HALFSIZE_INDEX]);
-        RenderBloomPass(
-            &s_renderTargetsTable[BLOOM0_LARGE_RENDER_TARGET_INDEX],
-            &s_renderTargetsTable[BRIGHTPASS_RENDER_TARGET_INDEX],
-            1, pNullSRV, pBloomCBuffer, clearColor);
-        RenderBloomPass(
-            &s_renderTargetsTable[BLOOM1_LARGE_RENDER_TARGET_INDEX],
-            &s_renderTargetsTable[BLOOM0_LARGE_RENDER_TARGET_INDEX],
-            0, pNullSRV, pBloomCBuffer, clearColor);
-
-        s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_QUARTERSIZE_INDEX]);
-        RenderBloomPass(
-            &s_renderTargetsTable[BLOOM0_MEDIUM_RENDER_TARGET_INDEX],
-            &s_renderTargetsTable[BRIGHTPASS_RENDER_TARGET_INDEX],
-            1, pNullSRV, pBloomCBuffer, clearColor);
-        RenderBloomPass(
-            &s_renderTargetsTable[BLOOM1_MEDIUM_RENDER_TARGET_INDEX],
-            &s_renderTargetsTable[BLOOM0_MEDIUM_RENDER_TARGET_INDEX],
-            0, pNullSRV, pBloomCBuffer, clearColor);
-
-        s_gfxHandle->pContext->lpVtbl->RSSetViewports(s_gfxHandle->pContext, 1, &s_viewportTable[VIEWPORT_FULLSIZE_INDEX]);
-        // Copy hdr texture to back buffer.
-        s_gfxHandle->pContext->lpVtbl->OMSetRenderTargets(s_gfxHandle->pContext, 1, &s_gfxHandle->pBackBufferRTV, NULL);
-        s_gfxHandle->pContext->lpVtbl->ClearRenderTargetView(
-            s_gfxHandle->pContext, s_gfxHandle->pBackBufferRTV, clearColor);
+        if (hdrCapture)
+        {
+            PROFILE_BEGIN("HdrCapture");
+            DROP_CaptureImage(s_gfxHandle, hdrCapture, s_renderTargetsTable[HDR_RENDER_TARGET_INDEX].pTexture,
+                              (u32) s_viewportTable[VIEWPORT_SCENE_INDEX].Width,
+                              (u32) s_viewportTable[VIEWPORT_SCENE_INDEX].Height);
+            PROFILE_END();
+        }
 
-        s_gfxHandle->pContext->lpVtbl->PSSetShader(s_gfxHandle->pContext, s_pPSTable[COPY_PS_INDEX], NULL, 0);
+        PROFILE_BEGIN("Present");
+        s_gfxHandle->pSwapChain->lpVtbl->Present(s_gfxHandle->pSwapChain, syncInterval, 0);
+        PROFILE_END();
 
-        s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(
-            s_gfxHandle->pContext, 0, 1, &s_renderTargetsTable[HDR_RENDER_TARGET_INDEX].pSRV);
-        s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(
-            s_gfxHandle->pContext, 1, 1, &s_renderTargetsTable[BLOOM1_LARGE_RENDER_TARGET_INDEX].pSRV);
-        s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(
-            s_gfxHandle->pContext, 2, 1, &s_renderTargetsTable[BLOOM1_MEDIUM_RENDER_TARGET_INDEX].pSRV);
+        DROP_BatchEndFrame(s_batchRenderer, DROP_FrameFenceSignal(s_gfxHandle, &s_frameFence));
 
-        s_gfxHandle->pContext->lpVtbl->Draw(s_gfxHandle->pContext, 3, 0);
+        if (isFirstFrame)
+        {
+            LOG_TRACE("Time to first frame: %.3f ms.", DROP_TicksToMilliseconds(DROP_GetTicks() - startTicks));
+            DROP_PrintTaskGraph(&startupGraph);
+            isFirstFrame = false;
+        }
 
-        s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 0, 1, &pNullSRV);
-        s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 1, 1, &pNullSRV);
-        s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 2, 1, &pNullSRV);
+        // The GPU time arrives a few frames late, the controller's settle frames cover that.
+        f32 gpuMs = 0.0f;
+        if (isDynamicResolution && DROP_GpuTimerRead(s_gfxHandle, &s_gpuTimer, completedFrame, &gpuMs) &&
+            DROP_UpdateDynamicResolution(&dynamicResolution, gpuMs))
+        {
+            s_renderScale = dynamicResolution.scale;
+            UpdateViewports(s_wndHandle->width, s_wndHandle->height);
+
+            s_viewParams.uvScale[0] = s_renderScale;
+            s_viewParams.uvScale[1] = s_renderScale;
+            s_gfxHandle->pContext->lpVtbl->UpdateSubresource(
+                s_gfxHandle->pContext, (ID3D11Resource*) s_pViewCBuffer, 0, NULL, &s_viewParams, 0, 0);
+            DROP_AddCounter(COUNTER_UPLOADED_BYTES, sizeof(s_viewParams));
+        }
 
-        s_gfxHandle->pSwapChain->lpVtbl->Present(s_gfxHandle->pSwapChain, 1, 0);
+        DROP_CaptureEndFrame(s_gfxHandle);
+        DROP_PipelineCacheEndFrame(s_pipelineCache);
+        DROP_RenderTargetPoolEndFrame(s_renderTargetPool);
+
+        PROFILE_END();
+        DROP_ProfileEndFrame();
+
+        DROP_SetGauge(COUNTER_PERSISTENT_BYTES_USED, PERSISTENT->used);
+        DROP_SetGauge(COUNTER_TRANSIENT_BYTES_USED, TRANSIENT->used);
+        DROP_CountersEndFrame();
 
         DROP_ClearArena(TRANSIENT);
+
+        DROP_EndFrameTiming(&s_frameTiming);
     }
 
     ShowWindow(s_wndHandle->hwnd, SW_HIDE);
 
-    RELEASE(pIntensityCBuffer);
-    RELEASE(pBloomCBuffer);
-    RELEASE(plinearSampler);
-    CleanupRenderTargets();
-    CleanupShadersAndMeshes();
+    FrameTimingStats frameStats;
+    DROP_GetFrameTimingStats(&s_frameTiming, &frameStats);
+    DROP_PrintFrameTimingStats(&frameStats);
+    DROP_SetFrameLimit(&s_frameTiming, 0.0);
+
+    DROP_EndCapture(s_gfxHandle);
+    if (hdrCapture)
+        DROP_DestroyImageCapture(s_gfxHandle, &hdrCapture);
+    if (hdrEncoder)
+    {
+        DROP_FlushFrameEncoder(hdrEncoder);
+        DROP_PrintFrameEncoderStats(hdrEncoder);
+        DROP_DestroyFrameEncoder(&hdrEncoder);
+    }
+#ifdef PROFILE
+    DROP_PrintProfileZones();
+#endif // PROFILE
+
+    // COUNTERS_FILE=<name>.csv or <name>.json writes the counters of the last frames.
+    const char* countersFile = getenv("COUNTERS_FILE");
+    if (countersFile)
+    {
+        const char*   extension = strrchr(countersFile, '.');
+        CounterFormat format    = extension && !strcmp(extension, ".json") ? COUNTER_FORMAT_JSON : COUNTER_FORMAT_CSV;
+        if (!DROP_ExportCounters(countersFile, format))
+        {
+            LOG_WARN("Failed to export the counters.");
+        }
+    }
+
+    // Sizes for InitializeGlobalMemory, from what the arenas really hold.
+    PRINT_ARENA_REPORT(PERSISTENT, "PERSISTENT");
+    PRINT_ARENA_REPORT(TRANSIENT, "TRANSIENT");
+
+    DROP_CleanupTaskGraph(&startupGraph);
     CleanupCore();
     CleanupGlobalMemory();
 
@@ -311,48 +632,215 @@ int EntryPoint()
     return 0;
 }
 
-static void RenderBloomPass(
-    const GfxRenderTarget* pCurrent, const GfxRenderTarget* pFormer, i32 horizontal,
-    ID3D11ShaderResourceView* pNullSRV, ID3D11Buffer* pBloomCBuffer, const f32* clearColor)
+static void UploadBlurKernel(const GaussianKernel* pKernel, ID3D11Buffer* pBloomCBuffer)
+{
+    BloomParams params = {
+        .weightCenter = pKernel->centerWeight,
+        .tapCount     = pKernel->tapCount};
+
+    for (u32 i = 0; i < pKernel->tapCount; ++i)
+    {
+        params.taps[i][0] = pKernel->weights[i];
+        params.taps[i][1] = pKernel->offsets[i];
+    }
+
+    s_gfxHandle->pContext->lpVtbl->UpdateSubresource(
+        s_gfxHandle->pContext, (ID3D11Resource*) pBloomCBuffer, 0, NULL, &params, 0, 0);
+    DROP_AddCounter(COUNTER_UPLOADED_BYTES, sizeof(params));
+}
+
+// Same vertex shader and states as pDesc, with the pixel shader of the description.
+static bool GetPostPipeline(
+    const GfxShaderDesc* pPixelShaderDesc, GfxPipelineDesc* pDesc, const GfxPipelineState** ppPipeline)
 {
-    s_gfxHandle->pContext->lpVtbl->OMSetRenderTargets(
-        s_gfxHandle->pContext, 1, &pCurrent->pRTV, NULL);
-    s_gfxHandle->pContext->lpVtbl->ClearRenderTargetView(
-        s_gfxHandle->pContext, pCurrent->pRTV, clearColor);
+    return DROP_GetPixelShader(s_gfxHandle, s_shaderCache, pPixelShaderDesc, &pDesc->pPixelShader) &&
+           DROP_GetPipelineState(s_pipelineCache, pDesc, ppPipeline);
+}
 
-    s_gfxHandle->pContext->lpVtbl->PSSetShader(
-        s_gfxHandle->pContext, s_pPSTable[BLOOM_PS_INDEX], NULL, 0);
+static void RenderPostPass(
+    const GfxRenderTarget* pTarget, ID3D11ShaderResourceView* const* ppSources, u32 sourceCount,
+    const GfxPipelineState* pPipeline, const f32* clearColor)
+{
+    ID3D11ShaderResourceView* pNullSRVs[2] = {NULL, NULL};
+    ASSERT_MSG(sourceCount <= ARRAYSIZE(pNullSRVs), "Too many post pass sources.");
 
-    s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(
-        s_gfxHandle->pContext, 0, 1, &pFormer->pSRV);
+    s_gfxHandle->pContext->lpVtbl->OMSetRenderTargets(s_gfxHandle->pContext, 1, &pTarget->pRTV, NULL);
+    s_gfxHandle->pContext->lpVtbl->ClearRenderTargetView(s_gfxHandle->pContext, pTarget->pRTV, clearColor);
 
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    DROP_BindPipelineState(s_gfxHandle, s_pipelineCache, pPipeline);
+
+    s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 0, sourceCount, ppSources);
+
+    s_gfxHandle->pContext->lpVtbl->Draw(s_gfxHandle->pContext, 3, 0);
+    DROP_AddCounter(COUNTER_DRAW_CALLS, 1);
 
-    HRESULT hr = s_gfxHandle->pContext->lpVtbl->Map(
-        s_gfxHandle->pContext, (ID3D11Resource*) pBloomCBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-    if (SUCCEEDED(hr))
+    s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 0, sourceCount, pNullSRVs);
+}
+
+static void SubmitMeshes(void* pUserData, const EntityView* pView, u32 threadIndex)
+{
+    RenderQueue              queue      = (RenderQueue) pUserData;
+    const MeshComponent*     pMeshes    = (const MeshComponent*) DROP_ViewComponent(pView, s_meshComponent);
+    const MaterialComponent* pMaterials = (const MaterialComponent*) DROP_ViewComponent(pView, s_materialComponent);
+
+    for (u32 i = 0; i < pView->count; ++i)
     {
-        BloomParams* pParams  = (BloomParams*) mappedResource.pData;
-        pParams->texelSize[0] = 1.0f / (f32) pCurrent->width;
-        pParams->texelSize[1] = 1.0f / (f32) pCurrent->height;
-        pParams->horizontal   = horizontal;
-        pParams->weightCenter = 0.4026199470f;
-        pParams->weights[0]   = 0.2442013420f;
-        pParams->weights[1]   = 0.2442013420f;
-        pParams->weights[2]   = 0.0544886845f;
-        pParams->weights[3]   = 0.0544886845;
-        s_gfxHandle->pContext->lpVtbl->Unmap(s_gfxHandle->pContext, (ID3D11Resource*) pBloomCBuffer, 0);
+        RenderPacket packet = {
+            .pPipeline       = pMaterials[i].pPipeline,
+            .pVertexBuffer   = pMeshes[i].pVertexBuffer,
+            .pConstantBuffer = pMaterials[i].pConstantBuffer,
+            .pSRV            = NULL,
+            .stride          = pMeshes[i].stride,
+            .vertexCount     = pMeshes[i].vertexCount,
+            .startVertex     = 0};
+
+        u64 key = DROP_MakeOpaqueKey(
+            OPAQUE_PASS, pMaterials[i].pPipeline->id, pMaterials[i].id, pMeshes[i].id, 0.0f);
+        DROP_RenderQueueSubmit(queue, key, &packet);
     }
-    s_gfxHandle->pContext->lpVtbl->PSSetConstantBuffers(s_gfxHandle->pContext, 0, 1, &pBloomCBuffer);
+}
 
-    s_gfxHandle->pContext->lpVtbl->Draw(s_gfxHandle->pContext, 3, 0);
+// The sprites live in clip space at SPRITE_DEPTH, x is squeezed back to square pixels.
+static void MakeSpriteViewProjection(Mat4* pViewProjection)
+{
+    const D3D11_VIEWPORT* pViewport = &s_viewportTable[VIEWPORT_SCENE_INDEX];
+
+    *pViewProjection         = DROP_Mat4Identity();
+    pViewProjection->rows[0] = _mm_setr_ps(pViewport->Height / pViewport->Width, 0.0f, 0.0f, 0.0f);
+    pViewProjection->rows[3] = _mm_setr_ps(0.0f, 0.0f, SPRITE_DEPTH, 1.0f);
+}
+
+// The root turns the rings around the triangle and every ring turns its sprites. Only those nodes
+// are set, the scene derives the world matrices of the sprites from them.
+static void AnimateSprites(f32 seconds)
+{
+    f32 origin[3]   = {0.0f, 0.0f, 0.0f};
+    f32 unit[3]     = {1.0f, 1.0f, 1.0f};
+    f32 orbit       = seconds * SPRITE_ORBIT_SPEED;
+    f32 rootTurn[4] = {0.0f, 0.0f, sinf(0.5f * orbit), cosf(0.5f * orbit)};
+    DROP_SceneSetLocal(&s_spriteScene, SPRITE_ROOT_NODE, origin, rootTurn, unit);
+
+    for (u32 i = 0; i < SPRITE_RING_COUNT; ++i)
+    {
+        f32 angle       = 6.2831853f * i / SPRITE_RING_COUNT;
+        f32 spin        = seconds * SPRITE_SPIN_SPEED * (i & 1 ? -1.0f : 1.0f);
+        f32 position[3] = {cosf(angle) * SPRITE_ORBIT_RADIUS, sinf(angle) * SPRITE_ORBIT_RADIUS, 0.0f};
+        f32 ringTurn[4] = {0.0f, 0.0f, sinf(0.5f * spin), cosf(0.5f * spin)};
+        DROP_SceneSetLocal(&s_spriteScene, SPRITE_FIRST_RING_NODE + i, position, ringTurn, unit);
+    }
 
-    s_gfxHandle->pContext->lpVtbl->PSSetShaderResources(s_gfxHandle->pContext, 0, 1, &pNullSRV);
+    DROP_UpdateScene(&s_spriteScene);
+}
+
+// Box around the unit primitive of a sprite, in world space.
+static void GetSpriteBounds(u32 sprite, f32 center[3], f32 extent[3])
+{
+    const Mat4* pWorld = DROP_SceneGetWorld(&s_spriteScene, SPRITE_FIRST_NODE + sprite);
+
+    f32 m[4][4];
+    for (u32 row = 0; row < 4; ++row)
+        _mm_storeu_ps(m[row], pWorld->rows[row]);
+
+    for (u32 i = 0; i < 3; ++i)
+    {
+        center[i] = m[3][i];
+        extent[i] = 0.5f * (fabsf(m[0][i]) + fabsf(m[1][i]));
+    }
+}
+
+// Every sprite moves every frame, the bounds are all set again and the tree refit.
+static void CullSprites(const Mat4* pViewProjection)
+{
+    for (u32 i = 0; i < SPRITE_COUNT; ++i)
+    {
+        f32 center[3];
+        f32 extent[3];
+        GetSpriteBounds(i, center, extent);
+        DROP_CullSetBounds(&s_spriteCullWorld, i, center, extent);
+    }
+    DROP_UpdateCullWorld(&s_spriteCullWorld);
+
+    Frustum frustum;
+    DROP_ExtractFrustum(pViewProjection, &frustum);
+    DROP_CullObjects(&s_spriteCullWorld, &frustum);
+}
+
+// The unit quad of the batch, as the occluder triangles.
+static const f32 s_panelPositions[] = {
+    -0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f, -0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.0f};
+static const u32 s_panelIndices[] = {0, 2, 1, 1, 2, 3};
+
+static Mat4 MakePanelWorld()
+{
+    Mat4 world    = DROP_Mat4Identity();
+    world.rows[0] = _mm_setr_ps(PANEL_WIDTH, 0.0f, 0.0f, 0.0f);
+    world.rows[1] = _mm_setr_ps(0.0f, PANEL_HEIGHT, 0.0f, 0.0f);
+    world.rows[3] = _mm_setr_ps(0.0f, PANEL_CENTER_Y, PANEL_DEPTH, 1.0f);
+    return world;
+}
+
+// The panel is the only occluder, the sprites the frustum kept behind it are dropped from the visible list.
+static void OccludeSprites(const Mat4* pViewProjection)
+{
+    Mat4 panelWorld = MakePanelWorld();
+    DROP_OcclusionBegin(&s_spriteOcclusion, pViewProjection);
+    DROP_OcclusionAddOccluder(
+        &s_spriteOcclusion, &panelWorld, s_panelPositions, s_panelIndices, ARRAY_COUNT(s_panelIndices));
+    DROP_OcclusionRasterize(&s_spriteOcclusion);
+    DROP_OcclusionCullVisible(&s_spriteOcclusion, &s_spriteCullWorld);
+}
+
+// The batch works in 2D, the basis and the translation are the xy part of world * viewProjection.
+static void SubmitBatchPrimitive(
+    BatchRenderer batch, BatchPrimitive primitive, const Mat4* pWorld, const Mat4* pViewProjection, const f32 color[4])
+{
+    Mat4 worldViewProjection;
+    DROP_Mat4Multiply(pWorld, pViewProjection, &worldViewProjection);
+
+    f32 m[4][4];
+    for (u32 row = 0; row < 4; ++row)
+        _mm_storeu_ps(m[row], worldViewProjection.rows[row]);
+
+    f32 basis[4]       = {m[0][0], m[1][0], m[0][1], m[1][1]};
+    f32 translation[2] = {m[3][0], m[3][1]};
+    DROP_BatchSubmit(batch, primitive, NULL, NULL, basis, translation, color);
+}
+
+// One instance per visible sprite, a draw per primitive kind. The panel goes last, the sort keeps the
+// submission order inside the quads so it covers the sprites it occludes.
+static void SubmitSprites(BatchRenderer batch, const Mat4* pViewProjection)
+{
+    for (u32 v = 0; v < s_spriteCullWorld.visibleCount; ++v)
+    {
+        u32 i        = s_spriteCullWorld.pVisible[v];
+        f32 t        = (f32) i / SPRITE_COUNT;
+        f32 color[4] = {0.5f * t, 0.1f, 0.5f * (1.0f - t), 1.0f};
+        SubmitBatchPrimitive(
+            batch, i & 1 ? BATCH_PRIMITIVE_QUAD : BATCH_PRIMITIVE_TRIANGLE,
+            DROP_SceneGetWorld(&s_spriteScene, SPRITE_FIRST_NODE + i), pViewProjection, color);
+    }
+
+    Mat4 panelWorld    = MakePanelWorld();
+    f32  panelColor[4] = {0.05f, 0.05f, 0.05f, 1.0f};
+    SubmitBatchPrimitive(batch, BATCH_PRIMITIVE_QUAD, &panelWorld, pViewProjection, panelColor);
+}
+
+static void ReleaseMeshes(void* pUserData, const EntityView* pView, u32 threadIndex)
+{
+    MeshComponent*     pMeshes    = (MeshComponent*) DROP_ViewComponent(pView, s_meshComponent);
+    MaterialComponent* pMaterials = (MaterialComponent*) DROP_ViewComponent(pView, s_materialComponent);
+
+    for (u32 i = 0; i < pView->count; ++i)
+    {
+        SAFE_RELEASE(pMeshes[i].pVertexBuffer);
+        if (pMaterials)
+            SAFE_RELEASE(pMaterials[i].pConstantBuffer);
+    }
 }
 #pragma endregion
 
 #pragma region RESOURCES
-static bool InitializeViewports()
+static bool InitializeViewports(void* pUserData)
 {
     // Setup viewport.
     s_viewportTable = (D3D11_VIEWPORT*) DROP_Allocate(PERSISTENT, (sizeof(D3D11_VIEWPORT) * VIEWPORT_TABLE_COUNT));
@@ -369,179 +857,207 @@ static bool InitializeViewports()
         return false;
     }
 
-    s_viewportDivider[0] = 1;
-    s_viewportDivider[1] = 2;
-    s_viewportDivider[2] = 4;
+    s_viewportDivider[VIEWPORT_COMPOSITE_INDEX] = 1;
+    s_viewportDivider[VIEWPORT_SCENE_INDEX]     = 1;
+    for (u32 i = 0; i < BLOOM_MAX_LEVELS; ++i)
+        s_viewportDivider[VIEWPORT_BLOOM_INDEX + i] = (f32) (2u << i);
+
+    UpdateViewports(s_wndHandle->width, s_wndHandle->height);
+
+    return true;
+}
+static void UpdateViewports(u32 width, u32 height)
+{
+    // The targets are sized from the size class of the window. The scene covers the window part
+    // of them, the post passes the whole targets, both shrunk by the render scale. The composite
+    // viewport spans the whole targets too, its window part lands 1:1 on the back buffer and the
+    // rest is clipped.
+    u32 extentWidth  = DROP_RenderTargetSizeClass(width);
+    u32 extentHeight = DROP_RenderTargetSizeClass(height);
 
     for (u32 i = 0; i < VIEWPORT_TABLE_COUNT; ++i)
     {
-        s_viewportTable[0].Width    = s_wndHandle->width / s_viewportDivider[i];
-        s_viewportTable[0].Height   = s_wndHandle->height / s_viewportDivider[i];
-        s_viewportTable[0].TopLeftX = 0;
-        s_viewportTable[0].TopLeftY = 0;
-        s_viewportTable[0].MinDepth = 0.0f;
-        s_viewportTable[0].MaxDepth = 1.0f;
+        bool isScene = i == VIEWPORT_SCENE_INDEX;
+        f32  scale   = i == VIEWPORT_COMPOSITE_INDEX ? 1.0f : s_renderScale;
+
+        s_viewportTable[i].Width    = (f32) (u32) ((isScene ? width : extentWidth) / s_viewportDivider[i] * scale);
+        s_viewportTable[i].Height   = (f32) (u32) ((isScene ? height : extentHeight) / s_viewportDivider[i] * scale);
+        s_viewportTable[i].TopLeftX = 0;
+        s_viewportTable[i].TopLeftY = 0;
+        s_viewportTable[i].MinDepth = 0.0f;
+        s_viewportTable[i].MaxDepth = 1.0f;
     }
-
-    return true;
 }
-static bool InitializeShadersAndMeshes()
+static bool InitializeShadersAndMeshes(void* pUserData)
 {
-    // Create shader.
-    s_pVSTable = (ID3D11VertexShader**) DROP_Allocate(PERSISTENT, sizeof(ID3D11VertexShader*) * VS_TABLE_COUNT);
-    if (!s_pVSTable)
+    // The shaders and the layout live in their caches, nothing to release here on failure.
+    ID3D11VertexShader* pBasicVS       = NULL;
+    ID3D11InputLayout*  pBasicVSLayout = NULL;
+    ID3D11PixelShader*  pBasicPS       = NULL;
+    if (!DROP_GetVertexShader(
+            s_gfxHandle, s_shaderCache, &s_shaderLoads[BASIC_VS_SHADER_INDEX].desc, &pBasicVS, &pBasicVSLayout) ||
+        !DROP_GetPixelShader(s_gfxHandle, s_shaderCache, &s_shaderLoads[BASIC_PS_SHADER_INDEX].desc, &pBasicPS))
     {
-        LOG_ERROR("Failed to allocate memory for vertex shader table.");
+        LOG_ERROR("Failed to create basic shaders.");
         return false;
     }
-    s_pPSTable = (ID3D11PixelShader**) DROP_Allocate(PERSISTENT, sizeof(ID3D11PixelShader*) * PS_TABLE_COUNT);
-    if (!s_pPSTable)
+
+    // In the order of the basic.hlsl input signature, the input layout is built from it.
+    typedef struct
+    {
+        f32 pos[2];
+        f32 color[4];
+    } Vertex;
+
+    Vertex vertices[] = {
+        {.pos = {0.0f, 0.5f}, .color = {0.12f, 0.5f, 0.2f, 1.0f}},  // Brighter red
+        {.pos = {0.5f, -0.5f}, .color = {0.2f, 0.0f, 0.2f, 1.0f}},  // Brighter green
+        {.pos = {-0.5f, -0.5f}, .color = {0.2f, 0.2f, 0.5f, 1.0f}}, // Brighter blue
+    };
+
+    ID3D11Buffer* pTriangleVB = NULL;
+    if (!DROP_CreateVertexBuffer(
+            s_gfxHandle, vertices, sizeof(vertices), &pTriangleVB) ||
+        !pTriangleVB)
     {
-        LOG_ERROR("Failed to allocate memory for pixel shader table.");
+        LOG_ERROR("Failed to create triangle vertex buffer.");
         return false;
     }
 
-    HRESULT hr = 0;
+    IntensityParams intensityParams = {
+        .intensity = 3.0f};
+
+    D3D11_BUFFER_DESC intensityBufferDesc = {
+        .ByteWidth           = sizeof(IntensityParams),
+        .Usage               = D3D11_USAGE_IMMUTABLE,
+        .BindFlags           = D3D11_BIND_CONSTANT_BUFFER,
+        .CPUAccessFlags      = 0,
+        .MiscFlags           = 0,
+        .StructureByteStride = 0};
+
+    D3D11_SUBRESOURCE_DATA intensityData = {
+        .pSysMem = &intensityParams};
 
-    const wchar_t* vertexShaderList[] = {
-        L"assets/shaders/basic_vs.cso",
-        L"assets/shaders/copy_vs.cso"};
-    ID3DBlob* pByteCodeList[] = {
-        NULL,
-        NULL};
+    ID3D11Buffer* pIntensityCBuffer = NULL;
 
-    for (u32 i = 0; i < VS_TABLE_COUNT; ++i)
+    HRESULT hr = s_gfxHandle->pDevice->lpVtbl->CreateBuffer(
+        s_gfxHandle->pDevice, &intensityBufferDesc, &intensityData, &pIntensityCBuffer);
+    if (FAILED(hr) || !pIntensityCBuffer)
     {
-        hr = D3DReadFileToBlob(vertexShaderList[i], &pByteCodeList[i]);
-        if (FAILED(hr) || !pByteCodeList[i])
-        {
-            LOG_ERROR("Failed to load vertex shader: %s.", vertexShaderList[i]);
-            for (u32 j = 0; j < i; ++j)
-                RELEASE(pByteCodeList[j]);
-            return false;
-        }
+        LOG_ERROR("Failed to create intensity constant buffer.");
+        RELEASE(pTriangleVB);
+        return false;
+    }
+    DROP_SetCaptureData((ID3D11DeviceChild*) pIntensityCBuffer, &intensityParams, sizeof(IntensityParams));
+
+    GfxPipelineDesc basicDesc = {
+        .pVertexShader = pBasicVS,
+        .pPixelShader  = pBasicPS,
+        .pInputLayout  = pBasicVSLayout,
+        .topology      = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST};
+
+    // Renderables live in the entity world, which owns the mesh resources from here on.
+    const GfxPipelineState* pBasicPipeline = NULL;
+    EntityId                triangle       = {0};
+    if (!DROP_GetPipelineState(s_pipelineCache, &basicDesc, &pBasicPipeline) ||
+        !DROP_CreateEntityWorld(&s_entityWorld) ||
+        !DROP_RegisterComponent(&s_entityWorld, sizeof(MeshComponent), &s_meshComponent) ||
+        !DROP_RegisterComponent(&s_entityWorld, sizeof(MaterialComponent), &s_materialComponent) ||
+        !DROP_CreateEntity(
+            &s_entityWorld, COMPONENT_BIT(s_meshComponent) | COMPONENT_BIT(s_materialComponent), &triangle))
+    {
+        LOG_ERROR("Failed to create triangle entity.");
+        DROP_DestroyEntityWorld(&s_entityWorld);
+        RELEASE(pIntensityCBuffer);
+        RELEASE(pTriangleVB);
+        return false;
+    }
 
-        hr = s_gfxHandle->pDevice->lpVtbl->CreateVertexShader(
-            s_gfxHandle->pDevice, pByteCodeList[i]->lpVtbl->GetBufferPointer(pByteCodeList[i]),
-            pByteCodeList[i]->lpVtbl->GetBufferSize(pByteCodeList[i]), NULL, &s_pVSTable[i]);
-        if (FAILED(hr) || !s_pVSTable[i])
-        {
-            LOG_ERROR("Failed to create vertex shader at index %d", i);
-            for (u32 j = 0; j <= i; ++j)
-            {
-                RELEASE(pByteCodeList[j]);
-                if (j < i)
-                    RELEASE(s_pVSTable[j]);
-            }
-            return false;
-        }
+    MeshComponent* pMesh = (MeshComponent*) DROP_WriteComponent(&s_entityWorld, triangle, s_meshComponent);
+    pMesh->pVertexBuffer = pTriangleVB;
+    pMesh->pInputLayout  = pBasicVSLayout;
+    pMesh->stride        = TRIANGLE_VB_STRIDE;
+    pMesh->vertexCount   = 3;
+    pMesh->id            = 0;
+
+    MaterialComponent* pMaterial = (MaterialComponent*) DROP_WriteComponent(&s_entityWorld, triangle, s_materialComponent);
+    pMaterial->pPipeline         = pBasicPipeline;
+    pMaterial->pConstantBuffer   = pIntensityCBuffer;
+    pMaterial->id                = 0;
+
+    return true;
+}
+static bool InitializeBatch(void* pUserData)
+{
+    BatchInitProps batchProps = {
+        .maxInstances      = BATCH_MAX_INSTANCES,
+        .shaderCache       = s_shaderCache,
+        .pVertexShaderDesc = &s_shaderLoads[BATCH_VS_SHADER_INDEX].desc,
+        .pPixelShaderDesc  = &s_shaderLoads[BATCH_PS_SHADER_INDEX].desc};
+
+    if (!DROP_CreateBatchRenderer(s_gfxHandle, &batchProps, &s_batchRenderer) || !s_batchRenderer)
+    {
+        LOG_ERROR("Failed to create batch renderer.");
+        return false;
     }
 
-    const wchar_t* pixelShaderList[] = {
-        L"assets/shaders/basic_ps.cso",
-        L"assets/shaders/copy_ps.cso",
-        L"assets/shaders/brightpass_ps.cso",
-        L"assets/shaders/bloom_ps.cso"};
-    for (u32 i = 0; i < PS_TABLE_COUNT; ++i)
+    return true;
+}
+static bool InitializeSprites(void* pUserData)
+{
+    if (!DROP_CreateScene(SPRITE_NODE_COUNT, &s_spriteScene))
     {
-        ID3DBlob* pByteCode = NULL;
+        LOG_ERROR("Failed to create sprite scene.");
+        return false;
+    }
 
-        hr = D3DReadFileToBlob(pixelShaderList[i], &pByteCode);
-        if (FAILED(hr) || !pByteCode)
-        {
-            LOG_ERROR("Failed to load pixel shader: %s.", pixelShaderList[i]);
-            for (u32 j = 0; j < VS_TABLE_COUNT; ++j)
-            {
-                RELEASE(pByteCodeList[j]);
-                RELEASE(s_pVSTable[j]);
-            }
-            return false;
-        }
+    // Root first, then the rings, then their sprites, so the nodes are already in depth order.
+    DROP_SceneAddNode(&s_spriteScene, SCENE_NO_PARENT);
+    for (u32 i = 0; i < SPRITE_RING_COUNT; ++i)
+        DROP_SceneAddNode(&s_spriteScene, SPRITE_ROOT_NODE);
 
-        hr = s_gfxHandle->pDevice->lpVtbl->CreatePixelShader(
-            s_gfxHandle->pDevice, pByteCode->lpVtbl->GetBufferPointer(pByteCode),
-            pByteCode->lpVtbl->GetBufferSize(pByteCode), NULL, &s_pPSTable[i]);
-        pByteCode->lpVtbl->Release(pByteCode);
-        if (FAILED(hr) || !s_pPSTable[i])
-        {
-            LOG_ERROR("Failed to create pixel shader at index %d", i);
-            for (u32 j = 0; j < VS_TABLE_COUNT; ++j)
-            {
-                RELEASE(pByteCodeList[j]);
-                RELEASE(s_pVSTable[j]);
-            }
-            for (u32 j = 0; j < i; ++j)
-                RELEASE(s_pPSTable[j]);
-            return false;
-        }
+    f32 size[3] = {SPRITE_SIZE, SPRITE_SIZE, SPRITE_SIZE};
+    for (u32 i = 0; i < SPRITE_COUNT; ++i)
+    {
+        u32 sprite = DROP_SceneAddNode(&s_spriteScene, SPRITE_FIRST_RING_NODE + i / SPRITES_PER_RING);
+        ASSERT_MSG(sprite == SPRITE_FIRST_NODE + i, "Sprite nodes are out of order.");
+
+        f32 angle       = 6.2831853f * (i % SPRITES_PER_RING) / SPRITES_PER_RING;
+        f32 position[3] = {cosf(angle) * SPRITE_RING_RADIUS, sinf(angle) * SPRITE_RING_RADIUS, 0.0f};
+        f32 rotation[4] = {0.0f, 0.0f, sinf(0.5f * angle), cosf(0.5f * angle)};
+        DROP_SceneSetLocal(&s_spriteScene, sprite, position, rotation, size);
     }
 
-    typedef struct
+    if (!DROP_CreateCullWorld(SPRITE_COUNT, &s_spriteCullWorld))
     {
-        f32 pos[2];
-        f32 color[4];
-    } Vertex;
+        LOG_ERROR("Failed to create sprite cull world.");
+        DROP_DestroyScene(&s_spriteScene);
+        return false;
+    }
 
-    Vertex vertices[] = {
-        {.pos = {0.0f, 0.5f}, .color = {0.12f, 0.5f, 0.2f, 1.0f}},  // Brighter red
-        {.pos = {0.5f, -0.5f}, .color = {0.2f, 0.0f, 0.2f, 1.0f}},  // Brighter green
-        {.pos = {-0.5f, -0.5f}, .color = {0.2f, 0.2f, 0.5f, 1.0f}}, // Brighter blue
-    };
+    // Built once from the rest pose, every frame after only refits it.
+    DROP_UpdateScene(&s_spriteScene);
+    for (u32 i = 0; i < SPRITE_COUNT; ++i)
+    {
+        f32 center[3];
+        f32 extent[3];
+        GetSpriteBounds(i, center, extent);
+        DROP_CullAddObject(&s_spriteCullWorld, center, extent);
+    }
+    DROP_RebuildCullWorld(&s_spriteCullWorld);
 
-    if (!DROP_CreateVertexBuffer(
-            s_gfxHandle, vertices, sizeof(vertices), &s_pTriangleVB) ||
-        !s_pTriangleVB)
+    if (!DROP_CreateOcclusionBuffer(
+            SPRITE_OCCLUSION_WIDTH, SPRITE_OCCLUSION_HEIGHT, ARRAY_COUNT(s_panelIndices) / 3, &s_spriteOcclusion))
     {
-        LOG_ERROR("Failed to create triangle vertex buffer.");
-        for (u32 i = 0; i < VS_TABLE_COUNT; ++i)
-        {
-            RELEASE(pByteCodeList[i]);
-            RELEASE(s_pVSTable[i]);
-        }
-        for (u32 i = 0; i < PS_TABLE_COUNT; ++i)
-            RELEASE(s_pPSTable[i]);
-        return false;
-    }
-
-    D3D11_INPUT_ELEMENT_DESC basicVSLayouts[] = {
-        {.SemanticName         = "POSITION",
-         .SemanticIndex        = 0,
-         .Format               = DXGI_FORMAT_R32G32_FLOAT,
-         .InputSlot            = 0,
-         .AlignedByteOffset    = 0,
-         .InputSlotClass       = D3D11_INPUT_PER_VERTEX_DATA,
-         .InstanceDataStepRate = 0},
-        {.SemanticName         = "COLOR",
-         .SemanticIndex        = 0,
-         .Format               = DXGI_FORMAT_R32G32B32A32_FLOAT,
-         .InputSlot            = 0,
-         .AlignedByteOffset    = 8,
-         .InputSlotClass       = D3D11_INPUT_PER_VERTEX_DATA,
-         .InstanceDataStepRate = 0}};
-
-    if (!DROP_CreateInputLayout(
-            s_gfxHandle, basicVSLayouts, ARRAYSIZE(basicVSLayouts),
-            pByteCodeList[BASIC_VS_INDEX], &s_pBasicVSLayout) ||
-        !s_pBasicVSLayout)
-    {
-        LOG_ERROR("Failed to create input layout.");
-        s_pTriangleVB->lpVtbl->Release(s_pTriangleVB);
-        for (u32 i = 0; i < VS_TABLE_COUNT; ++i)
-        {
-            RELEASE(pByteCodeList[i]);
-            RELEASE(s_pVSTable[i]);
-        }
-        for (u32 i = 0; i < PS_TABLE_COUNT; ++i)
-            RELEASE(s_pPSTable[i]);
+        LOG_ERROR("Failed to create sprite occlusion buffer.");
+        DROP_DestroyCullWorld(&s_spriteCullWorld);
+        DROP_DestroyScene(&s_spriteScene);
         return false;
     }
 
-    for (u32 i = 0; i < VS_TABLE_COUNT; ++i)
-        RELEASE(pByteCodeList[i]);
-
     return true;
 }
-static bool InitializeRenderTargets()
+static bool InitializeRenderTargets(void* pUserData)
 {
     s_renderTargetsTable = (GfxRenderTarget*) DROP_Allocate(
         PERSISTENT, sizeof(GfxRenderTarget) * RENDER_TARGET_TABLE_COUNT);
@@ -558,46 +1074,315 @@ static bool InitializeRenderTargets()
         return false;
     }
 
-    s_renderTargetDivider[0] = 1;
-    s_renderTargetDivider[1] = 1;
-    s_renderTargetDivider[2] = 2;
-    s_renderTargetDivider[3] = 2;
-    s_renderTargetDivider[4] = 4;
-    s_renderTargetDivider[5] = 4;
+    // BLOOM_LEVELS=N sets the length of the bloom chain.
+    const char* bloomLevels = getenv("BLOOM_LEVELS");
+    if (bloomLevels && atoi(bloomLevels) > 0)
+        s_bloomLevelCount = (u32) atoi(bloomLevels);
+    if (s_bloomLevelCount > BLOOM_MAX_LEVELS)
+        s_bloomLevelCount = BLOOM_MAX_LEVELS;
+
+    // Levels past the end of the chain keep a divider of 0 and get no target.
+    s_renderTargetDivider[HDR_RENDER_TARGET_INDEX]        = 1;
+    s_renderTargetDivider[BLOOM_BLUR_RENDER_TARGET_INDEX] = 2u << (s_bloomLevelCount - 1);
+    for (u32 i = 0; i < s_bloomLevelCount; ++i)
+    {
+        s_renderTargetDivider[BLOOM_DOWN_RENDER_TARGET_INDEX + i] = 2u << i;
+        s_renderTargetDivider[BLOOM_UP_RENDER_TARGET_INDEX + i]   = 2u << i;
+    }
+
+    s_renderTargetFormat = (DXGI_FORMAT*) (DROP_Allocate(PERSISTENT, sizeof(DXGI_FORMAT) * RENDER_TARGET_TABLE_COUNT));
+    if (!s_renderTargetFormat)
+    {
+        LOG_ERROR("Failed to allocate memory for render target format.");
+        return false;
+    }
+
+    // The bloom chain never reads alpha or negative values, half the bytes of the HDR target are enough.
+    for (u32 i = 0; i < RENDER_TARGET_TABLE_COUNT; ++i)
+        s_renderTargetFormat[i] = DXGI_FORMAT_R11G11B10_FLOAT;
+    s_renderTargetFormat[HDR_RENDER_TARGET_INDEX] = DXGI_FORMAT_R16G16B16A16_FLOAT;
+
+    if (!DROP_CreateRenderTargetPool(s_gfxHandle, &s_renderTargetPool) || !s_renderTargetPool)
+    {
+        LOG_ERROR("Failed to create render target pool.");
+        return false;
+    }
+
+    if (!AcquireRenderTargets(s_wndHandle->width, s_wndHandle->height))
+    {
+        LOG_ERROR("Failed to create render targets.");
+        DROP_DestroyRenderTargetPool(&s_renderTargetPool);
+        return false;
+    }
+
+    return true;
+}
+static bool AcquireRenderTargets(u32 width, u32 height)
+{
+    // Sized from the size class of the window, so most resizes keep the targets they have.
+    u32 extentWidth  = DROP_RenderTargetSizeClass(width);
+    u32 extentHeight = DROP_RenderTargetSizeClass(height);
 
     for (u32 i = 0; i < RENDER_TARGET_TABLE_COUNT; ++i)
     {
-        if (!DROP_CreateHDRRenderTarget(
-                s_gfxHandle, s_wndHandle->width / s_renderTargetDivider[i],
-                s_wndHandle->height / s_renderTargetDivider[i], &s_renderTargetsTable[i]))
+        if (!s_renderTargetDivider[i])
+            continue;
+
+        GfxRenderTargetDesc desc = {
+            .width     = extentWidth / s_renderTargetDivider[i],
+            .height    = extentHeight / s_renderTargetDivider[i],
+            .format    = s_renderTargetFormat[i],
+            .bindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE};
+
+        GfxRenderTarget* pTarget = &s_renderTargetsTable[i];
+        if (pTarget->pTexture && pTarget->width == desc.width && pTarget->height == desc.height)
+            continue;
+
+        DROP_ReleaseRenderTarget(s_renderTargetPool, pTarget);
+        if (!DROP_AcquireRenderTarget(s_renderTargetPool, &desc, pTarget))
         {
-            LOG_ERROR("Failed to create render targets at index: %d", i);
-            for (u32 j = 0; j < i; ++j)
-                DROP_DestroyRenderTarget(&s_renderTargetsTable[j]);
+            LOG_ERROR("Failed to acquire render target at index: %d", i);
             return false;
         }
     }
 
     return true;
 }
-static void CleanupRenderTargets()
+static void CleanupRenderTargets(void* pUserData)
 {
     for (u32 i = 0; i < RENDER_TARGET_TABLE_COUNT; ++i)
-        DROP_DestroyRenderTarget(&s_renderTargetsTable[i]);
+        DROP_ReleaseRenderTarget(s_renderTargetPool, &s_renderTargetsTable[i]);
+    DROP_DestroyRenderTargetPool(&s_renderTargetPool);
+}
+static void CleanupShadersAndMeshes(void* pUserData)
+{
+    EntityQuery meshQuery = {
+        .all = COMPONENT_BIT(s_meshComponent)};
+    DROP_QueryEntities(&s_entityWorld, &meshQuery, ReleaseMeshes, NULL);
+    DROP_DestroyEntityWorld(&s_entityWorld);
+}
+static void CleanupBatch(void* pUserData)
+{
+    DROP_DestroyBatchRenderer(&s_batchRenderer);
+}
+static void CleanupSprites(void* pUserData)
+{
+    DROP_DestroyOcclusionBuffer(&s_spriteOcclusion);
+    DROP_DestroyCullWorld(&s_spriteCullWorld);
+    DROP_DestroyScene(&s_spriteScene);
 }
-static void CleanupShadersAndMeshes()
+#pragma endregion
+
+#pragma region STARTUP
+// Tasks on the window, the arenas, the tracked allocations or the pipeline cache run on the main thread,
+// the shader files and the device objects that need none of them on the workers.
+static bool BuildStartupGraph(TaskGraph* pGraph)
 {
-    SAFE_RELEASE(s_pBasicVSLayout);
-    SAFE_RELEASE(s_pTriangleVB);
+    DROP_InitTaskGraph(pGraph);
+
+    TaskDesc windowDesc        = {.name = "Window", .Run = InitializeWindow, .Cleanup = CleanupWindow, .isMainThread = true};
+    TaskDesc graphicsDesc      = {.name = "Graphics", .Run = InitializeGraphics, .Cleanup = CleanupGraphics, .isMainThread = true};
+    TaskDesc cachesDesc        = {.name = "Caches", .Run = InitializeCaches, .Cleanup = CleanupCaches, .isMainThread = true};
+    TaskDesc frameDesc         = {
+        .name         = "FrameResources",
+        .Run          = InitializeFrameResources,
+        .Cleanup      = CleanupFrameResources,
+        .isMainThread = true};
+    TaskDesc viewportsDesc     = {.name = "Viewports", .Run = InitializeViewports, .isMainThread = true};
+    TaskDesc renderTargetsDesc = {
+        .name         = "RenderTargets",
+        .Run          = InitializeRenderTargets,
+        .Cleanup      = CleanupRenderTargets,
+        .isMainThread = true};
+    TaskDesc createShadersDesc = {.name = "CreateShaders", .Run = CreateShaders};
+    TaskDesc meshesDesc        = {
+        .name         = "Meshes",
+        .Run          = InitializeShadersAndMeshes,
+        .Cleanup      = CleanupShadersAndMeshes,
+        .isMainThread = true};
+    TaskDesc batchDesc         = {.name = "Batch", .Run = InitializeBatch, .Cleanup = CleanupBatch, .isMainThread = true};
+    TaskDesc spritesDesc       = {
+        .name         = "Sprites",
+        .Run          = InitializeSprites,
+        .Cleanup      = CleanupSprites,
+        .isMainThread = true};
+    TaskDesc postResourcesDesc = {.name = "PostResources", .Run = InitializePostResources, .Cleanup = CleanupPostResources};
+    TaskDesc postPipelinesDesc = {.name = "PostPipelines", .Run = InitializePostPipelines, .isMainThread = true};
+
+    // The caches hold device objects, depending on the graphics puts their cleanup first.
+    u32 window        = 0;
+    u32 graphics      = 0;
+    u32 caches        = 0;
+    u32 viewports     = 0;
+    u32 renderTargets = 0;
+    if (!DROP_AddTask(pGraph, &windowDesc, NULL, 0, &window) ||
+        !DROP_AddTask(pGraph, &graphicsDesc, &window, 1, &graphics) ||
+        !DROP_AddTask(pGraph, &cachesDesc, &graphics, 1, &caches) ||
+        !DROP_AddTask(pGraph, &frameDesc, &graphics, 1, NULL) ||
+        !DROP_AddTask(pGraph, &viewportsDesc, &window, 1, &viewports) ||
+        !DROP_AddTask(pGraph, &spritesDesc, NULL, 0, NULL) ||
+        !DROP_AddTask(pGraph, &renderTargetsDesc, &graphics, 1, &renderTargets))
+        return false;
 
-    for (u32 i = 0; i < VS_TABLE_COUNT; ++i)
+    // The files are read from the start, the variants created once the device and the caches exist.
+    u32 createShadersDependencies[SHADER_LOAD_COUNT + 2] = {graphics, caches};
+    for (u32 i = 0; i < SHADER_LOAD_COUNT; ++i)
     {
-        SAFE_RELEASE(s_pVSTable[i]);
+        TaskDesc loadDesc = {
+            .name      = s_shaderLoads[i].taskName,
+            .Run       = LoadShader,
+            .Cleanup   = ReleaseShader,
+            .pUserData = &s_shaderLoads[i]};
+        if (!DROP_AddTask(pGraph, &loadDesc, NULL, 0, &createShadersDependencies[2 + i]))
+            return false;
     }
-    for (u32 i = 0; i < PS_TABLE_COUNT; ++i)
+
+    u32 createShaders = 0;
+    if (!DROP_AddTask(
+            pGraph, &createShadersDesc, createShadersDependencies, ARRAYSIZE(createShadersDependencies), &createShaders))
+        return false;
+
+    // The view cbuffer averages the bloom levels, their count is settled with the render targets.
+    u32 postResources               = 0;
+    u32 postResourcesDependencies[] = {graphics, renderTargets};
+    if (!DROP_AddTask(pGraph, &meshesDesc, &createShaders, 1, NULL) ||
+        !DROP_AddTask(pGraph, &batchDesc, &createShaders, 1, NULL) ||
+        !DROP_AddTask(
+            pGraph, &postResourcesDesc, postResourcesDependencies, ARRAYSIZE(postResourcesDependencies), &postResources))
+        return false;
+
+    u32 postPipelinesDependencies[] = {createShaders, postResources};
+    return DROP_AddTask(
+        pGraph, &postPipelinesDesc, postPipelinesDependencies, ARRAYSIZE(postPipelinesDependencies), NULL);
+}
+static bool LoadShader(void* pUserData)
+{
+    ShaderLoad* pLoad = (ShaderLoad*) pUserData;
+    return DROP_LoadShaderBinary(pLoad->stage, &pLoad->desc, &pLoad->binary);
+}
+static void ReleaseShader(void* pUserData)
+{
+    ShaderLoad* pLoad = (ShaderLoad*) pUserData;
+    DROP_ReleaseShaderBinary(&pLoad->binary);
+}
+static bool CreateShaders(void* pUserData)
+{
+    // The only task on the shader and layout caches until it is done, the device is free threaded.
+    for (u32 i = 0; i < SHADER_LOAD_COUNT; ++i)
     {
-        SAFE_RELEASE(s_pPSTable[i]);
+        if (!DROP_AddShaderVariant(s_gfxHandle, s_shaderCache, &s_shaderLoads[i].binary))
+        {
+            LOG_ERROR("Failed to create shader variant for %s.", s_shaderLoads[i].taskName);
+            return false;
+        }
+
+        // The byte code isn't needed past this point, the load cleanup finds nothing left to release.
+        DROP_ReleaseShaderBinary(&s_shaderLoads[i].binary);
     }
+
+    return true;
+}
+static bool InitializePostResources(void* pUserData)
+{
+    D3D11_SAMPLER_DESC samplerDesc = {
+        .Filter         = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+        .AddressU       = D3D11_TEXTURE_ADDRESS_CLAMP,
+        .AddressV       = D3D11_TEXTURE_ADDRESS_CLAMP,
+        .AddressW       = D3D11_TEXTURE_ADDRESS_CLAMP,
+        .MipLODBias     = 0.0f,
+        .MaxAnisotropy  = 1,
+        .ComparisonFunc = D3D11_COMPARISON_ALWAYS,
+        .MinLOD         = 0,
+        .MaxLOD         = D3D11_FLOAT32_MAX};
+
+    HRESULT hr = s_gfxHandle->pDevice->lpVtbl->CreateSamplerState(
+        s_gfxHandle->pDevice, &samplerDesc, &s_pLinearSampler);
+    if (FAILED(hr) || !s_pLinearSampler)
+    {
+        LOG_ERROR("Failed to create sampler state.");
+        return false;
+    }
+
+    // Rewritten only when the blur kernel changes.
+    D3D11_BUFFER_DESC bloomBufferDesc = {
+        .ByteWidth           = sizeof(BloomParams),
+        .Usage               = D3D11_USAGE_DEFAULT,
+        .BindFlags           = D3D11_BIND_CONSTANT_BUFFER,
+        .CPUAccessFlags      = 0,
+        .MiscFlags           = 0,
+        .StructureByteStride = 0};
+
+    hr = s_gfxHandle->pDevice->lpVtbl->CreateBuffer(
+        s_gfxHandle->pDevice, &bloomBufferDesc, NULL, &s_pBloomCBuffer);
+    if (FAILED(hr) || !s_pBloomCBuffer)
+    {
+        LOG_ERROR("Failed to create bloom constant buffer.");
+        SAFE_RELEASE(s_pLinearSampler);
+        return false;
+    }
+
+    D3D11_BUFFER_DESC viewBufferDesc = {
+        .ByteWidth           = sizeof(ViewParams),
+        .Usage               = D3D11_USAGE_DEFAULT,
+        .BindFlags           = D3D11_BIND_CONSTANT_BUFFER,
+        .CPUAccessFlags      = 0,
+        .MiscFlags           = 0,
+        .StructureByteStride = 0};
+
+    // The bloom is the sum of its levels, averaged here.
+    s_viewParams = (ViewParams) {.uvScale = {1.0f, 1.0f}, .bloomIntensity = 1.0f / (f32) s_bloomLevelCount};
+    D3D11_SUBRESOURCE_DATA viewInitData = {.pSysMem = &s_viewParams};
+
+    hr = s_gfxHandle->pDevice->lpVtbl->CreateBuffer(
+        s_gfxHandle->pDevice, &viewBufferDesc, &viewInitData, &s_pViewCBuffer);
+    if (FAILED(hr) || !s_pViewCBuffer)
+    {
+        LOG_ERROR("Failed to create view constant buffer.");
+        SAFE_RELEASE(s_pBloomCBuffer);
+        SAFE_RELEASE(s_pLinearSampler);
+        return false;
+    }
+    DROP_SetCaptureData((ID3D11DeviceChild*) s_pViewCBuffer, &s_viewParams, sizeof(ViewParams));
+
+    return true;
+}
+static void CleanupPostResources(void* pUserData)
+{
+    SAFE_RELEASE(s_pViewCBuffer);
+    SAFE_RELEASE(s_pBloomCBuffer);
+    SAFE_RELEASE(s_pLinearSampler);
+}
+static bool InitializePostPipelines(void* pUserData)
+{
+    // The pipelines live in the pipeline cache, nothing to release here on failure.
+    GfxPipelineDesc postDesc = {
+        .pVertexShader = NULL,
+        .pPixelShader  = NULL,
+        .pInputLayout  = NULL,
+        .topology      = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+        .pSamplers     = {s_pLinearSampler, NULL}};
+
+    bool isPipelineReady = DROP_GetVertexShader(
+        s_gfxHandle, s_shaderCache, &s_shaderLoads[COPY_VS_SHADER_INDEX].desc, &postDesc.pVertexShader, NULL);
+    isPipelineReady = isPipelineReady &&
+                      GetPostPipeline(&s_shaderLoads[BRIGHT_PASS_SHADER_INDEX].desc, &postDesc, &s_pBrightPassPipeline);
+    isPipelineReady = isPipelineReady &&
+                      GetPostPipeline(&s_shaderLoads[BLOOM_HORIZONTAL_SHADER_INDEX].desc, &postDesc, &s_pBloomHorizontalPipeline);
+    isPipelineReady = isPipelineReady &&
+                      GetPostPipeline(&s_shaderLoads[BLOOM_VERTICAL_SHADER_INDEX].desc, &postDesc, &s_pBloomVerticalPipeline);
+    isPipelineReady = isPipelineReady &&
+                      GetPostPipeline(&s_shaderLoads[DOWNSAMPLE_SHADER_INDEX].desc, &postDesc, &s_pDownsamplePipeline);
+    isPipelineReady = isPipelineReady &&
+                      GetPostPipeline(&s_shaderLoads[UPSAMPLE_SHADER_INDEX].desc, &postDesc, &s_pUpsamplePipeline);
+    isPipelineReady = isPipelineReady &&
+                      GetPostPipeline(&s_shaderLoads[COPY_PS_SHADER_INDEX].desc, &postDesc, &s_pCopyPipeline);
+    if (!isPipelineReady)
+    {
+        LOG_ERROR("Failed to create post process pipeline states.");
+        return false;
+    }
+
+    return true;
 }
 #pragma endregion
 
@@ -610,48 +1395,77 @@ static bool OnClose()
 }
 static bool OnResize(RECT* pRect)
 {
-    u32 width  = pRect->right - pRect->left;
-    u32 height = pRect->bottom - pRect->top;
+    // A drag sends many of these between two frames, they are applied once in ApplyResize.
+    s_wndHandle->width  = pRect->right - pRect->left;
+    s_wndHandle->height = pRect->bottom - pRect->top;
+    s_isResizePending   = true;
+
+    return false;
+}
+static bool ApplyResize()
+{
+    s_isResizePending = false;
+
+    u32 width  = s_wndHandle->width;
+    u32 height = s_wndHandle->height;
+
+    // Minimized windows report an empty client area, everything stays as is until restored.
+    if (!width || !height)
+        return true;
+
+    // The capture holds references on the render targets, the swap chain can't resize with them.
+    if (DROP_IsCapturing())
+        DROP_EndCapture(s_gfxHandle);
 
-    s_wndHandle->width  = width;
-    s_wndHandle->height = height;
+    // The bound back buffer view keeps a reference too.
+    s_gfxHandle->pContext->lpVtbl->OMSetRenderTargets(s_gfxHandle->pContext, 0, NULL, NULL);
 
     if (!DROP_ResizeGraphics(s_gfxHandle, width, height))
     {
         ASSERT_MSG(false, "Failed to resize graphics.");
-        PostQuitMessage(0);
-        s_isRunning = false;
-        return true;
+        return false;
     }
 
-    for (u32 i = 0; i < VIEWPORT_TABLE_COUNT; ++i)
+    UpdateViewports(width, height);
+
+    if (!AcquireRenderTargets(width, height))
     {
-        s_viewportTable[i].Width  = width / s_viewportDivider[i];
-        s_viewportTable[i].Height = height / s_viewportDivider[i];
+        LOG_ERROR("Failed to resize render targets.");
+        return false;
     }
 
-    for (u32 i = 0; i < RENDER_TARGET_TABLE_COUNT; ++i)
+    return true;
+}
+static bool InitializeCore()
+{
+    // Before the startup graph, which runs on the job system.
+    if (!DROP_CreateJobSystem(0))
     {
-        RELEASE(s_renderTargetsTable[i].pRTV);
-        RELEASE(s_renderTargetsTable[i].pSRV);
-        RELEASE(s_renderTargetsTable[i].pTexture);
+        LOG_ERROR("Failed to create job system.");
+        return false;
+    }
 
-        if (!DROP_CreateHDRRenderTarget(
-                s_gfxHandle, width / s_renderTargetDivider[i], height / s_renderTargetDivider[i],
-                &s_renderTargetsTable[i]))
-        {
-            LOG_ERROR("Failed to resize render target at index: %d", i);
-            PostQuitMessage(0);
-            s_isRunning = false;
-            return true;
-        }
+#ifdef PROFILE
+    if (!DROP_CreateProfiler())
+    {
+        LOG_ERROR("Failed to create profiler.");
+        DROP_DestroyJobSystem();
+        return false;
     }
+#endif // PROFILE
 
-    return false;
+    return true;
 }
-static bool InitializeCore()
+static void CleanupCore()
+{
+    DROP_DestroyJobSystem();
+#ifdef PROFILE
+    // After the job system, no thread may still be in a zone.
+    DROP_DestroyProfiler();
+#endif // PROFILE
+}
+static bool InitializeWindow(void* pUserData)
 {
-
     WndInitProps wndProps = {
         .title    = L"Learning DX11",
         .width    = 1280,
@@ -666,22 +1480,101 @@ static bool InitializeCore()
         return false;
     }
 
+    return true;
+}
+static void CleanupWindow(void* pUserData)
+{
+    DROP_DestroyWindow(&s_wndHandle);
+}
+static bool InitializeGraphics(void* pUserData)
+{
     GfxInitProps gfxProps = {
         .wndHandle = s_wndHandle};
 
     if (!DROP_CreateGraphics(&gfxProps, &s_gfxHandle) || !s_gfxHandle)
     {
         LOG_ERROR("Failed to create graphics.");
-        DROP_DestroyWindow(&s_wndHandle);
         return false;
     }
 
     return true;
 }
-static void CleanupCore()
+static void CleanupGraphics(void* pUserData)
 {
     DROP_DestroyGraphics(&s_gfxHandle);
-    DROP_DestroyWindow(&s_wndHandle);
+}
+static bool InitializeCaches(void* pUserData)
+{
+    if (!DROP_CreatePipelineCache(&s_pipelineCache) || !s_pipelineCache)
+    {
+        LOG_ERROR("Failed to create pipeline cache.");
+        return false;
+    }
+
+    if (!DROP_CreateInputLayoutCache(&s_inputLayoutCache) || !s_inputLayoutCache)
+    {
+        LOG_ERROR("Failed to create input layout cache.");
+        DROP_DestroyPipelineCache(&s_pipelineCache);
+        return false;
+    }
+
+    if (!DROP_CreateShaderCache(s_inputLayoutCache, &s_shaderCache) || !s_shaderCache)
+    {
+        LOG_ERROR("Failed to create shader cache.");
+        DROP_DestroyInputLayoutCache(&s_inputLayoutCache);
+        DROP_DestroyPipelineCache(&s_pipelineCache);
+        return false;
+    }
+
+    if (!DROP_CreateRenderQueue(RENDER_QUEUE_CAPACITY, &s_renderQueue) || !s_renderQueue)
+    {
+        LOG_ERROR("Failed to create render queue.");
+        DROP_DestroyShaderCache(&s_shaderCache);
+        DROP_DestroyInputLayoutCache(&s_inputLayoutCache);
+        DROP_DestroyPipelineCache(&s_pipelineCache);
+        return false;
+    }
+
+    return true;
+}
+static void CleanupCaches(void* pUserData)
+{
+    DROP_DestroyRenderQueue(&s_renderQueue);
+    DROP_DestroyPipelineCache(&s_pipelineCache);
+    DROP_DestroyShaderCache(&s_shaderCache);
+    DROP_DestroyInputLayoutCache(&s_inputLayoutCache);
+}
+static bool InitializeFrameResources(void* pUserData)
+{
+    if (!DROP_CreateFrameFence(s_gfxHandle, &s_frameFence))
+    {
+        LOG_ERROR("Failed to create frame fence.");
+        return false;
+    }
+
+    if (!DROP_CreateGpuTimer(s_gfxHandle, &s_gpuTimer))
+    {
+        LOG_ERROR("Failed to create GPU timer.");
+        DROP_DestroyFrameFence(&s_frameFence);
+        return false;
+    }
+
+    // One arena per frame in flight and one for the frame being built.
+    if (!DROP_MakeFrameArenas(&s_frameArenas, GFX_MAX_FRAMES_IN_FLIGHT + 1, FRAME_ARENA_SIZE))
+    {
+        LOG_ERROR("Failed to make frame arenas.");
+        DROP_DestroyGpuTimer(&s_gpuTimer);
+        DROP_DestroyFrameFence(&s_frameFence);
+        return false;
+    }
+
+    return true;
+}
+static void CleanupFrameResources(void* pUserData)
+{
+    DROP_DestroyFrameArenas(&s_frameArenas);
+    DROP_DestroyGpuTimer(&s_gpuTimer);
+    DROP_DestroyFrameFence(&s_frameFence);
 }
 #pragma endregion CORE
 
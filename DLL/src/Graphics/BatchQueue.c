@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "Graphics/BatchQueue.h"
+
+#pragma region INTERNAL
+static u32 FindOrAddGroup(BatchQueue* pQueue, BatchPrimitive primitive, const void* pPixelShader, const void* pSRV)
+{
+    // Consecutive submits almost always hit the same group.
+    if (pQueue->groupCount > 0)
+    {
+        const BatchGroup* pLast = &pQueue->groups[pQueue->lastGroup];
+        if (pLast->pPixelShader == pPixelShader && pLast->pSRV == pSRV && pLast->primitive == primitive)
+            return pQueue->lastGroup;
+    }
+
+    for (u32 i = 0; i < pQueue->groupCount; ++i)
+    {
+        const BatchGroup* pGroup = &pQueue->groups[i];
+        if (pGroup->pPixelShader == pPixelShader && pGroup->pSRV == pSRV && pGroup->primitive == primitive)
+            return i;
+    }
+
+    if (pQueue->groupCount == BATCH_MAX_GROUPS)
+        return BATCH_MAX_GROUPS;
+
+    BatchGroup* pGroup    = &pQueue->groups[pQueue->groupCount];
+    pGroup->pPixelShader  = pPixelShader;
+    pGroup->pSRV          = pSRV;
+    pGroup->primitive     = primitive;
+    pGroup->firstInstance = 0;
+    pGroup->instanceCount = 0;
+
+    return pQueue->groupCount++;
+}
+
+static bool GroupLess(const BatchGroup* pA, const BatchGroup* pB)
+{
+    // Keep groups that share a pixel shader next to each other so only the texture changes between them.
+    if (pA->pPixelShader != pB->pPixelShader)
+        return (uintptr_t) pA->pPixelShader < (uintptr_t) pB->pPixelShader;
+    if (pA->pSRV != pB->pSRV)
+        return (uintptr_t) pA->pSRV < (uintptr_t) pB->pSRV;
+    return pA->primitive < pB->primitive;
+}
+#pragma endregion
+
+bool DROP_MakeBatchQueue(BatchQueue* pQueue, u32 maxInstances)
+{
+    ASSERT_MSG(pQueue, "Batch queue pointer is null.");
+    ASSERT_MSG(maxInstances > 0, "Batch queue capacity must be greater than zero.");
+
+    ZERO_MEM(pQueue, 1);
+
+    pQueue->pInstances       = (BatchInstance*) ALLOC(BatchInstance, maxInstances);
+    pQueue->pSortedInstances = (BatchInstance*) ALLOC(BatchInstance, maxInstances);
+    pQueue->pGroupIndices    = (u8*) ALLOC(u8, maxInstances);
+    pQueue->maxInstances     = maxInstances;
+    if (!pQueue->pInstances || !pQueue->pSortedInstances || !pQueue->pGroupIndices)
+    {
+        LOG_ERROR("Failed to allocate batch queue.");
+        DROP_DestroyBatchQueue(pQueue);
+        return false;
+    }
+
+    return true;
+}
+
+void DROP_DestroyBatchQueue(BatchQueue* pQueue)
+{
+    ASSERT_MSG(pQueue, "Batch queue pointer is null.");
+
+    if (pQueue->pGroupIndices) FREE(pQueue->pGroupIndices);
+    if (pQueue->pSortedInstances) FREE(pQueue->pSortedInstances);
+    if (pQueue->pInstances) FREE(pQueue->pInstances);
+
+    ZERO_MEM(pQueue, 1);
+}
+
+void DROP_BatchQueueReset(BatchQueue* pQueue)
+{
+    ASSERT_MSG(pQueue, "Batch queue pointer is null.");
+
+    pQueue->instanceCount = 0;
+    pQueue->groupCount    = 0;
+    pQueue->lastGroup     = 0;
+}
+
+bool DROP_BatchQueuePush(
+    BatchQueue* pQueue, BatchPrimitive primitive, const void* pPixelShader, const void* pSRV, const f32 basis[4],
+    const f32 translation[2], const f32 color[4])
+{
+    ASSERT_MSG(pQueue, "Batch queue pointer is null.");
+    ASSERT_MSG(primitive < BATCH_PRIMITIVE_COUNT, "Invalid batch primitive.");
+
+    if (pQueue->instanceCount == pQueue->maxInstances)
+        return false;
+
+    u32 group = FindOrAddGroup(pQueue, primitive, pPixelShader, pSRV);
+    if (group == BATCH_MAX_GROUPS)
+        return false;
+
+    pQueue->lastGroup = group;
+    ++pQueue->groups[group].instanceCount;
+
+    BatchInstance* pInstance  = &pQueue->pInstances[pQueue->instanceCount];
+    pInstance->basis[0]       = basis[0];
+    pInstance->basis[1]       = basis[1];
+    pInstance->basis[2]       = basis[2];
+    pInstance->basis[3]       = basis[3];
+    pInstance->translation[0] = translation[0];
+    pInstance->translation[1] = translation[1];
+    pInstance->primitive      = (u32) primitive;
+    pInstance->color[0]       = color[0];
+    pInstance->color[1]       = color[1];
+    pInstance->color[2]       = color[2];
+    pInstance->color[3]       = color[3];
+
+    pQueue->pGroupIndices[pQueue->instanceCount] = (u8) group;
+    ++pQueue->instanceCount;
+
+    return true;
+}
+
+void DROP_BatchQueueSort(BatchQueue* pQueue)
+{
+    ASSERT_MSG(pQueue, "Batch queue pointer is null.");
+
+    // Insertion sort over at most BATCH_MAX_GROUPS entries.
+    for (u32 i = 0; i < pQueue->groupCount; ++i)
+    {
+        u32 j = i;
+        while (j > 0 && GroupLess(&pQueue->groups[i], &pQueue->groups[pQueue->groupOrder[j - 1]]))
+        {
+            pQueue->groupOrder[j] = pQueue->groupOrder[j - 1];
+            --j;
+        }
+        pQueue->groupOrder[j] = (u8) i;
+    }
+
+    u32 cursor[BATCH_MAX_GROUPS];
+    u32 first = 0;
+    for (u32 i = 0; i < pQueue->groupCount; ++i)
+    {
+        u32         group     = pQueue->groupOrder[i];
+        BatchGroup* pGroup    = &pQueue->groups[group];
+        pGroup->firstInstance = first;
+        cursor[group]         = first;
+        first += pGroup->instanceCount;
+    }
+
+    // Counting sort scatter. Stable, so submission order is kept inside a group.
+    for (u32 i = 0; i < pQueue->instanceCount; ++i)
+        pQueue->pSortedInstances[cursor[pQueue->pGroupIndices[i]]++] = pQueue->pInstances[i];
+}
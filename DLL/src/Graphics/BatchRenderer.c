@@ -0,0 +1,178 @@
+#include "pch.h"
+#include "Graphics/BatchRenderer.h"
+
+#define BATCH_INSTANCE_ALIGNMENT 16
+
+static const u32 s_primitiveVertexCount[BATCH_PRIMITIVE_COUNT] = {3, 6};
+
+bool DROP_CreateBatchRenderer(const GfxHandle handle, const BatchInitProps* pProps, BatchRenderer* pBatch)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pProps && pProps->maxInstances > 0, "Batch properties are invalid.");
+    ASSERT_MSG(pProps->shaderCache && pProps->pVertexShaderDesc && pProps->pPixelShaderDesc, "Batch shaders are null.");
+    ASSERT_MSG(pProps->pVertexShaderDesc->inputClass == D3D11_INPUT_PER_INSTANCE_DATA, "Batch input is per vertex.");
+    ASSERT_MSG(pBatch, "Batch pointer is null.");
+
+    *pBatch = NULL;
+
+    // The layout comes from the reflected input signature, which BatchInstance follows.
+    ID3D11VertexShader* pVertexShader = NULL;
+    ID3D11InputLayout*  pInputLayout  = NULL;
+    ID3D11PixelShader*  pPixelShader  = NULL;
+    if (!DROP_GetVertexShader(handle, pProps->shaderCache, pProps->pVertexShaderDesc, &pVertexShader, &pInputLayout) ||
+        !pInputLayout || !DROP_GetPixelShader(handle, pProps->shaderCache, pProps->pPixelShaderDesc, &pPixelShader))
+    {
+        LOG_ERROR("Failed to create batch shaders.");
+        return false;
+    }
+
+    GfxDynamicBuffer instanceBuffer;
+    if (!DROP_CreateDynamicBuffer(
+            handle, sizeof(BatchInstance) * pProps->maxInstances * BATCH_BUFFER_FRAMES, D3D11_BIND_VERTEX_BUFFER,
+            &instanceBuffer))
+    {
+        LOG_ERROR("Failed to create batch instance buffer.");
+        return false;
+    }
+
+    BatchRenderer batch = (BatchRenderer) ALLOC(_BatchRenderer, 1);
+    if (!batch)
+    {
+        LOG_ERROR("Failed to allocate memory for batch renderer.");
+        DROP_DestroyDynamicBuffer(&instanceBuffer);
+        return false;
+    }
+
+    ZERO_MEM(batch, 1);
+    if (!DROP_MakeBatchQueue(&batch->queue, pProps->maxInstances))
+    {
+        FREE(batch);
+        DROP_DestroyDynamicBuffer(&instanceBuffer);
+        return false;
+    }
+
+    batch->gfxHandle           = handle;
+    batch->pVertexShader       = pVertexShader;
+    batch->pDefaultPixelShader = pPixelShader;
+    batch->pInputLayout        = pInputLayout;
+    batch->instanceBuffer      = instanceBuffer;
+
+    *pBatch = batch;
+
+    return true;
+}
+
+void DROP_DestroyBatchRenderer(BatchRenderer* pBatch)
+{
+    ASSERT_MSG(pBatch && *pBatch, "Batch renderer is null.");
+    BatchRenderer batch = *pBatch;
+
+    if (batch)
+    {
+        DROP_DestroyDynamicBuffer(&batch->instanceBuffer);
+        DROP_DestroyBatchQueue(&batch->queue);
+
+        FREE(batch);
+    }
+
+    *pBatch = NULL;
+}
+
+void DROP_BatchBegin(BatchRenderer batch)
+{
+    ASSERT_MSG(batch, "Batch renderer is null.");
+
+    DROP_BatchQueueReset(&batch->queue);
+    batch->drawCount        = 0;
+    batch->flushedInstances = 0;
+}
+
+void DROP_BatchSubmit(
+    BatchRenderer batch, BatchPrimitive primitive, ID3D11PixelShader* pPixelShader, ID3D11ShaderResourceView* pSRV,
+    const f32 basis[4], const f32 translation[2], const f32 color[4])
+{
+    ASSERT_MSG(batch, "Batch renderer is null.");
+    ASSERT_MSG(primitive < BATCH_PRIMITIVE_COUNT, "Invalid batch primitive.");
+
+    if (!pPixelShader)
+        pPixelShader = batch->pDefaultPixelShader;
+
+    if (!DROP_BatchQueuePush(&batch->queue, primitive, pPixelShader, pSRV, basis, translation, color))
+    {
+        DROP_BatchFlush(batch);
+        DROP_BatchQueuePush(&batch->queue, primitive, pPixelShader, pSRV, basis, translation, color);
+    }
+}
+
+void DROP_BatchFlush(BatchRenderer batch)
+{
+    ASSERT_MSG(batch, "Batch renderer is null.");
+
+    BatchQueue* pQueue = &batch->queue;
+    if (pQueue->instanceCount == 0)
+        return;
+
+    DROP_BatchQueueSort(pQueue);
+
+    // Appended after the instances the GPU may still be reading, no DISCARD and no rename of the buffer.
+    u32 offset = 0;
+    if (!DROP_DynamicBufferWrite(
+            batch->gfxHandle, &batch->instanceBuffer, pQueue->pSortedInstances,
+            sizeof(BatchInstance) * pQueue->instanceCount, BATCH_INSTANCE_ALIGNMENT, &offset))
+    {
+        LOG_ERROR("Failed to upload %u batch instances.", pQueue->instanceCount);
+        DROP_BatchQueueReset(pQueue);
+        return;
+    }
+
+    ID3D11DeviceContext* pContext = batch->gfxHandle->pContext;
+
+    u32 stride = sizeof(BatchInstance);
+    pContext->lpVtbl->VSSetShader(pContext, batch->pVertexShader, NULL, 0);
+    pContext->lpVtbl->IASetInputLayout(pContext, batch->pInputLayout);
+    pContext->lpVtbl->IASetVertexBuffers(pContext, 0, 1, &batch->instanceBuffer.pBuffer, &stride, &offset);
+    pContext->lpVtbl->IASetPrimitiveTopology(pContext, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    // Groups are sorted by shader then texture, so only bind what changed from the previous group.
+    ID3D11PixelShader*        pBoundShader = NULL;
+    ID3D11ShaderResourceView* pBoundSRV    = NULL;
+    for (u32 i = 0; i < pQueue->groupCount; ++i)
+    {
+        const BatchGroup*         pGroup       = &pQueue->groups[pQueue->groupOrder[i]];
+        ID3D11PixelShader*        pPixelShader = (ID3D11PixelShader*) pGroup->pPixelShader;
+        ID3D11ShaderResourceView* pSRV         = (ID3D11ShaderResourceView*) pGroup->pSRV;
+
+        if (i == 0 || pPixelShader != pBoundShader)
+        {
+            pContext->lpVtbl->PSSetShader(pContext, pPixelShader, NULL, 0);
+            pBoundShader = pPixelShader;
+        }
+        if (i == 0 || pSRV != pBoundSRV)
+        {
+            pContext->lpVtbl->PSSetShaderResources(pContext, 0, 1, &pSRV);
+            pBoundSRV = pSRV;
+        }
+
+        pContext->lpVtbl->DrawInstanced(
+            pContext, s_primitiveVertexCount[pGroup->primitive], pGroup->instanceCount, 0, pGroup->firstInstance);
+        ++batch->drawCount;
+    }
+    DROP_AddCounter(COUNTER_DRAW_CALLS, pQueue->groupCount);
+
+    batch->flushedInstances += pQueue->instanceCount;
+    DROP_BatchQueueReset(pQueue);
+}
+
+void DROP_BatchEndFrame(BatchRenderer batch, u64 frameIndex)
+{
+    ASSERT_MSG(batch, "Batch renderer is null.");
+
+    DROP_DynamicBufferEndFrame(&batch->instanceBuffer, frameIndex);
+}
+
+void DROP_BatchRetireFrames(BatchRenderer batch, u64 completedFrame)
+{
+    ASSERT_MSG(batch, "Batch renderer is null.");
+
+    DROP_DynamicBufferRetire(&batch->instanceBuffer, completedFrame);
+}
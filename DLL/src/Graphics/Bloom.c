@@ -0,0 +1,244 @@
+#include "pch.h"
+#include "Graphics/Bloom.h"
+#include "Math/PackedFloat.h"
+
+#include <math.h>
+
+#pragma region INTERNAL
+typedef struct
+{
+    f32* pPixels;
+    u32  width;
+    u32  height;
+} BloomLevel;
+
+static inline u32 ClampIndex(i32 index, u32 count)
+{
+    if (index < 0)
+        return 0;
+    return (u32) index >= count ? count - 1 : (u32) index;
+}
+
+// Bilinear fetch with clamp addressing, what the linear sampler does.
+static void Sample(const BloomLevel* pLevel, f32 u, f32 v, f32* pColor)
+{
+    f32 x     = u * (f32) pLevel->width - 0.5f;
+    f32 y     = v * (f32) pLevel->height - 0.5f;
+    f32 left  = floorf(x);
+    f32 top   = floorf(y);
+    f32 fracX = x - left;
+    f32 fracY = y - top;
+
+    u32 x0 = ClampIndex((i32) left, pLevel->width);
+    u32 x1 = ClampIndex((i32) left + 1, pLevel->width);
+    u32 y0 = ClampIndex((i32) top, pLevel->height);
+    u32 y1 = ClampIndex((i32) top + 1, pLevel->height);
+
+    const f32* p00 = &pLevel->pPixels[(y0 * pLevel->width + x0) * 4];
+    const f32* p10 = &pLevel->pPixels[(y0 * pLevel->width + x1) * 4];
+    const f32* p01 = &pLevel->pPixels[(y1 * pLevel->width + x0) * 4];
+    const f32* p11 = &pLevel->pPixels[(y1 * pLevel->width + x1) * 4];
+
+    for (u32 c = 0; c < 4; ++c)
+    {
+        f32 upper = p00[c] + (p10[c] - p00[c]) * fracX;
+        f32 lower = p01[c] + (p11[c] - p01[c]) * fracX;
+        pColor[c] = upper + (lower - upper) * fracY;
+    }
+}
+
+static void AddSample(const BloomLevel* pLevel, f32 u, f32 v, f32 weight, f32* pColor)
+{
+    f32 color[4];
+    Sample(pLevel, u, v, color);
+    for (u32 c = 0; c < 4; ++c)
+        pColor[c] += color[c] * weight;
+}
+
+// The GPU targets are R11G11B10, the next pass reads what they kept.
+static void StoreLevel(const BloomLevel* pLevel, u32* pScratch)
+{
+    u32 count = pLevel->width * pLevel->height;
+    DROP_PackR11G11B10Pixels(pLevel->pPixels, pScratch, count);
+    DROP_UnpackR11G11B10Pixels(pScratch, pLevel->pPixels, count);
+}
+
+static void BrightPass(const BloomLevel* pSource, const BloomLevel* pTarget)
+{
+    for (u32 y = 0; y < pTarget->height; ++y)
+    {
+        for (u32 x = 0; x < pTarget->width; ++x)
+        {
+            f32* pColor = &pTarget->pPixels[(y * pTarget->width + x) * 4];
+            Sample(pSource, (x + 0.5f) / pTarget->width, (y + 0.5f) / pTarget->height, pColor);
+
+            f32 intensity = fmaxf(pColor[0], fmaxf(pColor[1], pColor[2]));
+            if (intensity > BLOOM_THRESHOLD)
+                pColor[3] = 1.0f;
+            else
+                pColor[0] = pColor[1] = pColor[2] = pColor[3] = 0.0f;
+        }
+    }
+}
+
+// Same taps and weights as downsample.hlsl.
+static void Downsample(const BloomLevel* pSource, const BloomLevel* pTarget)
+{
+    static const f32 taps[13][3] = {
+        {-1.0f, -1.0f, 0.125f}, {1.0f, -1.0f, 0.125f}, {-1.0f, 1.0f, 0.125f}, {1.0f, 1.0f, 0.125f},
+        {-2.0f, -2.0f, 0.03125f}, {2.0f, -2.0f, 0.03125f}, {-2.0f, 2.0f, 0.03125f}, {2.0f, 2.0f, 0.03125f},
+        {0.0f, -2.0f, 0.0625f}, {-2.0f, 0.0f, 0.0625f}, {2.0f, 0.0f, 0.0625f}, {0.0f, 2.0f, 0.0625f},
+        {0.0f, 0.0f, 0.125f}};
+
+    f32 texelU = 1.0f / pSource->width;
+    f32 texelV = 1.0f / pSource->height;
+
+    for (u32 y = 0; y < pTarget->height; ++y)
+    {
+        for (u32 x = 0; x < pTarget->width; ++x)
+        {
+            f32  u      = (x + 0.5f) / pTarget->width;
+            f32  v      = (y + 0.5f) / pTarget->height;
+            f32* pColor = &pTarget->pPixels[(y * pTarget->width + x) * 4];
+            ZERO_MEM(pColor, 4);
+
+            for (u32 i = 0; i < ARRAY_COUNT(taps); ++i)
+                AddSample(pSource, u + texelU * taps[i][0], v + texelV * taps[i][1], taps[i][2], pColor);
+        }
+    }
+}
+
+// Same as bloom.hlsl, the target is the size of the source.
+static void Blur(const BloomLevel* pSource, const BloomLevel* pTarget, const GaussianKernel* pKernel, bool isHorizontal)
+{
+    f32 texelU = isHorizontal ? 1.0f / pTarget->width : 0.0f;
+    f32 texelV = isHorizontal ? 0.0f : 1.0f / pTarget->height;
+
+    for (u32 y = 0; y < pTarget->height; ++y)
+    {
+        for (u32 x = 0; x < pTarget->width; ++x)
+        {
+            f32  u      = (x + 0.5f) / pTarget->width;
+            f32  v      = (y + 0.5f) / pTarget->height;
+            f32* pColor = &pTarget->pPixels[(y * pTarget->width + x) * 4];
+            ZERO_MEM(pColor, 4);
+
+            AddSample(pSource, u, v, pKernel->centerWeight, pColor);
+            for (u32 i = 0; i < pKernel->tapCount; ++i)
+            {
+                f32 offsetU = texelU * pKernel->offsets[i];
+                f32 offsetV = texelV * pKernel->offsets[i];
+                AddSample(pSource, u + offsetU, v + offsetV, pKernel->weights[i], pColor);
+                AddSample(pSource, u - offsetU, v - offsetV, pKernel->weights[i], pColor);
+            }
+        }
+    }
+}
+
+// Same as upsample.hlsl.
+static void Upsample(const BloomLevel* pLevel, const BloomLevel* pLower, const BloomLevel* pTarget)
+{
+    f32 texelU = 1.0f / pLower->width;
+    f32 texelV = 1.0f / pLower->height;
+
+    for (u32 y = 0; y < pTarget->height; ++y)
+    {
+        for (u32 x = 0; x < pTarget->width; ++x)
+        {
+            f32  u      = (x + 0.5f) / pTarget->width;
+            f32  v      = (y + 0.5f) / pTarget->height;
+            f32* pColor = &pTarget->pPixels[(y * pTarget->width + x) * 4];
+            ZERO_MEM(pColor, 4);
+
+            for (i32 j = -1; j <= 1; ++j)
+            {
+                for (i32 i = -1; i <= 1; ++i)
+                {
+                    f32 weight = (f32) ((2 - abs(i)) * (2 - abs(j))) / 16.0f;
+                    AddSample(pLower, u + texelU * i, v + texelV * j, weight, pColor);
+                }
+            }
+
+            AddSample(pLevel, u, v, 1.0f, pColor);
+        }
+    }
+}
+#pragma endregion
+
+bool DROP_ComputeBloomReference(
+    const f32* pSource, u32 width, u32 height, u32 levelCount, const GaussianKernel* pBlurKernel, f32* pBloom)
+{
+    ASSERT_MSG(pSource, "Source pixels are null.");
+    ASSERT_MSG(pBlurKernel, "Blur kernel is null.");
+    ASSERT_MSG(pBloom, "Bloom pixels are null.");
+    ASSERT_MSG(width > 0 && height > 0, "Source is empty.");
+    ASSERT_MSG(levelCount > 0 && levelCount <= BLOOM_MAX_LEVELS, "Bloom level count out of range.");
+
+    BloomLevel source = {(f32*) pSource, width, height};
+    BloomLevel down[BLOOM_MAX_LEVELS];
+    BloomLevel up[BLOOM_MAX_LEVELS];
+    BloomLevel blur;
+
+    // Level 0 of the upsample chain is the result, the others live in one block.
+    u64 pixelCount = 0;
+    for (u32 i = 0; i < levelCount; ++i)
+    {
+        down[i].width  = DROP_BloomLevelSize(width, i);
+        down[i].height = DROP_BloomLevelSize(height, i);
+        up[i]          = down[i];
+        pixelCount += (u64) down[i].width * down[i].height * (i == 0 ? 1 : 2);
+    }
+    blur = down[levelCount - 1];
+    pixelCount += (u64) blur.width * blur.height;
+
+    f32* pPixels  = (f32*) ALLOC(f32, pixelCount * 4);
+    u32* pScratch = (u32*) ALLOC(u32, (u64) down[0].width * down[0].height);
+    if (!pPixels || !pScratch)
+    {
+        LOG_ERROR("Failed to allocate bloom reference levels.");
+        if (pPixels)
+            FREE(pPixels);
+        if (pScratch)
+            FREE(pScratch);
+        return false;
+    }
+
+    f32* pNext = pPixels;
+    for (u32 i = 0; i < levelCount; ++i)
+    {
+        down[i].pPixels = pNext;
+        pNext += down[i].width * down[i].height * 4;
+        if (i > 0)
+        {
+            up[i].pPixels = pNext;
+            pNext += up[i].width * up[i].height * 4;
+        }
+    }
+    up[0].pPixels = pBloom;
+    blur.pPixels  = pNext;
+
+    BrightPass(&source, &down[0]);
+    StoreLevel(&down[0], pScratch);
+    for (u32 i = 1; i < levelCount; ++i)
+    {
+        Downsample(&down[i - 1], &down[i]);
+        StoreLevel(&down[i], pScratch);
+    }
+
+    u32 bottom = levelCount - 1;
+    Blur(&down[bottom], &blur, pBlurKernel, true);
+    StoreLevel(&blur, pScratch);
+    Blur(&blur, &up[bottom], pBlurKernel, false);
+    StoreLevel(&up[bottom], pScratch);
+
+    for (u32 i = bottom; i-- > 0;)
+    {
+        Upsample(&down[i], &up[i + 1], &up[i]);
+        StoreLevel(&up[i], pScratch);
+    }
+
+    FREE(pScratch);
+    FREE(pPixels);
+
+    return true;
+}
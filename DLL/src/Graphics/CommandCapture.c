@@ -0,0 +1,1196 @@
+#include "pch.h"
+#include "Graphics/CommandCapture.h"
+
+#include <d3d11_4.h>
+
+#pragma region INTERNAL
+#define CAPTURE_INITIAL_COMMAND_BYTES MB(1)
+#define CAPTURE_INITIAL_DATA_BYTES KB(64)
+#define CAPTURE_MAX_PENDING_MAPS 8
+#define CAPTURE_STATE_SRV_SLOTS 16 // Shader resource slots read back when the capture starts, out of 128.
+#define CAPTURE_FILE_NAME_SIZE 260
+
+typedef struct
+{
+    ID3D11Resource* pResource;
+    u32             subresource;
+    u32             mapType;
+    const void*     pData;
+    u32             writtenBegin; // Bytes written, from DROP_CaptureWrittenRange.
+    u32             writtenEnd;
+    bool            hasRange;
+} PendingMap;
+
+typedef struct
+{
+    ID3D11DeviceContext*           pContext;
+    const ID3D11DeviceContextVtbl* pOriginal;
+
+    // The runtime's table is copied up to the newest interface it implements, so calls through
+    // ID3D11DeviceContext1 and later still find their entries. Only the base methods are hooked.
+    union
+    {
+        ID3D11DeviceContextVtbl  base;
+        ID3D11DeviceContext4Vtbl latest;
+    } hooks;
+
+    char fileName[CAPTURE_FILE_NAME_SIZE];
+    u32  framesLeft;
+    u32  recordedFrames;
+
+    u8* pCommands;
+    u64 commandBytes;
+    u64 commandCapacity;
+    u64 recordedBytes; // End of the last complete frame.
+
+    u8* pData; // Object data, see CaptureFormat.h.
+    u64 dataBytes;
+    u64 dataCapacity;
+
+    // Every object seen in a call, the capture holds a reference so no address is reused while it runs.
+    CaptureObject objects[CAPTURE_MAX_OBJECTS];
+    void*         pObjectPointers[CAPTURE_MAX_OBJECTS];
+    u32           objectCount;
+    u16           buckets[CAPTURE_MAX_OBJECTS * 2]; // Open addressing, index + 1 or 0 when empty.
+
+    PendingMap maps[CAPTURE_MAX_PENDING_MAPS];
+    u32        mapCount;
+
+    bool hasFailed; // Out of memory or object slots, the recording stops but the calls still go through.
+} CaptureState;
+
+static CaptureState* s_pCapture = NULL;
+
+// Private data the objects carry for the capture, see DROP_SetCaptureData.
+static const GUID s_captureDataGuid = {0x6c1f3a52, 0x8e0d, 0x4b7a, {0x9d, 0x21, 0x5f, 0x3e, 0x84, 0xc6, 0x0b, 0x17}};
+static bool       s_isDataKept      = false;
+
+// Grows the stream so size more bytes fit after the used ones.
+static bool ReserveBytes(u8** ppBytes, u64* pCapacity, u64 used, u64 size)
+{
+    if (used + size <= *pCapacity)
+        return true;
+
+    u64 capacity = *pCapacity * 2;
+    while (capacity < used + size)
+        capacity *= 2;
+
+    u8* pBytes = (u8*) ALLOC(u8, capacity);
+    if (!pBytes)
+        return false;
+
+    memcpy(pBytes, *ppBytes, used);
+    FREE(*ppBytes);
+    *ppBytes   = pBytes;
+    *pCapacity = capacity;
+    return true;
+}
+
+static u32 HashPointer(const void* p)
+{
+    u64 value = (u64) (size_t) p;
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    return (u32) value;
+}
+
+static u32 FindObject(const void* p)
+{
+    u32 bucket = HashPointer(p) % ARRAYSIZE(s_pCapture->buckets);
+    while (s_pCapture->buckets[bucket])
+    {
+        u32 index = s_pCapture->buckets[bucket] - 1;
+        if (s_pCapture->pObjectPointers[index] == p)
+            return index + 1;
+        bucket = (bucket + 1) % ARRAYSIZE(s_pCapture->buckets);
+    }
+    return 0;
+}
+
+static void AddRefObject(void* p, CaptureObjectKind kind)
+{
+    switch (kind)
+    {
+    case CAPTURE_OBJECT_BUFFER: ((ID3D11Buffer*) p)->lpVtbl->AddRef((ID3D11Buffer*) p); break;
+    case CAPTURE_OBJECT_TEXTURE2D: ((ID3D11Texture2D*) p)->lpVtbl->AddRef((ID3D11Texture2D*) p); break;
+    case CAPTURE_OBJECT_RTV: ((ID3D11RenderTargetView*) p)->lpVtbl->AddRef((ID3D11RenderTargetView*) p); break;
+    case CAPTURE_OBJECT_SRV: ((ID3D11ShaderResourceView*) p)->lpVtbl->AddRef((ID3D11ShaderResourceView*) p); break;
+    case CAPTURE_OBJECT_SAMPLER: ((ID3D11SamplerState*) p)->lpVtbl->AddRef((ID3D11SamplerState*) p); break;
+    case CAPTURE_OBJECT_VERTEX_SHADER: ((ID3D11VertexShader*) p)->lpVtbl->AddRef((ID3D11VertexShader*) p); break;
+    case CAPTURE_OBJECT_PIXEL_SHADER: ((ID3D11PixelShader*) p)->lpVtbl->AddRef((ID3D11PixelShader*) p); break;
+    case CAPTURE_OBJECT_INPUT_LAYOUT: ((ID3D11InputLayout*) p)->lpVtbl->AddRef((ID3D11InputLayout*) p); break;
+    case CAPTURE_OBJECT_QUERY: ((ID3D11Asynchronous*) p)->lpVtbl->AddRef((ID3D11Asynchronous*) p); break;
+    default: break;
+    }
+}
+
+static void ReleaseObject(void* p, CaptureObjectKind kind)
+{
+    switch (kind)
+    {
+    case CAPTURE_OBJECT_BUFFER: RELEASE(((ID3D11Buffer*) p)); break;
+    case CAPTURE_OBJECT_TEXTURE2D: RELEASE(((ID3D11Texture2D*) p)); break;
+    case CAPTURE_OBJECT_RTV: RELEASE(((ID3D11RenderTargetView*) p)); break;
+    case CAPTURE_OBJECT_SRV: RELEASE(((ID3D11ShaderResourceView*) p)); break;
+    case CAPTURE_OBJECT_SAMPLER: RELEASE(((ID3D11SamplerState*) p)); break;
+    case CAPTURE_OBJECT_VERTEX_SHADER: RELEASE(((ID3D11VertexShader*) p)); break;
+    case CAPTURE_OBJECT_PIXEL_SHADER: RELEASE(((ID3D11PixelShader*) p)); break;
+    case CAPTURE_OBJECT_INPUT_LAYOUT: RELEASE(((ID3D11InputLayout*) p)); break;
+    case CAPTURE_OBJECT_QUERY: RELEASE(((ID3D11Asynchronous*) p)); break;
+    default: break;
+    }
+}
+
+// Copies what DROP_SetCaptureData attached to the object, most objects have nothing.
+static void AddObjectData(void* p, CaptureObject* pObject)
+{
+    ID3D11DeviceChild* pChild = (ID3D11DeviceChild*) p;
+    UINT               size   = 0;
+    if (FAILED(pChild->lpVtbl->GetPrivateData(pChild, &s_captureDataGuid, &size, NULL)) || !size)
+        return;
+
+    u64 paddedSize = ((u64) size + 3) & ~3ull;
+    if (s_pCapture->dataBytes + paddedSize > UINT32_MAX ||
+        !ReserveBytes(&s_pCapture->pData, &s_pCapture->dataCapacity, s_pCapture->dataBytes, paddedSize))
+    {
+        LOG_ERROR("Failed to grow the capture object data.");
+        s_pCapture->hasFailed = true;
+        return;
+    }
+
+    u8* pData = s_pCapture->pData + s_pCapture->dataBytes;
+    memset(pData, 0, paddedSize);
+    if (FAILED(pChild->lpVtbl->GetPrivateData(pChild, &s_captureDataGuid, &size, pData)))
+        return;
+
+    pObject->dataOffset = (u32) s_pCapture->dataBytes;
+    pObject->dataSize   = size;
+    s_pCapture->dataBytes += paddedSize;
+}
+
+// Returns the entry of a new object to fill, or NULL when the table is full.
+static CaptureObject* AddObject(void* p, CaptureObjectKind kind, u32 parent)
+{
+    if (s_pCapture->objectCount == CAPTURE_MAX_OBJECTS)
+    {
+        if (!s_pCapture->hasFailed)
+        {
+            LOG_ERROR("Capture object table is full.");
+        }
+        s_pCapture->hasFailed = true;
+        return NULL;
+    }
+
+    u32 bucket = HashPointer(p) % ARRAYSIZE(s_pCapture->buckets);
+    while (s_pCapture->buckets[bucket])
+        bucket = (bucket + 1) % ARRAYSIZE(s_pCapture->buckets);
+
+    u32            index   = s_pCapture->objectCount++;
+    CaptureObject* pObject = &s_pCapture->objects[index];
+    ZERO_MEM(pObject, 1);
+    pObject->kind   = kind;
+    pObject->parent = parent;
+
+    s_pCapture->pObjectPointers[index] = p;
+    s_pCapture->buckets[bucket]        = (u16) (index + 1);
+    AddRefObject(p, kind);
+    AddObjectData(p, pObject);
+
+    return pObject;
+}
+
+// Objects without a description worth keeping.
+static u32 OpaqueId(void* p, CaptureObjectKind kind)
+{
+    if (!p)
+        return 0;
+
+    u32 id = FindObject(p);
+    if (!id && AddObject(p, kind, 0))
+        id = s_pCapture->objectCount;
+    return id;
+}
+
+static u32 QueryId(ID3D11Asynchronous* pAsync)
+{
+    if (!pAsync)
+        return 0;
+
+    u32 id = FindObject(pAsync);
+    if (id)
+        return id;
+
+    // Counters aren't queries, they are replayed as events.
+    D3D11_QUERY_DESC desc   = {.Query = D3D11_QUERY_EVENT};
+    ID3D11Query*     pQuery = NULL;
+    if (SUCCEEDED(pAsync->lpVtbl->QueryInterface(pAsync, &IID_ID3D11Query, (void**) &pQuery)))
+    {
+        pQuery->lpVtbl->GetDesc(pQuery, &desc);
+        RELEASE(pQuery);
+    }
+
+    CaptureObject* pObject = AddObject(pAsync, CAPTURE_OBJECT_QUERY, 0);
+    if (!pObject)
+        return 0;
+
+    pObject->params[0] = (u32) desc.Query;
+    pObject->params[1] = desc.MiscFlags;
+    return s_pCapture->objectCount;
+}
+
+static u32 BufferId(ID3D11Buffer* pBuffer)
+{
+    if (!pBuffer)
+        return 0;
+
+    u32 id = FindObject(pBuffer);
+    if (id)
+        return id;
+
+    D3D11_BUFFER_DESC desc = {0};
+    pBuffer->lpVtbl->GetDesc(pBuffer, &desc);
+
+    CaptureObject* pObject = AddObject(pBuffer, CAPTURE_OBJECT_BUFFER, 0);
+    if (!pObject)
+        return 0;
+
+    pObject->params[0] = desc.ByteWidth;
+    pObject->params[1] = (u32) desc.Usage;
+    pObject->params[2] = desc.BindFlags;
+    pObject->params[3] = desc.CPUAccessFlags;
+    pObject->params[4] = desc.MiscFlags;
+    pObject->params[5] = desc.StructureByteStride;
+    return s_pCapture->objectCount;
+}
+
+static u32 Texture2DId(ID3D11Texture2D* pTexture)
+{
+    u32 id = FindObject(pTexture);
+    if (id)
+        return id;
+
+    D3D11_TEXTURE2D_DESC desc = {0};
+    pTexture->lpVtbl->GetDesc(pTexture, &desc);
+
+    CaptureObject* pObject = AddObject(pTexture, CAPTURE_OBJECT_TEXTURE2D, 0);
+    if (!pObject)
+        return 0;
+
+    pObject->params[0] = desc.Width;
+    pObject->params[1] = desc.Height;
+    pObject->params[2] = desc.MipLevels;
+    pObject->params[3] = desc.ArraySize;
+    pObject->params[4] = (u32) desc.Format;
+    pObject->params[5] = desc.BindFlags;
+    return s_pCapture->objectCount;
+}
+
+static u32 ResourceId(ID3D11Resource* pResource)
+{
+    if (!pResource)
+        return 0;
+
+    D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+    pResource->lpVtbl->GetType(pResource, &dimension);
+
+    if (dimension == D3D11_RESOURCE_DIMENSION_BUFFER)
+        return BufferId((ID3D11Buffer*) pResource);
+    if (dimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D)
+        return Texture2DId((ID3D11Texture2D*) pResource);
+
+    LOG_WARN("Only buffers and 2D textures are captured.");
+    return 0;
+}
+
+static u32 RenderTargetViewId(ID3D11RenderTargetView* pRTV)
+{
+    if (!pRTV)
+        return 0;
+
+    u32 id = FindObject(pRTV);
+    if (id)
+        return id;
+
+    ID3D11Resource* pResource = NULL;
+    pRTV->lpVtbl->GetResource(pRTV, &pResource);
+    u32 parent = ResourceId(pResource);
+    SAFE_RELEASE(pResource);
+
+    D3D11_RENDER_TARGET_VIEW_DESC desc = {0};
+    pRTV->lpVtbl->GetDesc(pRTV, &desc);
+
+    CaptureObject* pObject = AddObject(pRTV, CAPTURE_OBJECT_RTV, parent);
+    if (!pObject)
+        return 0;
+
+    pObject->params[0] = (u32) desc.Format;
+    pObject->params[1] = desc.Texture2D.MipSlice;
+    return s_pCapture->objectCount;
+}
+
+static u32 ShaderResourceViewId(ID3D11ShaderResourceView* pSRV)
+{
+    if (!pSRV)
+        return 0;
+
+    u32 id = FindObject(pSRV);
+    if (id)
+        return id;
+
+    ID3D11Resource* pResource = NULL;
+    pSRV->lpVtbl->GetResource(pSRV, &pResource);
+    u32 parent = ResourceId(pResource);
+    SAFE_RELEASE(pResource);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC desc = {0};
+    pSRV->lpVtbl->GetDesc(pSRV, &desc);
+
+    CaptureObject* pObject = AddObject(pSRV, CAPTURE_OBJECT_SRV, parent);
+    if (!pObject)
+        return 0;
+
+    pObject->params[0] = (u32) desc.Format;
+    pObject->params[1] = desc.Texture2D.MostDetailedMip;
+    pObject->params[2] = desc.Texture2D.MipLevels;
+    return s_pCapture->objectCount;
+}
+
+static u32 SamplerId(ID3D11SamplerState* pSampler)
+{
+    if (!pSampler)
+        return 0;
+
+    u32 id = FindObject(pSampler);
+    if (id)
+        return id;
+
+    D3D11_SAMPLER_DESC desc = {0};
+    pSampler->lpVtbl->GetDesc(pSampler, &desc);
+
+    CaptureObject* pObject = AddObject(pSampler, CAPTURE_OBJECT_SAMPLER, 0);
+    if (!pObject)
+        return 0;
+
+    pObject->params[0] = (u32) desc.Filter;
+    pObject->params[1] = (u32) desc.AddressU;
+    pObject->params[2] = (u32) desc.AddressV;
+    pObject->params[3] = (u32) desc.AddressW;
+    return s_pCapture->objectCount;
+}
+
+// Appends a command and returns its payload, or NULL once the capture has failed.
+// Resolve object ids before pushing, nothing else may grow the stream while the payload is filled.
+static u32* PushCommand(CaptureCommandType type, u32 wordCount)
+{
+    if (s_pCapture->hasFailed)
+        return NULL;
+
+    u32 size = (u32) sizeof(CaptureCommand) + wordCount * sizeof(u32);
+    if (!ReserveBytes(&s_pCapture->pCommands, &s_pCapture->commandCapacity, s_pCapture->commandBytes, size))
+    {
+        LOG_ERROR("Failed to grow the capture command stream.");
+        s_pCapture->hasFailed = true;
+        return NULL;
+    }
+
+    CaptureCommand* pCommand = (CaptureCommand*) (s_pCapture->pCommands + s_pCapture->commandBytes);
+    pCommand->type           = (u16) type;
+    pCommand->reserved       = 0;
+    pCommand->size           = size;
+    s_pCapture->commandBytes += size;
+
+    return (u32*) (pCommand + 1);
+}
+
+static void RecordShader(CaptureStage stage, u32 id)
+{
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_SHADER, 2);
+    if (!pPayload)
+        return;
+
+    pPayload[0] = stage;
+    pPayload[1] = id;
+}
+
+static void RecordShaderResources(CaptureStage stage, UINT start, UINT count, ID3D11ShaderResourceView* const* ppViews)
+{
+    u32 ids[CAPTURE_STATE_SRV_SLOTS];
+    if (count > ARRAYSIZE(ids))
+    {
+        LOG_WARN("Only %u shader resources per call are captured.", (u32) ARRAYSIZE(ids));
+        count = ARRAYSIZE(ids);
+    }
+    for (u32 i = 0; i < count; ++i)
+        ids[i] = ppViews ? ShaderResourceViewId(ppViews[i]) : 0;
+
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_SHADER_RESOURCES, 3 + count);
+    if (!pPayload)
+        return;
+
+    pPayload[0] = stage;
+    pPayload[1] = start;
+    pPayload[2] = count;
+    memcpy(&pPayload[3], ids, sizeof(u32) * count);
+}
+
+static void RecordConstantBuffers(CaptureStage stage, UINT start, UINT count, ID3D11Buffer* const* ppBuffers)
+{
+    u32 ids[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+    if (count > ARRAYSIZE(ids))
+        count = ARRAYSIZE(ids);
+    for (u32 i = 0; i < count; ++i)
+        ids[i] = ppBuffers ? BufferId(ppBuffers[i]) : 0;
+
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_CONSTANT_BUFFERS, 3 + count);
+    if (!pPayload)
+        return;
+
+    pPayload[0] = stage;
+    pPayload[1] = start;
+    pPayload[2] = count;
+    memcpy(&pPayload[3], ids, sizeof(u32) * count);
+}
+
+// Records byteCount bytes of pBytes written at offset, cut to the end of the buffer.
+static void RecordUpdate(
+    ID3D11Resource* pResource, u32 subresource, u32 mapType, u32 offset, u32 byteCount, const void* pBytes)
+{
+    D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+    pResource->lpVtbl->GetType(pResource, &dimension);
+    if (dimension != D3D11_RESOURCE_DIMENSION_BUFFER)
+    {
+        LOG_WARN("Only buffer updates are captured.");
+        return;
+    }
+
+    u32 id = BufferId((ID3D11Buffer*) pResource);
+    if (!id || !pBytes)
+        return;
+
+    u32 byteWidth = s_pCapture->objects[id - 1].params[0];
+    if (offset > byteWidth)
+        offset = byteWidth;
+    if (byteCount > byteWidth - offset)
+        byteCount = byteWidth - offset;
+
+    u32  wordCount = (byteCount + 3) / 4;
+    u32* pPayload  = PushCommand(CAPTURE_CMD_UPDATE_RESOURCE, 5 + wordCount);
+    if (!pPayload)
+        return;
+
+    pPayload[0] = id;
+    pPayload[1] = subresource;
+    pPayload[2] = mapType;
+    pPayload[3] = offset;
+    pPayload[4] = byteCount;
+    if (wordCount)
+        pPayload[4 + wordCount] = 0;
+    memcpy(&pPayload[5], pBytes, byteCount);
+}
+
+static void STDMETHODCALLTYPE HookVSSetShader(
+    ID3D11DeviceContext* pContext, ID3D11VertexShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT classInstanceCount)
+{
+    RecordShader(CAPTURE_STAGE_VS, OpaqueId(pShader, CAPTURE_OBJECT_VERTEX_SHADER));
+    s_pCapture->pOriginal->VSSetShader(pContext, pShader, ppClassInstances, classInstanceCount);
+}
+
+static void STDMETHODCALLTYPE HookPSSetShader(
+    ID3D11DeviceContext* pContext, ID3D11PixelShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT classInstanceCount)
+{
+    RecordShader(CAPTURE_STAGE_PS, OpaqueId(pShader, CAPTURE_OBJECT_PIXEL_SHADER));
+    s_pCapture->pOriginal->PSSetShader(pContext, pShader, ppClassInstances, classInstanceCount);
+}
+
+static void STDMETHODCALLTYPE HookVSSetShaderResources(
+    ID3D11DeviceContext* pContext, UINT start, UINT count, ID3D11ShaderResourceView* const* ppViews)
+{
+    RecordShaderResources(CAPTURE_STAGE_VS, start, count, ppViews);
+    s_pCapture->pOriginal->VSSetShaderResources(pContext, start, count, ppViews);
+}
+
+static void STDMETHODCALLTYPE HookPSSetShaderResources(
+    ID3D11DeviceContext* pContext, UINT start, UINT count, ID3D11ShaderResourceView* const* ppViews)
+{
+    RecordShaderResources(CAPTURE_STAGE_PS, start, count, ppViews);
+    s_pCapture->pOriginal->PSSetShaderResources(pContext, start, count, ppViews);
+}
+
+static void STDMETHODCALLTYPE HookVSSetConstantBuffers(
+    ID3D11DeviceContext* pContext, UINT start, UINT count, ID3D11Buffer* const* ppBuffers)
+{
+    RecordConstantBuffers(CAPTURE_STAGE_VS, start, count, ppBuffers);
+    s_pCapture->pOriginal->VSSetConstantBuffers(pContext, start, count, ppBuffers);
+}
+
+static void STDMETHODCALLTYPE HookPSSetConstantBuffers(
+    ID3D11DeviceContext* pContext, UINT start, UINT count, ID3D11Buffer* const* ppBuffers)
+{
+    RecordConstantBuffers(CAPTURE_STAGE_PS, start, count, ppBuffers);
+    s_pCapture->pOriginal->PSSetConstantBuffers(pContext, start, count, ppBuffers);
+}
+
+static void STDMETHODCALLTYPE HookPSSetSamplers(
+    ID3D11DeviceContext* pContext, UINT start, UINT count, ID3D11SamplerState* const* ppSamplers)
+{
+    u32 ids[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+    u32 recordCount = count < ARRAYSIZE(ids) ? count : ARRAYSIZE(ids);
+    for (u32 i = 0; i < recordCount; ++i)
+        ids[i] = ppSamplers ? SamplerId(ppSamplers[i]) : 0;
+
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_SAMPLERS, 3 + recordCount);
+    if (pPayload)
+    {
+        pPayload[0] = CAPTURE_STAGE_PS;
+        pPayload[1] = start;
+        pPayload[2] = recordCount;
+        memcpy(&pPayload[3], ids, sizeof(u32) * recordCount);
+    }
+
+    s_pCapture->pOriginal->PSSetSamplers(pContext, start, count, ppSamplers);
+}
+
+static void STDMETHODCALLTYPE HookIASetInputLayout(ID3D11DeviceContext* pContext, ID3D11InputLayout* pLayout)
+{
+    u32  id       = OpaqueId(pLayout, CAPTURE_OBJECT_INPUT_LAYOUT);
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_INPUT_LAYOUT, 1);
+    if (pPayload)
+        pPayload[0] = id;
+
+    s_pCapture->pOriginal->IASetInputLayout(pContext, pLayout);
+}
+
+static void STDMETHODCALLTYPE HookIASetVertexBuffers(
+    ID3D11DeviceContext* pContext, UINT start, UINT count, ID3D11Buffer* const* ppBuffers, const UINT* pStrides, const UINT* pOffsets)
+{
+    u32 ids[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    u32 recordCount = count < ARRAYSIZE(ids) ? count : ARRAYSIZE(ids);
+    for (u32 i = 0; i < recordCount; ++i)
+        ids[i] = ppBuffers ? BufferId(ppBuffers[i]) : 0;
+
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_VERTEX_BUFFERS, 2 + recordCount * 3);
+    if (pPayload)
+    {
+        pPayload[0] = start;
+        pPayload[1] = recordCount;
+        for (u32 i = 0; i < recordCount; ++i)
+        {
+            pPayload[2 + i * 3 + 0] = ids[i];
+            pPayload[2 + i * 3 + 1] = pStrides ? pStrides[i] : 0;
+            pPayload[2 + i * 3 + 2] = pOffsets ? pOffsets[i] : 0;
+        }
+    }
+
+    s_pCapture->pOriginal->IASetVertexBuffers(pContext, start, count, ppBuffers, pStrides, pOffsets);
+}
+
+static void STDMETHODCALLTYPE HookIASetIndexBuffer(ID3D11DeviceContext* pContext, ID3D11Buffer* pBuffer, DXGI_FORMAT format, UINT offset)
+{
+    u32  id       = BufferId(pBuffer);
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_INDEX_BUFFER, 3);
+    if (pPayload)
+    {
+        pPayload[0] = id;
+        pPayload[1] = (u32) format;
+        pPayload[2] = offset;
+    }
+
+    s_pCapture->pOriginal->IASetIndexBuffer(pContext, pBuffer, format, offset);
+}
+
+static void STDMETHODCALLTYPE HookIASetPrimitiveTopology(ID3D11DeviceContext* pContext, D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_TOPOLOGY, 1);
+    if (pPayload)
+        pPayload[0] = (u32) topology;
+
+    s_pCapture->pOriginal->IASetPrimitiveTopology(pContext, topology);
+}
+
+static void STDMETHODCALLTYPE HookDraw(ID3D11DeviceContext* pContext, UINT vertexCount, UINT startVertex)
+{
+    u32* pPayload = PushCommand(CAPTURE_CMD_DRAW, 2);
+    if (pPayload)
+    {
+        pPayload[0] = vertexCount;
+        pPayload[1] = startVertex;
+    }
+
+    s_pCapture->pOriginal->Draw(pContext, vertexCount, startVertex);
+}
+
+static void STDMETHODCALLTYPE HookDrawIndexed(ID3D11DeviceContext* pContext, UINT indexCount, UINT startIndex, INT baseVertex)
+{
+    u32* pPayload = PushCommand(CAPTURE_CMD_DRAW_INDEXED, 3);
+    if (pPayload)
+    {
+        pPayload[0] = indexCount;
+        pPayload[1] = startIndex;
+        pPayload[2] = (u32) baseVertex;
+    }
+
+    s_pCapture->pOriginal->DrawIndexed(pContext, indexCount, startIndex, baseVertex);
+}
+
+static void STDMETHODCALLTYPE HookDrawInstanced(
+    ID3D11DeviceContext* pContext, UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance)
+{
+    u32* pPayload = PushCommand(CAPTURE_CMD_DRAW_INSTANCED, 4);
+    if (pPayload)
+    {
+        pPayload[0] = vertexCount;
+        pPayload[1] = instanceCount;
+        pPayload[2] = startVertex;
+        pPayload[3] = startInstance;
+    }
+
+    s_pCapture->pOriginal->DrawInstanced(pContext, vertexCount, instanceCount, startVertex, startInstance);
+}
+
+static void STDMETHODCALLTYPE HookDrawIndexedInstanced(
+    ID3D11DeviceContext* pContext, UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+{
+    u32* pPayload = PushCommand(CAPTURE_CMD_DRAW_INDEXED_INSTANCED, 5);
+    if (pPayload)
+    {
+        pPayload[0] = indexCount;
+        pPayload[1] = instanceCount;
+        pPayload[2] = startIndex;
+        pPayload[3] = (u32) baseVertex;
+        pPayload[4] = startInstance;
+    }
+
+    s_pCapture->pOriginal->DrawIndexedInstanced(pContext, indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+// The payload is only known at unmap, the mapping is remembered until then.
+static HRESULT STDMETHODCALLTYPE HookMap(
+    ID3D11DeviceContext* pContext, ID3D11Resource* pResource, UINT subresource,
+    D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* pMapped)
+{
+    HRESULT hr = s_pCapture->pOriginal->Map(pContext, pResource, subresource, mapType, mapFlags, pMapped);
+    if (FAILED(hr) || mapType == D3D11_MAP_READ || !pMapped)
+        return hr;
+
+    if (s_pCapture->mapCount == CAPTURE_MAX_PENDING_MAPS)
+    {
+        LOG_ERROR("Too many resources mapped at once for the capture.");
+        s_pCapture->hasFailed = true;
+        return hr;
+    }
+
+    PendingMap* pMap  = &s_pCapture->maps[s_pCapture->mapCount++];
+    pMap->pResource   = pResource;
+    pMap->subresource = subresource;
+    pMap->mapType     = (u32) mapType;
+    pMap->pData       = pMapped->pData;
+    pMap->hasRange    = false;
+
+    return hr;
+}
+
+static void STDMETHODCALLTYPE HookUnmap(ID3D11DeviceContext* pContext, ID3D11Resource* pResource, UINT subresource)
+{
+    for (u32 i = 0; i < s_pCapture->mapCount; ++i)
+    {
+        PendingMap* pMap = &s_pCapture->maps[i];
+        if (pMap->pResource != pResource || pMap->subresource != subresource)
+            continue;
+
+        // Without a range every byte may have been written, a ring buffer is then copied whole on
+        // every write. DynamicBuffer reports its ranges.
+        u32 offset    = pMap->hasRange ? pMap->writtenBegin : 0;
+        u32 byteCount = pMap->hasRange ? pMap->writtenEnd - pMap->writtenBegin : UINT32_MAX;
+        RecordUpdate(pResource, subresource, pMap->mapType, offset, byteCount, (const u8*) pMap->pData + offset);
+        *pMap = s_pCapture->maps[--s_pCapture->mapCount];
+        break;
+    }
+
+    s_pCapture->pOriginal->Unmap(pContext, pResource, subresource);
+}
+
+static void STDMETHODCALLTYPE HookUpdateSubresource(
+    ID3D11DeviceContext* pContext, ID3D11Resource* pResource, UINT subresource,
+    const D3D11_BOX* pBox, const void* pData, UINT rowPitch, UINT depthPitch)
+{
+    // On a buffer the box is a byte range, pData points at its first byte.
+    u32 offset    = pBox ? pBox->left : 0;
+    u32 byteCount = pBox ? (pBox->right > pBox->left ? pBox->right - pBox->left : 0) : UINT32_MAX;
+    RecordUpdate(pResource, subresource, 0, offset, byteCount, pData);
+
+    s_pCapture->pOriginal->UpdateSubresource(pContext, pResource, subresource, pBox, pData, rowPitch, depthPitch);
+}
+
+static void STDMETHODCALLTYPE HookCopyResource(ID3D11DeviceContext* pContext, ID3D11Resource* pDestination, ID3D11Resource* pSource)
+{
+    u32  destination = ResourceId(pDestination);
+    u32  source      = ResourceId(pSource);
+    u32* pPayload    = PushCommand(CAPTURE_CMD_COPY_RESOURCE, 2);
+    if (pPayload)
+    {
+        pPayload[0] = destination;
+        pPayload[1] = source;
+    }
+
+    s_pCapture->pOriginal->CopyResource(pContext, pDestination, pSource);
+}
+
+static void STDMETHODCALLTYPE HookBegin(ID3D11DeviceContext* pContext, ID3D11Asynchronous* pAsync)
+{
+    u32  id       = QueryId(pAsync);
+    u32* pPayload = PushCommand(CAPTURE_CMD_BEGIN_QUERY, 1);
+    if (pPayload)
+        pPayload[0] = id;
+
+    s_pCapture->pOriginal->Begin(pContext, pAsync);
+}
+
+static void STDMETHODCALLTYPE HookEnd(ID3D11DeviceContext* pContext, ID3D11Asynchronous* pAsync)
+{
+    u32  id       = QueryId(pAsync);
+    u32* pPayload = PushCommand(CAPTURE_CMD_END_QUERY, 1);
+    if (pPayload)
+        pPayload[0] = id;
+
+    s_pCapture->pOriginal->End(pContext, pAsync);
+}
+
+static void STDMETHODCALLTYPE HookOMSetRenderTargets(
+    ID3D11DeviceContext* pContext, UINT count, ID3D11RenderTargetView* const* ppRTVs, ID3D11DepthStencilView* pDSV)
+{
+    if (pDSV)
+    {
+        LOG_WARN("Depth stencil views are not captured.");
+    }
+
+    u32 ids[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+    u32 recordCount = count < ARRAYSIZE(ids) ? count : ARRAYSIZE(ids);
+    for (u32 i = 0; i < recordCount; ++i)
+        ids[i] = ppRTVs ? RenderTargetViewId(ppRTVs[i]) : 0;
+
+    u32* pPayload = PushCommand(CAPTURE_CMD_SET_RENDER_TARGETS, 2 + recordCount);
+    if (pPayload)
+    {
+        pPayload[0] = recordCount;
+        pPayload[1] = 0;
+        memcpy(&pPayload[2], ids, sizeof(u32) * recordCount);
+    }
+
+    s_pCapture->pOriginal->OMSetRenderTargets(pContext, count, ppRTVs, pDSV);
+}
+
+static void STDMETHODCALLTYPE HookRSSetViewports(ID3D11DeviceContext* pContext, UINT count, const D3D11_VIEWPORT* pViewports)
+{
+    u32  recordCount = pViewports ? count : 0;
+    u32* pPayload    = PushCommand(CAPTURE_CMD_SET_VIEWPORTS, 1 + recordCount * 6);
+    if (pPayload)
+    {
+        pPayload[0] = recordCount;
+        for (u32 i = 0; i < recordCount; ++i)
+        {
+            f32 values[6] = {
+                pViewports[i].TopLeftX, pViewports[i].TopLeftY, pViewports[i].Width,
+                pViewports[i].Height, pViewports[i].MinDepth, pViewports[i].MaxDepth};
+            memcpy(&pPayload[1 + i * 6], values, sizeof(values));
+        }
+    }
+
+    s_pCapture->pOriginal->RSSetViewports(pContext, count, pViewports);
+}
+
+static void STDMETHODCALLTYPE HookClearRenderTargetView(ID3D11DeviceContext* pContext, ID3D11RenderTargetView* pRTV, const FLOAT color[4])
+{
+    u32  id       = RenderTargetViewId(pRTV);
+    u32* pPayload = PushCommand(CAPTURE_CMD_CLEAR_RENDER_TARGET, 5);
+    if (pPayload)
+    {
+        pPayload[0] = id;
+        memcpy(&pPayload[1], color, sizeof(f32) * 4);
+    }
+
+    s_pCapture->pOriginal->ClearRenderTargetView(pContext, pRTV, color);
+}
+
+// Sets what is bound right now again through the hooks, so the first frame doesn't depend on
+// state left over from frames before the capture.
+static void RecordCurrentState(ID3D11DeviceContext* pContext)
+{
+    const ID3D11DeviceContextVtbl* pVtbl = pContext->lpVtbl;
+
+    ID3D11VertexShader* pVertexShader = NULL;
+    ID3D11PixelShader*  pPixelShader  = NULL;
+    pVtbl->VSGetShader(pContext, &pVertexShader, NULL, NULL);
+    pVtbl->PSGetShader(pContext, &pPixelShader, NULL, NULL);
+    pVtbl->VSSetShader(pContext, pVertexShader, NULL, 0);
+    pVtbl->PSSetShader(pContext, pPixelShader, NULL, 0);
+    SAFE_RELEASE(pVertexShader);
+    SAFE_RELEASE(pPixelShader);
+
+    ID3D11ShaderResourceView* pSRVs[CAPTURE_STATE_SRV_SLOTS] = {0};
+    pVtbl->PSGetShaderResources(pContext, 0, CAPTURE_STATE_SRV_SLOTS, pSRVs);
+    pVtbl->PSSetShaderResources(pContext, 0, CAPTURE_STATE_SRV_SLOTS, pSRVs);
+    for (u32 i = 0; i < CAPTURE_STATE_SRV_SLOTS; ++i)
+    {
+        SAFE_RELEASE(pSRVs[i]);
+    }
+    pVtbl->VSGetShaderResources(pContext, 0, CAPTURE_STATE_SRV_SLOTS, pSRVs);
+    pVtbl->VSSetShaderResources(pContext, 0, CAPTURE_STATE_SRV_SLOTS, pSRVs);
+    for (u32 i = 0; i < CAPTURE_STATE_SRV_SLOTS; ++i)
+    {
+        SAFE_RELEASE(pSRVs[i]);
+    }
+
+    ID3D11Buffer* pBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT] = {0};
+    pVtbl->PSGetConstantBuffers(pContext, 0, ARRAYSIZE(pBuffers), pBuffers);
+    pVtbl->PSSetConstantBuffers(pContext, 0, ARRAYSIZE(pBuffers), pBuffers);
+    for (u32 i = 0; i < ARRAYSIZE(pBuffers); ++i)
+    {
+        SAFE_RELEASE(pBuffers[i]);
+    }
+    pVtbl->VSGetConstantBuffers(pContext, 0, ARRAYSIZE(pBuffers), pBuffers);
+    pVtbl->VSSetConstantBuffers(pContext, 0, ARRAYSIZE(pBuffers), pBuffers);
+    for (u32 i = 0; i < ARRAYSIZE(pBuffers); ++i)
+    {
+        SAFE_RELEASE(pBuffers[i]);
+    }
+
+    ID3D11SamplerState* pSamplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT] = {0};
+    pVtbl->PSGetSamplers(pContext, 0, ARRAYSIZE(pSamplers), pSamplers);
+    pVtbl->PSSetSamplers(pContext, 0, ARRAYSIZE(pSamplers), pSamplers);
+    for (u32 i = 0; i < ARRAYSIZE(pSamplers); ++i)
+    {
+        SAFE_RELEASE(pSamplers[i]);
+    }
+
+    ID3D11InputLayout* pLayout = NULL;
+    pVtbl->IAGetInputLayout(pContext, &pLayout);
+    pVtbl->IASetInputLayout(pContext, pLayout);
+    SAFE_RELEASE(pLayout);
+
+    ID3D11Buffer* pVertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT] = {0};
+    UINT          strides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT]        = {0};
+    UINT          offsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT]        = {0};
+    pVtbl->IAGetVertexBuffers(pContext, 0, ARRAYSIZE(pVertexBuffers), pVertexBuffers, strides, offsets);
+    pVtbl->IASetVertexBuffers(pContext, 0, ARRAYSIZE(pVertexBuffers), pVertexBuffers, strides, offsets);
+    for (u32 i = 0; i < ARRAYSIZE(pVertexBuffers); ++i)
+    {
+        SAFE_RELEASE(pVertexBuffers[i]);
+    }
+
+    ID3D11Buffer* pIndexBuffer = NULL;
+    DXGI_FORMAT   indexFormat  = DXGI_FORMAT_UNKNOWN;
+    UINT          indexOffset  = 0;
+    pVtbl->IAGetIndexBuffer(pContext, &pIndexBuffer, &indexFormat, &indexOffset);
+    pVtbl->IASetIndexBuffer(pContext, pIndexBuffer, indexFormat, indexOffset);
+    SAFE_RELEASE(pIndexBuffer);
+
+    D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+    pVtbl->IAGetPrimitiveTopology(pContext, &topology);
+    pVtbl->IASetPrimitiveTopology(pContext, topology);
+
+    ID3D11RenderTargetView* pRTVs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {0};
+    ID3D11DepthStencilView* pDSV                                          = NULL;
+    pVtbl->OMGetRenderTargets(pContext, ARRAYSIZE(pRTVs), pRTVs, &pDSV);
+    pVtbl->OMSetRenderTargets(pContext, ARRAYSIZE(pRTVs), pRTVs, pDSV);
+    for (u32 i = 0; i < ARRAYSIZE(pRTVs); ++i)
+    {
+        SAFE_RELEASE(pRTVs[i]);
+    }
+    SAFE_RELEASE(pDSV);
+
+    D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    UINT           viewportCount = ARRAYSIZE(viewports);
+    pVtbl->RSGetViewports(pContext, &viewportCount, viewports);
+    pVtbl->RSSetViewports(pContext, viewportCount, viewports);
+}
+
+// Size of the newest context interface whose methods share the table of pContext. A runtime
+// newer than the headers may have more, nothing in here calls them.
+static size_t GetContextVtblSize(ID3D11DeviceContext* pContext)
+{
+    static const struct
+    {
+        const IID* pIid;
+        size_t     size;
+    } s_interfaces[] = {
+        {&IID_ID3D11DeviceContext4, sizeof(ID3D11DeviceContext4Vtbl)},
+        {&IID_ID3D11DeviceContext3, sizeof(ID3D11DeviceContext3Vtbl)},
+        {&IID_ID3D11DeviceContext2, sizeof(ID3D11DeviceContext2Vtbl)},
+        {&IID_ID3D11DeviceContext1, sizeof(ID3D11DeviceContext1Vtbl)}};
+
+    for (u32 i = 0; i < ARRAYSIZE(s_interfaces); ++i)
+    {
+        ID3D11DeviceContext* pInterface = NULL;
+        if (FAILED(pContext->lpVtbl->QueryInterface(pContext, s_interfaces[i].pIid, (void**) &pInterface)))
+            continue;
+
+        bool isSameTable = pInterface->lpVtbl == pContext->lpVtbl;
+        RELEASE(pInterface);
+        if (isSameTable)
+            return s_interfaces[i].size;
+    }
+    return sizeof(ID3D11DeviceContextVtbl);
+}
+
+static bool WriteCapture(const CaptureState* pCapture)
+{
+    FILE* file = fopen(pCapture->fileName, "wb");
+    if (!file)
+    {
+        LOG_ERROR("Failed to open file: %s", pCapture->fileName);
+        return false;
+    }
+
+    CaptureHeader header = {
+        .magic        = CAPTURE_MAGIC,
+        .version      = CAPTURE_VERSION,
+        .frameCount   = pCapture->recordedFrames,
+        .objectCount  = pCapture->objectCount,
+        .dataBytes    = pCapture->dataBytes,
+        .commandBytes = pCapture->recordedBytes};
+
+    bool isWritten = fwrite(&header, sizeof(header), 1, file) == 1;
+    isWritten      = isWritten && fwrite(pCapture->objects, sizeof(CaptureObject), pCapture->objectCount, file) == pCapture->objectCount;
+    isWritten      = isWritten && fwrite(pCapture->pData, 1, pCapture->dataBytes, file) == pCapture->dataBytes;
+    isWritten      = isWritten && fwrite(pCapture->pCommands, 1, pCapture->recordedBytes, file) == pCapture->recordedBytes;
+    fclose(file);
+
+    if (!isWritten)
+    {
+        LOG_ERROR("Failed to write capture: %s", pCapture->fileName);
+        return false;
+    }
+
+    return true;
+}
+#pragma endregion
+
+bool DROP_BeginCapture(const GfxHandle handle, const char* fileName, u32 frameCount)
+{
+    ASSERT_MSG(handle && handle->pContext, "Graphics handle is null.");
+    ASSERT_MSG(fileName, "Capture file name is null.");
+    ASSERT_MSG(frameCount > 0, "Capture frame count must be greater than zero.");
+
+    if (s_pCapture)
+    {
+        LOG_ERROR("A capture is already running.");
+        return false;
+    }
+
+    if (strlen(fileName) >= CAPTURE_FILE_NAME_SIZE)
+    {
+        LOG_ERROR("Capture file name is too long: %s", fileName);
+        return false;
+    }
+
+    CaptureState* pCapture = (CaptureState*) ALLOC(CaptureState, 1);
+    if (!pCapture)
+    {
+        LOG_ERROR("Failed to allocate capture state.");
+        return false;
+    }
+    ZERO_MEM(pCapture, 1);
+
+    pCapture->pCommands = (u8*) ALLOC(u8, CAPTURE_INITIAL_COMMAND_BYTES);
+    pCapture->pData     = (u8*) ALLOC(u8, CAPTURE_INITIAL_DATA_BYTES);
+    if (!pCapture->pCommands || !pCapture->pData)
+    {
+        LOG_ERROR("Failed to allocate capture command stream.");
+        if (pCapture->pCommands) FREE(pCapture->pCommands);
+        if (pCapture->pData) FREE(pCapture->pData);
+        FREE(pCapture);
+        return false;
+    }
+
+    ID3D11DeviceContext* pContext = handle->pContext;
+
+    strcpy(pCapture->fileName, fileName);
+    pCapture->commandCapacity = CAPTURE_INITIAL_COMMAND_BYTES;
+    pCapture->dataCapacity    = CAPTURE_INITIAL_DATA_BYTES;
+    pCapture->framesLeft      = frameCount;
+    pCapture->pContext        = pContext;
+    pCapture->pOriginal       = pContext->lpVtbl;
+
+    // Untouched entries keep calling the driver directly.
+    memcpy(&pCapture->hooks, pContext->lpVtbl, GetContextVtblSize(pContext));
+    pCapture->hooks.base.VSSetShader            = HookVSSetShader;
+    pCapture->hooks.base.PSSetShader            = HookPSSetShader;
+    pCapture->hooks.base.VSSetShaderResources   = HookVSSetShaderResources;
+    pCapture->hooks.base.PSSetShaderResources   = HookPSSetShaderResources;
+    pCapture->hooks.base.VSSetConstantBuffers   = HookVSSetConstantBuffers;
+    pCapture->hooks.base.PSSetConstantBuffers   = HookPSSetConstantBuffers;
+    pCapture->hooks.base.PSSetSamplers          = HookPSSetSamplers;
+    pCapture->hooks.base.IASetInputLayout       = HookIASetInputLayout;
+    pCapture->hooks.base.IASetVertexBuffers     = HookIASetVertexBuffers;
+    pCapture->hooks.base.IASetIndexBuffer       = HookIASetIndexBuffer;
+    pCapture->hooks.base.IASetPrimitiveTopology = HookIASetPrimitiveTopology;
+    pCapture->hooks.base.Draw                   = HookDraw;
+    pCapture->hooks.base.DrawIndexed            = HookDrawIndexed;
+    pCapture->hooks.base.DrawInstanced          = HookDrawInstanced;
+    pCapture->hooks.base.DrawIndexedInstanced   = HookDrawIndexedInstanced;
+    pCapture->hooks.base.Map                    = HookMap;
+    pCapture->hooks.base.Unmap                  = HookUnmap;
+    pCapture->hooks.base.UpdateSubresource      = HookUpdateSubresource;
+    pCapture->hooks.base.CopyResource           = HookCopyResource;
+    pCapture->hooks.base.Begin                  = HookBegin;
+    pCapture->hooks.base.End                    = HookEnd;
+    pCapture->hooks.base.OMSetRenderTargets     = HookOMSetRenderTargets;
+    pCapture->hooks.base.RSSetViewports         = HookRSSetViewports;
+    pCapture->hooks.base.ClearRenderTargetView  = HookClearRenderTargetView;
+
+    s_pCapture       = pCapture;
+    pContext->lpVtbl = &pCapture->hooks.base;
+
+    RecordCurrentState(pContext);
+
+    return true;
+}
+
+void DROP_CaptureEndFrame(const GfxHandle handle)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+
+    if (!s_pCapture)
+        return;
+
+    if (PushCommand(CAPTURE_CMD_FRAME_END, 0))
+    {
+        s_pCapture->recordedBytes = s_pCapture->commandBytes;
+        ++s_pCapture->recordedFrames;
+    }
+
+    if (--s_pCapture->framesLeft == 0)
+        DROP_EndCapture(handle);
+}
+
+void DROP_EndCapture(const GfxHandle handle)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+
+    CaptureState* pCapture = s_pCapture;
+    if (!pCapture)
+        return;
+
+    ASSERT_MSG(handle->pContext == pCapture->pContext, "Capture was started on another context.");
+
+    pCapture->pContext->lpVtbl = pCapture->pOriginal;
+    s_pCapture                 = NULL;
+
+    if (pCapture->mapCount)
+    {
+        LOG_WARN("Capture ended with %u resources still mapped.", pCapture->mapCount);
+    }
+
+    if (pCapture->hasFailed)
+    {
+        LOG_ERROR("Capture failed, nothing was written.");
+    }
+    else if (!pCapture->recordedFrames)
+    {
+        LOG_WARN("Capture ended before a frame was complete, nothing was written.");
+    }
+    else if (WriteCapture(pCapture))
+    {
+        LOG_TRACE("Captured %u frames to %s.", pCapture->recordedFrames, pCapture->fileName);
+    }
+
+    for (u32 i = 0; i < pCapture->objectCount; ++i)
+        ReleaseObject(pCapture->pObjectPointers[i], (CaptureObjectKind) pCapture->objects[i].kind);
+
+    FREE(pCapture->pData);
+    FREE(pCapture->pCommands);
+    FREE(pCapture);
+}
+
+bool DROP_IsCapturing()
+{
+    return s_pCapture != NULL;
+}
+
+void DROP_KeepCaptureData()
+{
+    s_isDataKept = true;
+}
+
+void DROP_SetCaptureData(ID3D11DeviceChild* pObject, const void* pData, u32 byteCount)
+{
+    ASSERT_MSG(pObject, "Capture data object is null.");
+
+    if (!s_isDataKept || !pData || !byteCount)
+        return;
+
+    // The runtime keeps its own copy, pData can go away after the call.
+    if (FAILED(pObject->lpVtbl->SetPrivateData(pObject, &s_captureDataGuid, byteCount, pData)))
+    {
+        LOG_WARN("Failed to keep %u bytes of capture data.", byteCount);
+    }
+}
+
+void DROP_SetCaptureInputLayoutData(
+    ID3D11InputLayout* pLayout, const D3D11_INPUT_ELEMENT_DESC* pElements, u32 elementCount, const void* pBytecode,
+    u32 bytecodeSize)
+{
+    ASSERT_MSG(pLayout, "Input layout is null.");
+    ASSERT_MSG(pElements && pBytecode, "Input layout description is null.");
+
+    if (!s_isDataKept)
+        return;
+
+    u32 size  = (u32) (sizeof(CaptureInputLayout) + sizeof(CaptureInputElement) * elementCount) + bytecodeSize;
+    u8* pData = (u8*) ALLOC(u8, size);
+    if (!pData)
+    {
+        LOG_WARN("Failed to allocate %u bytes of input layout capture data.", size);
+        return;
+    }
+
+    CaptureInputLayout* pHeader = (CaptureInputLayout*) pData;
+    pHeader->elementCount       = elementCount;
+    pHeader->bytecodeSize       = bytecodeSize;
+
+    CaptureInputElement* pCaptured = (CaptureInputElement*) (pHeader + 1);
+    for (u32 i = 0; i < elementCount; ++i)
+    {
+        if (strlen(pElements[i].SemanticName) >= CAPTURE_SEMANTIC_NAME_SIZE)
+        {
+            LOG_WARN("Semantic name is too long for the capture: %s", pElements[i].SemanticName);
+            FREE(pData);
+            return;
+        }
+
+        ZERO_MEM(&pCaptured[i], 1);
+        strcpy(pCaptured[i].semanticName, pElements[i].SemanticName);
+        pCaptured[i].semanticIndex        = pElements[i].SemanticIndex;
+        pCaptured[i].format               = (u32) pElements[i].Format;
+        pCaptured[i].inputSlot            = pElements[i].InputSlot;
+        pCaptured[i].alignedByteOffset    = pElements[i].AlignedByteOffset;
+        pCaptured[i].inputSlotClass       = (u32) pElements[i].InputSlotClass;
+        pCaptured[i].instanceDataStepRate = pElements[i].InstanceDataStepRate;
+    }
+    memcpy(&pCaptured[elementCount], pBytecode, bytecodeSize);
+
+    DROP_SetCaptureData((ID3D11DeviceChild*) pLayout, pData, size);
+    FREE(pData);
+}
+
+void DROP_CaptureWrittenRange(ID3D11Resource* pResource, u32 subresource, u32 offset, u32 byteCount)
+{
+    if (!s_pCapture)
+        return;
+
+    for (u32 i = 0; i < s_pCapture->mapCount; ++i)
+    {
+        PendingMap* pMap = &s_pCapture->maps[i];
+        if (pMap->pResource != pResource || pMap->subresource != subresource)
+            continue;
+
+        u32 end = offset + byteCount;
+        if (!pMap->hasRange || offset < pMap->writtenBegin)
+            pMap->writtenBegin = offset;
+        if (!pMap->hasRange || end > pMap->writtenEnd)
+            pMap->writtenEnd = end;
+        pMap->hasRange = true;
+        return;
+    }
+}
@@ -0,0 +1,88 @@
+#include "pch.h"
+#include "Graphics/DynamicResolution.h"
+
+#include <math.h>
+
+#pragma region INTERNAL
+#define FRAME_TIME_SMOOTHING 0.1f
+
+static f32 ClampScale(const DynamicResolutionDesc* pDesc, f32 scale)
+{
+    if (scale < pDesc->minScale)
+        return pDesc->minScale;
+    if (scale > pDesc->maxScale)
+        return pDesc->maxScale;
+    return scale;
+}
+#pragma endregion
+
+void DROP_InitDynamicResolution(DynamicResolution* pResolution, const DynamicResolutionDesc* pDesc)
+{
+    ASSERT_MSG(pResolution, "Dynamic resolution is null.");
+    ASSERT_MSG(pDesc, "Dynamic resolution description is null.");
+    ASSERT_MSG(pDesc->budgetMs > 0.0f, "Frame budget must be greater than zero.");
+    ASSERT_MSG(pDesc->minScale > 0.0f && pDesc->minScale <= pDesc->maxScale && pDesc->maxScale <= 1.0f,
+               "Scales must be in (0, 1] with min <= max.");
+    ASSERT_MSG(pDesc->scaleStep > 0.0f, "Scale step must be greater than zero.");
+
+    ZERO_MEM(pResolution, 1);
+    pResolution->desc  = *pDesc;
+    pResolution->scale = pDesc->maxScale;
+}
+
+bool DROP_UpdateDynamicResolution(DynamicResolution* pResolution, f32 frameMs)
+{
+    ASSERT_MSG(pResolution, "Dynamic resolution is null.");
+
+    const DynamicResolutionDesc* pDesc = &pResolution->desc;
+
+    if (pResolution->averageMs <= 0.0f)
+        pResolution->averageMs = frameMs;
+    else
+        pResolution->averageMs += (frameMs - pResolution->averageMs) * FRAME_TIME_SMOOTHING;
+
+    // Between the raise threshold and the budget nothing moves, that band is the hysteresis.
+    if (pResolution->averageMs > pDesc->budgetMs)
+    {
+        ++pResolution->overBudgetFrames;
+        pResolution->underBudgetFrames = 0;
+    }
+    else if (pResolution->averageMs < pDesc->budgetMs * pDesc->raiseThreshold)
+    {
+        ++pResolution->underBudgetFrames;
+        pResolution->overBudgetFrames = 0;
+    }
+    else
+    {
+        pResolution->overBudgetFrames  = 0;
+        pResolution->underBudgetFrames = 0;
+    }
+
+    f32 scale = pResolution->scale;
+    if (pResolution->overBudgetFrames >= pDesc->settleFrames)
+    {
+        // The cost follows the pixel count, the square of the scale. Drop straight to the scale
+        // that should fit and at least one step.
+        f32 fitScale = scale * sqrtf(pDesc->budgetMs / pResolution->averageMs);
+        scale        = floorf(fitScale / pDesc->scaleStep + 1e-3f) * pDesc->scaleStep;
+        if (scale > pResolution->scale - pDesc->scaleStep)
+            scale = pResolution->scale - pDesc->scaleStep;
+    }
+    else if (pResolution->underBudgetFrames >= pDesc->settleFrames)
+    {
+        // Climbs back one step at a time, overshooting the budget costs more than a blurry frame.
+        scale += pDesc->scaleStep;
+    }
+
+    scale = ClampScale(pDesc, scale);
+    if (scale == pResolution->scale)
+        return false;
+
+    // The average was measured at the old scale, start over.
+    pResolution->scale             = scale;
+    pResolution->averageMs         = 0.0f;
+    pResolution->overBudgetFrames  = 0;
+    pResolution->underBudgetFrames = 0;
+
+    return true;
+}
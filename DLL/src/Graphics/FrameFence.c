@@ -0,0 +1,88 @@
+#include "pch.h"
+#include "Graphics/FrameFence.h"
+
+bool DROP_CreateFrameFence(const GfxHandle handle, GfxFrameFence* pFence)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pFence, "Frame fence is null.");
+
+    ZERO_MEM(pFence, 1);
+
+    D3D11_QUERY_DESC queryDesc = {
+        .Query     = D3D11_QUERY_EVENT,
+        .MiscFlags = 0};
+
+    for (u32 i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        HRESULT hr = handle->pDevice->lpVtbl->CreateQuery(handle->pDevice, &queryDesc, &pFence->pQueries[i]);
+        if (FAILED(hr) || !pFence->pQueries[i])
+        {
+            LOG_ERROR("Failed to create frame fence query at index: %d", i);
+            for (u32 j = 0; j < i; ++j)
+                RELEASE(pFence->pQueries[j]);
+            ZERO_MEM(pFence, 1);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DROP_DestroyFrameFence(GfxFrameFence* pFence)
+{
+    ASSERT_MSG(pFence, "Frame fence is null.");
+
+    for (u32 i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; ++i)
+        SAFE_RELEASE(pFence->pQueries[i]);
+
+    ZERO_MEM(pFence, 1);
+}
+
+static bool IsFrameDone(const GfxHandle handle, GfxFrameFence* pFence, u64 frameIndex, UINT flags)
+{
+    ID3D11Query* pQuery = pFence->pQueries[frameIndex % GFX_MAX_FRAMES_IN_FLIGHT];
+
+    BOOL    done = FALSE;
+    HRESULT hr   = handle->pContext->lpVtbl->GetData(
+        handle->pContext, (ID3D11Asynchronous*) pQuery, &done, sizeof(done), flags);
+
+    // Anything other than S_OK means the data is not ready. A lost device would never finish,
+    // so treat failures as done rather than spinning forever.
+    if (FAILED(hr))
+        return true;
+
+    return hr == S_OK && done;
+}
+
+u64 DROP_FrameFenceSignal(const GfxHandle handle, GfxFrameFence* pFence)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pFence, "Frame fence is null.");
+
+    // The query slot of this frame is still owned by the oldest pending frame, wait for it.
+    while (pFence->submitted - pFence->completed >= GFX_MAX_FRAMES_IN_FLIGHT)
+    {
+        if (IsFrameDone(handle, pFence, pFence->completed + 1, 0))
+            ++pFence->completed;
+    }
+
+    u64 frameIndex = ++pFence->submitted;
+
+    handle->pContext->lpVtbl->End(
+        handle->pContext, (ID3D11Asynchronous*) pFence->pQueries[frameIndex % GFX_MAX_FRAMES_IN_FLIGHT]);
+
+    return frameIndex;
+}
+
+u64 DROP_FrameFencePoll(const GfxHandle handle, GfxFrameFence* pFence)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pFence, "Frame fence is null.");
+
+    // Queries finish in submission order, stop at the first one that is still pending.
+    while (pFence->completed < pFence->submitted &&
+           IsFrameDone(handle, pFence, pFence->completed + 1, D3D11_ASYNC_GETDATA_DONOTFLUSH))
+        ++pFence->completed;
+
+    return pFence->completed;
+}
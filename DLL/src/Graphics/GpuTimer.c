@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "Graphics/GpuTimer.h"
+
+bool DROP_CreateGpuTimer(const GfxHandle handle, GfxGpuTimer* pTimer)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pTimer, "GPU timer is null.");
+
+    ZERO_MEM(pTimer, 1);
+
+    D3D11_QUERY_DESC disjointDesc  = {.Query = D3D11_QUERY_TIMESTAMP_DISJOINT};
+    D3D11_QUERY_DESC timestampDesc = {.Query = D3D11_QUERY_TIMESTAMP};
+
+    for (u32 i = 0; i < GFX_GPU_TIMER_SLOTS; ++i)
+    {
+        ID3D11Device* pDevice = handle->pDevice;
+        if (FAILED(pDevice->lpVtbl->CreateQuery(pDevice, &disjointDesc, &pTimer->pDisjointQueries[i])) ||
+            FAILED(pDevice->lpVtbl->CreateQuery(pDevice, &timestampDesc, &pTimer->pBeginQueries[i])) ||
+            FAILED(pDevice->lpVtbl->CreateQuery(pDevice, &timestampDesc, &pTimer->pEndQueries[i])))
+        {
+            LOG_ERROR("Failed to create GPU timer queries at index: %d", i);
+            DROP_DestroyGpuTimer(pTimer);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DROP_DestroyGpuTimer(GfxGpuTimer* pTimer)
+{
+    ASSERT_MSG(pTimer, "GPU timer is null.");
+
+    for (u32 i = 0; i < GFX_GPU_TIMER_SLOTS; ++i)
+    {
+        SAFE_RELEASE(pTimer->pDisjointQueries[i]);
+        SAFE_RELEASE(pTimer->pBeginQueries[i]);
+        SAFE_RELEASE(pTimer->pEndQueries[i]);
+    }
+
+    ZERO_MEM(pTimer, 1);
+}
+
+void DROP_GpuTimerBegin(const GfxHandle handle, GfxGpuTimer* pTimer, u64 frameIndex)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pTimer, "GPU timer is null.");
+
+    u32                  slot     = (u32) (frameIndex % GFX_GPU_TIMER_SLOTS);
+    ID3D11DeviceContext* pContext = handle->pContext;
+    pContext->lpVtbl->Begin(pContext, (ID3D11Asynchronous*) pTimer->pDisjointQueries[slot]);
+    pContext->lpVtbl->End(pContext, (ID3D11Asynchronous*) pTimer->pBeginQueries[slot]);
+    pTimer->frames[slot] = 0;
+}
+
+void DROP_GpuTimerEnd(const GfxHandle handle, GfxGpuTimer* pTimer, u64 frameIndex)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pTimer, "GPU timer is null.");
+
+    u32                  slot     = (u32) (frameIndex % GFX_GPU_TIMER_SLOTS);
+    ID3D11DeviceContext* pContext = handle->pContext;
+    pContext->lpVtbl->End(pContext, (ID3D11Asynchronous*) pTimer->pEndQueries[slot]);
+    pContext->lpVtbl->End(pContext, (ID3D11Asynchronous*) pTimer->pDisjointQueries[slot]);
+    pTimer->frames[slot] = frameIndex;
+}
+
+bool DROP_GpuTimerRead(const GfxHandle handle, GfxGpuTimer* pTimer, u64 completedFrame, f32* pMilliseconds)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pTimer && pMilliseconds, "GPU timer is null.");
+
+    u32 newest = GFX_GPU_TIMER_SLOTS;
+    for (u32 i = 0; i < GFX_GPU_TIMER_SLOTS; ++i)
+    {
+        u64 frame = pTimer->frames[i];
+        if (frame && frame <= completedFrame && (newest == GFX_GPU_TIMER_SLOTS || frame > pTimer->frames[newest]))
+            newest = i;
+    }
+    if (newest == GFX_GPU_TIMER_SLOTS)
+        return false;
+
+    // Older measurements are dropped with it, only the newest one matters to the caller.
+    u64 newestFrame = pTimer->frames[newest];
+    for (u32 i = 0; i < GFX_GPU_TIMER_SLOTS; ++i)
+    {
+        if (pTimer->frames[i] <= newestFrame)
+            pTimer->frames[i] = 0;
+    }
+
+    // The frame fence saw the frame complete, so the data is there and nothing needs flushing.
+    ID3D11DeviceContext*                pContext = handle->pContext;
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {0};
+    u64                                 begin    = 0;
+    u64                                 end      = 0;
+    if (pContext->lpVtbl->GetData(
+            pContext, (ID3D11Asynchronous*) pTimer->pDisjointQueries[newest], &disjoint, sizeof(disjoint),
+            D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+        pContext->lpVtbl->GetData(
+            pContext, (ID3D11Asynchronous*) pTimer->pBeginQueries[newest], &begin, sizeof(begin),
+            D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+        pContext->lpVtbl->GetData(
+            pContext, (ID3D11Asynchronous*) pTimer->pEndQueries[newest], &end, sizeof(end),
+            D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+    {
+        return false;
+    }
+
+    if (disjoint.Disjoint || disjoint.Frequency == 0 || end < begin)
+        return false;
+
+    *pMilliseconds = (f32) ((f64) (end - begin) * 1000.0 / (f64) disjoint.Frequency);
+    return true;
+}
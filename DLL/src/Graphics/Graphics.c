@@ -172,21 +172,22 @@ bool DROP_ResizeGraphics(GfxHandle handle, u32 width, u32 height)
     return true;
 }
 
-bool DROP_CreateHDRRenderTarget(const GfxHandle handle, u32 width, u32 height, GfxRenderTarget* pRenderTarget)
+bool DROP_CreateRenderTarget(const GfxHandle handle, const GfxRenderTargetDesc* pDesc, GfxRenderTarget* pRenderTarget)
 {
     ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pDesc, "Render target description is null.");
     ASSERT_MSG(pRenderTarget, "Render target view is null.");
 
     D3D11_TEXTURE2D_DESC texDesc = {
-        .Width              = width,
-        .Height             = height,
+        .Width              = pDesc->width,
+        .Height             = pDesc->height,
         .SampleDesc.Count   = 1,
         .SampleDesc.Quality = 0,
         .ArraySize          = 1,
-        .BindFlags          = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE,
+        .BindFlags          = pDesc->bindFlags,
         .CPUAccessFlags     = 0,
         .MiscFlags          = 0,
-        .Format             = DXGI_FORMAT_R16G16B16A16_FLOAT,
+        .Format             = pDesc->format,
         .MipLevels          = 1,
         .Usage              = D3D11_USAGE_DEFAULT};
 
@@ -201,36 +202,53 @@ bool DROP_CreateHDRRenderTarget(const GfxHandle handle, u32 width, u32 height, G
 
     ID3D11RenderTargetView* pRTV = NULL;
 
-    hr = handle->pDevice->lpVtbl->CreateRenderTargetView(
-        handle->pDevice, (ID3D11Resource*) pTexture, NULL, &pRTV);
-    if (FAILED(hr) || !pRTV)
+    if (pDesc->bindFlags & D3D11_BIND_RENDER_TARGET)
     {
-        ASSERT_MSG(false, "Failed to create texture 2D.");
-        RELEASE(pTexture);
-        return false;
+        hr = handle->pDevice->lpVtbl->CreateRenderTargetView(
+            handle->pDevice, (ID3D11Resource*) pTexture, NULL, &pRTV);
+        if (FAILED(hr) || !pRTV)
+        {
+            ASSERT_MSG(false, "Failed to create render target view.");
+            RELEASE(pTexture);
+            return false;
+        }
     }
 
     ID3D11ShaderResourceView* pSRV = NULL;
 
-    hr = handle->pDevice->lpVtbl->CreateShaderResourceView(
-        handle->pDevice, (ID3D11Resource*) pTexture, NULL, &pSRV);
-    if (FAILED(hr) || !pSRV)
+    if (pDesc->bindFlags & D3D11_BIND_SHADER_RESOURCE)
     {
-        ASSERT_MSG(false, "Failed to create texture 2D.");
-        RELEASE(pRTV);
-        RELEASE(pTexture);
-        return false;
+        hr = handle->pDevice->lpVtbl->CreateShaderResourceView(
+            handle->pDevice, (ID3D11Resource*) pTexture, NULL, &pSRV);
+        if (FAILED(hr) || !pSRV)
+        {
+            ASSERT_MSG(false, "Failed to create shader resource view.");
+            SAFE_RELEASE(pRTV);
+            RELEASE(pTexture);
+            return false;
+        }
     }
 
     pRenderTarget->pRTV     = pRTV;
     pRenderTarget->pSRV     = pSRV;
     pRenderTarget->pTexture = pTexture;
-    pRenderTarget->width    = width;
-    pRenderTarget->height   = height;
+    pRenderTarget->width    = pDesc->width;
+    pRenderTarget->height   = pDesc->height;
 
     return true;
 }
 
+bool DROP_CreateHDRRenderTarget(const GfxHandle handle, u32 width, u32 height, GfxRenderTarget* pRenderTarget)
+{
+    GfxRenderTargetDesc desc = {
+        .width     = width,
+        .height    = height,
+        .format    = DXGI_FORMAT_R16G16B16A16_FLOAT,
+        .bindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE};
+
+    return DROP_CreateRenderTarget(handle, &desc, pRenderTarget);
+}
+
 void DROP_DestroyRenderTarget(GfxRenderTarget* pRenderTarget)
 {
     ASSERT_MSG(pRenderTarget, "Render target is null.");
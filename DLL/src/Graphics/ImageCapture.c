@@ -0,0 +1,182 @@
+#include "pch.h"
+#include "Graphics/ImageCapture.h"
+
+#include "Graphics/RenderTargetPool.h"
+
+#pragma region INTERNAL
+static bool ReadBackStaging(const GfxHandle handle, GfxImageCapture capture, GfxCaptureStaging* pStaging, UINT flags)
+{
+    D3D11_MAPPED_SUBRESOURCE mapped = {0};
+    HRESULT                  hr     = handle->pContext->lpVtbl->Map(
+        handle->pContext, (ID3D11Resource*) pStaging->pTexture, 0, D3D11_MAP_READ, flags, &mapped);
+
+    if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+        return false;
+
+    // Whatever happens to the pixels, the staging texture is free again.
+    pStaging->isPending = false;
+
+    if (FAILED(hr))
+    {
+        LOG_ERROR("Failed to map capture staging texture of frame %llu.", pStaging->frameIndex);
+        return true;
+    }
+
+    EncoderFrame* pFrame =
+        DROP_AcquireEncoderFrame(capture->encoder, pStaging->copyWidth, pStaging->copyHeight, pStaging->frameIndex);
+    if (pFrame)
+    {
+        u64 rowSize = (u64) pStaging->copyWidth * 4 * sizeof(u16);
+        for (u32 y = 0; y < pStaging->copyHeight; ++y)
+            memcpy((char*) pFrame->pPixels + y * rowSize, (const char*) mapped.pData + (u64) y * mapped.RowPitch, rowSize);
+
+        DROP_SubmitEncoderFrame(capture->encoder);
+    }
+
+    handle->pContext->lpVtbl->Unmap(handle->pContext, (ID3D11Resource*) pStaging->pTexture, 0);
+
+    return true;
+}
+
+static bool PrepareStaging(const GfxHandle handle, GfxCaptureStaging* pStaging, u32 width, u32 height)
+{
+    // Sized to the size class of the copy, so the staging textures survive small resizes.
+    if (pStaging->pTexture && pStaging->width >= width && pStaging->height >= height)
+        return true;
+
+    SAFE_RELEASE(pStaging->pTexture);
+
+    D3D11_TEXTURE2D_DESC desc = {
+        .Width          = width,
+        .Height         = height,
+        .MipLevels      = 1,
+        .ArraySize      = 1,
+        .Format         = DXGI_FORMAT_R16G16B16A16_FLOAT,
+        .SampleDesc     = {1, 0},
+        .Usage          = D3D11_USAGE_STAGING,
+        .BindFlags      = 0,
+        .CPUAccessFlags = D3D11_CPU_ACCESS_READ,
+        .MiscFlags      = 0};
+
+    HRESULT hr = handle->pDevice->lpVtbl->CreateTexture2D(handle->pDevice, &desc, NULL, &pStaging->pTexture);
+    if (FAILED(hr) || !pStaging->pTexture)
+    {
+        LOG_ERROR("Failed to create capture staging texture.");
+        pStaging->pTexture = NULL;
+        return false;
+    }
+
+    pStaging->width  = width;
+    pStaging->height = height;
+
+    return true;
+}
+#pragma endregion
+
+bool DROP_CreateImageCapture(FrameEncoder encoder, u32 frameCount, GfxImageCapture* pCapture)
+{
+    ASSERT_MSG(encoder, "Frame encoder is null.");
+    ASSERT_MSG(pCapture, "Image capture pointer is null.");
+
+    *pCapture = NULL;
+
+    GfxImageCapture capture = (GfxImageCapture) ALLOC(_GfxImageCapture, 1);
+    if (!capture)
+    {
+        LOG_ERROR("Failed to allocate image capture.");
+        return false;
+    }
+
+    ZERO_MEM(capture, 1);
+    capture->encoder   = encoder;
+    capture->remaining = frameCount;
+
+    *pCapture = capture;
+
+    return true;
+}
+
+void DROP_DestroyImageCapture(const GfxHandle handle, GfxImageCapture* pCapture)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pCapture && *pCapture, "Image capture is null.");
+    GfxImageCapture capture = *pCapture;
+
+    if (capture)
+    {
+        for (u32 i = 0; i < GFX_IMAGE_CAPTURE_LATENCY; ++i)
+        {
+            GfxCaptureStaging* pStaging = &capture->staging[(capture->oldest + i) % GFX_IMAGE_CAPTURE_LATENCY];
+            if (pStaging->isPending)
+                ReadBackStaging(handle, capture, pStaging, 0);
+            SAFE_RELEASE(pStaging->pTexture);
+        }
+
+        FREE(capture);
+    }
+
+    *pCapture = NULL;
+}
+
+void DROP_CaptureImage(
+    const GfxHandle handle, GfxImageCapture capture, ID3D11Texture2D* pSource, u32 width, u32 height)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(capture, "Image capture is null.");
+    ASSERT_MSG(pSource, "Source texture is null.");
+
+    ++capture->frameIndex;
+
+    // Copies finish in order, stop at the first one the GPU hasn't reached.
+    while (capture->staging[capture->oldest].isPending &&
+           ReadBackStaging(handle, capture, &capture->staging[capture->oldest], D3D11_MAP_FLAG_DO_NOT_WAIT))
+        capture->oldest = (capture->oldest + 1) % GFX_IMAGE_CAPTURE_LATENCY;
+
+    if (capture->remaining == 0)
+        return;
+
+    GfxCaptureStaging* pStaging = &capture->staging[capture->next];
+    if (pStaging->isPending)
+    {
+        capture->encoder->droppedCount++;
+        return;
+    }
+
+    if (!PrepareStaging(handle, pStaging, DROP_RenderTargetSizeClass(width), DROP_RenderTargetSizeClass(height)))
+        return;
+
+    D3D11_BOX box = {
+        .left   = 0,
+        .top    = 0,
+        .front  = 0,
+        .right  = width,
+        .bottom = height,
+        .back   = 1};
+
+    handle->pContext->lpVtbl->CopySubresourceRegion(
+        handle->pContext, (ID3D11Resource*) pStaging->pTexture, 0, 0, 0, 0, (ID3D11Resource*) pSource, 0, &box);
+
+    pStaging->copyWidth  = width;
+    pStaging->copyHeight = height;
+    pStaging->frameIndex = capture->frameIndex;
+    pStaging->isPending  = true;
+
+    capture->next = (capture->next + 1) % GFX_IMAGE_CAPTURE_LATENCY;
+    --capture->remaining;
+}
+
+bool DROP_IsImageCaptureDone(GfxImageCapture capture)
+{
+    ASSERT_MSG(capture, "Image capture is null.");
+
+    if (capture->remaining > 0)
+        return false;
+
+    for (u32 i = 0; i < GFX_IMAGE_CAPTURE_LATENCY; ++i)
+    {
+        if (capture->staging[i].isPending)
+            return false;
+    }
+
+    return true;
+}
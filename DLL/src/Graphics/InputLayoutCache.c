@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "Graphics/InputLayoutCache.h"
+#include "Graphics/CommandCapture.h"
+
+#pragma region INTERNAL
+// By component type, then component count.
+static const DXGI_FORMAT s_elementFormats[3][4] = {
+    {DXGI_FORMAT_R32_UINT, DXGI_FORMAT_R32G32_UINT, DXGI_FORMAT_R32G32B32_UINT, DXGI_FORMAT_R32G32B32A32_UINT},
+    {DXGI_FORMAT_R32_SINT, DXGI_FORMAT_R32G32_SINT, DXGI_FORMAT_R32G32B32_SINT, DXGI_FORMAT_R32G32B32A32_SINT},
+    {DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT}};
+
+static bool IsSameSignature(const GfxInputLayout* pLayout, const ShaderReflection* pReflection)
+{
+    if (pLayout->inputCount != pReflection->inputCount)
+        return false;
+
+    for (u32 i = 0; i < pLayout->inputCount; ++i)
+    {
+        const ShaderSignatureElement* pA = &pLayout->inputs[i];
+        const ShaderSignatureElement* pB = &pReflection->inputs[i];
+        if (strcmp(pA->semanticName, pB->semanticName) != 0 || pA->semanticIndex != pB->semanticIndex ||
+            pA->systemValue != pB->systemValue || pA->componentType != pB->componentType ||
+            pA->reg != pB->reg || pA->mask != pB->mask)
+            return false;
+    }
+    return true;
+}
+#pragma endregion
+
+bool DROP_CreateInputLayoutCache(GfxInputLayoutCache* pCache)
+{
+    ASSERT_MSG(pCache, "Input layout cache pointer is null.");
+
+    GfxInputLayoutCache cache = (GfxInputLayoutCache) ALLOC(_GfxInputLayoutCache, 1);
+    if (!cache)
+    {
+        LOG_ERROR("Failed to allocate input layout cache.");
+        *pCache = NULL;
+        return false;
+    }
+
+    ZERO_MEM(cache, 1);
+    *pCache = cache;
+
+    return true;
+}
+
+void DROP_DestroyInputLayoutCache(GfxInputLayoutCache* pCache)
+{
+    ASSERT_MSG(pCache && *pCache, "Input layout cache is null.");
+    GfxInputLayoutCache cache = *pCache;
+
+    if (cache)
+    {
+        for (u32 i = 0; i < cache->layoutCount; ++i)
+            SAFE_RELEASE(cache->layouts[i].pInputLayout);
+
+        FREE(cache);
+    }
+
+    *pCache = NULL;
+}
+
+bool DROP_GetInputLayout(
+    const GfxHandle handle, GfxInputLayoutCache cache, const ShaderReflection* pReflection, const void* pByteCode,
+    u64 byteCodeSize, D3D11_INPUT_CLASSIFICATION slotClass, ID3D11InputLayout** ppInputLayout)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(cache, "Input layout cache is null.");
+    ASSERT_MSG(pReflection, "Reflection is null.");
+    ASSERT_MSG(pByteCode, "VS bytecode is null.");
+    ASSERT_MSG(ppInputLayout, "Input layout pointer is null.");
+
+    *ppInputLayout = NULL;
+
+    for (u32 i = 0; i < cache->layoutCount; ++i)
+    {
+        const GfxInputLayout* pLayout = &cache->layouts[i];
+        if (pLayout->hash == pReflection->inputHash && pLayout->slotClass == slotClass &&
+            IsSameSignature(pLayout, pReflection))
+        {
+            *ppInputLayout = pLayout->pInputLayout;
+            return true;
+        }
+    }
+
+    // System values come from the input assembler itself, they have no element.
+    D3D11_INPUT_ELEMENT_DESC elements[SHADER_MAX_SIGNATURE_ELEMENTS];
+    u32                      elementCount = 0;
+    for (u32 i = 0; i < pReflection->inputCount; ++i)
+    {
+        const ShaderSignatureElement* pInput = &pReflection->inputs[i];
+        if (pInput->systemValue)
+            continue;
+
+        if (pInput->componentType < SHADER_COMPONENT_UINT32 || pInput->componentType > SHADER_COMPONENT_FLOAT32 ||
+            pInput->componentCount == 0)
+        {
+            LOG_ERROR("Vertex input %s%u has no vertex format.", pInput->semanticName, pInput->semanticIndex);
+            return false;
+        }
+
+        elements[elementCount++] = (D3D11_INPUT_ELEMENT_DESC) {
+            .SemanticName         = pInput->semanticName,
+            .SemanticIndex        = pInput->semanticIndex,
+            .Format               = s_elementFormats[pInput->componentType - 1][pInput->componentCount - 1],
+            .InputSlot            = 0,
+            .AlignedByteOffset    = D3D11_APPEND_ALIGNED_ELEMENT,
+            .InputSlotClass       = slotClass,
+            .InstanceDataStepRate = slotClass == D3D11_INPUT_PER_INSTANCE_DATA ? 1 : 0};
+    }
+
+    if (elementCount == 0)
+        return true;
+
+    if (cache->layoutCount == GFX_MAX_INPUT_LAYOUTS)
+    {
+        LOG_ERROR("Input layout cache is full.");
+        return false;
+    }
+
+    ID3D11InputLayout* pInputLayout = NULL;
+
+    HRESULT hr = handle->pDevice->lpVtbl->CreateInputLayout(
+        handle->pDevice, elements, elementCount, pByteCode, (SIZE_T) byteCodeSize, &pInputLayout);
+    if (FAILED(hr) || !pInputLayout)
+    {
+        LOG_ERROR("Failed to create input layout.");
+        return false;
+    }
+    DROP_SetCaptureInputLayoutData(pInputLayout, elements, elementCount, pByteCode, (u32) byteCodeSize);
+
+    GfxInputLayout* pLayout = &cache->layouts[cache->layoutCount++];
+    memcpy(pLayout->inputs, pReflection->inputs, sizeof(ShaderSignatureElement) * pReflection->inputCount);
+    pLayout->inputCount   = pReflection->inputCount;
+    pLayout->hash         = pReflection->inputHash;
+    pLayout->slotClass    = slotClass;
+    pLayout->pInputLayout = pInputLayout;
+    *ppInputLayout        = pInputLayout;
+
+    return true;
+}
@@ -0,0 +1,189 @@
+#include "pch.h"
+#include "Graphics/PipelineState.h"
+
+#pragma region INTERNAL
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+static u64 HashValue(u64 hash, u64 value)
+{
+    for (u32 i = 0; i < 8; ++i)
+    {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Hashed member by member, the description has padding.
+static u64 HashDesc(const GfxPipelineDesc* pDesc)
+{
+    u64 hash = FNV_OFFSET_BASIS;
+    hash     = HashValue(hash, (u64) (size_t) pDesc->pVertexShader);
+    hash     = HashValue(hash, (u64) (size_t) pDesc->pPixelShader);
+    hash     = HashValue(hash, (u64) (size_t) pDesc->pInputLayout);
+    hash     = HashValue(hash, (u64) pDesc->topology);
+    for (u32 i = 0; i < GFX_PIPELINE_SAMPLER_COUNT; ++i)
+        hash = HashValue(hash, (u64) (size_t) pDesc->pSamplers[i]);
+    return hash;
+}
+
+static bool IsSameDesc(const GfxPipelineDesc* pA, const GfxPipelineDesc* pB)
+{
+    if (pA->pVertexShader != pB->pVertexShader || pA->pPixelShader != pB->pPixelShader ||
+        pA->pInputLayout != pB->pInputLayout || pA->topology != pB->topology)
+        return false;
+
+    for (u32 i = 0; i < GFX_PIPELINE_SAMPLER_COUNT; ++i)
+    {
+        if (pA->pSamplers[i] != pB->pSamplers[i])
+            return false;
+    }
+    return true;
+}
+
+static void AddRefDesc(const GfxPipelineDesc* pDesc)
+{
+    if (pDesc->pVertexShader) pDesc->pVertexShader->lpVtbl->AddRef(pDesc->pVertexShader);
+    if (pDesc->pPixelShader) pDesc->pPixelShader->lpVtbl->AddRef(pDesc->pPixelShader);
+    if (pDesc->pInputLayout) pDesc->pInputLayout->lpVtbl->AddRef(pDesc->pInputLayout);
+    for (u32 i = 0; i < GFX_PIPELINE_SAMPLER_COUNT; ++i)
+    {
+        if (pDesc->pSamplers[i]) pDesc->pSamplers[i]->lpVtbl->AddRef(pDesc->pSamplers[i]);
+    }
+}
+
+static void ReleaseDesc(GfxPipelineDesc* pDesc)
+{
+    SAFE_RELEASE(pDesc->pVertexShader);
+    SAFE_RELEASE(pDesc->pPixelShader);
+    SAFE_RELEASE(pDesc->pInputLayout);
+    for (u32 i = 0; i < GFX_PIPELINE_SAMPLER_COUNT; ++i)
+    {
+        SAFE_RELEASE(pDesc->pSamplers[i]);
+    }
+}
+#pragma endregion
+
+bool DROP_CreatePipelineCache(GfxPipelineCache* pCache)
+{
+    ASSERT_MSG(pCache, "Pipeline cache pointer is null.");
+
+    GfxPipelineCache cache = (GfxPipelineCache) ALLOC(_GfxPipelineCache, 1);
+    if (!cache)
+    {
+        LOG_ERROR("Failed to allocate pipeline cache.");
+        *pCache = NULL;
+        return false;
+    }
+
+    ZERO_MEM(cache, 1);
+    *pCache = cache;
+
+    return true;
+}
+
+void DROP_DestroyPipelineCache(GfxPipelineCache* pCache)
+{
+    ASSERT_MSG(pCache && *pCache, "Pipeline cache is null.");
+    GfxPipelineCache cache = *pCache;
+
+    if (cache)
+    {
+        for (u32 i = 0; i < cache->stateCount; ++i)
+            ReleaseDesc(&cache->states[i].desc);
+
+        FREE(cache);
+    }
+
+    *pCache = NULL;
+}
+
+bool DROP_GetPipelineState(GfxPipelineCache cache, const GfxPipelineDesc* pDesc, const GfxPipelineState** ppState)
+{
+    ASSERT_MSG(cache, "Pipeline cache is null.");
+    ASSERT_MSG(pDesc, "Pipeline description is null.");
+    ASSERT_MSG(ppState, "Pipeline state pointer is null.");
+
+    u64 hash   = HashDesc(pDesc);
+    u32 bucket = (u32) (hash % ARRAYSIZE(cache->buckets));
+
+    while (cache->buckets[bucket])
+    {
+        const GfxPipelineState* pState = &cache->states[cache->buckets[bucket] - 1];
+        if (pState->hash == hash && IsSameDesc(&pState->desc, pDesc))
+        {
+            *ppState = pState;
+            return true;
+        }
+        bucket = (bucket + 1) % ARRAYSIZE(cache->buckets);
+    }
+
+    if (cache->stateCount == GFX_MAX_PIPELINE_STATES)
+    {
+        LOG_ERROR("Pipeline cache is full.");
+        *ppState = NULL;
+        return false;
+    }
+
+    GfxPipelineState* pState = &cache->states[cache->stateCount];
+    pState->desc             = *pDesc;
+    pState->hash             = hash;
+    pState->id               = cache->stateCount;
+    AddRefDesc(&pState->desc);
+
+    cache->buckets[bucket] = (u8) ++cache->stateCount;
+    *ppState               = pState;
+
+    return true;
+}
+
+void DROP_BindPipelineState(const GfxHandle handle, GfxPipelineCache cache, const GfxPipelineState* pState)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(cache, "Pipeline cache is null.");
+    ASSERT_MSG(pState, "Pipeline state is null.");
+
+    const GfxPipelineState* pBound = cache->pBound;
+    if (pBound == pState)
+        return;
+
+    ID3D11DeviceContext*   pContext = handle->pContext;
+    const GfxPipelineDesc* pDesc    = &pState->desc;
+
+    if (!pBound || pBound->desc.pVertexShader != pDesc->pVertexShader)
+        pContext->lpVtbl->VSSetShader(pContext, pDesc->pVertexShader, NULL, 0);
+    if (!pBound || pBound->desc.pPixelShader != pDesc->pPixelShader)
+        pContext->lpVtbl->PSSetShader(pContext, pDesc->pPixelShader, NULL, 0);
+    if (!pBound || pBound->desc.pInputLayout != pDesc->pInputLayout)
+        pContext->lpVtbl->IASetInputLayout(pContext, pDesc->pInputLayout);
+    if (!pBound || pBound->desc.topology != pDesc->topology)
+        pContext->lpVtbl->IASetPrimitiveTopology(pContext, pDesc->topology);
+
+    for (u32 i = 0; i < GFX_PIPELINE_SAMPLER_COUNT; ++i)
+    {
+        if (!pBound || pBound->desc.pSamplers[i] != pDesc->pSamplers[i])
+            pContext->lpVtbl->PSSetSamplers(pContext, i, 1, &pDesc->pSamplers[i]);
+    }
+
+    cache->pBound = pState;
+    ++cache->switchCount;
+    DROP_AddCounter(COUNTER_STATE_CHANGES, 1);
+}
+
+void DROP_InvalidatePipelineState(GfxPipelineCache cache)
+{
+    ASSERT_MSG(cache, "Pipeline cache is null.");
+
+    cache->pBound = NULL;
+}
+
+u32 DROP_PipelineCacheEndFrame(GfxPipelineCache cache)
+{
+    ASSERT_MSG(cache, "Pipeline cache is null.");
+
+    cache->lastFrameSwitchCount = cache->switchCount;
+    cache->switchCount          = 0;
+
+    return cache->lastFrameSwitchCount;
+}
@@ -0,0 +1,158 @@
+#include "pch.h"
+#include "Graphics/RenderQueue.h"
+
+#pragma region INTERNAL
+#define RENDER_KEY_MASK(bits) ((1ull << (bits)) - 1)
+
+static u64 QuantizeDepth(f32 depth)
+{
+    depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+    return (u64) (depth * (f32) RENDER_KEY_MASK(RENDER_KEY_DEPTH_BITS));
+}
+#pragma endregion
+
+bool DROP_CreateRenderQueue(u32 maxPackets, RenderQueue* pQueue)
+{
+    ASSERT_MSG(maxPackets > 0, "Render queue capacity must be greater than zero.");
+    ASSERT_MSG(pQueue, "Render queue pointer is null.");
+
+    *pQueue = NULL;
+
+    RenderQueue queue = (RenderQueue) ALLOC(_RenderQueue, 1);
+    if (!queue)
+    {
+        LOG_ERROR("Failed to allocate render queue.");
+        return false;
+    }
+    ZERO_MEM(queue, 1);
+
+    queue->maxPackets = maxPackets;
+    if (!DROP_MakeRadixSort(&queue->sort, maxPackets))
+    {
+        LOG_ERROR("Failed to allocate render queue storage.");
+        DROP_DestroyRenderQueue(&queue);
+        return false;
+    }
+
+    *pQueue = queue;
+
+    return true;
+}
+
+void DROP_DestroyRenderQueue(RenderQueue* pQueue)
+{
+    ASSERT_MSG(pQueue && *pQueue, "Render queue is null.");
+    RenderQueue queue = *pQueue;
+
+    if (queue)
+    {
+        DROP_DestroyRadixSort(&queue->sort);
+
+        FREE(queue);
+    }
+
+    *pQueue = NULL;
+}
+
+u64 DROP_MakeOpaqueKey(u32 pass, u32 pipeline, u32 material, u32 mesh, f32 depth)
+{
+    u64 key = (u64) pass & RENDER_KEY_MASK(RENDER_KEY_PASS_BITS);
+    key     = (key << RENDER_KEY_PIPELINE_BITS) | (pipeline & RENDER_KEY_MASK(RENDER_KEY_PIPELINE_BITS));
+    key     = (key << RENDER_KEY_MATERIAL_BITS) | (material & RENDER_KEY_MASK(RENDER_KEY_MATERIAL_BITS));
+    key     = (key << RENDER_KEY_MESH_BITS) | (mesh & RENDER_KEY_MASK(RENDER_KEY_MESH_BITS));
+    key     = (key << RENDER_KEY_DEPTH_BITS) | QuantizeDepth(depth);
+    return key;
+}
+
+u64 DROP_MakeTransparentKey(u32 pass, u32 pipeline, u32 material, u32 mesh, f32 depth)
+{
+    u64 key = (u64) pass & RENDER_KEY_MASK(RENDER_KEY_PASS_BITS);
+    key     = (key << RENDER_KEY_DEPTH_BITS) | (RENDER_KEY_MASK(RENDER_KEY_DEPTH_BITS) - QuantizeDepth(depth));
+    key     = (key << RENDER_KEY_PIPELINE_BITS) | (pipeline & RENDER_KEY_MASK(RENDER_KEY_PIPELINE_BITS));
+    key     = (key << RENDER_KEY_MATERIAL_BITS) | (material & RENDER_KEY_MASK(RENDER_KEY_MATERIAL_BITS));
+    key     = (key << RENDER_KEY_MESH_BITS) | (mesh & RENDER_KEY_MASK(RENDER_KEY_MESH_BITS));
+    return key;
+}
+
+void DROP_RenderQueueBegin(RenderQueue queue, FrameArenas* pArenas)
+{
+    ASSERT_MSG(queue, "Render queue is null.");
+    ASSERT_MSG(pArenas, "Frame arenas pointer is null.");
+
+    queue->pPackets    = (RenderPacket*) DROP_AllocateFrame(pArenas, sizeof(RenderPacket) * queue->maxPackets, 0);
+    queue->packetCount = 0;
+}
+
+bool DROP_RenderQueueSubmit(RenderQueue queue, u64 key, const RenderPacket* pPacket)
+{
+    ASSERT_MSG(queue, "Render queue is null.");
+    ASSERT_MSG(pPacket && pPacket->pPipeline, "Render packet is invalid.");
+    ASSERT_MSG(queue->pPackets, "Render queue has not begun.");
+
+    if (queue->packetCount == queue->maxPackets)
+    {
+        LOG_WARN("Render queue is full.");
+        return false;
+    }
+
+    u32 index                  = queue->packetCount++;
+    queue->pPackets[index]     = *pPacket;
+    queue->sort.pKeys[index]   = key;
+    queue->sort.pValues[index] = index;
+
+    return true;
+}
+
+void DROP_RenderQueueSort(RenderQueue queue)
+{
+    ASSERT_MSG(queue, "Render queue is null.");
+
+    DROP_RadixSort(&queue->sort, queue->packetCount);
+}
+
+void DROP_RenderQueueExecute(const GfxHandle handle, GfxPipelineCache cache, RenderQueue queue)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(cache, "Pipeline cache is null.");
+    ASSERT_MSG(queue, "Render queue is null.");
+
+    ID3D11DeviceContext* pContext = handle->pContext;
+
+    const RenderPacket* pLast = NULL;
+    queue->drawCount          = 0;
+    queue->bindCount          = 0;
+
+    for (u32 i = 0; i < queue->packetCount; ++i)
+    {
+        const RenderPacket* pPacket = &queue->pPackets[queue->sort.pValues[i]];
+
+        if (!pLast || pLast->pPipeline != pPacket->pPipeline)
+        {
+            DROP_BindPipelineState(handle, cache, pPacket->pPipeline);
+            ++queue->bindCount;
+        }
+        if (!pLast || pLast->pVertexBuffer != pPacket->pVertexBuffer || pLast->stride != pPacket->stride)
+        {
+            u32 offset = 0;
+            pContext->lpVtbl->IASetVertexBuffers(pContext, 0, 1, &pPacket->pVertexBuffer, &pPacket->stride, &offset);
+            ++queue->bindCount;
+        }
+        if (!pLast || pLast->pConstantBuffer != pPacket->pConstantBuffer)
+        {
+            pContext->lpVtbl->PSSetConstantBuffers(pContext, 0, 1, &pPacket->pConstantBuffer);
+            ++queue->bindCount;
+        }
+        if (!pLast || pLast->pSRV != pPacket->pSRV)
+        {
+            pContext->lpVtbl->PSSetShaderResources(pContext, 0, 1, &pPacket->pSRV);
+            ++queue->bindCount;
+        }
+
+        pContext->lpVtbl->Draw(pContext, pPacket->vertexCount, pPacket->startVertex);
+        ++queue->drawCount;
+
+        pLast = pPacket;
+    }
+
+    DROP_AddCounter(COUNTER_DRAW_CALLS, queue->drawCount);
+}
@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "Graphics/RenderTargetPool.h"
+
+#pragma region INTERNAL
+static bool IsSameDesc(const GfxRenderTargetDesc* pA, const GfxRenderTargetDesc* pB)
+{
+    return pA->width == pB->width && pA->height == pB->height && pA->format == pB->format &&
+           pA->bindFlags == pB->bindFlags;
+}
+
+static void RemoveEntry(GfxRenderTargetPool pool, u32 index)
+{
+    DROP_DestroyRenderTarget(&pool->entries[index].target);
+    pool->entries[index] = pool->entries[--pool->entryCount];
+}
+
+// Returns the index of the free entry used the longest time ago, or entryCount when all are in use.
+static u32 FindLeastRecentlyUsed(GfxRenderTargetPool pool)
+{
+    u32 found = pool->entryCount;
+    for (u32 i = 0; i < pool->entryCount; ++i)
+    {
+        const GfxPooledTarget* pEntry = &pool->entries[i];
+        if (!pEntry->isInUse && (found == pool->entryCount || pEntry->lastUsedFrame < pool->entries[found].lastUsedFrame))
+            found = i;
+    }
+    return found;
+}
+#pragma endregion
+
+bool DROP_CreateRenderTargetPool(const GfxHandle handle, GfxRenderTargetPool* pPool)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pPool, "Render target pool pointer is null.");
+
+    GfxRenderTargetPool pool = (GfxRenderTargetPool) ALLOC(_GfxRenderTargetPool, 1);
+    if (!pool)
+    {
+        LOG_ERROR("Failed to allocate render target pool.");
+        *pPool = NULL;
+        return false;
+    }
+
+    ZERO_MEM(pool, 1);
+    pool->handle = handle;
+    *pPool       = pool;
+
+    return true;
+}
+
+void DROP_DestroyRenderTargetPool(GfxRenderTargetPool* pPool)
+{
+    ASSERT_MSG(pPool && *pPool, "Render target pool is null.");
+    GfxRenderTargetPool pool = *pPool;
+
+    if (pool)
+    {
+        for (u32 i = 0; i < pool->entryCount; ++i)
+            DROP_DestroyRenderTarget(&pool->entries[i].target);
+
+        LOG_TRACE("Render target pool created %llu targets and reused %llu.", pool->createCount, pool->reuseCount);
+        FREE(pool);
+    }
+
+    *pPool = NULL;
+}
+
+bool DROP_AcquireRenderTarget(GfxRenderTargetPool pool, const GfxRenderTargetDesc* pDesc, GfxRenderTarget* pTarget)
+{
+    ASSERT_MSG(pool, "Render target pool is null.");
+    ASSERT_MSG(pDesc, "Render target description is null.");
+    ASSERT_MSG(pTarget, "Render target is null.");
+
+    u32 found = pool->entryCount;
+    for (u32 i = 0; i < pool->entryCount; ++i)
+    {
+        const GfxPooledTarget* pEntry = &pool->entries[i];
+        if (pEntry->isInUse || !IsSameDesc(&pEntry->desc, pDesc))
+            continue;
+
+        // The most recently used target is the most likely to still be resident.
+        if (found == pool->entryCount || pEntry->lastUsedFrame > pool->entries[found].lastUsedFrame)
+            found = i;
+    }
+
+    if (found == pool->entryCount)
+    {
+        if (pool->entryCount == GFX_RENDER_TARGET_POOL_SIZE)
+        {
+            u32 evicted = FindLeastRecentlyUsed(pool);
+            if (evicted == pool->entryCount)
+            {
+                LOG_ERROR("Render target pool is full, every target is in use.");
+                return false;
+            }
+            RemoveEntry(pool, evicted);
+        }
+
+        found                   = pool->entryCount;
+        GfxPooledTarget* pEntry = &pool->entries[found];
+        if (!DROP_CreateRenderTarget(pool->handle, pDesc, &pEntry->target))
+        {
+            LOG_ERROR("Failed to create pooled render target of %ux%u.", pDesc->width, pDesc->height);
+            return false;
+        }
+
+        pEntry->desc = *pDesc;
+        ++pool->entryCount;
+        ++pool->createCount;
+    }
+    else
+    {
+        ++pool->reuseCount;
+    }
+
+    GfxPooledTarget* pEntry = &pool->entries[found];
+    pEntry->isInUse         = true;
+    pEntry->lastUsedFrame   = pool->frameIndex;
+    *pTarget                = pEntry->target;
+
+    return true;
+}
+
+void DROP_ReleaseRenderTarget(GfxRenderTargetPool pool, GfxRenderTarget* pTarget)
+{
+    ASSERT_MSG(pool, "Render target pool is null.");
+    ASSERT_MSG(pTarget, "Render target is null.");
+
+    if (!pTarget->pTexture)
+        return;
+
+    for (u32 i = 0; i < pool->entryCount; ++i)
+    {
+        GfxPooledTarget* pEntry = &pool->entries[i];
+        if (pEntry->target.pTexture != pTarget->pTexture)
+            continue;
+
+        ASSERT_MSG(pEntry->isInUse, "Render target is released twice.");
+        pEntry->isInUse       = false;
+        pEntry->lastUsedFrame = pool->frameIndex;
+        break;
+    }
+
+    ZERO_MEM(pTarget, 1);
+}
+
+void DROP_RenderTargetPoolEndFrame(GfxRenderTargetPool pool)
+{
+    ASSERT_MSG(pool, "Render target pool is null.");
+
+    for (u32 i = 0; i < pool->entryCount;)
+    {
+        const GfxPooledTarget* pEntry = &pool->entries[i];
+        if (!pEntry->isInUse && pool->frameIndex - pEntry->lastUsedFrame > GFX_RENDER_TARGET_MAX_IDLE_FRAMES)
+            RemoveEntry(pool, i);
+        else
+            ++i;
+    }
+
+    ++pool->frameIndex;
+}
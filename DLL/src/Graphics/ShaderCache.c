@@ -0,0 +1,300 @@
+#include "pch.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/CommandCapture.h"
+
+#pragma region INTERNAL
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+#define SHADER_PATH_LENGTH 160
+
+static u64 HashString(u64 hash, const char* string)
+{
+    // The terminator goes in too, so "a" "bc" and "ab" "c" differ.
+    do
+    {
+        hash ^= (u8) *string;
+        hash *= FNV_PRIME;
+    } while (*string++);
+    return hash;
+}
+
+static u64 HashVariant(GfxShaderStage stage, const char* name, const char* defines)
+{
+    u64 hash = FNV_OFFSET_BASIS;
+    hash ^= (u64) stage;
+    hash *= FNV_PRIME;
+    hash = HashString(hash, name);
+    return HashString(hash, defines);
+}
+
+// The defines become part of the file name, their spaces turned into underscores.
+static bool BuildShaderPath(GfxShaderStage stage, const char* name, const char* defines, wchar_t* path)
+{
+    char fileName[SHADER_PATH_LENGTH];
+    i32  length = snprintf(
+        fileName, sizeof(fileName), GFX_SHADER_DIRECTORY "%s_%s%s%s.cso", name,
+        stage == GFX_SHADER_STAGE_VERTEX ? "vs" : "ps", defines[0] ? "_" : "", defines);
+    if (length < 0 || length >= SHADER_PATH_LENGTH)
+        return false;
+
+    for (i32 i = 0; i <= length; ++i)
+        path[i] = fileName[i] == ' ' ? L'_' : (wchar_t) fileName[i];
+    return true;
+}
+
+static bool CreateVariant(
+    const GfxHandle handle, GfxShaderCache cache, const GfxShaderBinary* pBinary, GfxShaderVariant* pVariant)
+{
+    ID3DBlob*   pByteCode = pBinary->pByteCode;
+    const void* pData     = pByteCode->lpVtbl->GetBufferPointer(pByteCode);
+    SIZE_T      size      = pByteCode->lpVtbl->GetBufferSize(pByteCode);
+    HRESULT     hr        = 0;
+
+    bool isCreated = false;
+    if (pBinary->stage == GFX_SHADER_STAGE_VERTEX)
+    {
+        isCreated = DROP_GetInputLayout(
+            handle, cache->layoutCache, &pBinary->reflection, pData, size, pBinary->inputClass,
+            &pVariant->pInputLayout);
+        if (isCreated)
+        {
+            hr = handle->pDevice->lpVtbl->CreateVertexShader(handle->pDevice, pData, size, NULL, &pVariant->pVertexShader);
+            isCreated = SUCCEEDED(hr) && pVariant->pVertexShader;
+        }
+    }
+    else
+    {
+        hr = handle->pDevice->lpVtbl->CreatePixelShader(handle->pDevice, pData, size, NULL, &pVariant->pPixelShader);
+        isCreated = SUCCEEDED(hr) && pVariant->pPixelShader;
+    }
+
+    if (!isCreated)
+    {
+        LOG_ERROR("Failed to create shader %s with defines '%s'.", pBinary->name, pBinary->defines);
+        ZERO_MEM(pVariant, 1);
+        return false;
+    }
+
+    DROP_SetCaptureData(
+        pVariant->pVertexShader ? (ID3D11DeviceChild*) pVariant->pVertexShader
+                                : (ID3D11DeviceChild*) pVariant->pPixelShader,
+        pData, (u32) size);
+
+    pVariant->stage = pBinary->stage;
+    strcpy(pVariant->name, pBinary->name);
+    strcpy(pVariant->defines, pBinary->defines);
+
+    return true;
+}
+
+// Returns the variant or the empty bucket it would go in.
+static GfxShaderVariant* FindVariant(
+    GfxShaderCache cache, GfxShaderStage stage, const char* name, const char* defines, u64 hash, u32* pBucket)
+{
+    u32 bucket = (u32) (hash % ARRAYSIZE(cache->buckets));
+    while (cache->buckets[bucket])
+    {
+        GfxShaderVariant* pVariant = &cache->variants[cache->buckets[bucket] - 1];
+        if (pVariant->hash == hash && pVariant->stage == stage && strcmp(pVariant->name, name) == 0 &&
+            strcmp(pVariant->defines, defines) == 0)
+            return pVariant;
+        bucket = (bucket + 1) % ARRAYSIZE(cache->buckets);
+    }
+
+    *pBucket = bucket;
+    return NULL;
+}
+
+static bool InsertVariant(
+    const GfxHandle handle, GfxShaderCache cache, const GfxShaderBinary* pBinary, u64 hash, u32 bucket,
+    const GfxShaderVariant** ppVariant)
+{
+    if (cache->variantCount == GFX_MAX_SHADER_VARIANTS)
+    {
+        LOG_ERROR("Shader cache is full.");
+        return false;
+    }
+
+    GfxShaderVariant* pVariant = &cache->variants[cache->variantCount];
+    if (!CreateVariant(handle, cache, pBinary, pVariant))
+        return false;
+
+    pVariant->hash         = hash;
+    cache->buckets[bucket] = (u8) ++cache->variantCount;
+    *ppVariant             = pVariant;
+
+    return true;
+}
+
+static bool GetVariant(
+    const GfxHandle handle, GfxShaderCache cache, GfxShaderStage stage, const GfxShaderDesc* pDesc,
+    const GfxShaderVariant** ppVariant)
+{
+    const char* defines = pDesc->defines ? pDesc->defines : "";
+    u64         hash    = HashVariant(stage, pDesc->name, defines);
+    u32         bucket  = 0;
+
+    *ppVariant = FindVariant(cache, stage, pDesc->name, defines, hash, &bucket);
+    if (*ppVariant)
+        return true;
+
+    GfxShaderBinary binary;
+    if (!DROP_LoadShaderBinary(stage, pDesc, &binary))
+        return false;
+
+    bool isInserted = InsertVariant(handle, cache, &binary, hash, bucket, ppVariant);
+    DROP_ReleaseShaderBinary(&binary);
+
+    return isInserted;
+}
+#pragma endregion
+
+bool DROP_CreateShaderCache(GfxInputLayoutCache layoutCache, GfxShaderCache* pCache)
+{
+    ASSERT_MSG(layoutCache, "Input layout cache is null.");
+    ASSERT_MSG(pCache, "Shader cache pointer is null.");
+
+    GfxShaderCache cache = (GfxShaderCache) ALLOC(_GfxShaderCache, 1);
+    if (!cache)
+    {
+        LOG_ERROR("Failed to allocate shader cache.");
+        *pCache = NULL;
+        return false;
+    }
+
+    ZERO_MEM(cache, 1);
+    cache->layoutCache = layoutCache;
+    *pCache            = cache;
+
+    return true;
+}
+
+void DROP_DestroyShaderCache(GfxShaderCache* pCache)
+{
+    ASSERT_MSG(pCache && *pCache, "Shader cache is null.");
+    GfxShaderCache cache = *pCache;
+
+    if (cache)
+    {
+        for (u32 i = 0; i < cache->variantCount; ++i)
+        {
+            SAFE_RELEASE(cache->variants[i].pVertexShader);
+            SAFE_RELEASE(cache->variants[i].pPixelShader);
+        }
+
+        FREE(cache);
+    }
+
+    *pCache = NULL;
+}
+
+bool DROP_LoadShaderBinary(GfxShaderStage stage, const GfxShaderDesc* pDesc, GfxShaderBinary* pBinary)
+{
+    ASSERT_MSG(pDesc && pDesc->name, "Shader description is invalid.");
+    ASSERT_MSG(pBinary, "Shader binary is null.");
+
+    ZERO_MEM(pBinary, 1);
+
+    const char* defines = pDesc->defines ? pDesc->defines : "";
+    wchar_t     path[SHADER_PATH_LENGTH];
+    if (strlen(pDesc->name) >= GFX_SHADER_NAME_LENGTH || strlen(defines) >= GFX_SHADER_DEFINES_LENGTH ||
+        !BuildShaderPath(stage, pDesc->name, defines, path))
+    {
+        LOG_ERROR("Shader name or defines too long: %s %s.", pDesc->name, defines);
+        return false;
+    }
+
+    pBinary->stage      = stage;
+    pBinary->inputClass = pDesc->inputClass;
+    strcpy(pBinary->name, pDesc->name);
+    strcpy(pBinary->defines, defines);
+
+    HRESULT hr = D3DReadFileToBlob(path, &pBinary->pByteCode);
+    if (FAILED(hr) || !pBinary->pByteCode)
+    {
+        LOG_ERROR("Failed to load shader %s with defines '%s'.", pDesc->name, defines);
+        pBinary->pByteCode = NULL;
+        return false;
+    }
+
+    ID3DBlob* pByteCode = pBinary->pByteCode;
+    if (!DROP_ReflectShader(
+            pByteCode->lpVtbl->GetBufferPointer(pByteCode), pByteCode->lpVtbl->GetBufferSize(pByteCode),
+            &pBinary->reflection) ||
+        (pDesc->cbufferName &&
+         !DROP_ValidateConstantBuffer(&pBinary->reflection, pDesc->cbufferName, pDesc->cbufferSize)))
+    {
+        LOG_ERROR("Shader %s with defines '%s' does not match the code.", pDesc->name, defines);
+        DROP_ReleaseShaderBinary(pBinary);
+        return false;
+    }
+
+    return true;
+}
+
+void DROP_ReleaseShaderBinary(GfxShaderBinary* pBinary)
+{
+    ASSERT_MSG(pBinary, "Shader binary is null.");
+
+    SAFE_RELEASE(pBinary->pByteCode);
+}
+
+bool DROP_AddShaderVariant(const GfxHandle handle, GfxShaderCache cache, const GfxShaderBinary* pBinary)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(cache, "Shader cache is null.");
+    ASSERT_MSG(pBinary && pBinary->pByteCode, "Shader binary is not loaded.");
+
+    u64 hash   = HashVariant(pBinary->stage, pBinary->name, pBinary->defines);
+    u32 bucket = 0;
+    if (FindVariant(cache, pBinary->stage, pBinary->name, pBinary->defines, hash, &bucket))
+        return true;
+
+    const GfxShaderVariant* pVariant = NULL;
+    return InsertVariant(handle, cache, pBinary, hash, bucket, &pVariant);
+}
+
+bool DROP_GetVertexShader(
+    const GfxHandle handle, GfxShaderCache cache, const GfxShaderDesc* pDesc, ID3D11VertexShader** ppVertexShader,
+    ID3D11InputLayout** ppInputLayout)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(cache, "Shader cache is null.");
+    ASSERT_MSG(pDesc && pDesc->name, "Shader description is invalid.");
+    ASSERT_MSG(ppVertexShader, "Vertex shader pointer is null.");
+
+    const GfxShaderVariant* pVariant = NULL;
+    if (!GetVariant(handle, cache, GFX_SHADER_STAGE_VERTEX, pDesc, &pVariant))
+    {
+        *ppVertexShader = NULL;
+        if (ppInputLayout)
+            *ppInputLayout = NULL;
+        return false;
+    }
+
+    *ppVertexShader = pVariant->pVertexShader;
+    if (ppInputLayout)
+        *ppInputLayout = pVariant->pInputLayout;
+
+    return true;
+}
+
+bool DROP_GetPixelShader(
+    const GfxHandle handle, GfxShaderCache cache, const GfxShaderDesc* pDesc, ID3D11PixelShader** ppPixelShader)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(cache, "Shader cache is null.");
+    ASSERT_MSG(pDesc && pDesc->name, "Shader description is invalid.");
+    ASSERT_MSG(ppPixelShader, "Pixel shader pointer is null.");
+
+    const GfxShaderVariant* pVariant = NULL;
+    if (!GetVariant(handle, cache, GFX_SHADER_STAGE_PIXEL, pDesc, &pVariant))
+    {
+        *ppPixelShader = NULL;
+        return false;
+    }
+
+    *ppPixelShader = pVariant->pPixelShader;
+
+    return true;
+}
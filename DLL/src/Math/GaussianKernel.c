@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "Math/GaussianKernel.h"
+
+#include <math.h>
+
+bool DROP_BuildGaussianKernel(f32 sigma, u32 radius, GaussianKernel* pKernel)
+{
+    ASSERT_MSG(pKernel, "Gaussian kernel is null.");
+
+    if (!(sigma > 0.0f) || radius < 1 || radius > GAUSSIAN_MAX_RADIUS)
+    {
+        LOG_ERROR("Invalid Gaussian kernel, sigma %f and radius %u.", sigma, radius);
+        return false;
+    }
+
+    f32 texelWeights[GAUSSIAN_MAX_RADIUS + 1];
+    f32 sum = 0.0f;
+    for (u32 i = 0; i <= radius; ++i)
+    {
+        texelWeights[i] = expf(-(f32) (i * i) / (2.0f * sigma * sigma));
+        sum += i == 0 ? texelWeights[i] : texelWeights[i] * 2.0f;
+    }
+
+    ZERO_MEM(pKernel, 1);
+    pKernel->sigma        = sigma;
+    pKernel->radius       = radius;
+    pKernel->tapCount     = (radius + 1) / 2;
+    pKernel->centerWeight = texelWeights[0] / sum;
+
+    // Texels 2i + 1 and 2i + 2 share a tap, an odd radius leaves the last texel on its own.
+    for (u32 i = 0; i < pKernel->tapCount; ++i)
+    {
+        u32 first  = i * 2 + 1;
+        f32 weight = texelWeights[first] + (first < radius ? texelWeights[first + 1] : 0.0f);
+        f32 offset = first < radius ? first + texelWeights[first + 1] / weight : (f32) first;
+
+        pKernel->weights[i] = weight / sum;
+        pKernel->offsets[i] = offset;
+    }
+
+    return true;
+}
+
+void DROP_InitGaussianKernelCache(GaussianKernelCache* pCache)
+{
+    ASSERT_MSG(pCache, "Gaussian kernel cache is null.");
+
+    ZERO_MEM(pCache, 1);
+    pCache->nextId = 1;
+}
+
+bool DROP_GetGaussianKernel(GaussianKernelCache* pCache, f32 sigma, u32 radius, const GaussianKernel** ppKernel)
+{
+    ASSERT_MSG(pCache, "Gaussian kernel cache is null.");
+    ASSERT_MSG(ppKernel, "Gaussian kernel pointer is null.");
+
+    // Anything above zero keeps at least one step, the builder rejects the rest.
+    if (sigma > 0.0f)
+        sigma = fmaxf(roundf(sigma * GAUSSIAN_SIGMA_STEPS), 1.0f) / GAUSSIAN_SIGMA_STEPS;
+
+    for (u32 i = 0; i < pCache->kernelCount; ++i)
+    {
+        const GaussianKernel* pKernel = &pCache->kernels[i];
+        if (pKernel->sigma == sigma && pKernel->radius == radius)
+        {
+            *ppKernel = pKernel;
+            return true;
+        }
+    }
+
+    GaussianKernel* pKernel = &pCache->kernels[pCache->nextKernel];
+    if (!DROP_BuildGaussianKernel(sigma, radius, pKernel))
+    {
+        *ppKernel = NULL;
+        return false;
+    }
+
+    pKernel->id          = pCache->nextId++;
+    pCache->nextKernel   = (pCache->nextKernel + 1) % GAUSSIAN_KERNEL_CACHE_SIZE;
+    if (pCache->kernelCount < GAUSSIAN_KERNEL_CACHE_SIZE)
+        ++pCache->kernelCount;
+    *ppKernel = pKernel;
+
+    return true;
+}
@@ -0,0 +1,342 @@
+#include "pch.h"
+#include "Math/HalfFloat.h"
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#pragma region INTERNAL
+#define HALF_SIGN_MASK 0x8000
+#define HALF_MAGNITUDE_MASK 0x7FFF
+#define HALF_MANTISSA_MASK 0x3FF
+#define HALF_INF_BITS 0x7C00
+#define HALF_MAX_BITS 0x7BFF      // 65504.
+#define HALF_QUIET_NAN_BITS 0x7E00
+#define FLOAT_SIGN_MASK 0x80000000
+#define FLOAT_MAGNITUDE_MASK 0x7FFFFFFF
+#define FLOAT_INF_BITS 0x7F800000
+#define FLOAT_QUIET_BIT 0x00400000
+#define FLOAT_HALF_MIN_NORMAL_BITS 0x38800000 // 2^-14, the smallest normal half.
+#define FLOAT_REBIAS_BITS 0x38000000         // Subtracts (127 - 15) from the exponent.
+#define FLOAT_DROPPED_MASK 0x1FFF            // Mantissa bits a normal half doesn't have.
+#define FLOAT_DROPPED_HALFWAY 0x1000
+#define HALF_REBIAS_SCALE_BITS 0x77800000 // 2^112, moves the half exponent bias onto the float one.
+#define HALF_DENORMAL_SCALE 16777216.0f   // 2^24, denormal halves count steps of 2^-24.
+
+#define CPUID_F16C_BIT (1 << 29)
+#define CPUID_AVX_BIT (1 << 28)
+#define CPUID_OSXSAVE_BIT (1 << 27)
+#define XCR0_AVX_STATE 0x6 // The OS saves the SSE and AVX registers.
+
+// GCC and clang only emit F16C in functions that ask for it, MSVC always can.
+#if defined(__GNUC__)
+#define TARGET_F16C __attribute__((target("avx,f16c")))
+#else
+#define TARGET_F16C
+#endif
+
+static HalfFloatPath s_path       = HALF_FLOAT_PATH_COUNT; // Not detected yet.
+static bool          s_isF16CSafe = false;
+
+static inline u32 AsBits(f32 value)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline f32 AsFloat(u32 bits)
+{
+    f32 value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static bool HasF16C()
+{
+    u32 ecx = 0;
+#if defined(_MSC_VER)
+    i32 info[4];
+    __cpuid(info, 1);
+    ecx = (u32) info[2];
+#else
+    u32 eax, ebx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+#endif
+
+    // F16C works on AVX registers, which are only usable when the OS saves them.
+    if (!(ecx & CPUID_F16C_BIT) || !(ecx & CPUID_AVX_BIT) || !(ecx & CPUID_OSXSAVE_BIT))
+        return false;
+
+#if defined(_MSC_VER)
+    u64 xcr0 = _xgetbv(0);
+#else
+    u32 xcr0Low, xcr0High;
+    __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    u64 xcr0 = ((u64) xcr0High << 32) | xcr0Low;
+#endif
+
+    return (xcr0 & XCR0_AVX_STATE) == XCR0_AVX_STATE;
+}
+
+static HalfFloatPath GetPath()
+{
+    // Racing threads detect the same thing, so whichever store lands is right.
+    if (s_path == HALF_FLOAT_PATH_COUNT)
+    {
+        s_isF16CSafe = HasF16C();
+        s_path       = s_isF16CSafe ? HALF_FLOAT_PATH_F16C : HALF_FLOAT_PATH_SSE2;
+    }
+    return s_path;
+}
+
+// The magnitude shifted into float position reads as the value scaled by 2^-112, denormals included,
+// so one multiply rebiases every finite half exactly. Infinities and NaN get the float exponent.
+static inline __m128i HalfToFloat4(__m128i half)
+{
+    __m128i magnitude = _mm_and_si128(half, _mm_set1_epi32(HALF_MAGNITUDE_MASK));
+    __m128i sign      = _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(HALF_SIGN_MASK)), 16);
+    __m128i isSpecial = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(HALF_INF_BITS - 1));
+    __m128i isNaN     = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(HALF_INF_BITS));
+
+    __m128i value = _mm_castps_si128(
+        _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(magnitude, 13)), _mm_set1_ps(AsFloat(HALF_REBIAS_SCALE_BITS))));
+    value = _mm_or_si128(value, _mm_and_si128(isSpecial, _mm_set1_epi32(FLOAT_INF_BITS)));
+    value = _mm_or_si128(value, _mm_and_si128(isNaN, _mm_set1_epi32(FLOAT_QUIET_BIT)));
+    return _mm_or_si128(value, sign);
+}
+
+static inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Same steps as DROP_FloatToHalf without branches. The masks are all set or all clear and pick the
+// rounding, none set truncates. The halves come out in the low 16 bits of each lane.
+static inline __m128i FloatToHalf4(__m128i bits, __m128i upMask, __m128i downMask, __m128i nearestMask)
+{
+    __m128i magnitude  = _mm_and_si128(bits, _mm_set1_epi32(FLOAT_MAGNITUDE_MASK));
+    __m128i isNegative = _mm_srai_epi32(bits, 31);
+    __m128i awayMask   = Select(isNegative, downMask, upMask);
+
+    // Normal halves, the dropped mantissa bits plus the bias carry into the kept ones when rounding up.
+    __m128i lsb     = _mm_and_si128(_mm_srli_epi32(magnitude, 13), _mm_set1_epi32(1));
+    __m128i bias    = _mm_or_si128(_mm_and_si128(awayMask, _mm_set1_epi32(FLOAT_DROPPED_MASK)),
+                                   _mm_and_si128(nearestMask, _mm_add_epi32(lsb, _mm_set1_epi32(FLOAT_DROPPED_HALFWAY - 1))));
+    __m128i normal  = _mm_srli_epi32(_mm_add_epi32(_mm_sub_epi32(magnitude, _mm_set1_epi32(FLOAT_REBIAS_BITS)), bias), 13);
+    __m128i largest = _mm_sub_epi32(_mm_set1_epi32(HALF_MAX_BITS), _mm_cmpgt_epi32(bias, _mm_setzero_si128()));
+    normal          = Select(_mm_cmpgt_epi32(normal, largest), largest, normal);
+
+    // Denormal halves, the scaled value is exact so its fraction decides the rounding.
+    __m128  scaled     = _mm_mul_ps(_mm_castsi128_ps(magnitude), _mm_set1_ps(HALF_DENORMAL_SCALE));
+    __m128i truncated  = _mm_cvttps_epi32(scaled);
+    __m128  fraction   = _mm_sub_ps(scaled, _mm_cvtepi32_ps(truncated));
+    __m128i isOdd      = _mm_cmpeq_epi32(_mm_and_si128(truncated, _mm_set1_epi32(1)), _mm_set1_epi32(1));
+    __m128i isPastHalf = _mm_or_si128(
+        _mm_castps_si128(_mm_cmpgt_ps(fraction, _mm_set1_ps(0.5f))),
+        _mm_and_si128(isOdd, _mm_castps_si128(_mm_cmpeq_ps(fraction, _mm_set1_ps(0.5f)))));
+    __m128i isUp = _mm_or_si128(_mm_and_si128(awayMask, _mm_castps_si128(_mm_cmpgt_ps(fraction, _mm_setzero_ps()))),
+                                _mm_and_si128(nearestMask, isPastHalf));
+    __m128i denormal = _mm_sub_epi32(truncated, isUp);
+
+    __m128i isNaN   = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(FLOAT_INF_BITS));
+    __m128i special = _mm_or_si128(
+        _mm_set1_epi32(HALF_INF_BITS),
+        _mm_and_si128(isNaN, _mm_or_si128(_mm_set1_epi32(HALF_QUIET_NAN_BITS & ~HALF_INF_BITS),
+                                          _mm_and_si128(_mm_srli_epi32(magnitude, 13), _mm_set1_epi32(HALF_MANTISSA_MASK)))));
+
+    __m128i half = Select(_mm_cmplt_epi32(magnitude, _mm_set1_epi32(FLOAT_HALF_MIN_NORMAL_BITS)), denormal, normal);
+    half         = Select(_mm_cmpgt_epi32(magnitude, _mm_set1_epi32(FLOAT_INF_BITS - 1)), special, half);
+    return _mm_or_si128(half, _mm_srli_epi32(_mm_and_si128(bits, _mm_set1_epi32(FLOAT_SIGN_MASK)), 16));
+}
+
+static u32 HalfToFloatSSE2(const u16* pHalves, f32* pFloats, u32 count)
+{
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i halves = _mm_loadu_si128((const __m128i*) &pHalves[i]);
+
+        _mm_storeu_si128((__m128i*) &pFloats[i + 0], HalfToFloat4(_mm_unpacklo_epi16(halves, _mm_setzero_si128())));
+        _mm_storeu_si128((__m128i*) &pFloats[i + 4], HalfToFloat4(_mm_unpackhi_epi16(halves, _mm_setzero_si128())));
+    }
+    return i;
+}
+
+static u32 FloatToHalfSSE2(const f32* pFloats, u16* pHalves, u32 count, HalfRounding rounding)
+{
+    __m128i upMask      = _mm_set1_epi32(rounding == HALF_ROUND_UP ? -1 : 0);
+    __m128i downMask    = _mm_set1_epi32(rounding == HALF_ROUND_DOWN ? -1 : 0);
+    __m128i nearestMask = _mm_set1_epi32(rounding == HALF_ROUND_NEAREST_EVEN ? -1 : 0);
+
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i low  = FloatToHalf4(_mm_loadu_si128((const __m128i*) &pFloats[i + 0]), upMask, downMask, nearestMask);
+        __m128i high = FloatToHalf4(_mm_loadu_si128((const __m128i*) &pFloats[i + 4]), upMask, downMask, nearestMask);
+
+        // The pack saturates signed values, sign extending the halves first keeps every bit.
+        low  = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+        high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+        _mm_storeu_si128((__m128i*) &pHalves[i], _mm_packs_epi32(low, high));
+    }
+    return i;
+}
+
+static TARGET_F16C u32 HalfToFloatF16C(const u16* pHalves, f32* pFloats, u32 count)
+{
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(&pFloats[i], _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) &pHalves[i])));
+    return i;
+}
+
+static TARGET_F16C u32 FloatToHalfF16C(const f32* pFloats, u16* pHalves, u32 count, HalfRounding rounding)
+{
+    // The rounding is an immediate, one loop per mode.
+    u32 i = 0;
+    switch (rounding)
+    {
+    case HALF_ROUND_NEAREST_EVEN:
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128((__m128i*) &pHalves[i], _mm256_cvtps_ph(_mm256_loadu_ps(&pFloats[i]), _MM_FROUND_TO_NEAREST_INT));
+        break;
+    case HALF_ROUND_TOWARD_ZERO:
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128((__m128i*) &pHalves[i], _mm256_cvtps_ph(_mm256_loadu_ps(&pFloats[i]), _MM_FROUND_TO_ZERO));
+        break;
+    case HALF_ROUND_UP:
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128((__m128i*) &pHalves[i], _mm256_cvtps_ph(_mm256_loadu_ps(&pFloats[i]), _MM_FROUND_TO_POS_INF));
+        break;
+    case HALF_ROUND_DOWN:
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128((__m128i*) &pHalves[i], _mm256_cvtps_ph(_mm256_loadu_ps(&pFloats[i]), _MM_FROUND_TO_NEG_INF));
+        break;
+    }
+    return i;
+}
+#pragma endregion
+
+f32 DROP_HalfToFloat(u16 half)
+{
+    u32 magnitude = half & HALF_MAGNITUDE_MASK;
+    u32 sign      = (u32) (half & HALF_SIGN_MASK) << 16;
+
+    u32 bits = AsBits(AsFloat(magnitude << 13) * AsFloat(HALF_REBIAS_SCALE_BITS));
+    if (magnitude >= HALF_INF_BITS)
+        bits |= FLOAT_INF_BITS;
+    if (magnitude > HALF_INF_BITS)
+        bits |= FLOAT_QUIET_BIT;
+
+    return AsFloat(bits | sign);
+}
+
+u16 DROP_FloatToHalf(f32 value, HalfRounding rounding)
+{
+    u32  bits       = AsBits(value);
+    u32  magnitude  = bits & FLOAT_MAGNITUDE_MASK;
+    u16  sign       = (u16) ((bits >> 16) & HALF_SIGN_MASK);
+    bool isNegative = sign != 0;
+
+    if (magnitude > FLOAT_INF_BITS)
+        return sign | HALF_QUIET_NAN_BITS | ((magnitude >> 13) & HALF_MANTISSA_MASK);
+
+    u32 half, dropped, halfway;
+    if (magnitude >= FLOAT_HALF_MIN_NORMAL_BITS)
+    {
+        half    = (magnitude - FLOAT_REBIAS_BITS) >> 13;
+        dropped = magnitude & FLOAT_DROPPED_MASK;
+        halfway = FLOAT_DROPPED_HALFWAY;
+    }
+    else
+    {
+        // A count of 2^-24, the mantissa with its implicit bit shifted down by the exponent difference.
+        u32 exponent = magnitude >> 23;
+        u32 mantissa = exponent ? (magnitude & 0x7FFFFF) | 0x800000 : magnitude;
+        u32 shift    = 126 - (exponent ? exponent : 1);
+
+        // Past 24 the whole mantissa is dropped and stays below half of the smallest denormal.
+        half    = shift > 24 ? 0 : mantissa >> shift;
+        dropped = shift > 24 ? mantissa : mantissa & ((1u << shift) - 1);
+        halfway = shift > 24 ? 1u << 24 : 1u << (shift - 1);
+    }
+
+    bool isAway = (rounding == HALF_ROUND_UP && !isNegative) || (rounding == HALF_ROUND_DOWN && isNegative);
+    if (rounding == HALF_ROUND_NEAREST_EVEN)
+        half += dropped > halfway || (dropped == halfway && (half & 1));
+    else if (isAway)
+        half += dropped != 0;
+
+    // Infinity stays infinity, finite values past 65504 only get there rounding away from zero.
+    if (half >= HALF_INF_BITS)
+    {
+        bool isInf = magnitude == FLOAT_INF_BITS || rounding == HALF_ROUND_NEAREST_EVEN || isAway;
+        half       = isInf ? HALF_INF_BITS : HALF_MAX_BITS;
+    }
+
+    return sign | (u16) half;
+}
+
+void DROP_HalfToFloatArray(const u16* pHalves, f32* pFloats, u32 count)
+{
+    ASSERT_MSG(pHalves || count == 0, "Halves are null.");
+    ASSERT_MSG(pFloats || count == 0, "Floats are null.");
+
+    u32 i = 0;
+    switch (GetPath())
+    {
+    case HALF_FLOAT_PATH_F16C:
+        i = HalfToFloatF16C(pHalves, pFloats, count);
+        break;
+    case HALF_FLOAT_PATH_SSE2:
+        i = HalfToFloatSSE2(pHalves, pFloats, count);
+        break;
+    default:
+        break;
+    }
+
+    for (; i < count; ++i)
+        pFloats[i] = DROP_HalfToFloat(pHalves[i]);
+}
+
+void DROP_FloatToHalfArray(const f32* pFloats, u16* pHalves, u32 count, HalfRounding rounding)
+{
+    ASSERT_MSG(pFloats || count == 0, "Floats are null.");
+    ASSERT_MSG(pHalves || count == 0, "Halves are null.");
+
+    u32 i = 0;
+    switch (GetPath())
+    {
+    case HALF_FLOAT_PATH_F16C:
+        i = FloatToHalfF16C(pFloats, pHalves, count, rounding);
+        break;
+    case HALF_FLOAT_PATH_SSE2:
+        i = FloatToHalfSSE2(pFloats, pHalves, count, rounding);
+        break;
+    default:
+        break;
+    }
+
+    for (; i < count; ++i)
+        pHalves[i] = DROP_FloatToHalf(pFloats[i], rounding);
+}
+
+HalfFloatPath DROP_GetHalfFloatPath()
+{
+    return GetPath();
+}
+
+void DROP_SetHalfFloatPath(HalfFloatPath path)
+{
+    ASSERT_MSG(path < HALF_FLOAT_PATH_COUNT, "Half float path is out of range.");
+
+    GetPath();
+    s_path = path == HALF_FLOAT_PATH_F16C && !s_isF16CSafe ? HALF_FLOAT_PATH_SSE2 : path;
+}
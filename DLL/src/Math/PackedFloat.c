@@ -0,0 +1,297 @@
+#include "pch.h"
+#include "Math/PackedFloat.h"
+
+#include <emmintrin.h>
+
+#pragma region INTERNAL
+// R11G11B10 channels share everything but the mantissa width.
+#define R11_MANTISSA_BITS 6
+#define B10_MANTISSA_BITS 5
+#define R11_MAX_FLOAT_BITS 0x477E0000 // 65024, the largest finite 11-bit value.
+#define B10_MAX_FLOAT_BITS 0x477C0000 // 64512, the largest finite 10-bit value.
+#define SMALL_FLOAT_EXP_MASK 0x1F
+#define SMALL_FLOAT_MIN_NORMAL_BITS 0x38800000 // 2^-14.
+#define FLOAT_REBIAS_BITS 0xC8000000           // Subtracts (127 - 15) from the exponent.
+#define FLOAT_INF_BITS 0x7F800000
+
+#define RGB9E5_MAX_FLOAT 65408.0f          // 511/512 * 2^16.
+#define RGB9E5_MIN_FLOAT (1.0f / 65536.0f) // 2^-16, the smallest shared exponent.
+#define RGB9E5_MANTISSA_MASK 0x1FF
+
+static inline u32 AsBits(f32 value)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline f32 AsFloat(u32 bits)
+{
+    f32 value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Same instruction as the SIMD path, so both round to nearest even the same way.
+static inline u32 RoundToInt(f32 value)
+{
+    return (u32) _mm_cvtss_si32(_mm_set_ss(value));
+}
+
+static u32 PackSmallFloat(f32 value, u32 mantissaBits, u32 maxFloatBits)
+{
+    u32 bits     = AsBits(value);
+    u32 infValue = SMALL_FLOAT_EXP_MASK << mantissaBits;
+
+    if ((bits & 0x7FFFFFFF) > FLOAT_INF_BITS)
+        return infValue | 1;
+    if (bits & 0x80000000)
+        return 0;
+    if (bits == FLOAT_INF_BITS)
+        return infValue;
+    if (bits > maxFloatBits)
+        return (infValue - 1);
+
+    // Below the smallest normal the value is a fixed point count of 2^-(14 + mantissaBits).
+    if (bits < SMALL_FLOAT_MIN_NORMAL_BITS)
+        return RoundToInt(value * AsFloat((127 + 14 + mantissaBits) << 23));
+
+    u32 shift = 23 - mantissaBits;
+    bits += FLOAT_REBIAS_BITS;
+    return (bits + (1u << (shift - 1)) - 1 + ((bits >> shift) & 1)) >> shift;
+}
+
+static f32 UnpackSmallFloat(u32 value, u32 mantissaBits)
+{
+    u32 exponent = value >> mantissaBits;
+    u32 mantissa = value & ((1u << mantissaBits) - 1);
+
+    if (exponent == SMALL_FLOAT_EXP_MASK)
+        return AsFloat(FLOAT_INF_BITS | (mantissa << (23 - mantissaBits)));
+    if (exponent == 0)
+        return (f32) mantissa * AsFloat((127 - 14 - mantissaBits) << 23);
+
+    return AsFloat(((exponent + 112) << 23) | (mantissa << (23 - mantissaBits)));
+}
+
+static inline f32 ClampRGB9E5(f32 value)
+{
+    // Written so NaN ends up as 0, like _mm_max_ps does.
+    value = value > 0.0f ? value : 0.0f;
+    return value < RGB9E5_MAX_FLOAT ? value : RGB9E5_MAX_FLOAT;
+}
+
+static inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline __m128i PackSmallFloat4(__m128 value, u32 mantissaBits, u32 maxFloatBits)
+{
+    __m128i bits     = _mm_castps_si128(value);
+    __m128i infValue = _mm_set1_epi32(SMALL_FLOAT_EXP_MASK << mantissaBits);
+    __m128i shift    = _mm_cvtsi32_si128(23 - mantissaBits);
+
+    __m128i isNaN      = _mm_cmpgt_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x7FFFFFFF)), _mm_set1_epi32(FLOAT_INF_BITS));
+    __m128i isNegative = _mm_srai_epi32(bits, 31);
+    __m128i isInf      = _mm_cmpeq_epi32(bits, _mm_set1_epi32(FLOAT_INF_BITS));
+    __m128i isTooLarge = _mm_cmpgt_epi32(bits, _mm_set1_epi32((i32) maxFloatBits));
+    __m128i isDenormal = _mm_cmplt_epi32(bits, _mm_set1_epi32(SMALL_FLOAT_MIN_NORMAL_BITS));
+
+    __m128i rebiased = _mm_add_epi32(bits, _mm_set1_epi32((i32) FLOAT_REBIAS_BITS));
+    __m128i odd      = _mm_and_si128(_mm_srl_epi32(rebiased, shift), _mm_set1_epi32(1));
+    __m128i normal   = _mm_add_epi32(rebiased, _mm_set1_epi32((1 << (22 - mantissaBits)) - 1));
+    normal           = _mm_srl_epi32(_mm_add_epi32(normal, odd), shift);
+
+    __m128i denormal = _mm_cvtps_epi32(_mm_mul_ps(value, _mm_set1_ps(AsFloat((127 + 14 + mantissaBits) << 23))));
+
+    __m128i result = Select(isDenormal, denormal, normal);
+    result         = Select(isTooLarge, _mm_sub_epi32(infValue, _mm_set1_epi32(1)), result);
+    result         = Select(isInf, infValue, result);
+    result         = _mm_andnot_si128(isNegative, result);
+    return Select(isNaN, _mm_or_si128(infValue, _mm_set1_epi32(1)), result);
+}
+
+static inline __m128 UnpackSmallFloat4(__m128i value, u32 mantissaBits)
+{
+    __m128i exponent = _mm_srl_epi32(value, _mm_cvtsi32_si128(mantissaBits));
+    __m128i mantissa = _mm_and_si128(value, _mm_set1_epi32((1 << mantissaBits) - 1));
+    __m128i fraction = _mm_sll_epi32(mantissa, _mm_cvtsi32_si128(23 - mantissaBits));
+
+    __m128i normal   = _mm_or_si128(_mm_slli_epi32(_mm_add_epi32(exponent, _mm_set1_epi32(112)), 23), fraction);
+    __m128i special  = _mm_or_si128(_mm_set1_epi32(FLOAT_INF_BITS), fraction);
+    __m128i denormal = _mm_castps_si128(
+        _mm_mul_ps(_mm_cvtepi32_ps(mantissa), _mm_set1_ps(AsFloat((127 - 14 - mantissaBits) << 23))));
+
+    __m128i result = Select(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()), denormal, normal);
+    result         = Select(_mm_cmpeq_epi32(exponent, _mm_set1_epi32(SMALL_FLOAT_EXP_MASK)), special, result);
+    return _mm_castsi128_ps(result);
+}
+#pragma endregion
+
+u32 DROP_PackR11G11B10(f32 r, f32 g, f32 b)
+{
+    return PackSmallFloat(r, R11_MANTISSA_BITS, R11_MAX_FLOAT_BITS) |
+           (PackSmallFloat(g, R11_MANTISSA_BITS, R11_MAX_FLOAT_BITS) << 11) |
+           (PackSmallFloat(b, B10_MANTISSA_BITS, B10_MAX_FLOAT_BITS) << 22);
+}
+
+void DROP_UnpackR11G11B10(u32 packed, f32* pRGB)
+{
+    ASSERT_MSG(pRGB, "Color is null.");
+
+    pRGB[0] = UnpackSmallFloat(packed & 0x7FF, R11_MANTISSA_BITS);
+    pRGB[1] = UnpackSmallFloat((packed >> 11) & 0x7FF, R11_MANTISSA_BITS);
+    pRGB[2] = UnpackSmallFloat(packed >> 22, B10_MANTISSA_BITS);
+}
+
+u32 DROP_PackRGB9E5(f32 r, f32 g, f32 b)
+{
+    r = ClampRGB9E5(r);
+    g = ClampRGB9E5(g);
+    b = ClampRGB9E5(b);
+
+    f32 maxColor = r > g ? r : g;
+    maxColor     = maxColor > b ? maxColor : b;
+    maxColor     = maxColor > RGB9E5_MIN_FLOAT ? maxColor : RGB9E5_MIN_FLOAT;
+
+    // Rounds the largest channel to 9 bits first, so it can't round up to 512 below.
+    u32 exponent = (AsBits(maxColor) + 0x4000) >> 23;
+    f32 scale    = AsFloat(0x83000000 - (exponent << 23));
+
+    return RoundToInt(r * scale) | (RoundToInt(g * scale) << 9) | (RoundToInt(b * scale) << 18) |
+           ((exponent - 111) << 27);
+}
+
+void DROP_UnpackRGB9E5(u32 packed, f32* pRGB)
+{
+    ASSERT_MSG(pRGB, "Color is null.");
+
+    f32 scale = AsFloat(((packed >> 27) + 103) << 23);
+    pRGB[0]   = (f32) (packed & RGB9E5_MANTISSA_MASK) * scale;
+    pRGB[1]   = (f32) ((packed >> 9) & RGB9E5_MANTISSA_MASK) * scale;
+    pRGB[2]   = (f32) ((packed >> 18) & RGB9E5_MANTISSA_MASK) * scale;
+}
+
+void DROP_PackR11G11B10Pixels(const f32* pPixels, u32* pPacked, u32 count)
+{
+    ASSERT_MSG(pPixels || count == 0, "Pixels are null.");
+    ASSERT_MSG(pPacked || count == 0, "Packed pixels are null.");
+
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 r = _mm_loadu_ps(&pPixels[i * 4 + 0]);
+        __m128 g = _mm_loadu_ps(&pPixels[i * 4 + 4]);
+        __m128 b = _mm_loadu_ps(&pPixels[i * 4 + 8]);
+        __m128 a = _mm_loadu_ps(&pPixels[i * 4 + 12]);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        __m128i packed = PackSmallFloat4(r, R11_MANTISSA_BITS, R11_MAX_FLOAT_BITS);
+        packed = _mm_or_si128(packed, _mm_slli_epi32(PackSmallFloat4(g, R11_MANTISSA_BITS, R11_MAX_FLOAT_BITS), 11));
+        packed = _mm_or_si128(packed, _mm_slli_epi32(PackSmallFloat4(b, B10_MANTISSA_BITS, B10_MAX_FLOAT_BITS), 22));
+        _mm_storeu_si128((__m128i*) &pPacked[i], packed);
+    }
+
+    for (; i < count; ++i)
+        pPacked[i] = DROP_PackR11G11B10(pPixels[i * 4 + 0], pPixels[i * 4 + 1], pPixels[i * 4 + 2]);
+}
+
+void DROP_UnpackR11G11B10Pixels(const u32* pPacked, f32* pPixels, u32 count)
+{
+    ASSERT_MSG(pPacked || count == 0, "Packed pixels are null.");
+    ASSERT_MSG(pPixels || count == 0, "Pixels are null.");
+
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i packed = _mm_loadu_si128((const __m128i*) &pPacked[i]);
+
+        __m128 r = UnpackSmallFloat4(_mm_and_si128(packed, _mm_set1_epi32(0x7FF)), R11_MANTISSA_BITS);
+        __m128 g = UnpackSmallFloat4(_mm_and_si128(_mm_srli_epi32(packed, 11), _mm_set1_epi32(0x7FF)), R11_MANTISSA_BITS);
+        __m128 b = UnpackSmallFloat4(_mm_srli_epi32(packed, 22), B10_MANTISSA_BITS);
+        __m128 a = _mm_set1_ps(1.0f);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        _mm_storeu_ps(&pPixels[i * 4 + 0], r);
+        _mm_storeu_ps(&pPixels[i * 4 + 4], g);
+        _mm_storeu_ps(&pPixels[i * 4 + 8], b);
+        _mm_storeu_ps(&pPixels[i * 4 + 12], a);
+    }
+
+    for (; i < count; ++i)
+    {
+        DROP_UnpackR11G11B10(pPacked[i], &pPixels[i * 4]);
+        pPixels[i * 4 + 3] = 1.0f;
+    }
+}
+
+void DROP_PackRGB9E5Pixels(const f32* pPixels, u32* pPacked, u32 count)
+{
+    ASSERT_MSG(pPixels || count == 0, "Pixels are null.");
+    ASSERT_MSG(pPacked || count == 0, "Packed pixels are null.");
+
+    const __m128 zero     = _mm_setzero_ps();
+    const __m128 maxFloat = _mm_set1_ps(RGB9E5_MAX_FLOAT);
+
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 r = _mm_loadu_ps(&pPixels[i * 4 + 0]);
+        __m128 g = _mm_loadu_ps(&pPixels[i * 4 + 4]);
+        __m128 b = _mm_loadu_ps(&pPixels[i * 4 + 8]);
+        __m128 a = _mm_loadu_ps(&pPixels[i * 4 + 12]);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        r = _mm_min_ps(_mm_max_ps(r, zero), maxFloat);
+        g = _mm_min_ps(_mm_max_ps(g, zero), maxFloat);
+        b = _mm_min_ps(_mm_max_ps(b, zero), maxFloat);
+
+        __m128 maxColor = _mm_max_ps(_mm_max_ps(r, g), b);
+        maxColor        = _mm_max_ps(maxColor, _mm_set1_ps(RGB9E5_MIN_FLOAT));
+
+        __m128i exponent = _mm_srli_epi32(_mm_add_epi32(_mm_castps_si128(maxColor), _mm_set1_epi32(0x4000)), 23);
+        __m128  scale    = _mm_castsi128_ps(_mm_sub_epi32(_mm_set1_epi32((i32) 0x83000000), _mm_slli_epi32(exponent, 23)));
+
+        __m128i packed = _mm_cvtps_epi32(_mm_mul_ps(r, scale));
+        packed         = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(g, scale)), 9));
+        packed         = _mm_or_si128(packed, _mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(b, scale)), 18));
+        packed         = _mm_or_si128(packed, _mm_slli_epi32(_mm_sub_epi32(exponent, _mm_set1_epi32(111)), 27));
+        _mm_storeu_si128((__m128i*) &pPacked[i], packed);
+    }
+
+    for (; i < count; ++i)
+        pPacked[i] = DROP_PackRGB9E5(pPixels[i * 4 + 0], pPixels[i * 4 + 1], pPixels[i * 4 + 2]);
+}
+
+void DROP_UnpackRGB9E5Pixels(const u32* pPacked, f32* pPixels, u32 count)
+{
+    ASSERT_MSG(pPacked || count == 0, "Packed pixels are null.");
+    ASSERT_MSG(pPixels || count == 0, "Pixels are null.");
+
+    const __m128i mantissaMask = _mm_set1_epi32(RGB9E5_MANTISSA_MASK);
+
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i packed = _mm_loadu_si128((const __m128i*) &pPacked[i]);
+        __m128  scale  = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_srli_epi32(packed, 27), _mm_set1_epi32(103)), 23));
+
+        __m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(packed, mantissaMask)), scale);
+        __m128 g = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 9), mantissaMask)), scale);
+        __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 18), mantissaMask)), scale);
+        __m128 a = _mm_set1_ps(1.0f);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        _mm_storeu_ps(&pPixels[i * 4 + 0], r);
+        _mm_storeu_ps(&pPixels[i * 4 + 4], g);
+        _mm_storeu_ps(&pPixels[i * 4 + 8], b);
+        _mm_storeu_ps(&pPixels[i * 4 + 12], a);
+    }
+
+    for (; i < count; ++i)
+    {
+        DROP_UnpackRGB9E5(pPacked[i], &pPixels[i * 4]);
+        pPixels[i * 4 + 3] = 1.0f;
+    }
+}
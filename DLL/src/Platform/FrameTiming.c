@@ -0,0 +1,174 @@
+#include "pch.h"
+#include "Platform/FrameTiming.h"
+
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
+
+#ifdef _WIN32
+#include <mmsystem.h>
+#endif // _WIN32
+
+#pragma region INTERNAL
+#define JITTER_SMOOTHING (1.0 / 16.0)
+#define JITTER_DEVIATIONS 4.0 // Margin kept for the spin wait, in deviations above the average oversleep.
+
+static int CompareTicks(const void* pA, const void* pB)
+{
+    u64 a = *(const u64*) pA;
+    u64 b = *(const u64*) pB;
+    return (a > b) - (a < b);
+}
+
+static void TrackSleepJitter(FrameTiming* pTiming, f64 oversleepTicks)
+{
+    if (oversleepTicks < 0.0)
+        oversleepTicks = 0.0;
+
+    f64 deviation = oversleepTicks - pTiming->sleepJitterTicks;
+    pTiming->sleepJitterTicks += deviation * JITTER_SMOOTHING;
+    pTiming->sleepDeviationTicks += ((deviation < 0.0 ? -deviation : deviation) - pTiming->sleepDeviationTicks) * JITTER_SMOOTHING;
+}
+
+// Sleeps while the deadline is further than what Sleep may overshoot, then spins the rest.
+static void WaitUntil(FrameTiming* pTiming, u64 deadline)
+{
+    u64 ticksPerMs = DROP_GetTickFrequency() / 1000;
+    f64 margin     = pTiming->sleepJitterTicks + pTiming->sleepDeviationTicks * JITTER_DEVIATIONS;
+
+    for (;;)
+    {
+        u64 now = DROP_GetTicks();
+        if (now >= deadline)
+            return;
+
+        f64 sleepTicks = (f64) (deadline - now) - margin;
+        if (sleepTicks < (f64) ticksPerMs)
+            break;
+
+        u32 sleepMs = (u32) (sleepTicks / (f64) ticksPerMs);
+        DROP_SleepMilliseconds(sleepMs);
+
+        TrackSleepJitter(pTiming, (f64) (DROP_GetTicks() - now) - (f64) (sleepMs * ticksPerMs));
+        margin = pTiming->sleepJitterTicks + pTiming->sleepDeviationTicks * JITTER_DEVIATIONS;
+    }
+
+    while (DROP_GetTicks() < deadline)
+        DROP_YieldProcessor();
+}
+#pragma endregion
+
+void DROP_InitFrameTiming(FrameTiming* pTiming)
+{
+    ASSERT_MSG(pTiming, "Frame timing is null.");
+
+    ZERO_MEM(pTiming, 1);
+    pTiming->lastFrameTicks = DROP_GetTicks();
+    // Sleep is assumed a millisecond late until measured.
+    pTiming->sleepJitterTicks = (f64) (DROP_GetTickFrequency() / 1000);
+}
+
+void DROP_SetFrameLimit(FrameTiming* pTiming, f64 framesPerSecond)
+{
+    ASSERT_MSG(pTiming, "Frame timing is null.");
+    ASSERT_MSG(framesPerSecond >= 0.0, "Frame limit can't be negative.");
+
+#ifdef _WIN32
+    // The default scheduler tick of 15.6 ms is too coarse to sleep part of a frame.
+    if (framesPerSecond > 0.0 && !pTiming->targetTicks)
+        timeBeginPeriod(1);
+    else if (framesPerSecond <= 0.0 && pTiming->targetTicks)
+        timeEndPeriod(1);
+#endif // _WIN32
+
+    pTiming->targetTicks   = framesPerSecond > 0.0 ? (u64) ((f64) DROP_GetTickFrequency() / framesPerSecond) : 0;
+    pTiming->deadlineTicks = pTiming->lastFrameTicks + pTiming->targetTicks;
+}
+
+void DROP_EndFrameTiming(FrameTiming* pTiming)
+{
+    ASSERT_MSG(pTiming, "Frame timing is null.");
+
+    if (pTiming->targetTicks)
+    {
+        WaitUntil(pTiming, pTiming->deadlineTicks);
+
+        u64 now       = DROP_GetTicks();
+        f64 wakeError = (f64) (now - pTiming->deadlineTicks);
+        pTiming->wakeErrorTicks += (wakeError - pTiming->wakeErrorTicks) * JITTER_SMOOTHING;
+
+        // Deadlines advance by whole intervals so wake errors and frames a little late don't shift
+        // the cadence. After missing a whole interval the schedule restarts from now instead of
+        // rushing to catch up.
+        pTiming->deadlineTicks += pTiming->targetTicks;
+        if (pTiming->deadlineTicks <= now)
+            pTiming->deadlineTicks = now + pTiming->targetTicks;
+    }
+
+    u64 now = DROP_GetTicks();
+
+    pTiming->samples[pTiming->nextSample] = now - pTiming->lastFrameTicks;
+    pTiming->nextSample                   = (pTiming->nextSample + 1) & (FRAME_TIMING_WINDOW - 1);
+    if (pTiming->sampleCount < FRAME_TIMING_WINDOW)
+        ++pTiming->sampleCount;
+
+    pTiming->lastFrameTicks = now;
+}
+
+void DROP_GetFrameTimingStats(const FrameTiming* pTiming, FrameTimingStats* pStats)
+{
+    ASSERT_MSG(pTiming, "Frame timing is null.");
+    ASSERT_MSG(pStats, "Frame timing stats pointer is null.");
+
+    ZERO_MEM(pStats, 1);
+    pStats->targetMs      = DROP_TicksToMilliseconds(pTiming->targetTicks);
+    pStats->sleepJitterMs = DROP_TicksToMilliseconds((u64) pTiming->sleepJitterTicks);
+    pStats->wakeErrorMs   = DROP_TicksToMilliseconds((u64) pTiming->wakeErrorTicks);
+
+    u32 count = pTiming->sampleCount;
+    if (!count)
+        return;
+
+    u64 sorted[FRAME_TIMING_WINDOW];
+    memcpy(sorted, pTiming->samples, sizeof(u64) * count);
+    qsort(sorted, count, sizeof(u64), CompareTicks);
+
+    u64 total = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        f64 ms     = DROP_TicksToMilliseconds(sorted[i]);
+        u32 bucket = (u32) (ms / FRAME_TIMING_BUCKET_MS);
+        ++pStats->histogram[bucket < FRAME_TIMING_HISTOGRAM_BUCKETS ? bucket : FRAME_TIMING_HISTOGRAM_BUCKETS - 1];
+        total += sorted[i];
+    }
+
+    pStats->sampleCount = count;
+    pStats->minMs       = DROP_TicksToMilliseconds(sorted[0]);
+    pStats->maxMs       = DROP_TicksToMilliseconds(sorted[count - 1]);
+    pStats->averageMs   = DROP_TicksToMilliseconds(total) / (f64) count;
+    pStats->medianMs    = DROP_TicksToMilliseconds(sorted[count / 2]);
+    pStats->p95Ms       = DROP_TicksToMilliseconds(sorted[(u64) count * 95 / 100]);
+    pStats->p99Ms       = DROP_TicksToMilliseconds(sorted[(u64) count * 99 / 100]);
+}
+
+void DROP_PrintFrameTimingStats(const FrameTimingStats* pStats)
+{
+    ASSERT_MSG(pStats, "Frame timing stats pointer is null.");
+
+    printf("Frame time over %u frames: min %.3f ms, avg %.3f ms, median %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms.\n",
+           pStats->sampleCount, pStats->minMs, pStats->averageMs, pStats->medianMs, pStats->p95Ms, pStats->p99Ms,
+           pStats->maxMs);
+    if (pStats->targetMs > 0.0)
+    {
+        printf("Limiter: target %.3f ms, sleep jitter %.3f ms, wake error %.3f ms.\n", pStats->targetMs,
+               pStats->sleepJitterMs, pStats->wakeErrorMs);
+    }
+
+    for (u32 i = 0; i < FRAME_TIMING_HISTOGRAM_BUCKETS; ++i)
+    {
+        if (!pStats->histogram[i])
+            continue;
+
+        printf("%s%3.0f ms %6u\n", i == FRAME_TIMING_HISTOGRAM_BUCKETS - 1 ? ">=" : "  ",
+               i * FRAME_TIMING_BUCKET_MS, pStats->histogram[i]);
+    }
+}
@@ -0,0 +1,168 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include "pch.h"
+#include "Platform/Thread.h"
+
+#ifndef _WIN32
+#pragma region INTERNAL
+typedef struct _Thread
+{
+    pthread_t  handle;
+    ThreadFunc func;
+    void*      pUserData;
+} _Thread;
+
+// A counting semaphore out of a mutex and a condition, sem_t has no unnamed version on every system.
+typedef struct _Semaphore
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t  condition;
+    u32             count;
+} _Semaphore;
+
+static void* ThreadMain(void* pParam)
+{
+    Thread thread = (Thread) pParam;
+    thread->func(thread->pUserData);
+    return NULL;
+}
+#pragma endregion
+
+bool DROP_CreateThread(ThreadFunc func, void* pUserData, Thread* pThread)
+{
+    ASSERT_MSG(func, "Thread function is null.");
+    ASSERT_MSG(pThread, "Thread pointer is null.");
+
+    *pThread = NULL;
+
+    Thread thread = (Thread) ALLOC(_Thread, 1);
+    if (!thread)
+    {
+        LOG_ERROR("Failed to allocate thread.");
+        return false;
+    }
+
+    thread->func      = func;
+    thread->pUserData = pUserData;
+    if (pthread_create(&thread->handle, NULL, ThreadMain, thread) != 0)
+    {
+        LOG_ERROR("Failed to create thread.");
+        FREE(thread);
+        return false;
+    }
+
+    *pThread = thread;
+
+    return true;
+}
+
+void DROP_JoinThread(Thread* pThread)
+{
+    ASSERT_MSG(pThread && *pThread, "Thread is null.");
+    Thread thread = *pThread;
+
+    if (thread)
+    {
+        pthread_join(thread->handle, NULL);
+        FREE(thread);
+    }
+
+    *pThread = NULL;
+}
+
+bool DROP_CreateSemaphore(u32 initialCount, Semaphore* pSemaphore)
+{
+    ASSERT_MSG(pSemaphore, "Semaphore pointer is null.");
+
+    *pSemaphore = NULL;
+
+    Semaphore semaphore = (Semaphore) ALLOC(_Semaphore, 1);
+    if (!semaphore)
+    {
+        LOG_ERROR("Failed to allocate semaphore.");
+        return false;
+    }
+
+    if (pthread_mutex_init(&semaphore->mutex, NULL) != 0)
+    {
+        LOG_ERROR("Failed to create semaphore mutex.");
+        FREE(semaphore);
+        return false;
+    }
+    if (pthread_cond_init(&semaphore->condition, NULL) != 0)
+    {
+        LOG_ERROR("Failed to create semaphore condition.");
+        pthread_mutex_destroy(&semaphore->mutex);
+        FREE(semaphore);
+        return false;
+    }
+    semaphore->count = initialCount;
+
+    *pSemaphore = semaphore;
+
+    return true;
+}
+
+void DROP_DestroySemaphore(Semaphore* pSemaphore)
+{
+    ASSERT_MSG(pSemaphore && *pSemaphore, "Semaphore is null.");
+    Semaphore semaphore = *pSemaphore;
+
+    if (semaphore)
+    {
+        pthread_cond_destroy(&semaphore->condition);
+        pthread_mutex_destroy(&semaphore->mutex);
+        FREE(semaphore);
+    }
+
+    *pSemaphore = NULL;
+}
+
+void DROP_WaitSemaphore(Semaphore semaphore)
+{
+    ASSERT_MSG(semaphore, "Semaphore is null.");
+
+    pthread_mutex_lock(&semaphore->mutex);
+    while (semaphore->count == 0)
+        pthread_cond_wait(&semaphore->condition, &semaphore->mutex);
+    --semaphore->count;
+    pthread_mutex_unlock(&semaphore->mutex);
+}
+
+void DROP_SignalSemaphore(Semaphore semaphore, u32 count)
+{
+    ASSERT_MSG(semaphore, "Semaphore is null.");
+
+    if (count == 0)
+        return;
+
+    pthread_mutex_lock(&semaphore->mutex);
+    semaphore->count += count;
+    if (count == 1)
+        pthread_cond_signal(&semaphore->condition);
+    else
+        pthread_cond_broadcast(&semaphore->condition);
+    pthread_mutex_unlock(&semaphore->mutex);
+}
+
+u32 DROP_GetProcessorCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32) count : 1;
+}
+
+void DROP_SleepMilliseconds(u32 milliseconds)
+{
+    struct timespec duration = {
+        .tv_sec  = milliseconds / 1000,
+        .tv_nsec = (long) (milliseconds % 1000) * 1000000};
+
+    while (nanosleep(&duration, &duration) != 0)
+        ;
+}
+#endif // _WIN32
@@ -0,0 +1,50 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif // _WIN32
+
+#include "pch.h"
+#include "Platform/Timer.h"
+
+#pragma region INTERNAL
+// The frequency is fixed at boot, it is only queried once.
+static u64 s_frequency = 0;
+#pragma endregion
+
+u64 DROP_GetTicks()
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (u64) counter.QuadPart;
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (u64) time.tv_sec * 1000000000ull + (u64) time.tv_nsec;
+#endif // _WIN32
+}
+
+u64 DROP_GetTickFrequency()
+{
+    if (!s_frequency)
+    {
+#ifdef _WIN32
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        s_frequency = (u64) frequency.QuadPart;
+#else
+        s_frequency = 1000000000ull;
+#endif // _WIN32
+    }
+    return s_frequency;
+}
+
+f64 DROP_TicksToSeconds(u64 ticks)
+{
+    return (f64) ticks / (f64) DROP_GetTickFrequency();
+}
+
+f64 DROP_TicksToMilliseconds(u64 ticks)
+{
+    return (f64) ticks * 1000.0 / (f64) DROP_GetTickFrequency();
+}
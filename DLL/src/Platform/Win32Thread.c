@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "Platform/Thread.h"
+
+#ifdef _WIN32
+#pragma region INTERNAL
+typedef struct _Thread
+{
+    HANDLE     handle;
+    ThreadFunc func;
+    void*      pUserData;
+} _Thread;
+
+typedef struct _Semaphore
+{
+    HANDLE handle;
+} _Semaphore;
+
+static DWORD WINAPI ThreadMain(LPVOID pParam)
+{
+    Thread thread = (Thread) pParam;
+    thread->func(thread->pUserData);
+    return 0;
+}
+#pragma endregion
+
+bool DROP_CreateThread(ThreadFunc func, void* pUserData, Thread* pThread)
+{
+    ASSERT_MSG(func, "Thread function is null.");
+    ASSERT_MSG(pThread, "Thread pointer is null.");
+
+    *pThread = NULL;
+
+    Thread thread = (Thread) ALLOC(_Thread, 1);
+    if (!thread)
+    {
+        LOG_ERROR("Failed to allocate thread.");
+        return false;
+    }
+
+    thread->func      = func;
+    thread->pUserData = pUserData;
+    thread->handle    = CreateThread(NULL, 0, ThreadMain, thread, 0, NULL);
+    if (!thread->handle)
+    {
+        LOG_ERROR("Failed to create thread.");
+        FREE(thread);
+        return false;
+    }
+
+    *pThread = thread;
+
+    return true;
+}
+
+void DROP_JoinThread(Thread* pThread)
+{
+    ASSERT_MSG(pThread && *pThread, "Thread is null.");
+    Thread thread = *pThread;
+
+    if (thread)
+    {
+        WaitForSingleObject(thread->handle, INFINITE);
+        CloseHandle(thread->handle);
+        FREE(thread);
+    }
+
+    *pThread = NULL;
+}
+
+bool DROP_CreateSemaphore(u32 initialCount, Semaphore* pSemaphore)
+{
+    ASSERT_MSG(pSemaphore, "Semaphore pointer is null.");
+
+    *pSemaphore = NULL;
+
+    Semaphore semaphore = (Semaphore) ALLOC(_Semaphore, 1);
+    if (!semaphore)
+    {
+        LOG_ERROR("Failed to allocate semaphore.");
+        return false;
+    }
+
+    semaphore->handle = CreateSemaphoreW(NULL, (LONG) initialCount, MAXLONG, NULL);
+    if (!semaphore->handle)
+    {
+        LOG_ERROR("Failed to create semaphore.");
+        FREE(semaphore);
+        return false;
+    }
+
+    *pSemaphore = semaphore;
+
+    return true;
+}
+
+void DROP_DestroySemaphore(Semaphore* pSemaphore)
+{
+    ASSERT_MSG(pSemaphore && *pSemaphore, "Semaphore is null.");
+    Semaphore semaphore = *pSemaphore;
+
+    if (semaphore)
+    {
+        CloseHandle(semaphore->handle);
+        FREE(semaphore);
+    }
+
+    *pSemaphore = NULL;
+}
+
+void DROP_WaitSemaphore(Semaphore semaphore)
+{
+    ASSERT_MSG(semaphore, "Semaphore is null.");
+
+    WaitForSingleObject(semaphore->handle, INFINITE);
+}
+
+void DROP_SignalSemaphore(Semaphore semaphore, u32 count)
+{
+    ASSERT_MSG(semaphore, "Semaphore is null.");
+
+    if (count > 0)
+        ReleaseSemaphore(semaphore->handle, (LONG) count, NULL);
+}
+
+u32 DROP_GetProcessorCount()
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return (u32) systemInfo.dwNumberOfProcessors;
+}
+
+void DROP_SleepMilliseconds(u32 milliseconds)
+{
+    Sleep((DWORD) milliseconds);
+}
+#endif // _WIN32
@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "Resources/DynamicBuffer.h"
+#include "Graphics/CommandCapture.h"
+
+bool DROP_CreateDynamicBuffer(const GfxHandle handle, u32 size, u32 bindFlags, GfxDynamicBuffer* pBuffer)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(size > 0, "Size must be greater than zero.");
+    ASSERT_MSG(pBuffer, "Dynamic buffer is null.");
+
+    ZERO_MEM(pBuffer, 1);
+
+    D3D11_BUFFER_DESC bufferDesc = {
+        .ByteWidth           = size,
+        .Usage               = D3D11_USAGE_DYNAMIC,
+        .BindFlags           = bindFlags,
+        .CPUAccessFlags      = D3D11_CPU_ACCESS_WRITE,
+        .MiscFlags           = 0,
+        .StructureByteStride = 0};
+
+    ID3D11Buffer* pD3DBuffer = NULL;
+
+    HRESULT hr = handle->pDevice->lpVtbl->CreateBuffer(handle->pDevice, &bufferDesc, NULL, &pD3DBuffer);
+    if (FAILED(hr) || !pD3DBuffer)
+    {
+        ASSERT_MSG(false, "Failed to create dynamic buffer.");
+        return false;
+    }
+
+    pBuffer->pBuffer = pD3DBuffer;
+    DROP_MakeRing(&pBuffer->ring, size);
+
+    return true;
+}
+
+void DROP_DestroyDynamicBuffer(GfxDynamicBuffer* pBuffer)
+{
+    ASSERT_MSG(pBuffer, "Dynamic buffer is null.");
+
+    SAFE_RELEASE(pBuffer->pBuffer);
+    ZERO_MEM(pBuffer, 1);
+}
+
+bool DROP_DynamicBufferWrite(
+    const GfxHandle handle, GfxDynamicBuffer* pBuffer, const void* data, u32 size, u32 alignment, u32* pOffset)
+{
+    ASSERT_MSG(handle, "Graphics handle is null.");
+    ASSERT_MSG(pBuffer && pBuffer->pBuffer, "Dynamic buffer is null.");
+    ASSERT_MSG(data, "Data is null.");
+    ASSERT_MSG(pOffset, "Offset pointer is null.");
+
+    u64 offset = 0;
+    if (!DROP_RingAllocate(&pBuffer->ring, size, alignment, &offset))
+    {
+        LOG_WARN("Dynamic buffer is full, %u bytes dropped.", size);
+        return false;
+    }
+
+    D3D11_MAP mapType = pBuffer->isMapped ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD;
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+    HRESULT hr = handle->pContext->lpVtbl->Map(
+        handle->pContext, (ID3D11Resource*) pBuffer->pBuffer, 0, mapType, 0, &mappedResource);
+    if (FAILED(hr))
+    {
+        LOG_ERROR("Failed to map dynamic buffer.");
+        return false;
+    }
+
+    memcpy((char*) mappedResource.pData + offset, data, size);
+    DROP_CaptureWrittenRange((ID3D11Resource*) pBuffer->pBuffer, 0, (u32) offset, size);
+    handle->pContext->lpVtbl->Unmap(handle->pContext, (ID3D11Resource*) pBuffer->pBuffer, 0);
+    DROP_AddCounter(COUNTER_UPLOADED_BYTES, size);
+
+    pBuffer->isMapped = true;
+    *pOffset          = (u32) offset;
+
+    return true;
+}
+
+void DROP_DynamicBufferEndFrame(GfxDynamicBuffer* pBuffer, u64 frameIndex)
+{
+    ASSERT_MSG(pBuffer, "Dynamic buffer is null.");
+
+    if (!DROP_RingEndFrame(&pBuffer->ring, frameIndex))
+    {
+        LOG_WARN("Dynamic buffer has too many frames in flight, frame %llu is held with the previous one.",
+                 frameIndex);
+    }
+}
+
+void DROP_DynamicBufferRetire(GfxDynamicBuffer* pBuffer, u64 completedFrame)
+{
+    ASSERT_MSG(pBuffer, "Dynamic buffer is null.");
+
+    DROP_RingRetireFrames(&pBuffer->ring, completedFrame);
+}
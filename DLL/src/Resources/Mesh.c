@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Resources/Mesh.h"
+#include "Graphics/CommandCapture.h"
 
 bool DROP_CreateVertexBuffer(const GfxHandle handle, const void* vertices, u32 verticesSize, ID3D11Buffer** ppVertexBuffer)
 {
@@ -30,6 +31,7 @@ bool DROP_CreateVertexBuffer(const GfxHandle handle, const void* vertices, u32 v
         ASSERT_MSG(false, "Failed to create vertex buffer.");
         return false;
     }
+    DROP_SetCaptureData((ID3D11DeviceChild*) pVertexBuffer, vertices, verticesSize);
 
     *ppVertexBuffer = pVertexBuffer;
 
@@ -56,6 +58,9 @@ bool DROP_CreateInputLayout(
         ASSERT_MSG(false, "Failed to create input layout.");
         return false;
     }
+    DROP_SetCaptureInputLayoutData(
+        pInputLayout, layouts, layoutCount, pByteCode->lpVtbl->GetBufferPointer(pByteCode),
+        (u32) pByteCode->lpVtbl->GetBufferSize(pByteCode));
 
     *ppInputLayout = pInputLayout;
 
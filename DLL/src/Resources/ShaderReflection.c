@@ -0,0 +1,324 @@
+#include "pch.h"
+#include "Resources/ShaderReflection.h"
+
+#pragma region INTERNAL
+#define FOURCC(a, b, c, d) ((u32) (a) | ((u32) (b) << 8) | ((u32) (c) << 16) | ((u32) (d) << 24))
+#define CONTAINER_HEADER_SIZE 32 // Magic, checksum, version, total size and chunk count.
+#define CHUNK_HEADER_SIZE 8      // Fourcc and size.
+#define SIGNATURE_ELEMENT_SIZE 24
+#define SIGNATURE1_ELEMENT_SIZE 32 // Adds the stream in front and the min precision at the end.
+#define RDEF_HEADER_SIZE 28
+#define RDEF_CBUFFER_SIZE 24
+#define RDEF_BINDING_SIZE 32
+#define RDEF_VARIABLE_SIZE 24 // Before shader model 5, RD11 gives the sizes after it.
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+typedef struct
+{
+    const u8* pData;
+    u32       size;
+} Chunk;
+
+static bool ReadU32(const Chunk* pChunk, u32 offset, u32* pValue)
+{
+    if (offset > pChunk->size || pChunk->size - offset < 4)
+        return false;
+
+    memcpy(pValue, pChunk->pData + offset, 4);
+    return true;
+}
+
+// Names are stored once per chunk and referenced by offset, they must end inside it.
+static bool ReadName(const Chunk* pChunk, u32 offset, char* pName)
+{
+    if (offset >= pChunk->size)
+        return false;
+
+    u32 length = 0;
+    while (offset + length < pChunk->size && pChunk->pData[offset + length])
+        ++length;
+
+    if (offset + length >= pChunk->size || length >= SHADER_NAME_LENGTH)
+        return false;
+
+    memcpy(pName, pChunk->pData + offset, length);
+    pName[length] = '\0';
+    return true;
+}
+
+static bool FindChunk(const Chunk* pContainer, u32 fourcc, Chunk* pChunk)
+{
+    u32 chunkCount = 0;
+    ReadU32(pContainer, 28, &chunkCount);
+
+    for (u32 i = 0; i < chunkCount; ++i)
+    {
+        u32 offset      = 0;
+        u32 chunkFourcc = 0;
+        u32 size        = 0;
+        if (!ReadU32(pContainer, CONTAINER_HEADER_SIZE + i * 4, &offset) ||
+            !ReadU32(pContainer, offset, &chunkFourcc) ||
+            !ReadU32(pContainer, offset + 4, &size))
+            return false;
+
+        if (chunkFourcc != fourcc)
+            continue;
+
+        if (pContainer->size - offset - CHUNK_HEADER_SIZE < size)
+            return false;
+
+        pChunk->pData = pContainer->pData + offset + CHUNK_HEADER_SIZE;
+        pChunk->size  = size;
+        return true;
+    }
+
+    return false;
+}
+
+static bool ParseSignature(const Chunk* pChunk, u32 elementSize, ShaderSignatureElement* pElements, u32* pCount)
+{
+    u32 count         = 0;
+    u32 elementOffset = 0;
+    if (!ReadU32(pChunk, 0, &count) || !ReadU32(pChunk, 4, &elementOffset) || count > SHADER_MAX_SIGNATURE_ELEMENTS)
+        return false;
+
+    // The stream of the 32 byte elements comes first, the rest lines up with the 24 byte ones.
+    u32 skip = elementSize == SIGNATURE1_ELEMENT_SIZE ? 4 : 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 base = elementOffset + i * elementSize;
+        if (base > pChunk->size || pChunk->size - base < elementSize)
+            return false;
+
+        ShaderSignatureElement* pElement   = &pElements[i];
+        u32                     nameOffset = 0;
+        ReadU32(pChunk, base + skip, &nameOffset);
+        ReadU32(pChunk, base + skip + 4, &pElement->semanticIndex);
+        ReadU32(pChunk, base + skip + 8, &pElement->systemValue);
+        ReadU32(pChunk, base + skip + 12, &pElement->componentType);
+        ReadU32(pChunk, base + skip + 16, &pElement->reg);
+        pElement->mask = pChunk->pData[base + skip + 20] & 0xF;
+
+        pElement->componentCount = 0;
+        for (u32 bit = 0; bit < 4; ++bit)
+            pElement->componentCount += (pElement->mask >> bit) & 1;
+
+        if (!ReadName(pChunk, nameOffset, pElement->semanticName))
+            return false;
+    }
+
+    *pCount = count;
+    return true;
+}
+
+// DXIL containers have the 32 byte elements, fxc the 24 byte ones. A missing signature is empty.
+static bool ParseSignatureChunk(
+    const Chunk* pContainer, u32 fourcc1, u32 fourcc, ShaderSignatureElement* pElements, u32* pCount)
+{
+    Chunk chunk = {0};
+    if (FindChunk(pContainer, fourcc1, &chunk))
+        return ParseSignature(&chunk, SIGNATURE1_ELEMENT_SIZE, pElements, pCount);
+    if (FindChunk(pContainer, fourcc, &chunk))
+        return ParseSignature(&chunk, SIGNATURE_ELEMENT_SIZE, pElements, pCount);
+    return true;
+}
+
+static bool ParseResources(const Chunk* pChunk, ShaderReflection* pReflection)
+{
+    u32 cbufferCount  = 0;
+    u32 cbufferOffset = 0;
+    u32 bindingCount  = 0;
+    u32 bindingOffset = 0;
+    u32 version       = 0;
+    if (!ReadU32(pChunk, 0, &cbufferCount) || !ReadU32(pChunk, 4, &cbufferOffset) ||
+        !ReadU32(pChunk, 8, &bindingCount) || !ReadU32(pChunk, 12, &bindingOffset) ||
+        !ReadU32(pChunk, 16, &version))
+        return false;
+
+    u32 cbufferSize  = RDEF_CBUFFER_SIZE;
+    u32 bindingSize  = RDEF_BINDING_SIZE;
+    u32 variableSize = RDEF_VARIABLE_SIZE;
+    u32 tag          = 0;
+    if (((version >> 8) & 0xFF) >= 5 && ReadU32(pChunk, RDEF_HEADER_SIZE, &tag) && tag == FOURCC('R', 'D', '1', '1'))
+    {
+        if (!ReadU32(pChunk, RDEF_HEADER_SIZE + 8, &cbufferSize) ||
+            !ReadU32(pChunk, RDEF_HEADER_SIZE + 12, &bindingSize) ||
+            !ReadU32(pChunk, RDEF_HEADER_SIZE + 16, &variableSize) ||
+            cbufferSize < RDEF_CBUFFER_SIZE || bindingSize < RDEF_BINDING_SIZE || variableSize < RDEF_VARIABLE_SIZE)
+            return false;
+    }
+
+    if (bindingCount > SHADER_MAX_BINDINGS)
+        return false;
+
+    for (u32 i = 0; i < bindingCount; ++i)
+    {
+        u32            base       = bindingOffset + i * bindingSize;
+        ShaderBinding* pBinding   = &pReflection->bindings[i];
+        u32            nameOffset = 0;
+        if (!ReadU32(pChunk, base, &nameOffset) || !ReadU32(pChunk, base + 4, &pBinding->type) ||
+            !ReadU32(pChunk, base + 20, &pBinding->bindPoint) || !ReadU32(pChunk, base + 24, &pBinding->bindCount) ||
+            !ReadName(pChunk, nameOffset, pBinding->name))
+            return false;
+    }
+    pReflection->bindingCount = bindingCount;
+
+    for (u32 i = 0; i < cbufferCount; ++i)
+    {
+        u32 base           = cbufferOffset + i * cbufferSize;
+        u32 nameOffset     = 0;
+        u32 variableCount  = 0;
+        u32 variableOffset = 0;
+        u32 size           = 0;
+        u32 type           = 0;
+        if (!ReadU32(pChunk, base, &nameOffset) || !ReadU32(pChunk, base + 4, &variableCount) ||
+            !ReadU32(pChunk, base + 8, &variableOffset) || !ReadU32(pChunk, base + 12, &size) ||
+            !ReadU32(pChunk, base + 20, &type))
+            return false;
+
+        // Structured buffers and interfaces are listed here too, only keep cbuffers and tbuffers (0 and 1).
+        if (type > 1)
+            continue;
+
+        if (pReflection->constantBufferCount == SHADER_MAX_CONSTANT_BUFFERS || variableCount > SHADER_MAX_VARIABLES)
+            return false;
+
+        ShaderConstantBuffer* pConstantBuffer = &pReflection->constantBuffers[pReflection->constantBufferCount++];
+        pConstantBuffer->size          = size;
+        pConstantBuffer->variableCount = variableCount;
+        if (!ReadName(pChunk, nameOffset, pConstantBuffer->name))
+            return false;
+
+        for (u32 j = 0; j < variableCount; ++j)
+        {
+            u32             variableBase = variableOffset + j * variableSize;
+            ShaderVariable* pVariable    = &pConstantBuffer->variables[j];
+            if (!ReadU32(pChunk, variableBase, &nameOffset) || !ReadU32(pChunk, variableBase + 4, &pVariable->offset) ||
+                !ReadU32(pChunk, variableBase + 8, &pVariable->size) || !ReadName(pChunk, nameOffset, pVariable->name))
+                return false;
+        }
+    }
+
+    pReflection->hasResources = true;
+    return true;
+}
+
+static u64 HashBytes(u64 hash, const void* pData, u64 size)
+{
+    const u8* pBytes = (const u8*) pData;
+    for (u64 i = 0; i < size; ++i)
+    {
+        hash ^= pBytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Member by member, the elements have padding and the names garbage after their end.
+static u64 HashSignature(const ShaderSignatureElement* pElements, u32 count)
+{
+    u64 hash = FNV_OFFSET_BASIS;
+    for (u32 i = 0; i < count; ++i)
+    {
+        const ShaderSignatureElement* pElement = &pElements[i];
+        hash = HashBytes(hash, pElement->semanticName, strlen(pElement->semanticName) + 1);
+        hash = HashBytes(hash, &pElement->semanticIndex, sizeof(u32));
+        hash = HashBytes(hash, &pElement->systemValue, sizeof(u32));
+        hash = HashBytes(hash, &pElement->componentType, sizeof(u32));
+        hash = HashBytes(hash, &pElement->reg, sizeof(u32));
+        hash = HashBytes(hash, &pElement->mask, sizeof(u8));
+    }
+    return hash;
+}
+#pragma endregion
+
+bool DROP_ReflectShader(const void* pByteCode, u64 size, ShaderReflection* pReflection)
+{
+    ASSERT_MSG(pByteCode, "Byte code is null.");
+    ASSERT_MSG(pReflection, "Reflection pointer is null.");
+
+    ZERO_MEM(pReflection, 1);
+
+    Chunk container = {(const u8*) pByteCode, 0};
+    u32   magic     = 0;
+    u32   totalSize = 0;
+    if (size < CONTAINER_HEADER_SIZE || size > 0xFFFFFFFFull)
+    {
+        LOG_ERROR("Shader byte code is %llu bytes, not a container.", size);
+        return false;
+    }
+    container.size = (u32) size;
+    ReadU32(&container, 0, &magic);
+    ReadU32(&container, 24, &totalSize);
+    if (magic != FOURCC('D', 'X', 'B', 'C') || totalSize > container.size)
+    {
+        LOG_ERROR("Shader byte code is not a DXBC container.");
+        return false;
+    }
+    container.size = totalSize;
+
+    Chunk chunk         = {0};
+    pReflection->isDXIL = FindChunk(&container, FOURCC('D', 'X', 'I', 'L'), &chunk);
+
+    if (!ParseSignatureChunk(
+            &container, FOURCC('I', 'S', 'G', '1'), FOURCC('I', 'S', 'G', 'N'),
+            pReflection->inputs, &pReflection->inputCount) ||
+        !ParseSignatureChunk(
+            &container, FOURCC('O', 'S', 'G', '1'), FOURCC('O', 'S', 'G', 'N'),
+            pReflection->outputs, &pReflection->outputCount) ||
+        (FindChunk(&container, FOURCC('R', 'D', 'E', 'F'), &chunk) && !ParseResources(&chunk, pReflection)))
+    {
+        LOG_ERROR("Shader container is malformed or has more than the reflection holds.");
+        ZERO_MEM(pReflection, 1);
+        return false;
+    }
+
+    pReflection->inputHash = HashSignature(pReflection->inputs, pReflection->inputCount);
+
+    return true;
+}
+
+bool DROP_FindConstantBuffer(
+    const ShaderReflection* pReflection, const char* name, const ShaderConstantBuffer** ppConstantBuffer)
+{
+    ASSERT_MSG(pReflection, "Reflection is null.");
+    ASSERT_MSG(name, "Constant buffer name is null.");
+    ASSERT_MSG(ppConstantBuffer, "Constant buffer pointer is null.");
+
+    for (u32 i = 0; i < pReflection->constantBufferCount; ++i)
+    {
+        if (strcmp(pReflection->constantBuffers[i].name, name) == 0)
+        {
+            *ppConstantBuffer = &pReflection->constantBuffers[i];
+            return true;
+        }
+    }
+
+    *ppConstantBuffer = NULL;
+    return false;
+}
+
+bool DROP_ValidateConstantBuffer(const ShaderReflection* pReflection, const char* name, u32 size)
+{
+    ASSERT_MSG(pReflection, "Reflection is null.");
+    ASSERT_MSG(name, "Constant buffer name is null.");
+
+    if (!pReflection->hasResources)
+        return true;
+
+    const ShaderConstantBuffer* pConstantBuffer = NULL;
+    if (!DROP_FindConstantBuffer(pReflection, name, &pConstantBuffer))
+    {
+        LOG_ERROR("Shader has no constant buffer %s.", name);
+        return false;
+    }
+
+    if (pConstantBuffer->size != size)
+    {
+        LOG_ERROR("Constant buffer %s is %u bytes in the shader and %u in C.", name, pConstantBuffer->size, size);
+        return false;
+    }
+
+    return true;
+}
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Resources/Shaders.h"
+#include "Graphics/CommandCapture.h"
 
 bool DROP_CreateVertexShader(ID3D11Device* const pDevice, const wchar_t* fileName,
                              ID3D11VertexShader** ppVertexShader, ID3DBlob** ppByteCode)
@@ -31,6 +32,9 @@ bool DROP_CreateVertexShader(ID3D11Device* const pDevice, const wchar_t* fileNam
         RELEASE(pByteCode);
         return false;
     }
+    DROP_SetCaptureData(
+        (ID3D11DeviceChild*) pVertexShader, pByteCode->lpVtbl->GetBufferPointer(pByteCode),
+        (u32) pByteCode->lpVtbl->GetBufferSize(pByteCode));
 
     *ppVertexShader = pVertexShader;
     if (ppByteCode)
@@ -63,6 +67,12 @@ bool DROP_CreatePixelShader(ID3D11Device* const pDevice, const wchar_t* fileName
     hr = pDevice->lpVtbl->CreatePixelShader(
         pDevice, pByteCode->lpVtbl->GetBufferPointer(pByteCode),
         pByteCode->lpVtbl->GetBufferSize(pByteCode), NULL, &pPixelShader);
+    if (SUCCEEDED(hr) && pPixelShader)
+    {
+        DROP_SetCaptureData(
+            (ID3D11DeviceChild*) pPixelShader, pByteCode->lpVtbl->GetBufferPointer(pByteCode),
+            (u32) pByteCode->lpVtbl->GetBufferSize(pByteCode));
+    }
     RELEASE(pByteCode);
     if (FAILED(hr) || !pPixelShader)
     {
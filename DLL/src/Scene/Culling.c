@@ -0,0 +1,628 @@
+#include "pch.h"
+#include "Scene/Culling.h"
+
+#include "Utils/JobSystem.h"
+
+#include <math.h>
+
+#pragma region INTERNAL
+// Refitting is kept until the tree is this much worse than right after a build.
+#define CULL_REBUILD_COST_RATIO 1.5f
+
+typedef struct _FrustumSIMD
+{
+    __m128 nx[6], ny[6], nz[6], d[6];
+    __m128 absX[6], absY[6], absZ[6];
+} FrustumSIMD;
+
+typedef struct _CullJob
+{
+    const CullWorld*   pWorld;
+    const FrustumSIMD* pFrustum;
+    u32                visible[CULL_MAX_TASKS];
+} CullJob;
+
+static u64 AlignSize(u64 size)
+{
+    return (size + 15) & ~15;
+}
+
+static f32 BoxArea(f32 dx, f32 dy, f32 dz)
+{
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+// Returns a 4-bit mask of the boxes that intersect the frustum, pInside receives the ones fully inside.
+static inline u32 TestBoxes4(
+    const FrustumSIMD* pFrustum, __m128 cx, __m128 cy, __m128 cz, __m128 ex, __m128 ey, __m128 ez, u32* pInside)
+{
+    __m128 zero    = _mm_setzero_ps();
+    __m128 outside = _mm_setzero_ps();
+    __m128 inside  = _mm_cmpeq_ps(zero, zero);
+
+    for (u32 p = 0; p < 6; ++p)
+    {
+        __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(pFrustum->nx[p], cx), _mm_mul_ps(pFrustum->ny[p], cy)),
+            _mm_add_ps(_mm_mul_ps(pFrustum->nz[p], cz), pFrustum->d[p]));
+        __m128 radius = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(pFrustum->absX[p], ex), _mm_mul_ps(pFrustum->absY[p], ey)),
+            _mm_mul_ps(pFrustum->absZ[p], ez));
+
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        inside  = _mm_and_ps(inside, _mm_cmpge_ps(_mm_sub_ps(distance, radius), zero));
+    }
+
+    if (pInside)
+        *pInside = (u32) _mm_movemask_ps(inside);
+
+    return (u32) _mm_movemask_ps(outside) ^ 0xF;
+}
+
+static inline u32 TestNode(const FrustumSIMD* pFrustum, const CullNode* pNode, u32* pInside)
+{
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 minX = _mm_loadu_ps(pNode->minX), maxX = _mm_loadu_ps(pNode->maxX);
+    __m128 minY = _mm_loadu_ps(pNode->minY), maxY = _mm_loadu_ps(pNode->maxY);
+    __m128 minZ = _mm_loadu_ps(pNode->minZ), maxZ = _mm_loadu_ps(pNode->maxZ);
+
+    u32 valid = 0;
+    for (u32 k = 0; k < 4; ++k)
+        valid |= pNode->count[k] > 0 ? 1u << k : 0;
+
+    u32 visible = TestBoxes4(
+        pFrustum,
+        _mm_mul_ps(_mm_add_ps(minX, maxX), half), _mm_mul_ps(_mm_add_ps(minY, maxY), half),
+        _mm_mul_ps(_mm_add_ps(minZ, maxZ), half), _mm_mul_ps(_mm_sub_ps(maxX, minX), half),
+        _mm_mul_ps(_mm_sub_ps(maxY, minY), half), _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half), pInside);
+
+    *pInside &= valid;
+    return visible & valid;
+}
+
+// Tests the objects of the slots [first, first + count) 4 at a time. The streams are padded so reading past the end is fine.
+static u32 TestSlots(const CullWorld* pWorld, const FrustumSIMD* pFrustum, u32 first, u32 count, u32* pOut)
+{
+    u32 written = 0;
+    for (u32 i = 0; i < count; i += 4)
+    {
+        u32 slot    = first + i;
+        u32 visible = TestBoxes4(
+            pFrustum,
+            _mm_loadu_ps(&pWorld->pCenterX[slot]), _mm_loadu_ps(&pWorld->pCenterY[slot]),
+            _mm_loadu_ps(&pWorld->pCenterZ[slot]), _mm_loadu_ps(&pWorld->pExtentX[slot]),
+            _mm_loadu_ps(&pWorld->pExtentY[slot]), _mm_loadu_ps(&pWorld->pExtentZ[slot]), NULL);
+
+        if (count - i < 4)
+            visible &= (1u << (count - i)) - 1;
+
+        while (visible)
+        {
+            u32 lane = 0;
+            while (!(visible & (1u << lane)))
+                ++lane;
+            visible &= visible - 1;
+
+            pOut[written++] = pWorld->pObjectOfSlot[slot + lane];
+        }
+    }
+
+    return written;
+}
+
+static u32 CullChild(const CullWorld* pWorld, const FrustumSIMD* pFrustum, const CullNode* pNode, u32 k, bool isInside, u32* pOut)
+{
+    if (isInside)
+    {
+        memcpy(pOut, &pWorld->pObjectOfSlot[pNode->first[k]], sizeof(u32) * pNode->count[k]);
+        return pNode->count[k];
+    }
+
+    if (pNode->children[k] == CULL_LEAF)
+        return TestSlots(pWorld, pFrustum, pNode->first[k], pNode->count[k], pOut);
+
+    // Inner child, walk its subtree with an explicit stack.
+    u32 stack[64];
+    u32 stackSize = 0;
+    u32 written   = 0;
+
+    stack[stackSize++] = pNode->children[k];
+    while (stackSize > 0)
+    {
+        const CullNode* pCurrent = &pWorld->pNodes[stack[--stackSize]];
+
+        u32 inside  = 0;
+        u32 visible = TestNode(pFrustum, pCurrent, &inside);
+        for (u32 c = 0; c < 4; ++c)
+        {
+            if (!(visible & (1u << c)))
+                continue;
+
+            if ((inside & (1u << c)) || pCurrent->children[c] == CULL_LEAF)
+            {
+                written += CullChild(pWorld, pFrustum, pCurrent, c, (inside & (1u << c)) != 0, pOut + written);
+            }
+            else
+            {
+                ASSERT_MSG(stackSize < ARRAY_COUNT(stack), "Cull stack overflow.");
+                stack[stackSize++] = pCurrent->children[c];
+            }
+        }
+    }
+
+    return written;
+}
+
+static void CullTaskJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    UNUSED(threadIndex);
+
+    CullJob*         pJob   = (CullJob*) pUserData;
+    const CullWorld* pWorld = pJob->pWorld;
+
+    for (u32 t = begin; t < end; ++t)
+    {
+        const CullTask* pTask = &pWorld->tasks[t];
+        const CullNode* pNode = &pWorld->pNodes[pTask->node];
+
+        // Every task writes into the part of the output that matches its slot range, so no two tasks overlap.
+        u32* pOut    = &pWorld->pVisible[pNode->first[pTask->child]];
+        u32  inside  = 0;
+        u32  visible = TestNode(pJob->pFrustum, pNode, &inside);
+
+        pJob->visible[t] = 0;
+        if (visible & (1u << pTask->child))
+            pJob->visible[t] = CullChild(pWorld, pJob->pFrustum, pNode, pTask->child, (inside & (1u << pTask->child)) != 0, pOut);
+    }
+}
+
+// Quickselect so that the item at nth has every smaller key before it and every larger key after it.
+static void SelectNth(u32* pItems, i32 count, i32 nth, const f32 (*pBoxes)[6], u32 axis)
+{
+    i32 lo = 0;
+    i32 hi = count - 1;
+    while (lo < hi)
+    {
+        f32 pivot = pBoxes[pItems[(lo + hi) / 2]][axis];
+        i32 i     = lo;
+        i32 j     = hi;
+        while (i <= j)
+        {
+            while (pBoxes[pItems[i]][axis] < pivot)
+                ++i;
+            while (pBoxes[pItems[j]][axis] > pivot)
+                --j;
+            if (i <= j)
+            {
+                u32 item  = pItems[i];
+                pItems[i] = pItems[j];
+                pItems[j] = item;
+                ++i;
+                --j;
+            }
+        }
+
+        if (nth <= j)
+            hi = j;
+        else if (nth >= i)
+            lo = i;
+        else
+            break;
+    }
+}
+
+// Sorts the range around its median on the axis where the box centers spread the most.
+static u32 SplitRange(CullWorld* pWorld, const f32 (*pBoxes)[6], u32 first, u32 count)
+{
+    f32 lo[3] = {INFINITY, INFINITY, INFINITY};
+    f32 hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (u32 i = first; i < first + count; ++i)
+    {
+        const f32* pBox = pBoxes[pWorld->pObjectOfSlot[i]];
+        for (u32 axis = 0; axis < 3; ++axis)
+        {
+            lo[axis] = pBox[axis] < lo[axis] ? pBox[axis] : lo[axis];
+            hi[axis] = pBox[axis] > hi[axis] ? pBox[axis] : hi[axis];
+        }
+    }
+
+    u32 axis = 0;
+    if (hi[1] - lo[1] > hi[axis] - lo[axis]) axis = 1;
+    if (hi[2] - lo[2] > hi[axis] - lo[axis]) axis = 2;
+
+    u32 half = count / 2;
+    SelectNth(&pWorld->pObjectOfSlot[first], (i32) count, (i32) half, pBoxes, axis);
+
+    return half;
+}
+
+static u32 BuildNode(CullWorld* pWorld, const f32 (*pBoxes)[6], u32 first, u32 count)
+{
+    u32 nodeIndex = pWorld->nodeCount++;
+
+    // Two levels of median splits give up to four children.
+    u32 rangeFirst[4];
+    u32 rangeCount[4];
+    u32 rangeTotal = 0;
+
+    u32 half         = SplitRange(pWorld, pBoxes, first, count);
+    u32 halves[2][2] = {{first, half}, {first + half, count - half}};
+    for (u32 h = 0; h < 2; ++h)
+    {
+        if (halves[h][1] > CULL_LEAF_SIZE)
+        {
+            u32 quarter              = SplitRange(pWorld, pBoxes, halves[h][0], halves[h][1]);
+            rangeFirst[rangeTotal]   = halves[h][0];
+            rangeCount[rangeTotal++] = quarter;
+            rangeFirst[rangeTotal]   = halves[h][0] + quarter;
+            rangeCount[rangeTotal++] = halves[h][1] - quarter;
+        }
+        else
+        {
+            rangeFirst[rangeTotal]   = halves[h][0];
+            rangeCount[rangeTotal++] = halves[h][1];
+        }
+    }
+
+    for (u32 k = 0; k < 4; ++k)
+    {
+        u32 children = CULL_LEAF;
+        if (k < rangeTotal && rangeCount[k] > CULL_LEAF_SIZE)
+            children = BuildNode(pWorld, pBoxes, rangeFirst[k], rangeCount[k]);
+
+        // The node array doesn't move, but fetch the node after the recursion for clarity.
+        CullNode* pNode    = &pWorld->pNodes[nodeIndex];
+        pNode->children[k] = children;
+        pNode->first[k]    = k < rangeTotal ? rangeFirst[k] : 0;
+        pNode->count[k]    = k < rangeTotal ? rangeCount[k] : 0;
+    }
+
+    return nodeIndex;
+}
+
+// Recomputes every node's child bounds bottom-up. Children always have a higher index than their parent.
+static void Refit(CullWorld* pWorld)
+{
+    f32 cost = 0.0f;
+
+    for (u32 n = pWorld->nodeCount; n-- > 0;)
+    {
+        CullNode* pNode = &pWorld->pNodes[n];
+        for (u32 k = 0; k < 4; ++k)
+        {
+            f32 lo[3] = {INFINITY, INFINITY, INFINITY};
+            f32 hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+
+            if (pNode->count[k] == 0)
+            {
+                lo[0] = lo[1] = lo[2] = 0.0f;
+                hi[0] = hi[1] = hi[2] = 0.0f;
+            }
+            else if (pNode->children[k] == CULL_LEAF)
+            {
+                for (u32 s = pNode->first[k]; s < pNode->first[k] + pNode->count[k]; ++s)
+                {
+                    lo[0] = fminf(lo[0], pWorld->pCenterX[s] - pWorld->pExtentX[s]);
+                    lo[1] = fminf(lo[1], pWorld->pCenterY[s] - pWorld->pExtentY[s]);
+                    lo[2] = fminf(lo[2], pWorld->pCenterZ[s] - pWorld->pExtentZ[s]);
+                    hi[0] = fmaxf(hi[0], pWorld->pCenterX[s] + pWorld->pExtentX[s]);
+                    hi[1] = fmaxf(hi[1], pWorld->pCenterY[s] + pWorld->pExtentY[s]);
+                    hi[2] = fmaxf(hi[2], pWorld->pCenterZ[s] + pWorld->pExtentZ[s]);
+                }
+            }
+            else
+            {
+                const CullNode* pChild = &pWorld->pNodes[pNode->children[k]];
+                for (u32 c = 0; c < 4; ++c)
+                {
+                    if (pChild->count[c] == 0)
+                        continue;
+                    lo[0] = fminf(lo[0], pChild->minX[c]);
+                    lo[1] = fminf(lo[1], pChild->minY[c]);
+                    lo[2] = fminf(lo[2], pChild->minZ[c]);
+                    hi[0] = fmaxf(hi[0], pChild->maxX[c]);
+                    hi[1] = fmaxf(hi[1], pChild->maxY[c]);
+                    hi[2] = fmaxf(hi[2], pChild->maxZ[c]);
+                }
+            }
+
+            pNode->minX[k] = lo[0], pNode->minY[k] = lo[1], pNode->minZ[k] = lo[2];
+            pNode->maxX[k] = hi[0], pNode->maxY[k] = hi[1], pNode->maxZ[k] = hi[2];
+
+            cost += BoxArea(hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]);
+        }
+    }
+
+    pWorld->currentCost = cost;
+    pWorld->needsRefit  = false;
+}
+
+// Splits the root into subtrees until there are enough of them to keep every thread busy.
+static void BuildTasks(CullWorld* pWorld)
+{
+    pWorld->taskCount = 0;
+    if (pWorld->nodeCount == 0)
+        return;
+
+    for (u32 k = 0; k < 4; ++k)
+    {
+        if (pWorld->pNodes[0].count[k] > 0)
+            pWorld->tasks[pWorld->taskCount++] = (CullTask) {.node = 0, .child = k};
+    }
+
+    for (;;)
+    {
+        CullTask expanded[CULL_MAX_TASKS];
+        u32      expandedCount = 0;
+        bool     hasInner      = false;
+
+        for (u32 t = 0; t < pWorld->taskCount; ++t)
+        {
+            const CullTask* pTask    = &pWorld->tasks[t];
+            u32             children = pWorld->pNodes[pTask->node].children[pTask->child];
+            if (children == CULL_LEAF)
+            {
+                expanded[expandedCount++] = *pTask;
+                continue;
+            }
+
+            hasInner = true;
+            for (u32 k = 0; k < 4; ++k)
+            {
+                if (pWorld->pNodes[children].count[k] > 0)
+                    expanded[expandedCount++] = (CullTask) {.node = children, .child = k};
+            }
+        }
+
+        if (!hasInner)
+            break;
+
+        memcpy(pWorld->tasks, expanded, sizeof(CullTask) * expandedCount);
+        pWorld->taskCount = expandedCount;
+
+        // Stop before the next expansion could overflow the task table.
+        if (pWorld->taskCount * 4 > CULL_MAX_TASKS || pWorld->taskCount >= DROP_GetJobThreadCount() * 4)
+            break;
+    }
+}
+#pragma endregion
+
+bool DROP_CreateCullWorld(u32 capacity, CullWorld* pWorld)
+{
+    ASSERT_MSG(capacity > 0, "Capacity must be greater than zero.");
+    ASSERT_MSG(pWorld, "Cull world is null.");
+
+    ZERO_MEM(pWorld, 1);
+
+    // Every leaf holds at least CULL_LEAF_SIZE / 2 objects and every node at least two children.
+    u32 nodeCapacity = capacity / (CULL_LEAF_SIZE / 4) + 16;
+    u32 paddedCount  = capacity + 4;
+
+    u64 total = AlignSize(sizeof(CullNode) * nodeCapacity) +
+                AlignSize(sizeof(f32) * paddedCount) * 6 +
+                AlignSize(sizeof(u32) * capacity) * 3;
+
+    char* pMemory = (char*) ALLOC(char, total);
+    if (!pMemory)
+    {
+        LOG_ERROR("Failed to allocate memory for cull world.");
+        return false;
+    }
+    memset(pMemory, 0, total);
+
+    char* pCursor  = pMemory;
+    pWorld->pNodes = (CullNode*) pCursor;
+    pCursor += AlignSize(sizeof(CullNode) * nodeCapacity);
+
+    f32** streams[6] = {
+        &pWorld->pCenterX, &pWorld->pCenterY, &pWorld->pCenterZ,
+        &pWorld->pExtentX, &pWorld->pExtentY, &pWorld->pExtentZ};
+    for (u32 i = 0; i < 6; ++i)
+    {
+        *streams[i] = (f32*) pCursor;
+        pCursor += AlignSize(sizeof(f32) * paddedCount);
+    }
+
+    pWorld->pObjectOfSlot = (u32*) pCursor;
+    pCursor += AlignSize(sizeof(u32) * capacity);
+    pWorld->pSlotOfObject = (u32*) pCursor;
+    pCursor += AlignSize(sizeof(u32) * capacity);
+    pWorld->pVisible = (u32*) pCursor;
+
+    pWorld->capacity = capacity;
+    pWorld->pMemory  = pMemory;
+
+    return true;
+}
+
+void DROP_DestroyCullWorld(CullWorld* pWorld)
+{
+    ASSERT_MSG(pWorld, "Cull world is null.");
+
+    if (pWorld->pMemory)
+        FREE(pWorld->pMemory);
+
+    ZERO_MEM(pWorld, 1);
+}
+
+u32 DROP_CullAddObject(CullWorld* pWorld, const f32 center[3], const f32 extent[3])
+{
+    ASSERT_MSG(pWorld, "Cull world is null.");
+    ASSERT_MSG(pWorld->objectCount < pWorld->capacity, "Cull world is full.");
+
+    u32 object = pWorld->objectCount++;
+
+    pWorld->pObjectOfSlot[object] = object;
+    pWorld->pSlotOfObject[object] = object;
+    DROP_CullSetBounds(pWorld, object, center, extent);
+
+    return object;
+}
+
+void DROP_CullSetBounds(CullWorld* pWorld, u32 object, const f32 center[3], const f32 extent[3])
+{
+    ASSERT_MSG(pWorld, "Cull world is null.");
+    ASSERT_MSG(object < pWorld->objectCount, "Object does not exist.");
+
+    u32 slot = pWorld->pSlotOfObject[object];
+
+    pWorld->pCenterX[slot] = center[0];
+    pWorld->pCenterY[slot] = center[1];
+    pWorld->pCenterZ[slot] = center[2];
+    pWorld->pExtentX[slot] = extent[0];
+    pWorld->pExtentY[slot] = extent[1];
+    pWorld->pExtentZ[slot] = extent[2];
+
+    if (slot < pWorld->builtCount)
+        pWorld->needsRefit = true;
+}
+
+void DROP_RebuildCullWorld(CullWorld* pWorld)
+{
+    ASSERT_MSG(pWorld, "Cull world is null.");
+
+    u32 count = pWorld->objectCount;
+
+    pWorld->nodeCount  = 0;
+    pWorld->builtCount = count;
+    pWorld->taskCount  = 0;
+    if (count == 0)
+        return;
+
+    // The build shuffles slots, so work on a copy of the boxes indexed by object.
+    f32(*pBoxes)[6] = (f32(*)[6]) ALLOC(f32[6], count);
+    if (!pBoxes)
+    {
+        ASSERT_MSG(false, "Failed to allocate memory for cull world rebuild.");
+        pWorld->builtCount = 0;
+        return;
+    }
+
+    for (u32 slot = 0; slot < count; ++slot)
+    {
+        f32* pBox = pBoxes[pWorld->pObjectOfSlot[slot]];
+        pBox[0]   = pWorld->pCenterX[slot];
+        pBox[1]   = pWorld->pCenterY[slot];
+        pBox[2]   = pWorld->pCenterZ[slot];
+        pBox[3]   = pWorld->pExtentX[slot];
+        pBox[4]   = pWorld->pExtentY[slot];
+        pBox[5]   = pWorld->pExtentZ[slot];
+    }
+
+    BuildNode(pWorld, (const f32(*)[6]) pBoxes, 0, count);
+
+    for (u32 slot = 0; slot < count; ++slot)
+    {
+        u32        object = pWorld->pObjectOfSlot[slot];
+        const f32* pBox   = pBoxes[object];
+
+        pWorld->pSlotOfObject[object] = slot;
+        pWorld->pCenterX[slot]        = pBox[0];
+        pWorld->pCenterY[slot]        = pBox[1];
+        pWorld->pCenterZ[slot]        = pBox[2];
+        pWorld->pExtentX[slot]        = pBox[3];
+        pWorld->pExtentY[slot]        = pBox[4];
+        pWorld->pExtentZ[slot]        = pBox[5];
+    }
+
+    FREE(pBoxes);
+
+    Refit(pWorld);
+    pWorld->builtCost = pWorld->currentCost;
+
+    BuildTasks(pWorld);
+}
+
+void DROP_UpdateCullWorld(CullWorld* pWorld)
+{
+    ASSERT_MSG(pWorld, "Cull world is null.");
+
+    // Pending objects are tested one by one, so fold them in once they are a noticeable part of the work.
+    u32 pending = pWorld->objectCount - pWorld->builtCount;
+    if (pending > 64 && pending > pWorld->builtCount / 8)
+    {
+        DROP_RebuildCullWorld(pWorld);
+        return;
+    }
+
+    if (!pWorld->needsRefit)
+        return;
+
+    Refit(pWorld);
+    if (pWorld->currentCost > pWorld->builtCost * CULL_REBUILD_COST_RATIO)
+        DROP_RebuildCullWorld(pWorld);
+}
+
+void DROP_ExtractFrustum(const Mat4* pViewProjection, Frustum* pFrustum)
+{
+    ASSERT_MSG(pViewProjection, "View projection is null.");
+    ASSERT_MSG(pFrustum, "Frustum is null.");
+
+    f32 m[4][4];
+    for (u32 i = 0; i < 4; ++i)
+        _mm_storeu_ps(m[i], pViewProjection->rows[i]);
+
+    // Row vectors, so clip = p * M and each clip component is a column of M. D3D clip z goes from 0 to w.
+    for (u32 i = 0; i < 4; ++i)
+    {
+        pFrustum->planes[0][i] = m[i][3] + m[i][0]; // Left.
+        pFrustum->planes[1][i] = m[i][3] - m[i][0]; // Right.
+        pFrustum->planes[2][i] = m[i][3] + m[i][1]; // Bottom.
+        pFrustum->planes[3][i] = m[i][3] - m[i][1]; // Top.
+        pFrustum->planes[4][i] = m[i][2];           // Near.
+        pFrustum->planes[5][i] = m[i][3] - m[i][2]; // Far.
+    }
+
+    for (u32 p = 0; p < 6; ++p)
+    {
+        f32* pPlane = pFrustum->planes[p];
+        f32  length = sqrtf(pPlane[0] * pPlane[0] + pPlane[1] * pPlane[1] + pPlane[2] * pPlane[2]);
+        if (length > 0.0f)
+        {
+            pPlane[0] /= length;
+            pPlane[1] /= length;
+            pPlane[2] /= length;
+            pPlane[3] /= length;
+        }
+    }
+}
+
+void DROP_CullObjects(CullWorld* pWorld, const Frustum* pFrustum)
+{
+    ASSERT_MSG(pWorld, "Cull world is null.");
+    ASSERT_MSG(pFrustum, "Frustum is null.");
+
+    FrustumSIMD frustum;
+    for (u32 p = 0; p < 6; ++p)
+    {
+        frustum.nx[p]   = _mm_set1_ps(pFrustum->planes[p][0]);
+        frustum.ny[p]   = _mm_set1_ps(pFrustum->planes[p][1]);
+        frustum.nz[p]   = _mm_set1_ps(pFrustum->planes[p][2]);
+        frustum.d[p]    = _mm_set1_ps(pFrustum->planes[p][3]);
+        frustum.absX[p] = _mm_set1_ps(fabsf(pFrustum->planes[p][0]));
+        frustum.absY[p] = _mm_set1_ps(fabsf(pFrustum->planes[p][1]));
+        frustum.absZ[p] = _mm_set1_ps(fabsf(pFrustum->planes[p][2]));
+    }
+
+    CullJob job = {
+        .pWorld   = pWorld,
+        .pFrustum = &frustum};
+
+    DROP_ParallelFor(pWorld->taskCount, 1, CullTaskJob, &job);
+
+    // Pack the per-task output ranges. Tasks are in slot order, so the data only ever moves down.
+    u32 visibleCount = 0;
+    for (u32 t = 0; t < pWorld->taskCount; ++t)
+    {
+        const CullTask* pTask = &pWorld->tasks[t];
+        u32             first = pWorld->pNodes[pTask->node].first[pTask->child];
+
+        memmove(&pWorld->pVisible[visibleCount], &pWorld->pVisible[first], sizeof(u32) * job.visible[t]);
+        visibleCount += job.visible[t];
+    }
+
+    visibleCount += TestSlots(
+        pWorld, &frustum, pWorld->builtCount, pWorld->objectCount - pWorld->builtCount, &pWorld->pVisible[visibleCount]);
+
+    pWorld->visibleCount = visibleCount;
+}
@@ -0,0 +1,517 @@
+#include "pch.h"
+#include "Scene/Entity.h"
+
+#include "Utils/JobSystem.h"
+
+#pragma region INTERNAL
+#define ENTITY_ALIGNMENT 16
+
+typedef struct
+{
+    EntityWorld*     pWorld;
+    EntitySystemFunc func;
+    void*            pUserData;
+} QueryJob;
+
+static u32 AlignOffset(u32 offset)
+{
+    return (offset + ENTITY_ALIGNMENT - 1) & ~(ENTITY_ALIGNMENT - 1);
+}
+
+static u32 CountComponents(ComponentMask mask)
+{
+    u32 count = 0;
+    for (; mask; mask &= mask - 1)
+        ++count;
+    return count;
+}
+
+// Versions wrap, so compare them by distance instead of value.
+static bool IsNewer(u32 version, u32 sinceVersion)
+{
+    return (i32) (version - sinceVersion) > 0;
+}
+
+static void MarkWritten(EntityWorld* pWorld, EntityChunk* pChunk, ComponentMask mask)
+{
+    u32 version = ++pWorld->version;
+    for (u32 i = 0; i < pWorld->componentCount; ++i)
+    {
+        if (mask & COMPONENT_BIT(i))
+            pChunk->versions[i] = version;
+    }
+}
+
+static bool Grow(void** ppArray, u32* pCapacity, u32 elementSize, u32 minCapacity)
+{
+    u32   capacity = *pCapacity ? *pCapacity * 2 : minCapacity;
+    void* pNew     = ALLOC(u8, (u64) capacity * elementSize);
+    if (!pNew)
+        return false;
+
+    if (*ppArray)
+    {
+        memcpy(pNew, *ppArray, (u64) *pCapacity * elementSize);
+        FREE(*ppArray);
+    }
+
+    *ppArray   = pNew;
+    *pCapacity = capacity;
+    return true;
+}
+
+static u32 FindArchetype(EntityWorld* pWorld, ComponentMask mask)
+{
+    for (u32 i = 0; i < pWorld->archetypeCount; ++i)
+    {
+        if (pWorld->archetypes[i].mask == mask)
+            return i;
+    }
+
+    if (pWorld->archetypeCount == ENTITY_MAX_ARCHETYPES)
+    {
+        LOG_ERROR("Entity world is out of archetypes.");
+        return ENTITY_ABSENT;
+    }
+
+    // Rows are split so every component array starts aligned, with the entity ids last.
+    u32 rowSize = sizeof(EntityId);
+    for (u32 i = 0; i < pWorld->componentCount; ++i)
+    {
+        if (mask & COMPONENT_BIT(i))
+            rowSize += pWorld->componentSizes[i];
+    }
+
+    u32 padding  = ENTITY_ALIGNMENT * (CountComponents(mask) + 1);
+    u32 capacity = (ENTITY_CHUNK_SIZE - padding) / rowSize;
+    if (capacity == 0)
+    {
+        LOG_ERROR("Components of the archetype don't fit in a chunk.");
+        return ENTITY_ABSENT;
+    }
+
+    Archetype* pArchetype = &pWorld->archetypes[pWorld->archetypeCount];
+    ZERO_MEM(pArchetype, 1);
+    pArchetype->mask     = mask;
+    pArchetype->capacity = capacity;
+
+    u32 offset = 0;
+    for (u32 i = 0; i < ENTITY_MAX_COMPONENTS; ++i)
+    {
+        if (i < pWorld->componentCount && (mask & COMPONENT_BIT(i)))
+        {
+            pArchetype->offsets[i] = offset;
+            offset                 = AlignOffset(offset + pWorld->componentSizes[i] * capacity);
+        }
+        else
+        {
+            pArchetype->offsets[i] = ENTITY_ABSENT;
+        }
+    }
+    pArchetype->entityOffset = offset;
+
+    return pWorld->archetypeCount++;
+}
+
+static bool AllocateRow(EntityWorld* pWorld, u32 archetype, u32* pChunk, u32* pRow)
+{
+    Archetype* pArchetype = &pWorld->archetypes[archetype];
+
+    if (pArchetype->chunkCount == 0 ||
+        pArchetype->pChunks[pArchetype->chunkCount - 1].count == pArchetype->capacity)
+    {
+        if (pArchetype->chunkCount == pArchetype->chunkCapacity &&
+            !Grow((void**) &pArchetype->pChunks, &pArchetype->chunkCapacity, sizeof(EntityChunk), 4))
+        {
+            LOG_ERROR("Failed to grow the chunk list.");
+            return false;
+        }
+
+        EntityChunk* pNew = &pArchetype->pChunks[pArchetype->chunkCount];
+        ZERO_MEM(pNew, 1);
+        pNew->pData = (u8*) ALLOC(u8, ENTITY_CHUNK_SIZE);
+        if (!pNew->pData)
+        {
+            LOG_ERROR("Failed to allocate entity chunk.");
+            return false;
+        }
+        ++pArchetype->chunkCount;
+    }
+
+    *pChunk = pArchetype->chunkCount - 1;
+    *pRow   = pArchetype->pChunks[*pChunk].count++;
+    return true;
+}
+
+// Keeps chunks dense by moving the last entity of the archetype into the freed row.
+static void RemoveRow(EntityWorld* pWorld, u32 archetype, u32 chunk, u32 row)
+{
+    Archetype*   pArchetype = &pWorld->archetypes[archetype];
+    u32          lastChunk  = pArchetype->chunkCount - 1;
+    EntityChunk* pLast      = &pArchetype->pChunks[lastChunk];
+    u32          lastRow    = pLast->count - 1;
+
+    if (chunk != lastChunk || row != lastRow)
+    {
+        EntityChunk* pDst = &pArchetype->pChunks[chunk];
+        for (u32 i = 0; i < pWorld->componentCount; ++i)
+        {
+            if (pArchetype->offsets[i] == ENTITY_ABSENT)
+                continue;
+
+            u32 size = pWorld->componentSizes[i];
+            memcpy(pDst->pData + pArchetype->offsets[i] + row * size,
+                   pLast->pData + pArchetype->offsets[i] + lastRow * size, size);
+        }
+
+        EntityId moved = ((EntityId*) (pLast->pData + pArchetype->entityOffset))[lastRow];
+        ((EntityId*) (pDst->pData + pArchetype->entityOffset))[row] = moved;
+
+        pWorld->pRecords[moved.index].chunk = chunk;
+        pWorld->pRecords[moved.index].row   = row;
+        MarkWritten(pWorld, pDst, pArchetype->mask);
+    }
+
+    if (--pLast->count == 0)
+    {
+        FREE(pLast->pData);
+        --pArchetype->chunkCount;
+    }
+}
+
+static void* ComponentAt(const EntityWorld* pWorld, const EntityRecord* pRecord, ComponentId component)
+{
+    const Archetype* pArchetype = &pWorld->archetypes[pRecord->archetype];
+    if (pArchetype->offsets[component] == ENTITY_ABSENT)
+        return NULL;
+
+    return pArchetype->pChunks[pRecord->chunk].pData + pArchetype->offsets[component] +
+           pRecord->row * pWorld->componentSizes[component];
+}
+
+static bool MatchesArchetype(const Archetype* pArchetype, const EntityQuery* pQuery)
+{
+    return (pArchetype->mask & pQuery->all) == pQuery->all && !(pArchetype->mask & pQuery->none);
+}
+
+static bool MatchesChunk(const EntityChunk* pChunk, const EntityQuery* pQuery)
+{
+    if (!pQuery->changed)
+        return true;
+
+    for (u32 i = 0; i < ENTITY_MAX_COMPONENTS; ++i)
+    {
+        if ((pQuery->changed & COMPONENT_BIT(i)) && IsNewer(pChunk->versions[i], pQuery->sinceVersion))
+            return true;
+    }
+
+    return false;
+}
+
+static EntityView MakeView(const Archetype* pArchetype, EntityChunk* pChunk)
+{
+    EntityView view = {
+        .pArchetype = pArchetype,
+        .pChunk     = pChunk,
+        .count      = pChunk->count,
+        .pEntities  = (const EntityId*) (pChunk->pData + pArchetype->entityOffset)};
+    return view;
+}
+
+static void QueryChunkJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    QueryJob* pJob = (QueryJob*) pUserData;
+
+    for (u32 i = begin; i < end; ++i)
+    {
+        EntityView view = MakeView(pJob->pWorld->pQueryArchetypes[i], pJob->pWorld->pQueryChunks[i]);
+        pJob->func(pJob->pUserData, &view, threadIndex);
+    }
+}
+#pragma endregion
+
+bool DROP_CreateEntityWorld(EntityWorld* pWorld)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+
+    ZERO_MEM(pWorld, 1);
+    pWorld->freeRecord = ENTITY_ABSENT;
+
+    return true;
+}
+
+void DROP_DestroyEntityWorld(EntityWorld* pWorld)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+
+    for (u32 i = 0; i < pWorld->archetypeCount; ++i)
+    {
+        Archetype* pArchetype = &pWorld->archetypes[i];
+        for (u32 j = 0; j < pArchetype->chunkCount; ++j)
+            FREE(pArchetype->pChunks[j].pData);
+        if (pArchetype->pChunks)
+            FREE(pArchetype->pChunks);
+    }
+
+    if (pWorld->pRecords)
+        FREE(pWorld->pRecords);
+    if (pWorld->pQueryChunks)
+        FREE(pWorld->pQueryChunks);
+    if (pWorld->pQueryArchetypes)
+        FREE(pWorld->pQueryArchetypes);
+
+    ZERO_MEM(pWorld, 1);
+}
+
+bool DROP_RegisterComponent(EntityWorld* pWorld, u32 size, ComponentId* pId)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+    ASSERT_MSG(size > 0, "Component size must be greater than zero.");
+    ASSERT_MSG(pId, "Component id is null.");
+    ASSERT_MSG(pWorld->archetypeCount == 0, "Components must be registered before creating entities.");
+
+    if (pWorld->componentCount == ENTITY_MAX_COMPONENTS)
+    {
+        LOG_ERROR("Entity world is out of components.");
+        return false;
+    }
+
+    pWorld->componentSizes[pWorld->componentCount] = size;
+    *pId                                           = pWorld->componentCount++;
+
+    return true;
+}
+
+bool DROP_CreateEntity(EntityWorld* pWorld, ComponentMask mask, EntityId* pEntity)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+    ASSERT_MSG(pEntity, "Entity is null.");
+    ASSERT_MSG(pWorld->componentCount == ENTITY_MAX_COMPONENTS || !(mask >> pWorld->componentCount), "Mask has unregistered components.");
+
+    u32 archetype = FindArchetype(pWorld, mask);
+    if (archetype == ENTITY_ABSENT)
+        return false;
+
+    // Grow the records up front so a failed allocation never leaves a half created entity.
+    if (pWorld->freeRecord == ENTITY_ABSENT && pWorld->recordCount == pWorld->recordCapacity &&
+        !Grow((void**) &pWorld->pRecords, &pWorld->recordCapacity, sizeof(EntityRecord), 256))
+    {
+        LOG_ERROR("Failed to grow the entity records.");
+        return false;
+    }
+
+    u32 chunk = 0;
+    u32 row   = 0;
+    if (!AllocateRow(pWorld, archetype, &chunk, &row))
+        return false;
+
+    u32 index = pWorld->freeRecord;
+    if (index != ENTITY_ABSENT)
+    {
+        pWorld->freeRecord = pWorld->pRecords[index].row;
+    }
+    else
+    {
+        index                              = pWorld->recordCount++;
+        pWorld->pRecords[index].generation = 1;
+    }
+
+    EntityRecord* pRecord = &pWorld->pRecords[index];
+    pRecord->archetype = archetype;
+    pRecord->chunk     = chunk;
+    pRecord->row       = row;
+
+    Archetype*   pArchetype = &pWorld->archetypes[archetype];
+    EntityChunk* pChunk     = &pArchetype->pChunks[chunk];
+    for (u32 i = 0; i < pWorld->componentCount; ++i)
+    {
+        if (pArchetype->offsets[i] != ENTITY_ABSENT)
+            memset(pChunk->pData + pArchetype->offsets[i] + row * pWorld->componentSizes[i], 0, pWorld->componentSizes[i]);
+    }
+
+    pEntity->index      = index;
+    pEntity->generation = pRecord->generation;
+    ((EntityId*) (pChunk->pData + pArchetype->entityOffset))[row] = *pEntity;
+    MarkWritten(pWorld, pChunk, mask);
+
+    return true;
+}
+
+void DROP_DestroyEntity(EntityWorld* pWorld, EntityId entity)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+
+    if (!DROP_IsEntityAlive(pWorld, entity))
+    {
+        LOG_WARN("Destroying a dead entity.");
+        return;
+    }
+
+    EntityRecord* pRecord = &pWorld->pRecords[entity.index];
+    RemoveRow(pWorld, pRecord->archetype, pRecord->chunk, pRecord->row);
+
+    // Skip 0 on wrap so zeroed ids stay dead.
+    if (++pRecord->generation == 0)
+        pRecord->generation = 1;
+    pRecord->row       = pWorld->freeRecord;
+    pWorld->freeRecord = entity.index;
+}
+
+bool DROP_IsEntityAlive(const EntityWorld* pWorld, EntityId entity)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+
+    return entity.index < pWorld->recordCount && entity.generation != 0 &&
+           pWorld->pRecords[entity.index].generation == entity.generation;
+}
+
+bool DROP_SetEntityComponents(EntityWorld* pWorld, EntityId entity, ComponentMask mask)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+    ASSERT_MSG(DROP_IsEntityAlive(pWorld, entity), "Entity is dead.");
+
+    EntityRecord* pRecord = &pWorld->pRecords[entity.index];
+    u32           from    = pRecord->archetype;
+    if (pWorld->archetypes[from].mask == mask)
+        return true;
+
+    u32 to = FindArchetype(pWorld, mask);
+    if (to == ENTITY_ABSENT)
+        return false;
+
+    u32 chunk = 0;
+    u32 row   = 0;
+    if (!AllocateRow(pWorld, to, &chunk, &row))
+        return false;
+
+    const Archetype* pFrom = &pWorld->archetypes[from];
+    const Archetype* pTo   = &pWorld->archetypes[to];
+    EntityChunk*     pSrc  = &pFrom->pChunks[pRecord->chunk];
+    EntityChunk*     pDst  = &pTo->pChunks[chunk];
+    for (u32 i = 0; i < pWorld->componentCount; ++i)
+    {
+        if (pTo->offsets[i] == ENTITY_ABSENT)
+            continue;
+
+        u32 size = pWorld->componentSizes[i];
+        u8* pOut = pDst->pData + pTo->offsets[i] + row * size;
+        if (pFrom->offsets[i] != ENTITY_ABSENT)
+            memcpy(pOut, pSrc->pData + pFrom->offsets[i] + pRecord->row * size, size);
+        else
+            memset(pOut, 0, size);
+    }
+    ((EntityId*) (pDst->pData + pTo->entityOffset))[row] = entity;
+    MarkWritten(pWorld, pDst, mask);
+
+    RemoveRow(pWorld, from, pRecord->chunk, pRecord->row);
+
+    pRecord->archetype = to;
+    pRecord->chunk     = chunk;
+    pRecord->row       = row;
+
+    return true;
+}
+
+const void* DROP_ReadComponent(const EntityWorld* pWorld, EntityId entity, ComponentId component)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+    ASSERT_MSG(DROP_IsEntityAlive(pWorld, entity), "Entity is dead.");
+    ASSERT_MSG(component < pWorld->componentCount, "Component is not registered.");
+
+    return ComponentAt(pWorld, &pWorld->pRecords[entity.index], component);
+}
+
+void* DROP_WriteComponent(EntityWorld* pWorld, EntityId entity, ComponentId component)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+    ASSERT_MSG(DROP_IsEntityAlive(pWorld, entity), "Entity is dead.");
+    ASSERT_MSG(component < pWorld->componentCount, "Component is not registered.");
+
+    const EntityRecord* pRecord = &pWorld->pRecords[entity.index];
+    void*               pData   = ComponentAt(pWorld, pRecord, component);
+    if (pData)
+        MarkWritten(pWorld, &pWorld->archetypes[pRecord->archetype].pChunks[pRecord->chunk], COMPONENT_BIT(component));
+
+    return pData;
+}
+
+void* DROP_ViewComponent(const EntityView* pView, ComponentId component)
+{
+    ASSERT_MSG(pView, "Entity view is null.");
+    ASSERT_MSG(component < ENTITY_MAX_COMPONENTS, "Component id is out of range.");
+
+    u32 offset = pView->pArchetype->offsets[component];
+    return offset == ENTITY_ABSENT ? NULL : pView->pChunk->pData + offset;
+}
+
+void DROP_QueryEntities(EntityWorld* pWorld, const EntityQuery* pQuery, EntitySystemFunc func, void* pUserData)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+    ASSERT_MSG(pQuery && func, "Query is null.");
+
+    for (u32 i = 0; i < pWorld->archetypeCount; ++i)
+    {
+        const Archetype* pArchetype = &pWorld->archetypes[i];
+        if (!MatchesArchetype(pArchetype, pQuery))
+            continue;
+
+        for (u32 j = 0; j < pArchetype->chunkCount; ++j)
+        {
+            EntityChunk* pChunk = &pArchetype->pChunks[j];
+            if (!MatchesChunk(pChunk, pQuery))
+                continue;
+
+            if (pQuery->write)
+                MarkWritten(pWorld, pChunk, pQuery->write & pArchetype->mask);
+
+            EntityView view = MakeView(pArchetype, pChunk);
+            func(pUserData, &view, 0);
+        }
+    }
+}
+
+void DROP_QueryEntitiesParallel(EntityWorld* pWorld, const EntityQuery* pQuery, EntitySystemFunc func, void* pUserData)
+{
+    ASSERT_MSG(pWorld, "Entity world is null.");
+    ASSERT_MSG(pQuery && func, "Query is null.");
+
+    // Chunks are gathered first so the written versions are stamped before any job runs.
+    u32 count = 0;
+    for (u32 i = 0; i < pWorld->archetypeCount; ++i)
+    {
+        Archetype* pArchetype = &pWorld->archetypes[i];
+        if (!MatchesArchetype(pArchetype, pQuery))
+            continue;
+
+        for (u32 j = 0; j < pArchetype->chunkCount; ++j)
+        {
+            EntityChunk* pChunk = &pArchetype->pChunks[j];
+            if (!MatchesChunk(pChunk, pQuery))
+                continue;
+
+            if (count == pWorld->queryCapacity)
+            {
+                u32 capacity = pWorld->queryCapacity;
+                if (!Grow((void**) &pWorld->pQueryChunks, &capacity, sizeof(EntityChunk*), 64) ||
+                    !Grow((void**) &pWorld->pQueryArchetypes, &pWorld->queryCapacity, sizeof(Archetype*), 64))
+                {
+                    LOG_ERROR("Failed to grow the query chunk list.");
+                    return;
+                }
+            }
+
+            if (pQuery->write)
+                MarkWritten(pWorld, pChunk, pQuery->write & pArchetype->mask);
+
+            pWorld->pQueryChunks[count]     = pChunk;
+            pWorld->pQueryArchetypes[count] = pArchetype;
+            ++count;
+        }
+    }
+
+    QueryJob job = {
+        .pWorld    = pWorld,
+        .func      = func,
+        .pUserData = pUserData};
+    DROP_ParallelFor(count, 1, QueryChunkJob, &job);
+}
@@ -0,0 +1,375 @@
+#include "pch.h"
+#include "Scene/Occlusion.h"
+
+#include "Utils/JobSystem.h"
+
+#include <math.h>
+
+#pragma region INTERNAL
+// Vertices closer than this in clip w are treated as crossing the near plane.
+#define OCCLUSION_MIN_W 1e-4f
+
+static u64 AlignSize(u64 size)
+{
+    return (size + 15) & ~15;
+}
+
+static void RasterizeTriangle(OcclusionBuffer* pBuffer, const f32* pTriangle, u32 tileX, u32 tileY)
+{
+    f32 x0 = pTriangle[0], y0 = pTriangle[1], z0 = pTriangle[2];
+    f32 x1 = pTriangle[3], y1 = pTriangle[4], z1 = pTriangle[5];
+    f32 x2 = pTriangle[6], y2 = pTriangle[7], z2 = pTriangle[8];
+
+    // Two-sided: flip the winding instead of culling, so the edge functions are positive inside.
+    f32 area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+    if (area == 0.0f)
+        return;
+    if (area < 0.0f)
+    {
+        f32 t = x1, u = y1, v = z1;
+        x1 = x2, y1 = y2, z1 = z2;
+        x2 = t, y2 = u, z2 = v;
+        area = -area;
+    }
+
+    // Edge e(p) = a * p.x + b * p.y + c for the edges 1-2, 2-0 and 0-1. Each one is the barycentric weight
+    // of the opposite vertex times the area.
+    f32 a0 = y1 - y2, b0 = x2 - x1, c0 = -(a0 * x1 + b0 * y1);
+    f32 a1 = y2 - y0, b1 = x0 - x2, c1 = -(a1 * x2 + b1 * y2);
+    f32 a2 = y0 - y1, b2 = x1 - x0, c2 = -(a2 * x0 + b2 * y0);
+
+    f32 invArea = 1.0f / area;
+    f32 za      = (a0 * z0 + a1 * z1 + a2 * z2) * invArea;
+    f32 zb      = (b0 * z0 + b1 * z1 + b2 * z2) * invArea;
+    f32 zc      = (c0 * z0 + c1 * z1 + c2 * z2) * invArea;
+
+    // Triangle bounds clipped to the tile, x snapped to the 4-wide SIMD lanes.
+    i32 tileMinX = (i32) (tileX * OCCLUSION_TILE_WIDTH);
+    i32 tileMinY = (i32) (tileY * OCCLUSION_TILE_HEIGHT);
+    i32 minX     = (i32) floorf(fminf(x0, fminf(x1, x2)));
+    i32 maxX     = (i32) ceilf(fmaxf(x0, fmaxf(x1, x2)));
+    i32 minY     = (i32) floorf(fminf(y0, fminf(y1, y2)));
+    i32 maxY     = (i32) ceilf(fmaxf(y0, fmaxf(y1, y2)));
+
+    minX = (minX < tileMinX ? tileMinX : minX) & ~3;
+    minY = minY < tileMinY ? tileMinY : minY;
+    maxX = maxX > tileMinX + OCCLUSION_TILE_WIDTH ? tileMinX + OCCLUSION_TILE_WIDTH : maxX;
+    maxY = maxY > tileMinY + OCCLUSION_TILE_HEIGHT ? tileMinY + OCCLUSION_TILE_HEIGHT : maxY;
+    if (minX >= maxX || minY >= maxY)
+        return;
+
+    __m128 zero    = _mm_setzero_ps();
+    __m128 laneX   = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    __m128 stepA0  = _mm_set1_ps(a0 * 4.0f);
+    __m128 stepA1  = _mm_set1_ps(a1 * 4.0f);
+    __m128 stepA2  = _mm_set1_ps(a2 * 4.0f);
+    __m128 stepZ   = _mm_set1_ps(za * 4.0f);
+    __m128 startX  = _mm_add_ps(_mm_set1_ps((f32) minX), laneX);
+
+    for (i32 y = minY; y < maxY; ++y)
+    {
+        f32 py = (f32) y + 0.5f;
+
+        __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a0), startX), _mm_set1_ps(b0 * py + c0));
+        __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a1), startX), _mm_set1_ps(b1 * py + c1));
+        __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a2), startX), _mm_set1_ps(b2 * py + c2));
+        __m128 z  = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(za), startX), _mm_set1_ps(zb * py + zc));
+
+        f32* pRow = &pBuffer->pDepth[(u32) y * pBuffer->width];
+        for (i32 x = minX; x < maxX; x += 4)
+        {
+            __m128 inside = _mm_and_ps(
+                _mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+            if (_mm_movemask_ps(inside))
+            {
+                __m128 depth  = _mm_loadu_ps(&pRow[x]);
+                __m128 closer = _mm_min_ps(depth, z);
+                _mm_storeu_ps(&pRow[x], _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, depth)));
+            }
+
+            e0 = _mm_add_ps(e0, stepA0);
+            e1 = _mm_add_ps(e1, stepA1);
+            e2 = _mm_add_ps(e2, stepA2);
+            z  = _mm_add_ps(z, stepZ);
+        }
+    }
+}
+
+static void RasterizeTileJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    OcclusionBuffer* pBuffer = (OcclusionBuffer*) pUserData;
+    UNUSED(threadIndex);
+
+    for (u32 tile = begin; tile < end; ++tile)
+    {
+        u32 tileX = tile % pBuffer->tilesX;
+        u32 tileY = tile / pBuffer->tilesX;
+
+        const u32* pBin = &pBuffer->pBins[tile * pBuffer->triangleCapacity];
+        for (u32 i = 0; i < pBuffer->binCounts[tile]; ++i)
+            RasterizeTriangle(pBuffer, pBuffer->pTriangles[pBin[i]], tileX, tileY);
+
+        // Tiles are made of whole blocks, so the hierarchical depth can be built in the same job.
+        u32 blocksPerRow = pBuffer->width / OCCLUSION_BLOCK_SIZE;
+        u32 blockX0      = tileX * (OCCLUSION_TILE_WIDTH / OCCLUSION_BLOCK_SIZE);
+        u32 blockY0      = tileY * (OCCLUSION_TILE_HEIGHT / OCCLUSION_BLOCK_SIZE);
+        for (u32 by = blockY0; by < blockY0 + OCCLUSION_TILE_HEIGHT / OCCLUSION_BLOCK_SIZE; ++by)
+        {
+            for (u32 bx = blockX0; bx < blockX0 + OCCLUSION_TILE_WIDTH / OCCLUSION_BLOCK_SIZE; ++bx)
+            {
+                __m128 farthest = _mm_setzero_ps();
+                for (u32 y = 0; y < OCCLUSION_BLOCK_SIZE; ++y)
+                {
+                    const f32* pRow = &pBuffer->pDepth[(by * OCCLUSION_BLOCK_SIZE + y) * pBuffer->width + bx * OCCLUSION_BLOCK_SIZE];
+                    farthest        = _mm_max_ps(farthest, _mm_max_ps(_mm_loadu_ps(pRow), _mm_loadu_ps(pRow + 4)));
+                }
+
+                farthest = _mm_max_ps(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(1, 0, 3, 2)));
+                farthest = _mm_max_ps(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(2, 3, 0, 1)));
+                _mm_store_ss(&pBuffer->pHiZ[by * blocksPerRow + bx], farthest);
+            }
+        }
+    }
+}
+#pragma endregion
+
+bool DROP_CreateOcclusionBuffer(u32 width, u32 height, u32 maxTriangles, OcclusionBuffer* pBuffer)
+{
+    ASSERT_MSG(width > 0 && width % OCCLUSION_TILE_WIDTH == 0, "Width must be a multiple of the tile width.");
+    ASSERT_MSG(height > 0 && height % OCCLUSION_TILE_HEIGHT == 0, "Height must be a multiple of the tile height.");
+    ASSERT_MSG(maxTriangles > 0, "Triangle capacity must be greater than zero.");
+    ASSERT_MSG(pBuffer, "Occlusion buffer is null.");
+
+    ZERO_MEM(pBuffer, 1);
+
+    u32 tilesX = width / OCCLUSION_TILE_WIDTH;
+    u32 tilesY = height / OCCLUSION_TILE_HEIGHT;
+    if (tilesX * tilesY > OCCLUSION_MAX_TILES)
+    {
+        LOG_ERROR("Occlusion buffer of %ux%u has too many tiles.", width, height);
+        return false;
+    }
+
+    u32 blockCount = (width / OCCLUSION_BLOCK_SIZE) * (height / OCCLUSION_BLOCK_SIZE);
+    u64 total      = AlignSize(sizeof(f32) * width * height) +
+                AlignSize(sizeof(f32) * blockCount) +
+                AlignSize(sizeof(f32[9]) * maxTriangles) +
+                AlignSize(sizeof(u32) * maxTriangles * tilesX * tilesY);
+
+    char* pMemory = (char*) ALLOC(char, total);
+    if (!pMemory)
+    {
+        LOG_ERROR("Failed to allocate memory for occlusion buffer.");
+        return false;
+    }
+
+    char* pCursor   = pMemory;
+    pBuffer->pDepth = (f32*) pCursor;
+    pCursor += AlignSize(sizeof(f32) * width * height);
+    pBuffer->pHiZ = (f32*) pCursor;
+    pCursor += AlignSize(sizeof(f32) * blockCount);
+    pBuffer->pTriangles = (f32(*)[9]) pCursor;
+    pCursor += AlignSize(sizeof(f32[9]) * maxTriangles);
+    pBuffer->pBins = (u32*) pCursor;
+
+    pBuffer->width            = width;
+    pBuffer->height           = height;
+    pBuffer->tilesX           = tilesX;
+    pBuffer->tilesY           = tilesY;
+    pBuffer->triangleCapacity = maxTriangles;
+    pBuffer->viewProjection   = DROP_Mat4Identity();
+    pBuffer->pMemory          = pMemory;
+
+    for (u32 i = 0; i < blockCount; ++i)
+        pBuffer->pHiZ[i] = 1.0f;
+
+    return true;
+}
+
+void DROP_DestroyOcclusionBuffer(OcclusionBuffer* pBuffer)
+{
+    ASSERT_MSG(pBuffer, "Occlusion buffer is null.");
+
+    if (pBuffer->pMemory)
+        FREE(pBuffer->pMemory);
+
+    ZERO_MEM(pBuffer, 1);
+}
+
+void DROP_OcclusionBegin(OcclusionBuffer* pBuffer, const Mat4* pViewProjection)
+{
+    ASSERT_MSG(pBuffer, "Occlusion buffer is null.");
+    ASSERT_MSG(pViewProjection, "View projection is null.");
+
+    pBuffer->viewProjection = *pViewProjection;
+    pBuffer->triangleCount  = 0;
+    memset(pBuffer->binCounts, 0, sizeof(pBuffer->binCounts));
+
+    __m128 cleared = _mm_set1_ps(1.0f);
+    u32    count   = pBuffer->width * pBuffer->height;
+    for (u32 i = 0; i < count; i += 4)
+        _mm_storeu_ps(&pBuffer->pDepth[i], cleared);
+}
+
+void DROP_OcclusionAddOccluder(
+    OcclusionBuffer* pBuffer, const Mat4* pWorld, const f32* positions, const u32* indices, u32 indexCount)
+{
+    ASSERT_MSG(pBuffer, "Occlusion buffer is null.");
+    ASSERT_MSG(pWorld, "World matrix is null.");
+    ASSERT_MSG(positions && indices, "Occluder mesh is null.");
+
+    Mat4 worldViewProjection;
+    DROP_Mat4Multiply(pWorld, &pBuffer->viewProjection, &worldViewProjection);
+
+    f32 halfWidth  = (f32) pBuffer->width * 0.5f;
+    f32 halfHeight = (f32) pBuffer->height * 0.5f;
+
+    for (u32 i = 0; i + 2 < indexCount; i += 3)
+    {
+        if (pBuffer->triangleCount == pBuffer->triangleCapacity)
+        {
+            LOG_WARN("Occlusion buffer is out of triangles.");
+            return;
+        }
+
+        f32* pTriangle = pBuffer->pTriangles[pBuffer->triangleCount];
+        bool isClipped = false;
+        for (u32 v = 0; v < 3; ++v)
+        {
+            const f32* pPosition = &positions[indices[i + v] * 3];
+
+            f32 clip[4];
+            _mm_storeu_ps(clip, DROP_Mat4TransformRow(_mm_setr_ps(pPosition[0], pPosition[1], pPosition[2], 1.0f), &worldViewProjection));
+            if (clip[3] < OCCLUSION_MIN_W)
+            {
+                isClipped = true;
+                break;
+            }
+
+            f32 invW             = 1.0f / clip[3];
+            pTriangle[v * 3 + 0] = (clip[0] * invW + 1.0f) * halfWidth;
+            pTriangle[v * 3 + 1] = (1.0f - clip[1] * invW) * halfHeight;
+            pTriangle[v * 3 + 2] = clip[2] * invW;
+        }
+        if (isClipped)
+            continue;
+
+        f32 minX = fminf(pTriangle[0], fminf(pTriangle[3], pTriangle[6]));
+        f32 maxX = fmaxf(pTriangle[0], fmaxf(pTriangle[3], pTriangle[6]));
+        f32 minY = fminf(pTriangle[1], fminf(pTriangle[4], pTriangle[7]));
+        f32 maxY = fmaxf(pTriangle[1], fmaxf(pTriangle[4], pTriangle[7]));
+        if (maxX < 0.0f || maxY < 0.0f || minX >= (f32) pBuffer->width || minY >= (f32) pBuffer->height)
+            continue;
+
+        i32 tileMinX = (i32) fmaxf(minX, 0.0f) / OCCLUSION_TILE_WIDTH;
+        i32 tileMaxX = (i32) fminf(maxX, (f32) (pBuffer->width - 1)) / OCCLUSION_TILE_WIDTH;
+        i32 tileMinY = (i32) fmaxf(minY, 0.0f) / OCCLUSION_TILE_HEIGHT;
+        i32 tileMaxY = (i32) fminf(maxY, (f32) (pBuffer->height - 1)) / OCCLUSION_TILE_HEIGHT;
+        for (i32 ty = tileMinY; ty <= tileMaxY; ++ty)
+        {
+            for (i32 tx = tileMinX; tx <= tileMaxX; ++tx)
+            {
+                u32 tile = (u32) ty * pBuffer->tilesX + (u32) tx;
+                pBuffer->pBins[tile * pBuffer->triangleCapacity + pBuffer->binCounts[tile]++] = pBuffer->triangleCount;
+            }
+        }
+
+        ++pBuffer->triangleCount;
+    }
+}
+
+void DROP_OcclusionRasterize(OcclusionBuffer* pBuffer)
+{
+    ASSERT_MSG(pBuffer, "Occlusion buffer is null.");
+
+    DROP_ParallelFor(pBuffer->tilesX * pBuffer->tilesY, 1, RasterizeTileJob, pBuffer);
+}
+
+bool DROP_OcclusionTestBox(const OcclusionBuffer* pBuffer, const f32 boxMin[3], const f32 boxMax[3])
+{
+    ASSERT_MSG(pBuffer, "Occlusion buffer is null.");
+
+    f32 minX = INFINITY, maxX = -INFINITY;
+    f32 minY = INFINITY, maxY = -INFINITY;
+    f32 minZ = INFINITY;
+
+    for (u32 corner = 0; corner < 8; ++corner)
+    {
+        __m128 point = _mm_setr_ps(
+            (corner & 1) ? boxMax[0] : boxMin[0],
+            (corner & 2) ? boxMax[1] : boxMin[1],
+            (corner & 4) ? boxMax[2] : boxMin[2], 1.0f);
+
+        f32 clip[4];
+        _mm_storeu_ps(clip, DROP_Mat4TransformRow(point, &pBuffer->viewProjection));
+
+        // Box reaches behind the camera, it can't be hidden.
+        if (clip[3] < OCCLUSION_MIN_W)
+            return true;
+
+        f32 invW = 1.0f / clip[3];
+        f32 x    = (clip[0] * invW + 1.0f) * 0.5f * (f32) pBuffer->width;
+        f32 y    = (1.0f - clip[1] * invW) * 0.5f * (f32) pBuffer->height;
+        f32 z    = clip[2] * invW;
+
+        minX = fminf(minX, x), maxX = fmaxf(maxX, x);
+        minY = fminf(minY, y), maxY = fmaxf(maxY, y);
+        minZ = fminf(minZ, z);
+    }
+
+    if (minZ <= 0.0f)
+        return true;
+
+    // Off screen parts are the frustum culler's business, only look at the covered blocks.
+    i32 blocksX = (i32) (pBuffer->width / OCCLUSION_BLOCK_SIZE);
+    i32 blocksY = (i32) (pBuffer->height / OCCLUSION_BLOCK_SIZE);
+    i32 bx0     = (i32) floorf(minX) / OCCLUSION_BLOCK_SIZE;
+    i32 bx1     = (i32) floorf(maxX) / OCCLUSION_BLOCK_SIZE;
+    i32 by0     = (i32) floorf(minY) / OCCLUSION_BLOCK_SIZE;
+    i32 by1     = (i32) floorf(maxY) / OCCLUSION_BLOCK_SIZE;
+    bx0         = bx0 < 0 ? 0 : bx0;
+    by0         = by0 < 0 ? 0 : by0;
+    bx1         = bx1 >= blocksX ? blocksX - 1 : bx1;
+    by1         = by1 >= blocksY ? blocksY - 1 : by1;
+    if (bx0 > bx1 || by0 > by1)
+        return true;
+
+    for (i32 by = by0; by <= by1; ++by)
+    {
+        for (i32 bx = bx0; bx <= bx1; ++bx)
+        {
+            if (minZ <= pBuffer->pHiZ[by * blocksX + bx])
+                return true;
+        }
+    }
+
+    return false;
+}
+
+void DROP_OcclusionCullVisible(const OcclusionBuffer* pBuffer, CullWorld* pWorld)
+{
+    ASSERT_MSG(pBuffer, "Occlusion buffer is null.");
+    ASSERT_MSG(pWorld, "Cull world is null.");
+
+    u32 kept = 0;
+    for (u32 i = 0; i < pWorld->visibleCount; ++i)
+    {
+        u32 object = pWorld->pVisible[i];
+        u32 slot   = pWorld->pSlotOfObject[object];
+
+        f32 boxMin[3] = {
+            pWorld->pCenterX[slot] - pWorld->pExtentX[slot],
+            pWorld->pCenterY[slot] - pWorld->pExtentY[slot],
+            pWorld->pCenterZ[slot] - pWorld->pExtentZ[slot]};
+        f32 boxMax[3] = {
+            pWorld->pCenterX[slot] + pWorld->pExtentX[slot],
+            pWorld->pCenterY[slot] + pWorld->pExtentY[slot],
+            pWorld->pCenterZ[slot] + pWorld->pExtentZ[slot]};
+
+        if (DROP_OcclusionTestBox(pBuffer, boxMin, boxMax))
+            pWorld->pVisible[kept++] = object;
+    }
+
+    pWorld->visibleCount = kept;
+}
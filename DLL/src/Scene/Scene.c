@@ -0,0 +1,376 @@
+#include "pch.h"
+#include "Scene/Scene.h"
+
+#include "Utils/JobSystem.h"
+
+#pragma region INTERNAL
+#define SCENE_UPDATE_BATCH 1024 // Multiple of 4, nodes are updated 4 at a time.
+
+static const f32 s_identityLocal[SCENE_LOCAL_COUNT] = {
+    0.0f, 0.0f, 0.0f,       // Position.
+    0.0f, 0.0f, 0.0f, 1.0f, // Rotation.
+    1.0f, 1.0f, 1.0f};      // Scale.
+
+static u64 AlignSize(u64 size)
+{
+    return (size + 15) & ~15;
+}
+
+static void SortByDepth(Scene* pScene)
+{
+    u32 count = pScene->count;
+
+    u32* pNewIndex = (u32*) ALLOC(u32, count);
+    u8*  pScratch  = (u8*) ALLOC(Mat4, count);
+    if (!pNewIndex || !pScratch)
+    {
+        ASSERT_MSG(false, "Failed to allocate memory for scene sort.");
+        if (pNewIndex) FREE(pNewIndex);
+        if (pScratch) FREE(pScratch);
+        return;
+    }
+
+    // Counting sort on depth. Stable, and a parent is always shallower than its children.
+    u32 levelSize[SCENE_MAX_DEPTH] = {0};
+    for (u32 i = 0; i < count; ++i)
+        ++levelSize[pScene->pDepths[i]];
+
+    pScene->levelCount = 0;
+    u32 start          = 0;
+    for (u32 level = 0; level < SCENE_MAX_DEPTH; ++level)
+    {
+        pScene->levelStart[level] = start;
+        start += levelSize[level];
+        if (levelSize[level] > 0)
+            pScene->levelCount = level + 1;
+    }
+    pScene->levelStart[SCENE_MAX_DEPTH] = start;
+
+    u32 cursor[SCENE_MAX_DEPTH];
+    memcpy(cursor, pScene->levelStart, sizeof(cursor));
+    for (u32 i = 0; i < count; ++i)
+        pNewIndex[i] = cursor[pScene->pDepths[i]]++;
+
+    // Permute every stream through the scratch buffer.
+    u32* pScratchU32 = (u32*) pScratch;
+    for (u32 i = 0; i < count; ++i)
+        pScratchU32[pNewIndex[i]] = pScene->pParents[i] == SCENE_NO_PARENT ? SCENE_NO_PARENT : pNewIndex[pScene->pParents[i]];
+    memcpy(pScene->pParents, pScratchU32, sizeof(u32) * count);
+
+    for (u32 i = 0; i < count; ++i)
+        pScratchU32[pNewIndex[i]] = pScene->pNodeOfIndex[i];
+    memcpy(pScene->pNodeOfIndex, pScratchU32, sizeof(u32) * count);
+
+    for (u32 i = 0; i < count; ++i)
+        pScene->pIndexOfNode[pScene->pNodeOfIndex[i]] = i;
+
+    for (u32 i = 0; i < count; ++i)
+        pScratch[pNewIndex[i]] = pScene->pDepths[i];
+    memcpy(pScene->pDepths, pScratch, sizeof(u8) * count);
+
+    for (u32 i = 0; i < count; ++i)
+        pScratch[pNewIndex[i]] = pScene->pDirty[i];
+    memcpy(pScene->pDirty, pScratch, sizeof(u8) * count);
+
+    f32* pScratchF32 = (f32*) pScratch;
+    for (u32 stream = 0; stream < SCENE_LOCAL_COUNT; ++stream)
+    {
+        for (u32 i = 0; i < count; ++i)
+            pScratchF32[pNewIndex[i]] = pScene->pLocal[stream][i];
+        memcpy(pScene->pLocal[stream], pScratchF32, sizeof(f32) * count);
+    }
+
+    Mat4* pScratchMat4 = (Mat4*) pScratch;
+    for (u32 i = 0; i < count; ++i)
+        pScratchMat4[pNewIndex[i]] = pScene->pWorld[i];
+    memcpy(pScene->pWorld, pScratchMat4, sizeof(Mat4) * count);
+
+    FREE(pScratch);
+    FREE(pNewIndex);
+
+    pScene->needsSort = false;
+}
+
+// Builds the local matrices of 4 consecutive nodes at once, one node per SIMD lane.
+static void ComputeLocal4(__m128 local[SCENE_LOCAL_COUNT], Mat4 out[4])
+{
+    __m128 one  = _mm_set1_ps(1.0f);
+    __m128 two  = _mm_set1_ps(2.0f);
+    __m128 zero = _mm_setzero_ps();
+
+    __m128 qx = local[SCENE_LOCAL_ROTATION_X];
+    __m128 qy = local[SCENE_LOCAL_ROTATION_Y];
+    __m128 qz = local[SCENE_LOCAL_ROTATION_Z];
+    __m128 qw = local[SCENE_LOCAL_ROTATION_W];
+
+    __m128 xx = _mm_mul_ps(qx, qx);
+    __m128 yy = _mm_mul_ps(qy, qy);
+    __m128 zz = _mm_mul_ps(qz, qz);
+    __m128 xy = _mm_mul_ps(qx, qy);
+    __m128 xz = _mm_mul_ps(qx, qz);
+    __m128 yz = _mm_mul_ps(qy, qz);
+    __m128 wx = _mm_mul_ps(qw, qx);
+    __m128 wy = _mm_mul_ps(qw, qy);
+    __m128 wz = _mm_mul_ps(qw, qz);
+
+    __m128 sx = local[SCENE_LOCAL_SCALE_X];
+    __m128 sy = local[SCENE_LOCAL_SCALE_Y];
+    __m128 sz = local[SCENE_LOCAL_SCALE_Z];
+
+    __m128 r00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+    __m128 r01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+    __m128 r02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+    __m128 r03 = zero;
+
+    __m128 r10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+    __m128 r11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+    __m128 r12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+    __m128 r13 = zero;
+
+    __m128 r20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+    __m128 r21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+    __m128 r22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+    __m128 r23 = zero;
+
+    __m128 r30 = local[SCENE_LOCAL_POSITION_X];
+    __m128 r31 = local[SCENE_LOCAL_POSITION_Y];
+    __m128 r32 = local[SCENE_LOCAL_POSITION_Z];
+    __m128 r33 = one;
+
+    // Lanes hold nodes, transposing turns them back into per-node rows.
+    _MM_TRANSPOSE4_PS(r00, r01, r02, r03);
+    _MM_TRANSPOSE4_PS(r10, r11, r12, r13);
+    _MM_TRANSPOSE4_PS(r20, r21, r22, r23);
+    _MM_TRANSPOSE4_PS(r30, r31, r32, r33);
+
+    out[0].rows[0] = r00, out[0].rows[1] = r10, out[0].rows[2] = r20, out[0].rows[3] = r30;
+    out[1].rows[0] = r01, out[1].rows[1] = r11, out[1].rows[2] = r21, out[1].rows[3] = r31;
+    out[2].rows[0] = r02, out[2].rows[1] = r12, out[2].rows[2] = r22, out[2].rows[3] = r32;
+    out[3].rows[0] = r03, out[3].rows[1] = r13, out[3].rows[2] = r23, out[3].rows[3] = r33;
+}
+
+static void UpdateRange(Scene* pScene, u32 begin, u32 end)
+{
+    for (u32 i = begin; i < end; i += 4)
+    {
+        u32 n = end - i < 4 ? end - i : 4;
+
+        // A node is dirty when its local changed or its parent was recomputed this update.
+        // Parents live in the previous level, which is finished before this one starts.
+        u8 anyDirty = 0;
+        for (u32 k = 0; k < n; ++k)
+        {
+            u32 parent = pScene->pParents[i + k];
+            u8  dirty  = pScene->pDirty[i + k] | (parent != SCENE_NO_PARENT ? pScene->pDirty[parent] : 0);
+
+            pScene->pDirty[i + k] = dirty;
+            anyDirty |= dirty;
+        }
+        if (!anyDirty)
+            continue;
+
+        __m128 local[SCENE_LOCAL_COUNT];
+        if (n == 4)
+        {
+            for (u32 stream = 0; stream < SCENE_LOCAL_COUNT; ++stream)
+                local[stream] = _mm_loadu_ps(&pScene->pLocal[stream][i]);
+        }
+        else
+        {
+            // Tail of the level, pad the missing lanes with identity.
+            f32 padded[4];
+            for (u32 stream = 0; stream < SCENE_LOCAL_COUNT; ++stream)
+            {
+                for (u32 k = 0; k < 4; ++k)
+                    padded[k] = k < n ? pScene->pLocal[stream][i + k] : s_identityLocal[stream];
+                local[stream] = _mm_loadu_ps(padded);
+            }
+        }
+
+        Mat4 localMatrices[4];
+        ComputeLocal4(local, localMatrices);
+
+        for (u32 k = 0; k < n; ++k)
+        {
+            if (!pScene->pDirty[i + k])
+                continue;
+
+            u32 parent = pScene->pParents[i + k];
+            if (parent == SCENE_NO_PARENT)
+                pScene->pWorld[i + k] = localMatrices[k];
+            else
+                DROP_Mat4Multiply(&localMatrices[k], &pScene->pWorld[parent], &pScene->pWorld[i + k]);
+        }
+    }
+}
+
+typedef struct _LevelJob
+{
+    Scene* pScene;
+    u32    levelBegin;
+} LevelJob;
+
+static void UpdateLevelJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    LevelJob* pJob = (LevelJob*) pUserData;
+    UNUSED(threadIndex);
+
+    UpdateRange(pJob->pScene, pJob->levelBegin + begin, pJob->levelBegin + end);
+}
+#pragma endregion
+
+bool DROP_CreateScene(u32 capacity, Scene* pScene)
+{
+    ASSERT_MSG(capacity > 0, "Capacity must be greater than zero.");
+    ASSERT_MSG(pScene, "Scene is null.");
+
+    ZERO_MEM(pScene, 1);
+
+    // One block for every stream, each one 16-byte aligned.
+    u64 total = AlignSize(sizeof(Mat4) * capacity) +
+                AlignSize(sizeof(u32) * capacity) * 3 +
+                AlignSize(sizeof(u8) * capacity) * 2 +
+                AlignSize(sizeof(f32) * capacity) * SCENE_LOCAL_COUNT;
+
+    char* pMemory = (char*) ALLOC(char, total);
+    if (!pMemory)
+    {
+        LOG_ERROR("Failed to allocate memory for scene.");
+        return false;
+    }
+
+    char* pCursor  = pMemory;
+    pScene->pWorld = (Mat4*) pCursor;
+    pCursor += AlignSize(sizeof(Mat4) * capacity);
+    pScene->pIndexOfNode = (u32*) pCursor;
+    pCursor += AlignSize(sizeof(u32) * capacity);
+    pScene->pNodeOfIndex = (u32*) pCursor;
+    pCursor += AlignSize(sizeof(u32) * capacity);
+    pScene->pParents = (u32*) pCursor;
+    pCursor += AlignSize(sizeof(u32) * capacity);
+    pScene->pDepths = (u8*) pCursor;
+    pCursor += AlignSize(sizeof(u8) * capacity);
+    pScene->pDirty = (u8*) pCursor;
+    pCursor += AlignSize(sizeof(u8) * capacity);
+    for (u32 stream = 0; stream < SCENE_LOCAL_COUNT; ++stream)
+    {
+        pScene->pLocal[stream] = (f32*) pCursor;
+        pCursor += AlignSize(sizeof(f32) * capacity);
+    }
+
+    pScene->capacity = capacity;
+    pScene->pMemory  = pMemory;
+
+    return true;
+}
+
+void DROP_DestroyScene(Scene* pScene)
+{
+    ASSERT_MSG(pScene, "Scene is null.");
+
+    if (pScene->pMemory)
+        FREE(pScene->pMemory);
+
+    ZERO_MEM(pScene, 1);
+}
+
+u32 DROP_SceneAddNode(Scene* pScene, u32 parentNode)
+{
+    ASSERT_MSG(pScene, "Scene is null.");
+    ASSERT_MSG(pScene->count < pScene->capacity, "Scene is full.");
+    ASSERT_MSG(parentNode == SCENE_NO_PARENT || parentNode < pScene->count, "Parent node does not exist.");
+
+    u32 index = pScene->count;
+    u32 node  = pScene->count;
+
+    u32 parent = parentNode == SCENE_NO_PARENT ? SCENE_NO_PARENT : pScene->pIndexOfNode[parentNode];
+    u8  depth  = parent == SCENE_NO_PARENT ? 0 : pScene->pDepths[parent] + 1;
+    ASSERT_MSG(depth < SCENE_MAX_DEPTH, "Scene hierarchy is too deep.");
+
+    pScene->pIndexOfNode[node]  = index;
+    pScene->pNodeOfIndex[index] = node;
+    pScene->pParents[index]     = parent;
+    pScene->pDepths[index]      = depth;
+    pScene->pDirty[index]       = 1;
+    pScene->pWorld[index]       = DROP_Mat4Identity();
+    for (u32 stream = 0; stream < SCENE_LOCAL_COUNT; ++stream)
+        pScene->pLocal[stream][index] = s_identityLocal[stream];
+
+    // Appending keeps the depth order only while depths never go down.
+    if (index > 0 && depth < pScene->pDepths[index - 1])
+        pScene->needsSort = true;
+
+    ++pScene->count;
+    pScene->hasDirty = true;
+
+    return node;
+}
+
+void DROP_SceneSetLocal(Scene* pScene, u32 node, const f32 position[3], const f32 rotation[4], const f32 scale[3])
+{
+    ASSERT_MSG(pScene, "Scene is null.");
+    ASSERT_MSG(node < pScene->count, "Node does not exist.");
+
+    u32 index = pScene->pIndexOfNode[node];
+
+    pScene->pLocal[SCENE_LOCAL_POSITION_X][index] = position[0];
+    pScene->pLocal[SCENE_LOCAL_POSITION_Y][index] = position[1];
+    pScene->pLocal[SCENE_LOCAL_POSITION_Z][index] = position[2];
+    pScene->pLocal[SCENE_LOCAL_ROTATION_X][index] = rotation[0];
+    pScene->pLocal[SCENE_LOCAL_ROTATION_Y][index] = rotation[1];
+    pScene->pLocal[SCENE_LOCAL_ROTATION_Z][index] = rotation[2];
+    pScene->pLocal[SCENE_LOCAL_ROTATION_W][index] = rotation[3];
+    pScene->pLocal[SCENE_LOCAL_SCALE_X][index]    = scale[0];
+    pScene->pLocal[SCENE_LOCAL_SCALE_Y][index]    = scale[1];
+    pScene->pLocal[SCENE_LOCAL_SCALE_Z][index]    = scale[2];
+
+    pScene->pDirty[index] = 1;
+    pScene->hasDirty      = true;
+}
+
+const Mat4* DROP_SceneGetWorld(const Scene* pScene, u32 node)
+{
+    ASSERT_MSG(pScene, "Scene is null.");
+    ASSERT_MSG(node < pScene->count, "Node does not exist.");
+
+    return &pScene->pWorld[pScene->pIndexOfNode[node]];
+}
+
+void DROP_UpdateScene(Scene* pScene)
+{
+    ASSERT_MSG(pScene, "Scene is null.");
+
+    if (pScene->needsSort)
+        SortByDepth(pScene);
+
+    if (!pScene->hasDirty)
+        return;
+
+    // Without a sort the nodes are already in depth order, but the level ranges may be stale.
+    if (pScene->levelStart[SCENE_MAX_DEPTH] != pScene->count)
+    {
+        u32 level = 0;
+        for (u32 i = 0; i < pScene->count; ++i)
+        {
+            while (level <= pScene->pDepths[i])
+                pScene->levelStart[level++] = i;
+        }
+        pScene->levelCount = level;
+        while (level <= SCENE_MAX_DEPTH)
+            pScene->levelStart[level++] = pScene->count;
+    }
+
+    // Levels run one after another, the nodes of one level in parallel.
+    for (u32 level = 0; level < pScene->levelCount; ++level)
+    {
+        LevelJob job = {
+            .pScene     = pScene,
+            .levelBegin = pScene->levelStart[level]};
+
+        DROP_ParallelFor(
+            pScene->levelStart[level + 1] - pScene->levelStart[level], SCENE_UPDATE_BATCH, UpdateLevelJob, &job);
+    }
+
+    memset(pScene->pDirty, 0, sizeof(u8) * pScene->count);
+    pScene->hasDirty = false;
+}
@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "Utils/ArenaSnapshot.h"
+
+#pragma region INTERNAL
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+static u64 HashBytes(const char* pData, u64 size)
+{
+    u64 hash = FNV_OFFSET_BASIS;
+    for (u64 i = 0; i < size; ++i)
+    {
+        hash ^= (u8) pData[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+#pragma endregion
+
+bool DROP_SaveArenaSnapshot(
+    const char* fileName, const ArenaAllocator* pArena, u64 begin, u32 version, u64 sourceHash)
+{
+    ASSERT_MSG(fileName, "File path is null.");
+    ASSERT_MSG(pArena && pArena->memory, "Arena is null.");
+    ASSERT_MSG(begin < pArena->used, "Snapshot region is empty.");
+    ASSERT_MSG((begin & (ARENA_ALIGNMENT - 1)) == 0, "Snapshot region must start on an allocation.");
+
+    const char*         pData  = pArena->memory + begin;
+    ArenaSnapshotHeader header = {
+        .magic      = ARENA_SNAPSHOT_MAGIC,
+        .version    = version,
+        .sourceHash = sourceHash,
+        .size       = pArena->used - begin,
+        .dataHash   = HashBytes(pData, pArena->used - begin)};
+
+    FILE* file = fopen(fileName, "wb");
+    if (!file)
+    {
+        LOG_ERROR("Failed to open file: %s", fileName);
+        return false;
+    }
+
+    bool isWritten = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(pData, header.size, 1, file) == 1;
+    fclose(file);
+
+    if (!isWritten)
+    {
+        LOG_ERROR("Failed to write arena snapshot: %s", fileName);
+        remove(fileName);
+        return false;
+    }
+
+    return true;
+}
+
+bool DROP_LoadArenaSnapshot(
+    const char* fileName, ArenaAllocator* pArena, u32 version, u64 sourceHash, char** ppRoot)
+{
+    ASSERT_MSG(fileName, "File path is null.");
+    ASSERT_MSG(pArena && pArena->memory, "Arena is null.");
+    ASSERT_MSG(ppRoot, "Root pointer is null.");
+
+    *ppRoot = NULL;
+
+    // A missing snapshot is the usual cold start, not an error.
+    FILE* file = fopen(fileName, "rb");
+    if (!file)
+        return false;
+
+    ArenaSnapshotHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != ARENA_SNAPSHOT_MAGIC ||
+        header.version != version || header.sourceHash != sourceHash)
+    {
+        LOG_WARN("Arena snapshot is stale: %s", fileName);
+        fclose(file);
+        return false;
+    }
+
+    // Same bound as DROP_Allocate, checked here so a bad size fails instead of asserting.
+    if (header.size == 0 || (header.size & (ARENA_ALIGNMENT - 1)) != 0 || header.size >= pArena->size - pArena->used)
+    {
+        LOG_WARN("Arena snapshot doesn't fit the arena: %s", fileName);
+        fclose(file);
+        return false;
+    }
+
+    u64   used  = pArena->used;
+    char* pData = DROP_AllocateTagged(pArena, header.size, "ArenaSnapshot");
+
+    bool isRead = fread(pData, header.size, 1, file) == 1;
+    fclose(file);
+
+    if (!isRead || HashBytes(pData, header.size) != header.dataHash)
+    {
+        LOG_WARN("Arena snapshot is corrupt: %s", fileName);
+        pArena->used = used;
+        return false;
+    }
+
+    DROP_AddCounter(COUNTER_FILE_BYTES_READ, sizeof(header) + header.size);
+    *ppRoot = pData;
+
+    return true;
+}
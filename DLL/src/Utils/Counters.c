@@ -0,0 +1,187 @@
+#include "pch.h"
+#include "Utils/Counters.h"
+
+#include "Platform/Thread.h"
+
+#pragma region INTERNAL
+typedef struct
+{
+    const char* name;
+    CounterKind kind;
+} CounterInfo;
+
+static const CounterInfo s_counterInfos[COUNTER_COUNT] = {
+    {"DrawCalls", COUNTER_KIND_COUNTER},
+    {"StateChanges", COUNTER_KIND_COUNTER},
+    {"UploadedBytes", COUNTER_KIND_COUNTER},
+    {"Allocations", COUNTER_KIND_COUNTER},
+    {"AllocatedBytes", COUNTER_KIND_COUNTER},
+    {"FileBytesRead", COUNTER_KIND_COUNTER},
+    {"PersistentBytesUsed", COUNTER_KIND_GAUGE},
+    {"TransientBytesUsed", COUNTER_KIND_GAUGE}};
+
+// Totals since startup, only the owner thread writes them. Padded so two threads never share a
+// cache line, the 64-bit reads of the main thread can't tear on x64.
+typedef struct
+{
+    volatile u64 values[COUNTER_COUNT];
+    u8           padding[64 - (sizeof(u64) * COUNTER_COUNT) % 64];
+} CounterShard;
+
+// Static so the arena can count allocations made before anything is initialized.
+static CounterShard s_shards[COUNTER_MAX_THREADS];
+static Atomic32     s_shardCount = 0;
+// Threads past COUNTER_MAX_THREADS share these through atomic adds.
+static Atomic64 s_sharedTotals[COUNTER_COUNT];
+static Atomic64 s_gauges[COUNTER_COUNT];
+
+static u64             s_lastTotals[COUNTER_COUNT];
+static CounterSnapshot s_history[COUNTER_HISTORY_FRAMES];
+static u64             s_frameCount = 0;
+
+static THREAD_LOCAL CounterShard* t_pShard       = NULL;
+static THREAD_LOCAL bool          t_isRegistered = false;
+
+static CounterShard* GetShard()
+{
+    if (t_isRegistered)
+        return t_pShard;
+
+    t_isRegistered = true;
+
+    i32 index = DROP_AtomicIncrement32(&s_shardCount) - 1;
+    if (index < COUNTER_MAX_THREADS)
+        t_pShard = &s_shards[index];
+
+    return t_pShard;
+}
+
+static u32 GetHistoryCount()
+{
+    return s_frameCount < COUNTER_HISTORY_FRAMES ? (u32) s_frameCount : COUNTER_HISTORY_FRAMES;
+}
+
+static void WriteCSV(FILE* file)
+{
+    fprintf(file, "Frame");
+    for (u32 i = 0; i < COUNTER_COUNT; ++i)
+        fprintf(file, ",%s", s_counterInfos[i].name);
+    fprintf(file, "\n");
+
+    for (u32 i = GetHistoryCount(); i > 0; --i)
+    {
+        const CounterSnapshot* pSnapshot = DROP_GetCounterSnapshot(i - 1);
+        fprintf(file, "%llu", pSnapshot->frame);
+        for (u32 j = 0; j < COUNTER_COUNT; ++j)
+            fprintf(file, ",%llu", pSnapshot->values[j]);
+        fprintf(file, "\n");
+    }
+}
+
+static void WriteJSON(FILE* file)
+{
+    fprintf(file, "[");
+    for (u32 i = GetHistoryCount(); i > 0; --i)
+    {
+        const CounterSnapshot* pSnapshot = DROP_GetCounterSnapshot(i - 1);
+        fprintf(file, "%s\n{\"Frame\":%llu", i == GetHistoryCount() ? "" : ",", pSnapshot->frame);
+        for (u32 j = 0; j < COUNTER_COUNT; ++j)
+            fprintf(file, ",\"%s\":%llu", s_counterInfos[j].name, pSnapshot->values[j]);
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n]\n");
+}
+#pragma endregion
+
+void DROP_AddCounter(CounterId id, u64 value)
+{
+    ASSERT_MSG(id < COUNTER_COUNT, "Counter id is out of range.");
+    ASSERT_MSG(s_counterInfos[id].kind == COUNTER_KIND_COUNTER, "%s is not a counter.", s_counterInfos[id].name);
+
+    CounterShard* pShard = GetShard();
+    if (pShard)
+        pShard->values[id] += value;
+    else
+        DROP_AtomicAdd64(&s_sharedTotals[id], (i64) value);
+}
+
+void DROP_SetGauge(CounterId id, u64 value)
+{
+    ASSERT_MSG(id < COUNTER_COUNT, "Counter id is out of range.");
+    ASSERT_MSG(s_counterInfos[id].kind == COUNTER_KIND_GAUGE, "%s is not a gauge.", s_counterInfos[id].name);
+
+    DROP_AtomicExchange64(&s_gauges[id], (i64) value);
+}
+
+const char* DROP_GetCounterName(CounterId id)
+{
+    ASSERT_MSG(id < COUNTER_COUNT, "Counter id is out of range.");
+
+    return s_counterInfos[id].name;
+}
+
+CounterKind DROP_GetCounterKind(CounterId id)
+{
+    ASSERT_MSG(id < COUNTER_COUNT, "Counter id is out of range.");
+
+    return s_counterInfos[id].kind;
+}
+
+void DROP_CountersEndFrame()
+{
+    u32 shardCount = (u32) DROP_AtomicLoad32(&s_shardCount);
+    if (shardCount > COUNTER_MAX_THREADS)
+        shardCount = COUNTER_MAX_THREADS;
+
+    CounterSnapshot* pSnapshot = &s_history[s_frameCount & (COUNTER_HISTORY_FRAMES - 1)];
+    pSnapshot->frame           = s_frameCount;
+
+    for (u32 i = 0; i < COUNTER_COUNT; ++i)
+    {
+        if (s_counterInfos[i].kind == COUNTER_KIND_GAUGE)
+        {
+            pSnapshot->values[i] = (u64) DROP_AtomicLoad64(&s_gauges[i]);
+            continue;
+        }
+
+        // Totals only grow, the frame value is the difference with the previous frame.
+        u64 total = (u64) DROP_AtomicLoad64(&s_sharedTotals[i]);
+        for (u32 j = 0; j < shardCount; ++j)
+            total += s_shards[j].values[i];
+
+        pSnapshot->values[i] = total - s_lastTotals[i];
+        s_lastTotals[i]      = total;
+    }
+
+    ++s_frameCount;
+}
+
+const CounterSnapshot* DROP_GetCounterSnapshot(u32 framesAgo)
+{
+    if (framesAgo >= GetHistoryCount())
+        return NULL;
+
+    return &s_history[(s_frameCount - 1 - framesAgo) & (COUNTER_HISTORY_FRAMES - 1)];
+}
+
+bool DROP_ExportCounters(const char* fileName, CounterFormat format)
+{
+    ASSERT_MSG(fileName, "Counters file name is null.");
+
+    FILE* file = fopen(fileName, "w");
+    if (!file)
+    {
+        LOG_ERROR("Failed to open file: %s", fileName);
+        return false;
+    }
+
+    if (format == COUNTER_FORMAT_JSON)
+        WriteJSON(file);
+    else
+        WriteCSV(file);
+
+    fclose(file);
+    LOG_TRACE("Wrote %u frames of counters to %s.", GetHistoryCount(), fileName);
+
+    return true;
+}
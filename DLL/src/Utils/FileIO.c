@@ -64,7 +64,7 @@ char* DROP_ReadFile(const char* fileName, u64* pSize, ArenaAllocator* pArena)
     *pSize = ftell(file);
     fseek(file, 0, SEEK_SET);
 
-    char* buffer = (char*) DROP_Allocate(pArena, *pSize + 1);
+    char* buffer = (char*) DROP_AllocateTagged(pArena, *pSize + 1, "FileIO");
     if (!buffer)
     {
         LOG_ERROR("Failed to allocate memory for file: %s", fileName);
@@ -73,6 +73,7 @@ char* DROP_ReadFile(const char* fileName, u64* pSize, ArenaAllocator* pArena)
 
     fread(buffer, *pSize, 1, file);
     buffer[*pSize] = '\0'; // Null terminate the buffer to make it a string.
+    DROP_AddCounter(COUNTER_FILE_BYTES_READ, *pSize);
 
     fclose(file);
     return buffer;
@@ -109,9 +110,10 @@ bool DROP_CopyFile(const char* source, const char* destination, ArenaAllocator*
     u64 size = ftell(file);
     fseek(file, 0, SEEK_SET);
 
-    char* buffer = (char*) DROP_Allocate(pArena, size);
+    char* buffer = (char*) DROP_AllocateTagged(pArena, size, "FileIO");
     fread(buffer, 1, size, file);
     fclose(file);
+    DROP_AddCounter(COUNTER_FILE_BYTES_READ, size);
 
     if (!DROP_WriteFile(destination, buffer, size))
     {
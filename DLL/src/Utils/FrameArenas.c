@@ -0,0 +1,65 @@
+#include "pch.h"
+#include "Utils/FrameArenas.h"
+
+bool DROP_MakeFrameArenas(FrameArenas* pArenas, u32 count, u64 sizePerFrame)
+{
+    ASSERT_MSG(pArenas, "Frame arenas pointer is null.");
+    ASSERT_MSG(count > 0 && count <= FRAME_ARENA_MAX_COUNT, "Frame arena count is out of range.");
+
+    ZERO_MEM(pArenas, 1);
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (!DROP_MakeArena(&pArenas->arenas[i], sizePerFrame))
+        {
+            LOG_ERROR("Failed to make frame arena at index: %d", i);
+            for (u32 j = 0; j < i; ++j)
+                FREE(pArenas->arenas[j].memory);
+            ZERO_MEM(pArenas, 1);
+            return false;
+        }
+    }
+
+    pArenas->count = count;
+
+    return true;
+}
+
+void DROP_DestroyFrameArenas(FrameArenas* pArenas)
+{
+    ASSERT_MSG(pArenas, "Frame arenas pointer is null.");
+
+    for (u32 i = 0; i < pArenas->count; ++i)
+        FREE(pArenas->arenas[i].memory);
+
+    ZERO_MEM(pArenas, 1);
+}
+
+bool DROP_BeginFrameArenas(FrameArenas* pArenas, u64 frameIndex, u64 completedFrame)
+{
+    ASSERT_MSG(pArenas && pArenas->count, "Frame arenas are not made.");
+    ASSERT_MSG(frameIndex > pArenas->frameIndex, "Frames must begin in order.");
+
+    u32 slot = (u32) (frameIndex % pArenas->count);
+    if (pArenas->lastUseFrames[slot] > completedFrame)
+        return false;
+
+    DROP_ClearArena(&pArenas->arenas[slot]);
+    pArenas->lastUseFrames[slot] = frameIndex;
+    pArenas->frameIndex          = frameIndex;
+
+    return true;
+}
+
+char* DROP_AllocateFrame(FrameArenas* pArenas, u64 size, u32 framesAhead)
+{
+    ASSERT_MSG(pArenas && pArenas->frameIndex, "No frame has begun.");
+    ASSERT_MSG(framesAhead < pArenas->count, "The arena would be needed again before the frame it lives to.");
+
+    u32 slot    = (u32) (pArenas->frameIndex % pArenas->count);
+    u64 lastUse = pArenas->frameIndex + framesAhead;
+    if (lastUse > pArenas->lastUseFrames[slot])
+        pArenas->lastUseFrames[slot] = lastUse;
+
+    return DROP_AllocateTagged(&pArenas->arenas[slot], size, "FrameArenas");
+}
@@ -0,0 +1,336 @@
+#include "pch.h"
+#include "Utils/FrameEncoder.h"
+
+#include "Math/HalfFloat.h"
+#include "Platform/Timer.h"
+
+#include <math.h>
+
+#pragma region INTERNAL
+#define FRAME_ENCODER_PATH_LENGTH (FRAME_ENCODER_NAME_LENGTH + 16)
+
+static const char* s_extensions[] = {"pfm", "ppm", "raw"};
+
+// 8-bit sRGB of every half, so the 8-bit path never goes through floats.
+static u8   s_srgbTable[1 << 16];
+static bool s_isSrgbTableBuilt = false;
+
+static void BuildSrgbTable()
+{
+    for (u32 i = 0; i < ARRAY_COUNT(s_srgbTable); ++i)
+    {
+        // Written so NaN ends up as 0.
+        f32 value = DROP_HalfToFloat((u16) i);
+        value     = value > 0.0f ? value : 0.0f;
+        value     = value < 1.0f ? value : 1.0f;
+        value     = value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+
+        s_srgbTable[i] = (u8) (value * 255.0f + 0.5f);
+    }
+    s_isSrgbTableBuilt = true;
+}
+
+static bool WritePFM(FILE* file, const EncoderFrame* pFrame, f32* pRow, u64* pBytesWritten)
+{
+    i32 headerSize = fprintf(file, "PF\n%u %u\n-1.0\n", pFrame->width, pFrame->height);
+    if (headerSize < 0)
+        return false;
+    *pBytesWritten += (u64) headerSize;
+
+    // Little endian, from the bottom row up.
+    for (u32 y = pFrame->height; y-- > 0;)
+    {
+        const u16* pHalves = pFrame->pPixels + (u64) y * pFrame->width * 4;
+        DROP_HalfToFloatArray(pHalves, pRow, pFrame->width * 4);
+
+        // Alpha is dropped in place, each pixel only moves down.
+        for (u32 x = 0; x < pFrame->width; ++x)
+        {
+            pRow[x * 3 + 0] = pRow[x * 4 + 0];
+            pRow[x * 3 + 1] = pRow[x * 4 + 1];
+            pRow[x * 3 + 2] = pRow[x * 4 + 2];
+        }
+
+        if (fwrite(pRow, sizeof(f32) * 3, pFrame->width, file) != pFrame->width)
+            return false;
+        *pBytesWritten += sizeof(f32) * 3 * pFrame->width;
+    }
+
+    return true;
+}
+
+static bool WritePPM(FILE* file, const EncoderFrame* pFrame, u8* pRow, u64* pBytesWritten)
+{
+    if (!s_isSrgbTableBuilt)
+        BuildSrgbTable();
+
+    i32 headerSize = fprintf(file, "P6\n%u %u\n255\n", pFrame->width, pFrame->height);
+    if (headerSize < 0)
+        return false;
+    *pBytesWritten += (u64) headerSize;
+
+    for (u32 y = 0; y < pFrame->height; ++y)
+    {
+        const u16* pHalves = pFrame->pPixels + (u64) y * pFrame->width * 4;
+        for (u32 x = 0; x < pFrame->width; ++x)
+        {
+            pRow[x * 3 + 0] = s_srgbTable[pHalves[x * 4 + 0]];
+            pRow[x * 3 + 1] = s_srgbTable[pHalves[x * 4 + 1]];
+            pRow[x * 3 + 2] = s_srgbTable[pHalves[x * 4 + 2]];
+        }
+
+        if (fwrite(pRow, 3, pFrame->width, file) != pFrame->width)
+            return false;
+        *pBytesWritten += 3 * pFrame->width;
+    }
+
+    return true;
+}
+
+static bool WriteRaw(FILE* file, const EncoderFrame* pFrame, u64* pBytesWritten)
+{
+    RawFrameHeader header = {
+        .magic      = FRAME_ENCODER_RAW_MAGIC,
+        .width      = pFrame->width,
+        .height     = pFrame->height,
+        .padding    = 0,
+        .frameIndex = pFrame->frameIndex};
+
+    u64 pixelCount = (u64) pFrame->width * pFrame->height;
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(pFrame->pPixels, sizeof(u16) * 4, pixelCount, file) != pixelCount)
+        return false;
+
+    *pBytesWritten += sizeof(header) + sizeof(u16) * 4 * pixelCount;
+    return true;
+}
+
+static bool EncodeQueuedFrame(FrameEncoder encoder, const EncoderFrame* pFrame)
+{
+    if (encoder->encoding == FRAME_ENCODING_RAW)
+        return DROP_EncodeFrame(encoder->pRawFile, encoder->encoding, pFrame, encoder->pRow, &encoder->bytesWritten);
+
+    char path[FRAME_ENCODER_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s_%04d.%s", encoder->fileName, DROP_AtomicLoad32(&encoder->encodeCount),
+             s_extensions[encoder->encoding]);
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        LOG_ERROR("Failed to open file: %s", path);
+        return false;
+    }
+
+    bool isWritten = DROP_EncodeFrame(file, encoder->encoding, pFrame, encoder->pRow, &encoder->bytesWritten);
+    fclose(file);
+
+    return isWritten;
+}
+
+static void EncoderMain(void* pUserData)
+{
+    FrameEncoder encoder = (FrameEncoder) pUserData;
+
+    for (;;)
+    {
+        DROP_WaitSemaphore(encoder->semaphore);
+
+        // Every submitted frame comes with its own count, being woken with none left means stop.
+        i32 encodeCount = DROP_AtomicLoad32(&encoder->encodeCount);
+        if (encodeCount == DROP_AtomicLoad32(&encoder->submitCount))
+            break;
+
+        const EncoderFrame* pFrame     = &encoder->frames[encodeCount % FRAME_ENCODER_QUEUE_LENGTH];
+        u64                 startTicks = DROP_GetTicks();
+
+        if (!DROP_AtomicLoad32(&encoder->isFailed) && !EncodeQueuedFrame(encoder, pFrame))
+        {
+            LOG_ERROR("Failed to encode frame %llu, the frames after it are dropped.", pFrame->frameIndex);
+            DROP_AtomicExchange32(&encoder->isFailed, 1);
+        }
+
+        encoder->encodeTicks += DROP_GetTicks() - startTicks;
+
+        // Gives the buffer back to the submitting thread.
+        DROP_AtomicIncrement32(&encoder->encodeCount);
+    }
+}
+
+static void ReleaseEncoder(FrameEncoder encoder)
+{
+    if (encoder->semaphore)
+        DROP_DestroySemaphore(&encoder->semaphore);
+    if (encoder->pRawFile)
+        fclose(encoder->pRawFile);
+    if (encoder->pRow)
+        FREE(encoder->pRow);
+    for (u32 i = 0; i < FRAME_ENCODER_QUEUE_LENGTH; ++i)
+    {
+        if (encoder->frames[i].pPixels)
+            FREE(encoder->frames[i].pPixels);
+    }
+
+    FREE(encoder);
+}
+#pragma endregion
+
+bool DROP_CreateFrameEncoder(const FrameEncoderDesc* pDesc, FrameEncoder* pEncoder)
+{
+    ASSERT_MSG(pDesc && pDesc->fileName, "Frame encoder description is invalid.");
+    ASSERT_MSG(pDesc->maxWidth > 0 && pDesc->maxHeight > 0, "Frame encoder size must be greater than zero.");
+    ASSERT_MSG(pEncoder, "Frame encoder pointer is null.");
+
+    *pEncoder = NULL;
+
+    if (strlen(pDesc->fileName) >= FRAME_ENCODER_NAME_LENGTH)
+    {
+        LOG_ERROR("Frame encoder file name is too long: %s", pDesc->fileName);
+        return false;
+    }
+
+    FrameEncoder encoder = (FrameEncoder) ALLOC(_FrameEncoder, 1);
+    if (!encoder)
+    {
+        LOG_ERROR("Failed to allocate frame encoder.");
+        return false;
+    }
+
+    ZERO_MEM(encoder, 1);
+    strcpy(encoder->fileName, pDesc->fileName);
+    encoder->encoding  = pDesc->encoding;
+    encoder->maxWidth  = pDesc->maxWidth;
+    encoder->maxHeight = pDesc->maxHeight;
+
+    u64  pixelCount  = (u64) pDesc->maxWidth * pDesc->maxHeight;
+    bool isAllocated = true;
+    for (u32 i = 0; i < FRAME_ENCODER_QUEUE_LENGTH; ++i)
+    {
+        encoder->frames[i].pPixels = (u16*) ALLOC(u16, pixelCount * 4);
+        isAllocated                = isAllocated && encoder->frames[i].pPixels;
+    }
+
+    encoder->pRow = (f32*) ALLOC(f32, (u64) pDesc->maxWidth * 4);
+    if (!isAllocated || !encoder->pRow)
+    {
+        LOG_ERROR("Failed to allocate frame encoder buffers.");
+        ReleaseEncoder(encoder);
+        return false;
+    }
+
+    if (pDesc->encoding == FRAME_ENCODING_RAW)
+    {
+        char path[FRAME_ENCODER_PATH_LENGTH];
+        snprintf(path, sizeof(path), "%s.%s", pDesc->fileName, s_extensions[FRAME_ENCODING_RAW]);
+
+        encoder->pRawFile = fopen(path, "wb");
+        if (!encoder->pRawFile)
+        {
+            LOG_ERROR("Failed to open file: %s", path);
+            ReleaseEncoder(encoder);
+            return false;
+        }
+    }
+
+    if (pDesc->encoding == FRAME_ENCODING_PPM && !s_isSrgbTableBuilt)
+        BuildSrgbTable();
+
+    if (!DROP_CreateSemaphore(0, &encoder->semaphore))
+    {
+        LOG_ERROR("Failed to create frame encoder semaphore.");
+        ReleaseEncoder(encoder);
+        return false;
+    }
+
+    if (!DROP_CreateThread(EncoderMain, encoder, &encoder->thread))
+    {
+        LOG_ERROR("Failed to create frame encoder thread.");
+        ReleaseEncoder(encoder);
+        return false;
+    }
+
+    *pEncoder = encoder;
+
+    return true;
+}
+
+void DROP_DestroyFrameEncoder(FrameEncoder* pEncoder)
+{
+    ASSERT_MSG(pEncoder && *pEncoder, "Frame encoder is null.");
+    FrameEncoder encoder = *pEncoder;
+
+    if (encoder)
+    {
+        DROP_SignalSemaphore(encoder->semaphore, 1);
+        DROP_JoinThread(&encoder->thread);
+
+        ReleaseEncoder(encoder);
+    }
+
+    *pEncoder = NULL;
+}
+
+EncoderFrame* DROP_AcquireEncoderFrame(FrameEncoder encoder, u32 width, u32 height, u64 frameIndex)
+{
+    ASSERT_MSG(encoder, "Frame encoder is null.");
+
+    i32 submitCount = DROP_AtomicLoad32(&encoder->submitCount);
+    if (width > encoder->maxWidth || height > encoder->maxHeight || DROP_AtomicLoad32(&encoder->isFailed) ||
+        submitCount - DROP_AtomicLoad32(&encoder->encodeCount) >= FRAME_ENCODER_QUEUE_LENGTH)
+    {
+        ++encoder->droppedCount;
+        return NULL;
+    }
+
+    EncoderFrame* pFrame = &encoder->frames[submitCount % FRAME_ENCODER_QUEUE_LENGTH];
+    pFrame->width        = width;
+    pFrame->height       = height;
+    pFrame->frameIndex   = frameIndex;
+
+    return pFrame;
+}
+
+void DROP_SubmitEncoderFrame(FrameEncoder encoder)
+{
+    ASSERT_MSG(encoder, "Frame encoder is null.");
+
+    DROP_AtomicIncrement32(&encoder->submitCount);
+    DROP_SignalSemaphore(encoder->semaphore, 1);
+}
+
+void DROP_FlushFrameEncoder(FrameEncoder encoder)
+{
+    ASSERT_MSG(encoder, "Frame encoder is null.");
+
+    while (DROP_AtomicLoad32(&encoder->encodeCount) != DROP_AtomicLoad32(&encoder->submitCount))
+        DROP_SleepMilliseconds(1);
+}
+
+bool DROP_EncodeFrame(FILE* file, FrameEncoding encoding, const EncoderFrame* pFrame, f32* pRow, u64* pBytesWritten)
+{
+    ASSERT_MSG(file, "File is null.");
+    ASSERT_MSG(pFrame && pFrame->pPixels, "Frame is null.");
+    ASSERT_MSG(pRow, "Row buffer is null.");
+    ASSERT_MSG(pBytesWritten, "Bytes written pointer is null.");
+
+    switch (encoding)
+    {
+    case FRAME_ENCODING_PFM:
+        return WritePFM(file, pFrame, pRow, pBytesWritten);
+    case FRAME_ENCODING_PPM:
+        return WritePPM(file, pFrame, (u8*) pRow, pBytesWritten);
+    case FRAME_ENCODING_RAW:
+        return WriteRaw(file, pFrame, pBytesWritten);
+    }
+
+    return false;
+}
+
+void DROP_PrintFrameEncoderStats(FrameEncoder encoder)
+{
+    ASSERT_MSG(encoder, "Frame encoder is null.");
+
+    i32 encodeCount = DROP_AtomicLoad32(&encoder->encodeCount);
+    printf("Frame encoder: %d frames encoded, %llu dropped, %.1f MB written, %.3f ms per frame.\n", encodeCount,
+           encoder->droppedCount, encoder->bytesWritten / (1024.0 * 1024.0),
+           encodeCount ? DROP_TicksToMilliseconds(encoder->encodeTicks) / encodeCount : 0.0);
+}
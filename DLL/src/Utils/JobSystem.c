@@ -0,0 +1,158 @@
+#include "pch.h"
+#include "Utils/JobSystem.h"
+
+#include "Platform/Thread.h"
+
+#pragma region INTERNAL
+#define JOB_MAX_WORKERS 63
+
+typedef struct _ParallelJob
+{
+    JobFunc  func;
+    void*    pUserData;
+    u32      count;
+    u32      batchSize;
+    Atomic32 nextItem;
+    Atomic32 doneItems;
+} ParallelJob;
+
+static Thread                s_workers[JOB_MAX_WORKERS];
+static u32                   s_workerCount   = 0;
+static Semaphore             s_wakeSemaphore = NULL;
+static Atomic32              s_isRunning     = 0;
+static Atomic32              s_activeWorkers = 0;
+static ParallelJob* volatile s_pCurrentJob   = NULL;
+
+static void RunBatches(ParallelJob* pJob, u32 threadIndex)
+{
+    for (;;)
+    {
+        u32 begin = (u32) DROP_AtomicAdd32(&pJob->nextItem, (i32) pJob->batchSize) - pJob->batchSize;
+        if (begin >= pJob->count)
+            break;
+
+        u32 end = begin + pJob->batchSize;
+        if (end > pJob->count)
+            end = pJob->count;
+
+        pJob->func(pJob->pUserData, begin, end, threadIndex);
+        DROP_AtomicAdd32(&pJob->doneItems, (i32) (end - begin));
+    }
+}
+
+static void WorkerMain(void* pUserData)
+{
+    u32 threadIndex = (u32) (uintptr_t) pUserData;
+
+    for (;;)
+    {
+        DROP_WaitSemaphore(s_wakeSemaphore);
+        if (!DROP_AtomicLoad32(&s_isRunning))
+            break;
+
+        // Announce ourselves before looking at the job so the caller can't return while we still read it.
+        DROP_AtomicIncrement32(&s_activeWorkers);
+        ParallelJob* pJob = (ParallelJob*) DROP_AtomicLoadPointer((void* volatile*) &s_pCurrentJob);
+        if (pJob)
+            RunBatches(pJob, threadIndex);
+        DROP_AtomicDecrement32(&s_activeWorkers);
+    }
+}
+#pragma endregion
+
+bool DROP_CreateJobSystem(u32 workerCount)
+{
+    ASSERT_MSG(s_workerCount == 0, "Job system is already created.");
+
+    if (workerCount == 0)
+    {
+        u32 processorCount = DROP_GetProcessorCount();
+        workerCount        = processorCount > 1 ? processorCount - 1 : 0;
+    }
+    if (workerCount > JOB_MAX_WORKERS)
+        workerCount = JOB_MAX_WORKERS;
+    if (workerCount == 0)
+        return true;
+
+    if (!DROP_CreateSemaphore(0, &s_wakeSemaphore))
+    {
+        LOG_ERROR("Failed to create job system semaphore.");
+        return false;
+    }
+
+    DROP_AtomicStore32(&s_isRunning, 1);
+    for (u32 i = 0; i < workerCount; ++i)
+    {
+        if (!DROP_CreateThread(WorkerMain, (void*) (uintptr_t) (i + 1), &s_workers[i]))
+        {
+            LOG_ERROR("Failed to create job worker at index: %d", i);
+            s_workerCount = i;
+            DROP_DestroyJobSystem();
+            return false;
+        }
+    }
+    s_workerCount = workerCount;
+
+    return true;
+}
+
+void DROP_DestroyJobSystem()
+{
+    if (!s_wakeSemaphore)
+        return;
+
+    DROP_AtomicStore32(&s_isRunning, 0);
+    DROP_SignalSemaphore(s_wakeSemaphore, s_workerCount);
+    for (u32 i = 0; i < s_workerCount; ++i)
+        DROP_JoinThread(&s_workers[i]);
+    DROP_DestroySemaphore(&s_wakeSemaphore);
+
+    s_workerCount = 0;
+}
+
+u32 DROP_GetJobThreadCount()
+{
+    return s_workerCount + 1;
+}
+
+void DROP_ParallelFor(u32 count, u32 batchSize, JobFunc func, void* pUserData)
+{
+    ASSERT_MSG(func, "Job function is null.");
+    ASSERT_MSG(batchSize > 0, "Batch size must be greater than zero.");
+    ASSERT_MSG(count < 0x7FFFFFFF - batchSize, "Too many items for one job.");
+
+    if (count == 0)
+        return;
+
+    if (s_workerCount == 0 || count <= batchSize)
+    {
+        func(pUserData, 0, count, 0);
+        return;
+    }
+
+    ASSERT_MSG(!s_pCurrentJob, "Nested parallel for is not supported.");
+
+    ParallelJob job = {
+        .func      = func,
+        .pUserData = pUserData,
+        .count     = count,
+        .batchSize = batchSize,
+        .nextItem  = 0,
+        .doneItems = 0};
+
+    DROP_AtomicExchangePointer((void* volatile*) &s_pCurrentJob, &job);
+
+    u32 batchCount = (count + batchSize - 1) / batchSize;
+    u32 wakeCount  = batchCount - 1 < s_workerCount ? batchCount - 1 : s_workerCount;
+    DROP_SignalSemaphore(s_wakeSemaphore, wakeCount);
+
+    RunBatches(&job, 0);
+
+    while ((u32) DROP_AtomicLoad32(&job.doneItems) < count)
+        DROP_YieldProcessor();
+
+    // The job lives on this stack, wait for late workers to let go of it.
+    DROP_AtomicExchangePointer((void* volatile*) &s_pCurrentJob, NULL);
+    while (DROP_AtomicLoad32(&s_activeWorkers) != 0)
+        DROP_YieldProcessor();
+}
@@ -0,0 +1,455 @@
+#include "pch.h"
+#include "Utils/Profiler.h"
+
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
+
+#pragma region INTERNAL
+#define PROFILE_THREAD_EVENTS 16384 // Power of two.
+#define PROFILE_MAX_DEPTH 64
+#define PROFILE_MAX_TRACE_EVENTS (1 << 18)
+#define PROFILE_FILE_NAME_SIZE 260
+
+// A NULL name ends the innermost zone.
+typedef struct
+{
+    u64         ticks;
+    const char* name;
+} ProfileEvent;
+
+typedef struct
+{
+    const char* name;
+    u32         zone;
+    u64         startTicks;
+    u64         childTicks;
+} OpenZone;
+
+// Single producer, single consumer ring. The owner thread writes the events and the main thread
+// reads them in DROP_ProfileEndFrame, each side only moves its own index.
+typedef struct
+{
+    ProfileEvent events[PROFILE_THREAD_EVENTS];
+    Atomic32     writeIndex;
+    Atomic32     readIndex;
+
+    // Owner thread. Bit i is set when the begin at depth i made it into the ring, its end then has
+    // a slot reserved so zones never lose one half when the ring is full.
+    u64 pushedMask;
+    u32 openDepth;
+    u32 reservedCount;
+
+    // Main thread.
+    OpenZone stack[PROFILE_MAX_DEPTH];
+    u32      stackDepth;
+    u32      index;
+} ProfileThread;
+
+typedef struct
+{
+    const char* name;
+    u64         startTicks;
+    u64         durationTicks;
+    u32         thread;
+} TraceEvent;
+
+typedef struct
+{
+    ProfileThread* volatile pThreads[PROFILE_MAX_THREADS];
+    Atomic32                threadCount;
+
+    ProfileZone zones[PROFILE_MAX_ZONES];      // Timed since the last frame end.
+    ProfileZone frameZones[PROFILE_MAX_ZONES]; // The last completed frame.
+    u32         zoneCount;
+    u8          buckets[PROFILE_MAX_ZONES * 2]; // Open addressing, index + 1 or 0 when empty.
+
+    TraceEvent* pTraceEvents;
+    u32         traceEventCount;
+    u32         traceFramesLeft;
+    u64         traceStartTicks;
+    char        traceFileName[PROFILE_FILE_NAME_SIZE];
+} ProfilerState;
+
+static ProfilerState* s_pProfiler  = NULL;
+static Atomic32       s_generation = 0; // Bumped on every create, so threads drop buffers of an old profiler.
+
+static THREAD_LOCAL ProfileThread* t_pThread    = NULL;
+static THREAD_LOCAL i32            t_generation = 0;
+
+static ProfileThread* GetThread()
+{
+    i32 generation = DROP_AtomicLoad32(&s_generation);
+    if (t_generation == generation)
+        return t_pThread;
+
+    t_pThread    = NULL;
+    t_generation = generation;
+    if (!s_pProfiler)
+        return NULL;
+
+    i32 index = DROP_AtomicIncrement32(&s_pProfiler->threadCount) - 1;
+    if (index >= PROFILE_MAX_THREADS)
+    {
+        LOG_WARN("Too many threads for the profiler, thread %d is not profiled.", (i32) index);
+        return NULL;
+    }
+
+    ProfileThread* pThread = (ProfileThread*) ALLOC(ProfileThread, 1);
+    if (!pThread)
+    {
+        LOG_ERROR("Failed to allocate profiler thread buffer.");
+        return NULL;
+    }
+    ZERO_MEM(pThread, 1);
+    pThread->index = (u32) index;
+
+    DROP_AtomicExchangePointer((void* volatile*) &s_pProfiler->pThreads[index], pThread);
+    t_pThread = pThread;
+
+    return pThread;
+}
+
+static void PushEvent(ProfileThread* pThread, const char* name)
+{
+    u32           write  = (u32) DROP_AtomicLoad32(&pThread->writeIndex);
+    ProfileEvent* pEvent = &pThread->events[write & (PROFILE_THREAD_EVENTS - 1)];
+    pEvent->ticks        = DROP_GetTicks();
+    pEvent->name         = name;
+
+    // Publishes the event to the main thread.
+    DROP_AtomicStore32(&pThread->writeIndex, (i32) (write + 1));
+}
+
+static u32 HashZone(const char* name, u32 parent)
+{
+    u64 value = (u64) (size_t) name ^ ((u64) parent * 0x9e3779b97f4a7c15ull);
+    value ^= value >> 29;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 32;
+    return (u32) value;
+}
+
+// Returns PROFILE_NO_PARENT when the table is full.
+static u32 FindZone(const char* name, u32 parent)
+{
+    u32 bucket = HashZone(name, parent) % ARRAY_COUNT(s_pProfiler->buckets);
+    while (s_pProfiler->buckets[bucket])
+    {
+        u32 index = s_pProfiler->buckets[bucket] - 1;
+        if (s_pProfiler->zones[index].name == name && s_pProfiler->zones[index].parent == parent)
+            return index;
+        bucket = (bucket + 1) % ARRAY_COUNT(s_pProfiler->buckets);
+    }
+
+    if (s_pProfiler->zoneCount == PROFILE_MAX_ZONES)
+        return PROFILE_NO_PARENT;
+
+    u32          index = s_pProfiler->zoneCount++;
+    ProfileZone* pZone = &s_pProfiler->zones[index];
+    ZERO_MEM(pZone, 1);
+    pZone->name   = name;
+    pZone->parent = parent;
+    pZone->depth  = parent == PROFILE_NO_PARENT ? 0 : s_pProfiler->zones[parent].depth + 1;
+
+    s_pProfiler->buckets[bucket] = (u8) (index + 1);
+    if (s_pProfiler->zoneCount == PROFILE_MAX_ZONES)
+    {
+        LOG_WARN("Profile zone table is full, new zones are not timed.");
+    }
+
+    return index;
+}
+
+static void ConsumeEvent(ProfileThread* pThread, const ProfileEvent* pEvent)
+{
+    if (pEvent->name)
+    {
+        u32 parent = pThread->stackDepth ? pThread->stack[pThread->stackDepth - 1].zone : PROFILE_NO_PARENT;
+
+        OpenZone* pOpen   = &pThread->stack[pThread->stackDepth++];
+        pOpen->name       = pEvent->name;
+        pOpen->zone       = FindZone(pEvent->name, parent);
+        pOpen->startTicks = pEvent->ticks;
+        pOpen->childTicks = 0;
+        return;
+    }
+
+    if (!pThread->stackDepth)
+        return;
+
+    const OpenZone* pOpen     = &pThread->stack[--pThread->stackDepth];
+    u64             inclusive = pEvent->ticks - pOpen->startTicks;
+    if (pThread->stackDepth)
+        pThread->stack[pThread->stackDepth - 1].childTicks += inclusive;
+
+    if (pOpen->zone != PROFILE_NO_PARENT)
+    {
+        ProfileZone* pZone = &s_pProfiler->zones[pOpen->zone];
+        ++pZone->callCount;
+        pZone->inclusiveTicks += inclusive;
+        pZone->selfTicks += inclusive - pOpen->childTicks;
+    }
+
+    if (s_pProfiler->pTraceEvents && pOpen->startTicks >= s_pProfiler->traceStartTicks &&
+        s_pProfiler->traceEventCount < PROFILE_MAX_TRACE_EVENTS)
+    {
+        TraceEvent* pTrace    = &s_pProfiler->pTraceEvents[s_pProfiler->traceEventCount++];
+        pTrace->name          = pOpen->name;
+        pTrace->startTicks    = pOpen->startTicks;
+        pTrace->durationTicks = inclusive;
+        pTrace->thread        = pThread->index;
+    }
+}
+
+static void WriteJsonString(FILE* file, const char* text)
+{
+    fputc('"', file);
+    for (const char* p = text; *p; ++p)
+    {
+        if (*p == '"' || *p == '\\')
+            fputc('\\', file);
+        fputc(*p, file);
+    }
+    fputc('"', file);
+}
+
+static bool WriteTrace()
+{
+    FILE* file = fopen(s_pProfiler->traceFileName, "w");
+    if (!file)
+    {
+        LOG_ERROR("Failed to open file: %s", s_pProfiler->traceFileName);
+        return false;
+    }
+
+    u32 threadCount = (u32) DROP_AtomicLoad32(&s_pProfiler->threadCount);
+    if (threadCount > PROFILE_MAX_THREADS)
+        threadCount = PROFILE_MAX_THREADS;
+
+    // Every entry but the first starts with a comma.
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (u32 i = 0; i < threadCount; ++i)
+    {
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}",
+                i ? "," : "", i, i);
+    }
+
+    for (u32 i = 0; i < s_pProfiler->traceEventCount; ++i)
+    {
+        const TraceEvent* pEvent = &s_pProfiler->pTraceEvents[i];
+
+        fprintf(file, "%s\n{\"name\":", i || threadCount ? "," : "");
+        WriteJsonString(file, pEvent->name);
+        fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                pEvent->thread,
+                DROP_TicksToMilliseconds(pEvent->startTicks - s_pProfiler->traceStartTicks) * 1000.0,
+                DROP_TicksToMilliseconds(pEvent->durationTicks) * 1000.0);
+    }
+    fprintf(file, "\n]}\n");
+
+    bool isWritten = !ferror(file);
+    fclose(file);
+
+    if (!isWritten)
+    {
+        LOG_ERROR("Failed to write trace: %s", s_pProfiler->traceFileName);
+        return false;
+    }
+
+    return true;
+}
+
+static void PrintZone(u32 index)
+{
+    const ProfileZone* pZone = &s_pProfiler->frameZones[index];
+    printf("%*s%-*s %8.3f ms %8.3f ms self %6u calls\n",
+           (int) pZone->depth * 2, "", 32 - (int) pZone->depth * 2, pZone->name,
+           DROP_TicksToMilliseconds(pZone->inclusiveTicks), DROP_TicksToMilliseconds(pZone->selfTicks),
+           pZone->callCount);
+
+    for (u32 i = index + 1; i < s_pProfiler->zoneCount; ++i)
+    {
+        if (s_pProfiler->frameZones[i].parent == index)
+            PrintZone(i);
+    }
+}
+#pragma endregion
+
+bool DROP_CreateProfiler()
+{
+    ASSERT_MSG(!s_pProfiler, "Profiler is already created.");
+
+    s_pProfiler = (ProfilerState*) ALLOC(ProfilerState, 1);
+    if (!s_pProfiler)
+    {
+        LOG_ERROR("Failed to allocate profiler.");
+        return false;
+    }
+    ZERO_MEM(s_pProfiler, 1);
+
+    DROP_AtomicIncrement32(&s_generation);
+
+    return true;
+}
+
+void DROP_DestroyProfiler()
+{
+    ASSERT_MSG(s_pProfiler, "Profiler is null.");
+
+    if (s_pProfiler)
+    {
+        for (u32 i = 0; i < PROFILE_MAX_THREADS; ++i)
+        {
+            if (s_pProfiler->pThreads[i]) FREE(s_pProfiler->pThreads[i]);
+        }
+        if (s_pProfiler->pTraceEvents) FREE(s_pProfiler->pTraceEvents);
+
+        FREE(s_pProfiler);
+    }
+
+    s_pProfiler = NULL;
+    DROP_AtomicIncrement32(&s_generation);
+}
+
+void DROP_ProfileBegin(const char* name)
+{
+    ASSERT_MSG(name, "Profile zone name is null.");
+
+    ProfileThread* pThread = GetThread();
+    if (!pThread)
+        return;
+
+    u32 depth = pThread->openDepth++;
+    if (depth >= PROFILE_MAX_DEPTH)
+        return;
+
+    u32 usedCount = (u32) DROP_AtomicLoad32(&pThread->writeIndex) - (u32) DROP_AtomicLoad32(&pThread->readIndex);
+    if (usedCount + pThread->reservedCount + 2 > PROFILE_THREAD_EVENTS)
+    {
+        pThread->pushedMask &= ~(1ull << depth);
+        return;
+    }
+
+    PushEvent(pThread, name);
+    pThread->pushedMask |= 1ull << depth;
+    ++pThread->reservedCount;
+}
+
+void DROP_ProfileEnd()
+{
+    ProfileThread* pThread = GetThread();
+    if (!pThread)
+        return;
+
+    ASSERT_MSG(pThread->openDepth > 0, "Profile zone ended without a begin.");
+    if (!pThread->openDepth)
+        return;
+
+    u32 depth = --pThread->openDepth;
+    if (depth >= PROFILE_MAX_DEPTH || !((pThread->pushedMask >> depth) & 1))
+        return;
+
+    PushEvent(pThread, NULL);
+    --pThread->reservedCount;
+}
+
+void DROP_ProfileEndFrame()
+{
+    if (!s_pProfiler)
+        return;
+
+    u32 threadCount = (u32) DROP_AtomicLoad32(&s_pProfiler->threadCount);
+    if (threadCount > PROFILE_MAX_THREADS)
+        threadCount = PROFILE_MAX_THREADS;
+
+    for (u32 i = 0; i < threadCount; ++i)
+    {
+        ProfileThread* pThread = (ProfileThread*) DROP_AtomicLoadPointer((void* volatile*) &s_pProfiler->pThreads[i]);
+        if (!pThread)
+            continue;
+
+        u32 read  = (u32) pThread->readIndex;
+        u32 write = (u32) DROP_AtomicLoad32(&pThread->writeIndex);
+        for (; read != write; ++read)
+            ConsumeEvent(pThread, &pThread->events[read & (PROFILE_THREAD_EVENTS - 1)]);
+
+        DROP_AtomicStore32(&pThread->readIndex, (i32) read);
+    }
+
+    // Zones that didn't run this frame stay in the tree with zero time.
+    memcpy(s_pProfiler->frameZones, s_pProfiler->zones, sizeof(ProfileZone) * s_pProfiler->zoneCount);
+    for (u32 i = 0; i < s_pProfiler->zoneCount; ++i)
+    {
+        s_pProfiler->zones[i].callCount      = 0;
+        s_pProfiler->zones[i].inclusiveTicks = 0;
+        s_pProfiler->zones[i].selfTicks      = 0;
+    }
+
+    if (s_pProfiler->pTraceEvents && --s_pProfiler->traceFramesLeft == 0)
+    {
+        if (s_pProfiler->traceEventCount == PROFILE_MAX_TRACE_EVENTS)
+        {
+            LOG_WARN("Trace event buffer was full, the trace is cut short.");
+        }
+        if (WriteTrace())
+        {
+            LOG_TRACE("Wrote %u trace events to %s.", s_pProfiler->traceEventCount, s_pProfiler->traceFileName);
+        }
+
+        FREE(s_pProfiler->pTraceEvents);
+        s_pProfiler->pTraceEvents = NULL;
+    }
+}
+
+const ProfileZone* DROP_GetProfileZones(u32* pCount)
+{
+    ASSERT_MSG(pCount, "Zone count pointer is null.");
+
+    *pCount = s_pProfiler ? s_pProfiler->zoneCount : 0;
+    return s_pProfiler ? s_pProfiler->frameZones : NULL;
+}
+
+void DROP_PrintProfileZones()
+{
+    if (!s_pProfiler)
+        return;
+
+    for (u32 i = 0; i < s_pProfiler->zoneCount; ++i)
+    {
+        if (s_pProfiler->frameZones[i].parent == PROFILE_NO_PARENT)
+            PrintZone(i);
+    }
+}
+
+bool DROP_BeginProfileTrace(const char* fileName, u32 frameCount)
+{
+    ASSERT_MSG(s_pProfiler, "Profiler is null.");
+    ASSERT_MSG(fileName, "Trace file name is null.");
+    ASSERT_MSG(frameCount > 0, "Trace frame count must be greater than zero.");
+
+    if (!s_pProfiler || s_pProfiler->pTraceEvents)
+    {
+        LOG_ERROR("A trace is already recording or the profiler is missing.");
+        return false;
+    }
+
+    if (strlen(fileName) >= PROFILE_FILE_NAME_SIZE)
+    {
+        LOG_ERROR("Trace file name is too long: %s", fileName);
+        return false;
+    }
+
+    s_pProfiler->pTraceEvents = (TraceEvent*) ALLOC(TraceEvent, PROFILE_MAX_TRACE_EVENTS);
+    if (!s_pProfiler->pTraceEvents)
+    {
+        LOG_ERROR("Failed to allocate trace events.");
+        return false;
+    }
+
+    strcpy(s_pProfiler->traceFileName, fileName);
+    s_pProfiler->traceEventCount = 0;
+    s_pProfiler->traceFramesLeft = frameCount;
+    s_pProfiler->traceStartTicks = DROP_GetTicks();
+
+    return true;
+}
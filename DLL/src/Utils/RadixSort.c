@@ -0,0 +1,167 @@
+#include "pch.h"
+#include "Utils/RadixSort.h"
+
+#include "Utils/JobSystem.h"
+
+#pragma region INTERNAL
+// Smallest block handed to a job, below that the sort runs in one block.
+#define RADIX_SORT_MIN_BLOCK_SIZE 4096
+
+typedef struct
+{
+    RadixSort* pSort;
+    u32        count;
+    const u64* pKeys;
+    const u32* pValues;
+    u64*       pOutKeys;
+    u32*       pOutValues;
+    u32        shift;
+} RadixPass;
+
+static void HistogramJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    RadixPass* pPass = (RadixPass*) pUserData;
+    RadixSort* pSort = pPass->pSort;
+    UNUSED(threadIndex);
+
+    for (u32 block = begin; block < end; ++block)
+    {
+        u32* pHistogram = pSort->pHistograms[block];
+        memset(pHistogram, 0, sizeof(u32) * 256);
+
+        u32 first = block * pSort->blockSize;
+        u32 last  = first + pSort->blockSize < pPass->count ? first + pSort->blockSize : pPass->count;
+        for (u32 i = first; i < last; ++i)
+            ++pHistogram[(pPass->pKeys[i] >> pPass->shift) & 0xFF];
+    }
+}
+
+// Each block scatters in order from its own offsets, which keeps the sort stable.
+static void ScatterJob(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    RadixPass* pPass = (RadixPass*) pUserData;
+    RadixSort* pSort = pPass->pSort;
+    UNUSED(threadIndex);
+
+    for (u32 block = begin; block < end; ++block)
+    {
+        u32* pOffsets = pSort->pHistograms[block];
+
+        u32 first = block * pSort->blockSize;
+        u32 last  = first + pSort->blockSize < pPass->count ? first + pSort->blockSize : pPass->count;
+        for (u32 i = first; i < last; ++i)
+        {
+            u64 key    = pPass->pKeys[i];
+            u32 target = pOffsets[(key >> pPass->shift) & 0xFF]++;
+
+            pPass->pOutKeys[target]   = key;
+            pPass->pOutValues[target] = pPass->pValues[i];
+        }
+    }
+}
+#pragma endregion
+
+bool DROP_MakeRadixSort(RadixSort* pSort, u32 maxCount)
+{
+    ASSERT_MSG(pSort, "Radix sort pointer is null.");
+    ASSERT_MSG(maxCount > 0, "Radix sort capacity must be greater than zero.");
+
+    ZERO_MEM(pSort, 1);
+
+    pSort->pKeys          = (u64*) ALLOC(u64, maxCount);
+    pSort->pValues        = (u32*) ALLOC(u32, maxCount);
+    pSort->pScratchKeys   = (u64*) ALLOC(u64, maxCount);
+    pSort->pScratchValues = (u32*) ALLOC(u32, maxCount);
+    pSort->pHistograms    = (u32(*)[256]) ALLOC(u32, 256 * RADIX_SORT_MAX_BLOCKS);
+    pSort->maxCount       = maxCount;
+    if (!pSort->pKeys || !pSort->pValues || !pSort->pScratchKeys || !pSort->pScratchValues || !pSort->pHistograms)
+    {
+        LOG_ERROR("Failed to allocate radix sort storage.");
+        DROP_DestroyRadixSort(pSort);
+        return false;
+    }
+
+    return true;
+}
+
+void DROP_DestroyRadixSort(RadixSort* pSort)
+{
+    ASSERT_MSG(pSort, "Radix sort is null.");
+
+    if (pSort->pHistograms) FREE(pSort->pHistograms);
+    if (pSort->pScratchValues) FREE(pSort->pScratchValues);
+    if (pSort->pScratchKeys) FREE(pSort->pScratchKeys);
+    if (pSort->pValues) FREE(pSort->pValues);
+    if (pSort->pKeys) FREE(pSort->pKeys);
+
+    ZERO_MEM(pSort, 1);
+}
+
+void DROP_RadixSort(RadixSort* pSort, u32 count)
+{
+    ASSERT_MSG(pSort, "Radix sort is null.");
+    ASSERT_MSG(count <= pSort->maxCount, "Radix sort count is past its capacity.");
+
+    if (count < 2)
+        return;
+
+    u32 blockSize = (count + RADIX_SORT_MAX_BLOCKS - 1) / RADIX_SORT_MAX_BLOCKS;
+    if (blockSize < RADIX_SORT_MIN_BLOCK_SIZE)
+        blockSize = RADIX_SORT_MIN_BLOCK_SIZE;
+    pSort->blockSize  = blockSize;
+    pSort->blockCount = (count + blockSize - 1) / blockSize;
+
+    // Bytes that are the same in every key don't need a pass.
+    u64 varying = 0;
+    for (u32 i = 1; i < count; ++i)
+        varying |= pSort->pKeys[i] ^ pSort->pKeys[0];
+
+    RadixPass pass = {
+        .pSort      = pSort,
+        .count      = count,
+        .pKeys      = pSort->pKeys,
+        .pValues    = pSort->pValues,
+        .pOutKeys   = pSort->pScratchKeys,
+        .pOutValues = pSort->pScratchValues};
+
+    for (u32 shift = 0; shift < 64; shift += 8)
+    {
+        if (!((varying >> shift) & 0xFF))
+            continue;
+
+        pass.shift = shift;
+        DROP_ParallelFor(pSort->blockCount, 1, HistogramJob, &pass);
+
+        // Turn the counts into the first output slot of every digit for every block.
+        u32 offset = 0;
+        for (u32 digit = 0; digit < 256; ++digit)
+        {
+            for (u32 block = 0; block < pSort->blockCount; ++block)
+            {
+                u32 blockCount                   = pSort->pHistograms[block][digit];
+                pSort->pHistograms[block][digit] = offset;
+                offset += blockCount;
+            }
+        }
+
+        DROP_ParallelFor(pSort->blockCount, 1, ScatterJob, &pass);
+
+        const u64* pKeys   = pass.pKeys;
+        const u32* pValues = pass.pValues;
+        pass.pKeys         = pass.pOutKeys;
+        pass.pValues       = pass.pOutValues;
+        pass.pOutKeys      = (u64*) pKeys;
+        pass.pOutValues    = (u32*) pValues;
+    }
+
+    // An odd number of passes leaves the result in the scratch arrays.
+    if (pass.pKeys != pSort->pKeys)
+    {
+        u64* pKeys            = pSort->pKeys;
+        u32* pValues          = pSort->pValues;
+        pSort->pKeys          = pSort->pScratchKeys;
+        pSort->pValues        = pSort->pScratchValues;
+        pSort->pScratchKeys   = pKeys;
+        pSort->pScratchValues = pValues;
+    }
+}
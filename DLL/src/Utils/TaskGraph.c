@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "Utils/TaskGraph.h"
+
+#include "Utils/JobSystem.h"
+#include "Platform/Timer.h"
+
+#pragma region INTERNAL
+static bool IsReady(const TaskGraph* pGraph, const Task* pTask)
+{
+    for (u32 i = 0; i < pTask->dependencyCount; ++i)
+    {
+        if (DROP_AtomicLoad32(&pGraph->tasks[pTask->dependencies[i]].state) != TASK_STATE_DONE)
+            return false;
+    }
+    return true;
+}
+
+// Claims the first ready task the thread may run, the compare exchange settles races with the others.
+static Task* ClaimTask(TaskGraph* pGraph, u32 threadIndex)
+{
+    for (u32 i = 0; i < pGraph->taskCount; ++i)
+    {
+        Task* pTask = &pGraph->tasks[i];
+        if (DROP_AtomicLoad32(&pTask->state) != TASK_STATE_PENDING || (pTask->desc.isMainThread && threadIndex != 0) ||
+            !IsReady(pGraph, pTask))
+            continue;
+
+        if (DROP_AtomicCompareExchange32(&pTask->state, TASK_STATE_RUNNING, TASK_STATE_PENDING) == TASK_STATE_PENDING)
+            return pTask;
+    }
+    return NULL;
+}
+
+static bool IsFinished(TaskGraph* pGraph)
+{
+    return DROP_AtomicLoad32(&pGraph->isFailed) || (u32) DROP_AtomicLoad32(&pGraph->doneCount) == pGraph->taskCount;
+}
+
+// A task that ends can make others ready or end the run, every other thread looks again. Each one has a
+// semaphore of its own so no thread can take the wake up of another.
+static void WakeOtherThreads(TaskGraph* pGraph, u32 threadIndex)
+{
+    for (u32 i = 0; i < DROP_GetJobThreadCount(); ++i)
+    {
+        if (i != threadIndex)
+            DROP_SignalSemaphore(pGraph->wakeSemaphores[i], 1);
+    }
+}
+
+// Every thread of the job system runs this once and leaves when nothing is left to start.
+static void RunTasks(void* pUserData, u32 begin, u32 end, u32 threadIndex)
+{
+    TaskGraph* pGraph = (TaskGraph*) pUserData;
+    UNUSED(begin);
+    UNUSED(end);
+
+    while (!IsFinished(pGraph))
+    {
+        Task* pTask = ClaimTask(pGraph, threadIndex);
+        if (!pTask)
+        {
+            // Whatever is left waits on a running task or on the main thread, sleep until one ends.
+            DROP_WaitSemaphore(pGraph->wakeSemaphores[threadIndex]);
+            continue;
+        }
+
+        pTask->threadIndex = threadIndex;
+        pTask->startTicks  = DROP_GetTicks();
+        bool isDone        = pTask->desc.Run(pTask->desc.pUserData);
+        pTask->endTicks    = DROP_GetTicks();
+
+        if (!isDone)
+        {
+            LOG_ERROR("Task %s failed.", pTask->desc.name);
+            DROP_AtomicExchange32(&pTask->state, TASK_STATE_FAILED);
+            DROP_AtomicExchange32(&pGraph->isFailed, 1);
+            WakeOtherThreads(pGraph, threadIndex);
+            continue;
+        }
+
+        // The slot is taken before the state is published, cleanup never sees a done task unlisted.
+        u32 slot                = (u32) DROP_AtomicIncrement32(&pGraph->doneCount) - 1;
+        pGraph->doneOrder[slot] = (u32) (pTask - pGraph->tasks);
+        DROP_AtomicExchange32(&pTask->state, TASK_STATE_DONE);
+        WakeOtherThreads(pGraph, threadIndex);
+    }
+}
+#pragma endregion
+
+void DROP_InitTaskGraph(TaskGraph* pGraph)
+{
+    ASSERT_MSG(pGraph, "Task graph is null.");
+
+    ZERO_MEM(pGraph, 1);
+}
+
+bool DROP_AddTask(
+    TaskGraph* pGraph, const TaskDesc* pDesc, const u32* pDependencies, u32 dependencyCount, u32* pTaskId)
+{
+    ASSERT_MSG(pGraph, "Task graph is null.");
+    ASSERT_MSG(pDesc && pDesc->name && pDesc->Run, "Task description is invalid.");
+    ASSERT_MSG(pDependencies || dependencyCount == 0, "Task dependencies are null.");
+
+    if (pGraph->taskCount == TASK_GRAPH_MAX_TASKS || dependencyCount > TASK_GRAPH_MAX_DEPENDENCIES)
+    {
+        LOG_ERROR("Task graph has no room for task %s.", pDesc->name);
+        return false;
+    }
+
+    Task* pTask = &pGraph->tasks[pGraph->taskCount];
+    for (u32 i = 0; i < dependencyCount; ++i)
+    {
+        if (pDependencies[i] >= pGraph->taskCount)
+        {
+            LOG_ERROR("Task %s depends on a task added after it.", pDesc->name);
+            return false;
+        }
+        pTask->dependencies[i] = pDependencies[i];
+    }
+
+    pTask->desc            = *pDesc;
+    pTask->dependencyCount = dependencyCount;
+    pTask->state           = TASK_STATE_PENDING;
+    if (pTaskId)
+        *pTaskId = pGraph->taskCount;
+    ++pGraph->taskCount;
+
+    return true;
+}
+
+bool DROP_RunTaskGraph(TaskGraph* pGraph)
+{
+    ASSERT_MSG(pGraph, "Task graph is null.");
+    ASSERT_MSG(pGraph->doneCount == 0, "Task graph already ran.");
+
+    u32 threadCount = DROP_GetJobThreadCount();
+    ASSERT_MSG(threadCount <= TASK_GRAPH_MAX_THREADS, "Too many threads for a task graph.");
+    for (u32 i = 0; i < threadCount; ++i)
+    {
+        if (!DROP_CreateSemaphore(0, &pGraph->wakeSemaphores[i]))
+        {
+            LOG_ERROR("Failed to create task graph semaphore.");
+            for (u32 j = 0; j < i; ++j)
+                DROP_DestroySemaphore(&pGraph->wakeSemaphores[j]);
+            return false;
+        }
+    }
+
+    pGraph->startTicks = DROP_GetTicks();
+    DROP_ParallelFor(threadCount, 1, RunTasks, pGraph);
+    pGraph->endTicks = DROP_GetTicks();
+
+    for (u32 i = 0; i < threadCount; ++i)
+        DROP_DestroySemaphore(&pGraph->wakeSemaphores[i]);
+
+    if (pGraph->isFailed)
+    {
+        DROP_CleanupTaskGraph(pGraph);
+        return false;
+    }
+
+    return true;
+}
+
+void DROP_CleanupTaskGraph(TaskGraph* pGraph)
+{
+    ASSERT_MSG(pGraph, "Task graph is null.");
+
+    for (u32 i = (u32) pGraph->doneCount; i-- > 0;)
+    {
+        Task* pTask = &pGraph->tasks[pGraph->doneOrder[i]];
+        if (pTask->desc.Cleanup)
+            pTask->desc.Cleanup(pTask->desc.pUserData);
+    }
+    pGraph->doneCount = 0;
+}
+
+void DROP_PrintTaskGraph(const TaskGraph* pGraph)
+{
+    ASSERT_MSG(pGraph, "Task graph is null.");
+
+    LOG_TRACE("Task graph: %u tasks in %.3f ms on %u threads.", pGraph->taskCount,
+              DROP_TicksToMilliseconds(pGraph->endTicks - pGraph->startTicks), DROP_GetJobThreadCount());
+    for (u32 i = 0; i < pGraph->taskCount; ++i)
+    {
+        const Task* pTask = &pGraph->tasks[i];
+        if (pTask->state == TASK_STATE_PENDING)
+            continue;
+
+        LOG_TRACE("  %-24s %8.3f ms -> %8.3f ms  thread %u%s", pTask->desc.name,
+                  DROP_TicksToMilliseconds(pTask->startTicks - pGraph->startTicks),
+                  DROP_TicksToMilliseconds(pTask->endTicks - pGraph->startTicks), pTask->threadIndex,
+                  pTask->state == TASK_STATE_FAILED ? "  failed" : "");
+    }
+}
@@ -0,0 +1,214 @@
+#include "Replay.h"
+
+#pragma region INTERNAL
+typedef struct
+{
+    const Capture* pCapture;
+    u8**           ppShadows; // Per object, only buffers have one.
+
+    // Bound state, by object id.
+    u32 shaders[CAPTURE_STAGE_COUNT];
+    u32 shaderResources[CAPTURE_STAGE_COUNT][REPLAY_SHADER_RESOURCE_SLOTS];
+    u32 samplers[CAPTURE_STAGE_COUNT][REPLAY_SAMPLER_SLOTS];
+    u32 constantBuffers[CAPTURE_STAGE_COUNT][REPLAY_CONSTANT_BUFFER_SLOTS];
+    u32 vertexBuffers[REPLAY_VERTEX_BUFFER_SLOTS];
+    u32 renderTargets[REPLAY_RENDER_TARGET_SLOTS];
+    u32 inputLayout;
+    u32 topology;
+
+    ReplayCounters counters;
+} CounterBackend;
+
+// Binds the ids to the slots and returns how many didn't change anything.
+static u32 BindSlots(u32* pSlots, u32 start, u32 count, const u32* pIds, u32 stride)
+{
+    u32 redundant = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 id = pIds[i * stride];
+        redundant += pSlots[start + i] == id;
+        pSlots[start + i] = id;
+    }
+    return redundant;
+}
+
+static void Execute(void* pUserData, const CaptureCommand* pCommand, const u32* pPayload)
+{
+    CounterBackend* pBackend = (CounterBackend*) pUserData;
+    ReplayCounters* pCounts  = &pBackend->counters;
+    ++pCounts->commandCounts[pCommand->type];
+
+    u32 bindCount = 0;
+    u32 redundant = 0;
+
+    switch (pCommand->type)
+    {
+    case CAPTURE_CMD_SET_RENDER_TARGETS:
+        // Every slot past the count is unbound.
+        bindCount = pPayload[0];
+        redundant = BindSlots(pBackend->renderTargets, 0, pPayload[0], &pPayload[2], 1);
+        memset(&pBackend->renderTargets[pPayload[0]], 0, sizeof(u32) * (REPLAY_RENDER_TARGET_SLOTS - pPayload[0]));
+        break;
+    case CAPTURE_CMD_SET_SHADER:
+        bindCount                      = 1;
+        redundant                      = pBackend->shaders[pPayload[0]] == pPayload[1];
+        pBackend->shaders[pPayload[0]] = pPayload[1];
+        break;
+    case CAPTURE_CMD_SET_SHADER_RESOURCES:
+        bindCount = pPayload[2];
+        redundant = BindSlots(pBackend->shaderResources[pPayload[0]], pPayload[1], pPayload[2], &pPayload[3], 1);
+        break;
+    case CAPTURE_CMD_SET_SAMPLERS:
+        bindCount = pPayload[2];
+        redundant = BindSlots(pBackend->samplers[pPayload[0]], pPayload[1], pPayload[2], &pPayload[3], 1);
+        break;
+    case CAPTURE_CMD_SET_CONSTANT_BUFFERS:
+        bindCount = pPayload[2];
+        redundant = BindSlots(pBackend->constantBuffers[pPayload[0]], pPayload[1], pPayload[2], &pPayload[3], 1);
+        break;
+    case CAPTURE_CMD_SET_INPUT_LAYOUT:
+        bindCount             = 1;
+        redundant             = pBackend->inputLayout == pPayload[0];
+        pBackend->inputLayout = pPayload[0];
+        break;
+    case CAPTURE_CMD_SET_VERTEX_BUFFERS:
+        bindCount = pPayload[1];
+        redundant = BindSlots(pBackend->vertexBuffers, pPayload[0], pPayload[1], &pPayload[2], 3);
+        break;
+    case CAPTURE_CMD_SET_TOPOLOGY:
+        bindCount          = 1;
+        redundant          = pBackend->topology == pPayload[0];
+        pBackend->topology = pPayload[0];
+        break;
+    case CAPTURE_CMD_DRAW:
+    case CAPTURE_CMD_DRAW_INDEXED:
+        ++pCounts->drawCount;
+        pCounts->vertexCount += pPayload[0];
+        break;
+    case CAPTURE_CMD_DRAW_INSTANCED:
+    case CAPTURE_CMD_DRAW_INDEXED_INSTANCED:
+        ++pCounts->drawCount;
+        pCounts->vertexCount += (u64) pPayload[0] * pPayload[1];
+        break;
+    case CAPTURE_CMD_UPDATE_RESOURCE:
+        memcpy(pBackend->ppShadows[pPayload[0] - 1] + pPayload[3], &pPayload[5], pPayload[4]);
+        pCounts->uploadBytes += pPayload[4];
+        break;
+    default:
+        break;
+    }
+
+    pCounts->bindCount += bindCount;
+    pCounts->redundantBindCount += redundant;
+}
+
+static void EndFrame(void* pUserData)
+{
+    CounterBackend* pBackend = (CounterBackend*) pUserData;
+    ++pBackend->counters.frameCount;
+}
+#pragma endregion
+
+bool DROP_CreateCounterBackend(const Capture* pCapture, ReplayBackend* pBackend)
+{
+    ASSERT_MSG(pCapture && pCapture->pHeader, "Capture is not loaded.");
+    ASSERT_MSG(pBackend, "Replay backend pointer is null.");
+
+    ZERO_MEM(pBackend, 1);
+
+    CounterBackend* pCounter = (CounterBackend*) ALLOC(CounterBackend, 1);
+    if (!pCounter)
+    {
+        fprintf(stderr, "Failed to allocate counter backend.\n");
+        return false;
+    }
+    ZERO_MEM(pCounter, 1);
+    pCounter->pCapture = pCapture;
+
+    pBackend->name      = "counter";
+    pBackend->pUserData = pCounter;
+    pBackend->Execute   = Execute;
+    pBackend->EndFrame  = EndFrame;
+
+    u32 objectCount     = pCapture->pHeader->objectCount;
+    pCounter->ppShadows = (u8**) ALLOC(u8*, objectCount ? objectCount : 1);
+    if (!pCounter->ppShadows)
+    {
+        fprintf(stderr, "Failed to allocate buffer shadows.\n");
+        DROP_DestroyCounterBackend(pBackend);
+        return false;
+    }
+    ZERO_MEM(pCounter->ppShadows, objectCount);
+
+    for (u32 i = 0; i < objectCount; ++i)
+    {
+        const CaptureObject* pObject = &pCapture->pObjects[i];
+        if (pObject->kind != CAPTURE_OBJECT_BUFFER || !pObject->params[0])
+            continue;
+
+        pCounter->ppShadows[i] = (u8*) ALLOC(u8, pObject->params[0]);
+        if (!pCounter->ppShadows[i])
+        {
+            fprintf(stderr, "Failed to allocate buffer shadow of %u bytes.\n", pObject->params[0]);
+            DROP_DestroyCounterBackend(pBackend);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DROP_DestroyCounterBackend(ReplayBackend* pBackend)
+{
+    ASSERT_MSG(pBackend, "Replay backend pointer is null.");
+
+    CounterBackend* pCounter = (CounterBackend*) pBackend->pUserData;
+    if (pCounter)
+    {
+        if (pCounter->ppShadows)
+        {
+            for (u32 i = 0; i < pCounter->pCapture->pHeader->objectCount; ++i)
+            {
+                if (pCounter->ppShadows[i]) FREE(pCounter->ppShadows[i]);
+            }
+            FREE(pCounter->ppShadows);
+        }
+
+        FREE(pCounter);
+    }
+
+    ZERO_MEM(pBackend, 1);
+}
+
+void DROP_ResetCounters(ReplayBackend* pBackend)
+{
+    ASSERT_MSG(pBackend && pBackend->pUserData, "Replay backend is invalid.");
+
+    CounterBackend* pCounter = (CounterBackend*) pBackend->pUserData;
+    ZERO_MEM(&pCounter->counters, 1);
+}
+
+const ReplayCounters* DROP_GetCounters(const ReplayBackend* pBackend)
+{
+    ASSERT_MSG(pBackend && pBackend->pUserData, "Replay backend is invalid.");
+
+    return &((const CounterBackend*) pBackend->pUserData)->counters;
+}
+
+void DROP_PrintCounters(const ReplayBackend* pBackend)
+{
+    ASSERT_MSG(pBackend && pBackend->pUserData, "Replay backend is invalid.");
+
+    const ReplayCounters* pCounter = DROP_GetCounters(pBackend);
+    if (!pCounter->frameCount)
+        return;
+
+    u64 commandCount = 0;
+    for (u32 i = 0; i < CAPTURE_CMD_COUNT; ++i)
+        commandCount += pCounter->commandCounts[i];
+
+    f64 frames = (f64) pCounter->frameCount;
+    printf("Per frame: %.1f commands, %.1f draws, %.1f vertices, %.1f binds (%.1f redundant), %.1f bytes uploaded.\n",
+           commandCount / frames, pCounter->drawCount / frames, pCounter->vertexCount / frames,
+           pCounter->bindCount / frames, pCounter->redundantBindCount / frames, pCounter->uploadBytes / frames);
+}
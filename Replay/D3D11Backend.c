@@ -0,0 +1,529 @@
+#include "Replay.h"
+
+#ifdef _WIN32
+#pragma region INTERNAL
+typedef struct
+{
+    const Capture*       pCapture;
+    ID3D11Device*        pDevice;
+    ID3D11DeviceContext* pContext;
+    ID3D11Query*         pFrameQuery;
+    ID3D11DeviceChild**  ppObjects;    // Per object, NULL when it couldn't be created.
+    bool*                pIsDiscarded; // Per object, a dynamic buffer has to be discarded before anything else.
+} D3D11Backend;
+
+// The view of a swap chain buffer may be sRGB on a UNORM texture, anywhere else the texture has to
+// be typeless for that.
+static DXGI_FORMAT GetTypelessFormat(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB: return DXGI_FORMAT_R8G8B8A8_TYPELESS;
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB: return DXGI_FORMAT_B8G8R8A8_TYPELESS;
+    case DXGI_FORMAT_B8G8R8X8_UNORM:
+    case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB: return DXGI_FORMAT_B8G8R8X8_TYPELESS;
+    default: return format;
+    }
+}
+
+static void* ObjectOf(const D3D11Backend* pBackend, u32 id)
+{
+    return id ? pBackend->ppObjects[id - 1] : NULL;
+}
+
+static void GatherObjects(const D3D11Backend* pBackend, const u32* pIds, u32 count, u32 stride, void** ppObjects)
+{
+    for (u32 i = 0; i < count; ++i)
+        ppObjects[i] = ObjectOf(pBackend, pIds[i * stride]);
+}
+
+static ID3D11DeviceChild* CreateBuffer(D3D11Backend* pBackend, u32 id)
+{
+    const CaptureObject* pObject  = &pBackend->pCapture->pObjects[id - 1];
+    u32                  dataSize = 0;
+    const void*          pData    = DROP_GetObjectData(pBackend->pCapture, id, &dataSize);
+
+    D3D11_BUFFER_DESC desc = {
+        .ByteWidth           = pObject->params[0],
+        .Usage               = (D3D11_USAGE) pObject->params[1],
+        .BindFlags           = pObject->params[2],
+        .CPUAccessFlags      = pObject->params[3],
+        .MiscFlags           = pObject->params[4],
+        .StructureByteStride = pObject->params[5]};
+
+    // An immutable buffer can't be created without its contents.
+    if (desc.Usage == D3D11_USAGE_IMMUTABLE && !pData)
+        desc.Usage = D3D11_USAGE_DEFAULT;
+
+    ID3D11Device*          pDevice     = pBackend->pDevice;
+    D3D11_SUBRESOURCE_DATA initialData = {.pSysMem = pData};
+    ID3D11Buffer*          pBuffer     = NULL;
+    if (FAILED(pDevice->lpVtbl->CreateBuffer(pDevice, &desc, pData ? &initialData : NULL, &pBuffer)))
+        return NULL;
+    return (ID3D11DeviceChild*) pBuffer;
+}
+
+static ID3D11DeviceChild* CreateTexture2D(D3D11Backend* pBackend, u32 id)
+{
+    const Capture*       pCapture = pBackend->pCapture;
+    const CaptureObject* pObject  = &pCapture->pObjects[id - 1];
+
+    D3D11_TEXTURE2D_DESC desc = {
+        .Width            = pObject->params[0],
+        .Height           = pObject->params[1],
+        .MipLevels        = pObject->params[2],
+        .ArraySize        = pObject->params[3],
+        .Format           = (DXGI_FORMAT) pObject->params[4],
+        .SampleDesc.Count = 1,
+        .Usage            = D3D11_USAGE_DEFAULT,
+        .BindFlags        = pObject->params[5]};
+
+    // Views come after their texture in the table.
+    for (u32 i = id; i < pCapture->pHeader->objectCount; ++i)
+    {
+        const CaptureObject* pView = &pCapture->pObjects[i];
+        if (pView->parent == id && (pView->kind == CAPTURE_OBJECT_RTV || pView->kind == CAPTURE_OBJECT_SRV) &&
+            pView->params[0] && pView->params[0] != pObject->params[4])
+        {
+            desc.Format = GetTypelessFormat(desc.Format);
+            break;
+        }
+    }
+
+    ID3D11Texture2D* pTexture = NULL;
+    if (FAILED(pBackend->pDevice->lpVtbl->CreateTexture2D(pBackend->pDevice, &desc, NULL, &pTexture)))
+        return NULL;
+
+    // Only the first subresource is captured, the texture can't be created with it.
+    u32         dataSize = 0;
+    const void* pData    = DROP_GetObjectData(pCapture, id, &dataSize);
+    if (pData)
+    {
+        pBackend->pContext->lpVtbl->UpdateSubresource(
+            pBackend->pContext, (ID3D11Resource*) pTexture, 0, NULL, pData, dataSize / desc.Height, 0);
+    }
+    return (ID3D11DeviceChild*) pTexture;
+}
+
+static ID3D11DeviceChild* CreateView(D3D11Backend* pBackend, u32 id)
+{
+    const CaptureObject* pObject   = &pBackend->pCapture->pObjects[id - 1];
+    ID3D11Resource*      pResource = (ID3D11Resource*) ObjectOf(pBackend, pObject->parent);
+    if (!pResource || pBackend->pCapture->pObjects[pObject->parent - 1].kind != CAPTURE_OBJECT_TEXTURE2D)
+        return NULL;
+
+    // Without a format of its own the view takes the one the texture was captured with.
+    DXGI_FORMAT format = (DXGI_FORMAT) pObject->params[0];
+    if (!format)
+        format = (DXGI_FORMAT) pBackend->pCapture->pObjects[pObject->parent - 1].params[4];
+
+    ID3D11Device* pDevice = pBackend->pDevice;
+    if (pObject->kind == CAPTURE_OBJECT_RTV)
+    {
+        D3D11_RENDER_TARGET_VIEW_DESC desc = {
+            .Format             = format,
+            .ViewDimension      = D3D11_RTV_DIMENSION_TEXTURE2D,
+            .Texture2D.MipSlice = pObject->params[1]};
+
+        ID3D11RenderTargetView* pRTV = NULL;
+        if (FAILED(pDevice->lpVtbl->CreateRenderTargetView(pDevice, pResource, &desc, &pRTV)))
+            return NULL;
+        return (ID3D11DeviceChild*) pRTV;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC desc = {
+        .Format                    = format,
+        .ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D,
+        .Texture2D.MostDetailedMip = pObject->params[1],
+        .Texture2D.MipLevels       = pObject->params[2]};
+
+    ID3D11ShaderResourceView* pSRV = NULL;
+    if (FAILED(pDevice->lpVtbl->CreateShaderResourceView(pDevice, pResource, &desc, &pSRV)))
+        return NULL;
+    return (ID3D11DeviceChild*) pSRV;
+}
+
+static ID3D11DeviceChild* CreateSampler(D3D11Backend* pBackend, u32 id)
+{
+    const CaptureObject* pObject = &pBackend->pCapture->pObjects[id - 1];
+
+    D3D11_SAMPLER_DESC desc = {
+        .Filter         = (D3D11_FILTER) pObject->params[0],
+        .AddressU       = (D3D11_TEXTURE_ADDRESS_MODE) pObject->params[1],
+        .AddressV       = (D3D11_TEXTURE_ADDRESS_MODE) pObject->params[2],
+        .AddressW       = (D3D11_TEXTURE_ADDRESS_MODE) pObject->params[3],
+        .MaxAnisotropy  = 1,
+        .ComparisonFunc = D3D11_COMPARISON_NEVER,
+        .MaxLOD         = D3D11_FLOAT32_MAX};
+
+    ID3D11SamplerState* pSampler = NULL;
+    if (FAILED(pBackend->pDevice->lpVtbl->CreateSamplerState(pBackend->pDevice, &desc, &pSampler)))
+        return NULL;
+    return (ID3D11DeviceChild*) pSampler;
+}
+
+static ID3D11DeviceChild* CreateShader(D3D11Backend* pBackend, u32 id)
+{
+    u32         dataSize = 0;
+    const void* pData    = DROP_GetObjectData(pBackend->pCapture, id, &dataSize);
+    if (!pData)
+        return NULL;
+
+    ID3D11Device* pDevice = pBackend->pDevice;
+    if (pBackend->pCapture->pObjects[id - 1].kind == CAPTURE_OBJECT_VERTEX_SHADER)
+    {
+        ID3D11VertexShader* pShader = NULL;
+        if (FAILED(pDevice->lpVtbl->CreateVertexShader(pDevice, pData, dataSize, NULL, &pShader)))
+            return NULL;
+        return (ID3D11DeviceChild*) pShader;
+    }
+
+    ID3D11PixelShader* pShader = NULL;
+    if (FAILED(pDevice->lpVtbl->CreatePixelShader(pDevice, pData, dataSize, NULL, &pShader)))
+        return NULL;
+    return (ID3D11DeviceChild*) pShader;
+}
+
+static ID3D11DeviceChild* CreateInputLayout(D3D11Backend* pBackend, u32 id)
+{
+    u32       dataSize = 0;
+    const u8* pData    = (const u8*) DROP_GetObjectData(pBackend->pCapture, id, &dataSize);
+    if (!pData)
+        return NULL;
+
+    const CaptureInputLayout*  pLayout   = (const CaptureInputLayout*) pData;
+    const CaptureInputElement* pCaptured = (const CaptureInputElement*) (pLayout + 1);
+
+    D3D11_INPUT_ELEMENT_DESC* pElements =
+        (D3D11_INPUT_ELEMENT_DESC*) ALLOC(D3D11_INPUT_ELEMENT_DESC, pLayout->elementCount ? pLayout->elementCount : 1);
+    if (!pElements)
+        return NULL;
+
+    for (u32 i = 0; i < pLayout->elementCount; ++i)
+    {
+        pElements[i] = (D3D11_INPUT_ELEMENT_DESC) {
+            .SemanticName         = pCaptured[i].semanticName,
+            .SemanticIndex        = pCaptured[i].semanticIndex,
+            .Format               = (DXGI_FORMAT) pCaptured[i].format,
+            .InputSlot            = pCaptured[i].inputSlot,
+            .AlignedByteOffset    = pCaptured[i].alignedByteOffset,
+            .InputSlotClass       = (D3D11_INPUT_CLASSIFICATION) pCaptured[i].inputSlotClass,
+            .InstanceDataStepRate = pCaptured[i].instanceDataStepRate};
+    }
+
+    ID3D11InputLayout* pInputLayout = NULL;
+
+    HRESULT hr = pBackend->pDevice->lpVtbl->CreateInputLayout(
+        pBackend->pDevice, pElements, pLayout->elementCount, &pCaptured[pLayout->elementCount], pLayout->bytecodeSize,
+        &pInputLayout);
+    FREE(pElements);
+
+    if (FAILED(hr))
+        return NULL;
+    return (ID3D11DeviceChild*) pInputLayout;
+}
+
+static ID3D11DeviceChild* CreateQuery(D3D11Backend* pBackend, u32 id)
+{
+    const CaptureObject* pObject = &pBackend->pCapture->pObjects[id - 1];
+
+    D3D11_QUERY_DESC desc = {
+        .Query     = (D3D11_QUERY) pObject->params[0],
+        .MiscFlags = pObject->params[1]};
+
+    ID3D11Query* pQuery = NULL;
+    if (FAILED(pBackend->pDevice->lpVtbl->CreateQuery(pBackend->pDevice, &desc, &pQuery)))
+        return NULL;
+    return (ID3D11DeviceChild*) pQuery;
+}
+
+static ID3D11DeviceChild* CreateObject(D3D11Backend* pBackend, u32 id)
+{
+    switch (pBackend->pCapture->pObjects[id - 1].kind)
+    {
+    case CAPTURE_OBJECT_BUFFER: return CreateBuffer(pBackend, id);
+    case CAPTURE_OBJECT_TEXTURE2D: return CreateTexture2D(pBackend, id);
+    case CAPTURE_OBJECT_RTV:
+    case CAPTURE_OBJECT_SRV: return CreateView(pBackend, id);
+    case CAPTURE_OBJECT_SAMPLER: return CreateSampler(pBackend, id);
+    case CAPTURE_OBJECT_VERTEX_SHADER:
+    case CAPTURE_OBJECT_PIXEL_SHADER: return CreateShader(pBackend, id);
+    case CAPTURE_OBJECT_INPUT_LAYOUT: return CreateInputLayout(pBackend, id);
+    case CAPTURE_OBJECT_QUERY: return CreateQuery(pBackend, id);
+    default: return NULL;
+    }
+}
+
+static void UpdateResource(D3D11Backend* pBackend, const u32* pPayload)
+{
+    ID3D11Resource*      pResource = (ID3D11Resource*) ObjectOf(pBackend, pPayload[0]);
+    ID3D11DeviceContext* pContext  = pBackend->pContext;
+    if (!pResource)
+        return;
+
+    const CaptureObject* pObject = &pBackend->pCapture->pObjects[pPayload[0] - 1];
+    if (pObject->params[1] == D3D11_USAGE_DYNAMIC)
+    {
+        D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD;
+        if (pPayload[2] == D3D11_MAP_WRITE_NO_OVERWRITE && pBackend->pIsDiscarded[pPayload[0] - 1])
+            mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        if (FAILED(pContext->lpVtbl->Map(pContext, pResource, pPayload[1], mapType, 0, &mapped)))
+            return;
+
+        memcpy((u8*) mapped.pData + pPayload[3], &pPayload[5], pPayload[4]);
+        pContext->lpVtbl->Unmap(pContext, pResource, pPayload[1]);
+        pBackend->pIsDiscarded[pPayload[0] - 1] = true;
+        return;
+    }
+
+    // Constant buffers only take whole updates, which have no box.
+    D3D11_BOX box     = {.left = pPayload[3], .right = pPayload[3] + pPayload[4], .bottom = 1, .back = 1};
+    bool      isWhole = pPayload[3] == 0 && pPayload[4] == pObject->params[0];
+    pContext->lpVtbl->UpdateSubresource(pContext, pResource, pPayload[1], isWhole ? NULL : &box, &pPayload[5], 0, 0);
+}
+
+static void Execute(void* pUserData, const CaptureCommand* pCommand, const u32* pPayload)
+{
+    D3D11Backend*        pBackend = (D3D11Backend*) pUserData;
+    ID3D11DeviceContext* pContext = pBackend->pContext;
+
+    void* pObjects[REPLAY_SHADER_RESOURCE_SLOTS];
+
+    switch (pCommand->type)
+    {
+    case CAPTURE_CMD_SET_VIEWPORTS:
+    {
+        D3D11_VIEWPORT viewports[REPLAY_VIEWPORT_SLOTS];
+        memcpy(viewports, &pPayload[1], sizeof(D3D11_VIEWPORT) * pPayload[0]);
+        pContext->lpVtbl->RSSetViewports(pContext, pPayload[0], viewports);
+        break;
+    }
+    case CAPTURE_CMD_SET_RENDER_TARGETS:
+        // Depth stencil views aren't captured.
+        GatherObjects(pBackend, &pPayload[2], pPayload[0], 1, pObjects);
+        pContext->lpVtbl->OMSetRenderTargets(pContext, pPayload[0], (ID3D11RenderTargetView* const*) pObjects, NULL);
+        break;
+    case CAPTURE_CMD_CLEAR_RENDER_TARGET:
+    {
+        ID3D11RenderTargetView* pRTV = (ID3D11RenderTargetView*) ObjectOf(pBackend, pPayload[0]);
+        f32                     color[4];
+        memcpy(color, &pPayload[1], sizeof(color));
+        if (pRTV)
+            pContext->lpVtbl->ClearRenderTargetView(pContext, pRTV, color);
+        break;
+    }
+    case CAPTURE_CMD_SET_SHADER:
+        if (pPayload[0] == CAPTURE_STAGE_VS)
+            pContext->lpVtbl->VSSetShader(pContext, (ID3D11VertexShader*) ObjectOf(pBackend, pPayload[1]), NULL, 0);
+        else
+            pContext->lpVtbl->PSSetShader(pContext, (ID3D11PixelShader*) ObjectOf(pBackend, pPayload[1]), NULL, 0);
+        break;
+    case CAPTURE_CMD_SET_SHADER_RESOURCES:
+    {
+        GatherObjects(pBackend, &pPayload[3], pPayload[2], 1, pObjects);
+        ID3D11ShaderResourceView* const* ppViews = (ID3D11ShaderResourceView* const*) pObjects;
+        if (pPayload[0] == CAPTURE_STAGE_VS)
+            pContext->lpVtbl->VSSetShaderResources(pContext, pPayload[1], pPayload[2], ppViews);
+        else
+            pContext->lpVtbl->PSSetShaderResources(pContext, pPayload[1], pPayload[2], ppViews);
+        break;
+    }
+    case CAPTURE_CMD_SET_SAMPLERS:
+    {
+        GatherObjects(pBackend, &pPayload[3], pPayload[2], 1, pObjects);
+        ID3D11SamplerState* const* ppSamplers = (ID3D11SamplerState* const*) pObjects;
+        if (pPayload[0] == CAPTURE_STAGE_VS)
+            pContext->lpVtbl->VSSetSamplers(pContext, pPayload[1], pPayload[2], ppSamplers);
+        else
+            pContext->lpVtbl->PSSetSamplers(pContext, pPayload[1], pPayload[2], ppSamplers);
+        break;
+    }
+    case CAPTURE_CMD_SET_CONSTANT_BUFFERS:
+    {
+        GatherObjects(pBackend, &pPayload[3], pPayload[2], 1, pObjects);
+        ID3D11Buffer* const* ppBuffers = (ID3D11Buffer* const*) pObjects;
+        if (pPayload[0] == CAPTURE_STAGE_VS)
+            pContext->lpVtbl->VSSetConstantBuffers(pContext, pPayload[1], pPayload[2], ppBuffers);
+        else
+            pContext->lpVtbl->PSSetConstantBuffers(pContext, pPayload[1], pPayload[2], ppBuffers);
+        break;
+    }
+    case CAPTURE_CMD_SET_INPUT_LAYOUT:
+        pContext->lpVtbl->IASetInputLayout(pContext, (ID3D11InputLayout*) ObjectOf(pBackend, pPayload[0]));
+        break;
+    case CAPTURE_CMD_SET_VERTEX_BUFFERS:
+    {
+        UINT strides[REPLAY_VERTEX_BUFFER_SLOTS];
+        UINT offsets[REPLAY_VERTEX_BUFFER_SLOTS];
+        GatherObjects(pBackend, &pPayload[2], pPayload[1], 3, pObjects);
+        for (u32 i = 0; i < pPayload[1]; ++i)
+        {
+            strides[i] = pPayload[2 + i * 3 + 1];
+            offsets[i] = pPayload[2 + i * 3 + 2];
+        }
+        pContext->lpVtbl->IASetVertexBuffers(
+            pContext, pPayload[0], pPayload[1], (ID3D11Buffer* const*) pObjects, strides, offsets);
+        break;
+    }
+    case CAPTURE_CMD_SET_INDEX_BUFFER:
+        pContext->lpVtbl->IASetIndexBuffer(
+            pContext, (ID3D11Buffer*) ObjectOf(pBackend, pPayload[0]), (DXGI_FORMAT) pPayload[1], pPayload[2]);
+        break;
+    case CAPTURE_CMD_SET_TOPOLOGY:
+        pContext->lpVtbl->IASetPrimitiveTopology(pContext, (D3D11_PRIMITIVE_TOPOLOGY) pPayload[0]);
+        break;
+    case CAPTURE_CMD_DRAW:
+        pContext->lpVtbl->Draw(pContext, pPayload[0], pPayload[1]);
+        break;
+    case CAPTURE_CMD_DRAW_INDEXED:
+        pContext->lpVtbl->DrawIndexed(pContext, pPayload[0], pPayload[1], (INT) pPayload[2]);
+        break;
+    case CAPTURE_CMD_DRAW_INSTANCED:
+        pContext->lpVtbl->DrawInstanced(pContext, pPayload[0], pPayload[1], pPayload[2], pPayload[3]);
+        break;
+    case CAPTURE_CMD_DRAW_INDEXED_INSTANCED:
+        pContext->lpVtbl->DrawIndexedInstanced(
+            pContext, pPayload[0], pPayload[1], pPayload[2], (INT) pPayload[3], pPayload[4]);
+        break;
+    case CAPTURE_CMD_UPDATE_RESOURCE:
+        UpdateResource(pBackend, pPayload);
+        break;
+    case CAPTURE_CMD_COPY_RESOURCE:
+    {
+        ID3D11Resource* pDestination = (ID3D11Resource*) ObjectOf(pBackend, pPayload[0]);
+        ID3D11Resource* pSource      = (ID3D11Resource*) ObjectOf(pBackend, pPayload[1]);
+        if (pDestination && pSource)
+            pContext->lpVtbl->CopyResource(pContext, pDestination, pSource);
+        break;
+    }
+    case CAPTURE_CMD_BEGIN_QUERY:
+    case CAPTURE_CMD_END_QUERY:
+    {
+        ID3D11Asynchronous* pQuery = (ID3D11Asynchronous*) ObjectOf(pBackend, pPayload[0]);
+        if (!pQuery)
+            break;
+
+        if (pCommand->type == CAPTURE_CMD_BEGIN_QUERY)
+            pContext->lpVtbl->Begin(pContext, pQuery);
+        else
+            pContext->lpVtbl->End(pContext, pQuery);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Waits for the GPU to finish the frame, or it would queue frames and the timings would only
+// measure the submission.
+static void EndFrame(void* pUserData)
+{
+    D3D11Backend*        pBackend = (D3D11Backend*) pUserData;
+    ID3D11DeviceContext* pContext = pBackend->pContext;
+
+    pContext->lpVtbl->End(pContext, (ID3D11Asynchronous*) pBackend->pFrameQuery);
+    while (pContext->lpVtbl->GetData(pContext, (ID3D11Asynchronous*) pBackend->pFrameQuery, NULL, 0, 0) == S_FALSE)
+        YieldProcessor();
+}
+#pragma endregion
+
+bool DROP_CreateD3D11Backend(const Capture* pCapture, bool isWarp, ReplayBackend* pBackend)
+{
+    ASSERT_MSG(pCapture && pCapture->pHeader, "Capture is not loaded.");
+    ASSERT_MSG(pBackend, "Replay backend pointer is null.");
+
+    ZERO_MEM(pBackend, 1);
+
+    D3D11Backend* pD3D11 = (D3D11Backend*) ALLOC(D3D11Backend, 1);
+    if (!pD3D11)
+    {
+        fprintf(stderr, "Failed to allocate D3D11 backend.\n");
+        return false;
+    }
+    ZERO_MEM(pD3D11, 1);
+    pD3D11->pCapture = pCapture;
+
+    pBackend->name      = isWarp ? "warp" : "d3d11";
+    pBackend->pUserData = pD3D11;
+    pBackend->Execute   = Execute;
+    pBackend->EndFrame  = EndFrame;
+
+    UINT flags = 0;
+#ifdef DEBUG
+    flags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif // DEBUG
+
+    HRESULT hr = D3D11CreateDevice(
+        NULL, isWarp ? D3D_DRIVER_TYPE_WARP : D3D_DRIVER_TYPE_HARDWARE, NULL, flags, NULL, 0, D3D11_SDK_VERSION,
+        &pD3D11->pDevice, NULL, &pD3D11->pContext);
+    if (FAILED(hr) || !pD3D11->pDevice || !pD3D11->pContext)
+    {
+        fprintf(stderr, "Failed to create the %s device.\n", pBackend->name);
+        DROP_DestroyD3D11Backend(pBackend);
+        return false;
+    }
+
+    D3D11_QUERY_DESC queryDesc = {.Query = D3D11_QUERY_EVENT};
+    hr = pD3D11->pDevice->lpVtbl->CreateQuery(pD3D11->pDevice, &queryDesc, &pD3D11->pFrameQuery);
+    if (FAILED(hr))
+    {
+        fprintf(stderr, "Failed to create the frame query.\n");
+        DROP_DestroyD3D11Backend(pBackend);
+        return false;
+    }
+
+    u32 objectCount      = pCapture->pHeader->objectCount;
+    pD3D11->ppObjects    = (ID3D11DeviceChild**) ALLOC(ID3D11DeviceChild*, objectCount ? objectCount : 1);
+    pD3D11->pIsDiscarded = (bool*) ALLOC(bool, objectCount ? objectCount : 1);
+    if (!pD3D11->ppObjects || !pD3D11->pIsDiscarded)
+    {
+        fprintf(stderr, "Failed to allocate the object table.\n");
+        DROP_DestroyD3D11Backend(pBackend);
+        return false;
+    }
+    ZERO_MEM(pD3D11->ppObjects, objectCount);
+    ZERO_MEM(pD3D11->pIsDiscarded, objectCount);
+
+    // Parents come first in the table, so a view finds its texture.
+    u32 missingCount = 0;
+    for (u32 id = 1; id <= objectCount; ++id)
+    {
+        pD3D11->ppObjects[id - 1] = CreateObject(pD3D11, id);
+        missingCount += pD3D11->ppObjects[id - 1] == NULL;
+    }
+    if (missingCount)
+        fprintf(stderr, "%u of %u objects couldn't be created and stay unbound.\n", missingCount, objectCount);
+
+    return true;
+}
+
+void DROP_DestroyD3D11Backend(ReplayBackend* pBackend)
+{
+    ASSERT_MSG(pBackend, "Replay backend pointer is null.");
+
+    D3D11Backend* pD3D11 = (D3D11Backend*) pBackend->pUserData;
+    if (pD3D11)
+    {
+        if (pD3D11->ppObjects)
+        {
+            for (u32 i = 0; i < pD3D11->pCapture->pHeader->objectCount; ++i)
+            {
+                SAFE_RELEASE(pD3D11->ppObjects[i]);
+            }
+            FREE(pD3D11->ppObjects);
+        }
+        if (pD3D11->pIsDiscarded) FREE(pD3D11->pIsDiscarded);
+
+        SAFE_RELEASE(pD3D11->pFrameQuery);
+        SAFE_RELEASE(pD3D11->pContext);
+        SAFE_RELEASE(pD3D11->pDevice);
+        FREE(pD3D11);
+    }
+
+    ZERO_MEM(pBackend, 1);
+}
+#endif // _WIN32
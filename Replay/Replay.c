@@ -0,0 +1,287 @@
+#include "Replay.h"
+
+#pragma region INTERNAL
+static bool IsValidId(const Capture* pCapture, u32 id)
+{
+    return id <= pCapture->pHeader->objectCount;
+}
+
+// Null or an object of that kind, so a backend can hand it to the API that expects one.
+static bool IsIdOfKind(const Capture* pCapture, u32 id, CaptureObjectKind kind)
+{
+    return id == 0 || (IsValidId(pCapture, id) && pCapture->pObjects[id - 1].kind == kind);
+}
+
+static bool AreIdsOfKind(const Capture* pCapture, const u32* pIds, u32 count, u32 stride, CaptureObjectKind kind)
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (!IsIdOfKind(pCapture, pIds[i * stride], kind))
+            return false;
+    }
+    return true;
+}
+
+static bool IsResourceId(const Capture* pCapture, u32 id)
+{
+    return IsIdOfKind(pCapture, id, CAPTURE_OBJECT_BUFFER) || IsIdOfKind(pCapture, id, CAPTURE_OBJECT_TEXTURE2D);
+}
+
+static bool IsValidInputLayoutData(const u8* pData, u32 dataSize)
+{
+    if (dataSize < sizeof(CaptureInputLayout))
+        return false;
+
+    const CaptureInputLayout* pLayout = (const CaptureInputLayout*) pData;
+    if (sizeof(CaptureInputLayout) + (u64) sizeof(CaptureInputElement) * pLayout->elementCount +
+            pLayout->bytecodeSize != dataSize)
+    {
+        return false;
+    }
+
+    const CaptureInputElement* pElements = (const CaptureInputElement*) (pLayout + 1);
+    for (u32 i = 0; i < pLayout->elementCount; ++i)
+    {
+        if (!memchr(pElements[i].semanticName, 0, CAPTURE_SEMANTIC_NAME_SIZE))
+            return false;
+    }
+    return true;
+}
+
+static bool IsValidObject(const Capture* pCapture, u32 index)
+{
+    const CaptureObject* pObject = &pCapture->pObjects[index];
+    if (pObject->kind >= CAPTURE_OBJECT_KIND_COUNT || pObject->parent > index ||
+        (u64) pObject->dataOffset + pObject->dataSize > pCapture->pHeader->dataBytes)
+    {
+        return false;
+    }
+
+    if (!pObject->dataSize)
+        return true;
+
+    switch (pObject->kind)
+    {
+    case CAPTURE_OBJECT_BUFFER:
+        return pObject->dataSize == pObject->params[0];
+    case CAPTURE_OBJECT_TEXTURE2D:
+        return pObject->params[1] && pObject->dataSize % pObject->params[1] == 0;
+    case CAPTURE_OBJECT_VERTEX_SHADER:
+    case CAPTURE_OBJECT_PIXEL_SHADER:
+        return true;
+    case CAPTURE_OBJECT_INPUT_LAYOUT:
+        return IsValidInputLayoutData(pCapture->pObjectData + pObject->dataOffset, pObject->dataSize);
+    default:
+        return false;
+    }
+}
+
+static bool IsValidSlotRange(const u32* pPayload, u32 wordCount, u32 slotCount)
+{
+    return wordCount >= 3 && pPayload[0] < CAPTURE_STAGE_COUNT && wordCount == 3 + pPayload[2] &&
+           pPayload[1] <= slotCount && pPayload[2] <= slotCount - pPayload[1];
+}
+
+static bool IsValidCommand(const Capture* pCapture, const CaptureCommand* pCommand)
+{
+    const u32* pPayload  = (const u32*) (pCommand + 1);
+    u32        wordCount = (pCommand->size - sizeof(CaptureCommand)) / sizeof(u32);
+
+    switch (pCommand->type)
+    {
+    case CAPTURE_CMD_FRAME_END:
+        return wordCount == 0;
+    case CAPTURE_CMD_SET_VIEWPORTS:
+        return wordCount >= 1 && pPayload[0] <= REPLAY_VIEWPORT_SLOTS && wordCount == 1 + pPayload[0] * 6;
+    case CAPTURE_CMD_SET_RENDER_TARGETS:
+        return wordCount >= 2 && pPayload[0] <= REPLAY_RENDER_TARGET_SLOTS && wordCount == 2 + pPayload[0] &&
+               IsValidId(pCapture, pPayload[1]) &&
+               AreIdsOfKind(pCapture, &pPayload[2], pPayload[0], 1, CAPTURE_OBJECT_RTV);
+    case CAPTURE_CMD_CLEAR_RENDER_TARGET:
+        return wordCount == 5 && IsIdOfKind(pCapture, pPayload[0], CAPTURE_OBJECT_RTV);
+    case CAPTURE_CMD_SET_SHADER:
+        return wordCount == 2 && pPayload[0] < CAPTURE_STAGE_COUNT &&
+               IsIdOfKind(pCapture, pPayload[1],
+                          pPayload[0] == CAPTURE_STAGE_VS ? CAPTURE_OBJECT_VERTEX_SHADER : CAPTURE_OBJECT_PIXEL_SHADER);
+    case CAPTURE_CMD_SET_SHADER_RESOURCES:
+        return IsValidSlotRange(pPayload, wordCount, REPLAY_SHADER_RESOURCE_SLOTS) &&
+               AreIdsOfKind(pCapture, &pPayload[3], pPayload[2], 1, CAPTURE_OBJECT_SRV);
+    case CAPTURE_CMD_SET_SAMPLERS:
+        return IsValidSlotRange(pPayload, wordCount, REPLAY_SAMPLER_SLOTS) &&
+               AreIdsOfKind(pCapture, &pPayload[3], pPayload[2], 1, CAPTURE_OBJECT_SAMPLER);
+    case CAPTURE_CMD_SET_CONSTANT_BUFFERS:
+        return IsValidSlotRange(pPayload, wordCount, REPLAY_CONSTANT_BUFFER_SLOTS) &&
+               AreIdsOfKind(pCapture, &pPayload[3], pPayload[2], 1, CAPTURE_OBJECT_BUFFER);
+    case CAPTURE_CMD_SET_INPUT_LAYOUT:
+        return wordCount == 1 && IsIdOfKind(pCapture, pPayload[0], CAPTURE_OBJECT_INPUT_LAYOUT);
+    case CAPTURE_CMD_SET_VERTEX_BUFFERS:
+        return wordCount >= 2 && pPayload[0] <= REPLAY_VERTEX_BUFFER_SLOTS &&
+               pPayload[1] <= REPLAY_VERTEX_BUFFER_SLOTS - pPayload[0] && wordCount == 2 + pPayload[1] * 3 &&
+               AreIdsOfKind(pCapture, &pPayload[2], pPayload[1], 3, CAPTURE_OBJECT_BUFFER);
+    case CAPTURE_CMD_SET_INDEX_BUFFER:
+        return wordCount == 3 && IsIdOfKind(pCapture, pPayload[0], CAPTURE_OBJECT_BUFFER);
+    case CAPTURE_CMD_SET_TOPOLOGY:
+        return wordCount == 1;
+    case CAPTURE_CMD_DRAW:
+        return wordCount == 2;
+    case CAPTURE_CMD_DRAW_INDEXED:
+        return wordCount == 3;
+    case CAPTURE_CMD_DRAW_INSTANCED:
+        return wordCount == 4;
+    case CAPTURE_CMD_DRAW_INDEXED_INSTANCED:
+        return wordCount == 5;
+    case CAPTURE_CMD_UPDATE_RESOURCE:
+        return wordCount >= 5 && pPayload[0] != 0 && IsIdOfKind(pCapture, pPayload[0], CAPTURE_OBJECT_BUFFER) &&
+               pPayload[3] <= pCapture->pObjects[pPayload[0] - 1].params[0] &&
+               pPayload[4] <= pCapture->pObjects[pPayload[0] - 1].params[0] - pPayload[3] &&
+               wordCount == 5 + (pPayload[4] + 3) / 4;
+    case CAPTURE_CMD_COPY_RESOURCE:
+        return wordCount == 2 && IsResourceId(pCapture, pPayload[0]) && IsResourceId(pCapture, pPayload[1]);
+    case CAPTURE_CMD_BEGIN_QUERY:
+    case CAPTURE_CMD_END_QUERY:
+        return wordCount == 1 && IsIdOfKind(pCapture, pPayload[0], CAPTURE_OBJECT_QUERY);
+    default:
+        return false;
+    }
+}
+#pragma endregion
+
+bool DROP_LoadCapture(const char* fileName, Capture* pCapture)
+{
+    ASSERT_MSG(fileName, "Capture file name is null.");
+    ASSERT_MSG(pCapture, "Capture pointer is null.");
+
+    ZERO_MEM(pCapture, 1);
+
+    FILE* file = fopen(fileName, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open file: %s\n", fileName);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    u64 size = (u64) ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (size < sizeof(CaptureHeader))
+    {
+        fprintf(stderr, "Not a capture file: %s\n", fileName);
+        fclose(file);
+        return false;
+    }
+
+    pCapture->pData = (u8*) ALLOC(u8, size);
+    if (!pCapture->pData || fread(pCapture->pData, 1, size, file) != size)
+    {
+        fprintf(stderr, "Failed to read file: %s\n", fileName);
+        fclose(file);
+        DROP_DestroyCapture(pCapture);
+        return false;
+    }
+    fclose(file);
+
+    const CaptureHeader* pHeader = (const CaptureHeader*) pCapture->pData;
+    if (pHeader->magic != CAPTURE_MAGIC || pHeader->version != CAPTURE_VERSION || pHeader->frameCount == 0 ||
+        pHeader->dataBytes % sizeof(u32) || pHeader->dataBytes > size || pHeader->commandBytes > size ||
+        (u64) pHeader->objectCount * sizeof(CaptureObject) + pHeader->dataBytes + pHeader->commandBytes !=
+            size - sizeof(CaptureHeader))
+    {
+        fprintf(stderr, "Not a capture file or wrong version: %s\n", fileName);
+        DROP_DestroyCapture(pCapture);
+        return false;
+    }
+
+    pCapture->pHeader     = pHeader;
+    pCapture->pObjects    = (const CaptureObject*) (pHeader + 1);
+    pCapture->pObjectData = (const u8*) (pCapture->pObjects + pHeader->objectCount);
+    pCapture->pCommands   = pCapture->pObjectData + pHeader->dataBytes;
+
+    for (u32 i = 0; i < pHeader->objectCount; ++i)
+    {
+        if (!IsValidObject(pCapture, i))
+        {
+            fprintf(stderr, "Invalid object %u in capture: %s\n", i + 1, fileName);
+            DROP_DestroyCapture(pCapture);
+            return false;
+        }
+    }
+
+    pCapture->pFrameOffsets = (u64*) ALLOC(u64, pHeader->frameCount + 1);
+    if (!pCapture->pFrameOffsets)
+    {
+        fprintf(stderr, "Failed to allocate frame offsets.\n");
+        DROP_DestroyCapture(pCapture);
+        return false;
+    }
+
+    // Checks every command once, so replaying doesn't have to.
+    u32 frame                  = 0;
+    u64 offset                 = 0;
+    pCapture->pFrameOffsets[0] = 0;
+    while (offset < pHeader->commandBytes)
+    {
+        const CaptureCommand* pCommand = (const CaptureCommand*) (pCapture->pCommands + offset);
+        if (pHeader->commandBytes - offset < sizeof(CaptureCommand) || pCommand->size < sizeof(CaptureCommand) ||
+            pCommand->size % sizeof(u32) || pCommand->size > pHeader->commandBytes - offset ||
+            frame == pHeader->frameCount || !IsValidCommand(pCapture, pCommand))
+        {
+            fprintf(stderr, "Invalid command at byte %llu in capture: %s\n", (unsigned long long) offset, fileName);
+            DROP_DestroyCapture(pCapture);
+            return false;
+        }
+
+        offset += pCommand->size;
+        if (pCommand->type == CAPTURE_CMD_FRAME_END)
+            pCapture->pFrameOffsets[++frame] = offset;
+    }
+
+    if (frame != pHeader->frameCount)
+    {
+        fprintf(stderr, "Capture ends in the middle of a frame: %s\n", fileName);
+        DROP_DestroyCapture(pCapture);
+        return false;
+    }
+
+    return true;
+}
+
+void DROP_DestroyCapture(Capture* pCapture)
+{
+    ASSERT_MSG(pCapture, "Capture pointer is null.");
+
+    if (pCapture->pFrameOffsets) FREE(pCapture->pFrameOffsets);
+    if (pCapture->pData) FREE(pCapture->pData);
+
+    ZERO_MEM(pCapture, 1);
+}
+
+const void* DROP_GetObjectData(const Capture* pCapture, u32 id, u32* pByteCount)
+{
+    ASSERT_MSG(pCapture && pCapture->pHeader, "Capture is not loaded.");
+    ASSERT_MSG(id && id <= pCapture->pHeader->objectCount, "Object id is out of range.");
+    ASSERT_MSG(pByteCount, "Byte count pointer is null.");
+
+    const CaptureObject* pObject = &pCapture->pObjects[id - 1];
+    *pByteCount                  = pObject->dataSize;
+    return pObject->dataSize ? pCapture->pObjectData + pObject->dataOffset : NULL;
+}
+
+void DROP_ReplayFrame(const Capture* pCapture, u32 frame, const ReplayBackend* pBackend)
+{
+    ASSERT_MSG(pCapture && pCapture->pHeader, "Capture is not loaded.");
+    ASSERT_MSG(frame < pCapture->pHeader->frameCount, "Frame index is out of range.");
+    ASSERT_MSG(pBackend && pBackend->Execute, "Replay backend is invalid.");
+
+    const u8* pCommand = pCapture->pCommands + pCapture->pFrameOffsets[frame];
+    const u8* pEnd     = pCapture->pCommands + pCapture->pFrameOffsets[frame + 1];
+    while (pCommand < pEnd)
+    {
+        const CaptureCommand* pHeader = (const CaptureCommand*) pCommand;
+        pBackend->Execute(pBackend->pUserData, pHeader, (const u32*) (pHeader + 1));
+        pCommand += pHeader->size;
+    }
+
+    if (pBackend->EndFrame)
+        pBackend->EndFrame(pBackend->pUserData);
+}
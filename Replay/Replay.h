@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Common.h"
+#include "Graphics/CaptureFormat.h"
+
+// Slot limits of D3D11, a capture binding past them is rejected on load.
+#define REPLAY_SHADER_RESOURCE_SLOTS 128
+#define REPLAY_SAMPLER_SLOTS 16
+#define REPLAY_CONSTANT_BUFFER_SLOTS 14
+#define REPLAY_VERTEX_BUFFER_SLOTS 32
+#define REPLAY_RENDER_TARGET_SLOTS 8
+#define REPLAY_VIEWPORT_SLOTS 16
+
+typedef struct _Capture
+{
+    u8*                  pData;
+    const CaptureHeader* pHeader;
+    const CaptureObject* pObjects;
+    const u8*            pObjectData;
+    const u8*            pCommands;
+    u64*                 pFrameOffsets; // frameCount + 1 offsets into the commands, the last one is the end.
+} Capture;
+
+// A target for the commands. The stream is validated on load, so a backend can index its
+// tables with the ids and slots of a command without checking them again.
+typedef struct _ReplayBackend
+{
+    const char* name;
+    void*       pUserData;
+    void (*Execute)(void* pUserData, const CaptureCommand* pCommand, const u32* pPayload);
+    void (*EndFrame)(void* pUserData);
+} ReplayBackend;
+
+bool DROP_LoadCapture(const char* fileName, Capture* pCapture);
+void DROP_DestroyCapture(Capture* pCapture);
+// Issues the commands of one frame, FRAME_END included.
+void DROP_ReplayFrame(const Capture* pCapture, u32 frame, const ReplayBackend* pBackend);
+
+typedef struct _ReplayCounters
+{
+    u64 commandCounts[CAPTURE_CMD_COUNT];
+    u64 frameCount;
+    u64 drawCount;
+    u64 vertexCount;
+    u64 bindCount;
+    u64 redundantBindCount;
+    u64 uploadBytes;
+} ReplayCounters;
+
+// Data of an object, NULL when the capture has none.
+const void* DROP_GetObjectData(const Capture* pCapture, u32 id, u32* pByteCount);
+
+// Headless backend. Tracks the bound state, counts calls, redundant binds and uploaded bytes,
+// and copies every upload to a shadow of the buffer so it costs about what a driver would.
+bool DROP_CreateCounterBackend(const Capture* pCapture, ReplayBackend* pBackend);
+void DROP_DestroyCounterBackend(ReplayBackend* pBackend);
+void DROP_ResetCounters(ReplayBackend* pBackend);
+// Counts since the last reset.
+const ReplayCounters* DROP_GetCounters(const ReplayBackend* pBackend);
+void                  DROP_PrintCounters(const ReplayBackend* pBackend);
+
+#ifdef _WIN32
+// Recreates the objects on a device of its own and issues the commands to it, every frame waits
+// for the GPU so the frame time includes it. WARP runs on the CPU where there is no GPU.
+// Shaders and input layouts captured without their data stay null and their draws do nothing.
+bool DROP_CreateD3D11Backend(const Capture* pCapture, bool isWarp, ReplayBackend* pBackend);
+void DROP_DestroyD3D11Backend(ReplayBackend* pBackend);
+#endif // _WIN32
@@ -0,0 +1,132 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif // _WIN32
+
+#include "Replay.h"
+
+#define DEFAULT_ITERATIONS 100
+
+static f64 GetSeconds()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (f64) counter.QuadPart / (f64) frequency.QuadPart;
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (f64) time.tv_sec + (f64) time.tv_nsec * 1e-9;
+#endif // _WIN32
+}
+
+static int CompareSamples(const void* pA, const void* pB)
+{
+    f64 a = *(const f64*) pA;
+    f64 b = *(const f64*) pB;
+    return (a > b) - (a < b);
+}
+
+static bool CreateBackend(const Capture* pCapture, const char* name, ReplayBackend* pBackend)
+{
+    if (!strcmp(name, "counter"))
+        return DROP_CreateCounterBackend(pCapture, pBackend);
+#ifdef _WIN32
+    if (!strcmp(name, "d3d11") || !strcmp(name, "warp"))
+        return DROP_CreateD3D11Backend(pCapture, !strcmp(name, "warp"), pBackend);
+#endif // _WIN32
+
+    fprintf(stderr, "Unknown backend: %s\n", name);
+    return false;
+}
+
+static void DestroyBackend(ReplayBackend* pBackend)
+{
+#ifdef _WIN32
+    if (strcmp(pBackend->name, "counter"))
+    {
+        DROP_DestroyD3D11Backend(pBackend);
+        return;
+    }
+#endif // _WIN32
+    DROP_DestroyCounterBackend(pBackend);
+}
+
+// Replays a capture in a loop and reports the CPU time of every frame. The counter backend runs
+// without a device, d3d11 and warp (Windows only) replay on a device and include its time.
+// Usage: Replay <capture> [iterations] [counter|d3d11|warp]
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <capture> [iterations] [counter|d3d11|warp]\n", argv[0]);
+        return 1;
+    }
+
+    u32 iterations = argc > 2 ? (u32) atoi(argv[2]) : DEFAULT_ITERATIONS;
+    if (!iterations)
+        iterations = DEFAULT_ITERATIONS;
+
+    Capture capture;
+    if (!DROP_LoadCapture(argv[1], &capture))
+        return 1;
+
+    ReplayBackend backend;
+    if (!CreateBackend(&capture, argc > 3 ? argv[3] : "counter", &backend))
+    {
+        DROP_DestroyCapture(&capture);
+        return 1;
+    }
+
+    u32  frameCount  = capture.pHeader->frameCount;
+    u32  sampleCount = frameCount * iterations;
+    f64* pSamples    = (f64*) ALLOC(f64, sampleCount);
+    if (!pSamples)
+    {
+        fprintf(stderr, "Failed to allocate %u samples.\n", sampleCount);
+        DestroyBackend(&backend);
+        DROP_DestroyCapture(&capture);
+        return 1;
+    }
+
+    // One untimed pass so first touches of the shadows and the driver's first uses stay out of the samples.
+    for (u32 frame = 0; frame < frameCount; ++frame)
+        DROP_ReplayFrame(&capture, frame, &backend);
+
+    bool isCounter = !strcmp(backend.name, "counter");
+    if (isCounter)
+        DROP_ResetCounters(&backend);
+
+    for (u32 i = 0; i < iterations; ++i)
+    {
+        for (u32 frame = 0; frame < frameCount; ++frame)
+        {
+            f64 start = GetSeconds();
+            DROP_ReplayFrame(&capture, frame, &backend);
+            pSamples[i * frameCount + frame] = GetSeconds() - start;
+        }
+    }
+
+    qsort(pSamples, sampleCount, sizeof(f64), CompareSamples);
+
+    u32 p99Index = (u32) ((u64) sampleCount * 99 / 100);
+    if (p99Index >= sampleCount)
+        p99Index = sampleCount - 1;
+
+    printf("%s: %u frames, %u objects, %llu command bytes.\n", argv[1], frameCount,
+           capture.pHeader->objectCount, (unsigned long long) capture.pHeader->commandBytes);
+    printf("Backend %s, %u iterations.\n", backend.name, iterations);
+    printf("Frame CPU time: min %.3f us, median %.3f us, p99 %.3f us.\n",
+           pSamples[0] * 1e6, pSamples[sampleCount / 2] * 1e6, pSamples[p99Index] * 1e6);
+    if (isCounter)
+        DROP_PrintCounters(&backend);
+
+    FREE(pSamples);
+    DestroyBackend(&backend);
+    DROP_DestroyCapture(&capture);
+
+    PRINT_LEAKS();
+    CLEANUP();
+    return 0;
+}
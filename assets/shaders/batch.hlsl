@@ -0,0 +1,50 @@
+struct VSInput
+{
+    uint   id : SV_VertexID;
+    float4 basis : INSTANCE_BASIS;       // 2x2 rotation/scale, row major.
+    float2 translation : INSTANCE_TRANSLATION;
+    uint   primitive : INSTANCE_PRIMITIVE; // 0 = triangle, 1 = quad.
+    float4 color : INSTANCE_COLOR;
+};
+
+struct VSOutput
+{
+    float4 pos : SV_Position;
+    float2 uv : TEXCOORD0;
+    float4 color : COLOR;
+};
+
+// Unit primitives centered on the origin, expanded from SV_VertexID.
+static const float2 TRIANGLE_CORNERS[3] = {
+    float2(0.0, 0.5), float2(0.5, -0.5), float2(-0.5, -0.5)};
+static const float2 QUAD_CORNERS[6] = {
+    float2(-0.5, 0.5), float2(0.5, 0.5), float2(-0.5, -0.5),
+    float2(-0.5, -0.5), float2(0.5, 0.5), float2(0.5, -0.5)};
+
+VSOutput VSMain(VSInput input)
+{
+    float2 corner = input.primitive ? QUAD_CORNERS[input.id % 6] : TRIANGLE_CORNERS[input.id % 3];
+
+    float2 pos = float2(
+        dot(input.basis.xy, corner),
+        dot(input.basis.zw, corner)) + input.translation;
+
+    VSOutput output;
+    output.pos   = float4(pos, 0.0, 1.0);
+    output.uv    = float2(corner.x + 0.5, 0.5 - corner.y);
+    output.color = input.color;
+
+    return output;
+}
+
+struct PSInput
+{
+    float4 pos : SV_Position;
+    float2 uv : TEXCOORD0;
+    float4 color : COLOR;
+};
+
+float4 PSMain(PSInput input) : SV_Target
+{
+    return input.color;
+}
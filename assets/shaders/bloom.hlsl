@@ -4,28 +4,42 @@ struct PSInput
     float2 uv : TEXCOORD0;
 };
 
+#define MAX_TAPS 8 // GAUSSIAN_MAX_TAPS.
+
+// Built by DROP_BuildGaussianKernel, each tap sits between two texels so the linear sampler
+// fetches both with their Gaussian weights.
 cbuffer BloomParams : register(b0)
 {
-    float4 weights; // Check up to 4 neighbour pixel.
-    float2 texelSize;
+    float4 taps[MAX_TAPS]; // x weight, y offset in texels.
     float  weightCenter;
-    int    horizontal;
+    uint   tapCount;
+    float2 padding;
 };
 
+// A permutation rather than a cbuffer value, both passes share the kernel.
+#ifdef BLOOM_VERTICAL
+static const float2 direction = float2(0.0, 1.0);
+#else
+static const float2 direction = float2(1.0, 0.0);
+#endif
+
 Texture2D hdrTexture : register(t0);
 
 SamplerState linearSampler : register(s0);
 
 float4 PSMain(PSInput input) : SV_Target
 {
-    float4 result = hdrTexture.Sample(linearSampler, input.uv) * weightCenter;
+    float2 texelSize;
+    hdrTexture.GetDimensions(texelSize.x, texelSize.y);
+    texelSize = direction / texelSize;
 
-    float2 neighbourUV = horizontal ? float2(texelSize.x, 0) : float2(0, texelSize.y);
+    float4 result = hdrTexture.Sample(linearSampler, input.uv) * weightCenter;
 
-    for (uint i = 1; i < 5; ++i)
+    for (uint i = 0; i < tapCount; ++i)
     {
-        result += hdrTexture.Sample(linearSampler, input.uv + neighbourUV * i) * weights[i - 1];
-        result += hdrTexture.Sample(linearSampler, input.uv - neighbourUV * i) * weights[i - 1];
+        float2 offset = texelSize * taps[i].y;
+        result += hdrTexture.Sample(linearSampler, input.uv + offset) * taps[i].x;
+        result += hdrTexture.Sample(linearSampler, input.uv - offset) * taps[i].x;
     }
 
     return result;
@@ -4,12 +4,21 @@ struct VSOutput
     float2 uv : TEXCOORD0;
 };
 
+// The sources only cover the top left uvScale part of their textures when rendering at a lower scale.
+cbuffer ViewParams : register(b0)
+{
+    float2 uvScale;
+    float  bloomIntensity; // Scales the sum of the bloom levels.
+    float  padding;
+};
+
 VSOutput VSMain(uint id : SV_VertexID)
 {
     VSOutput output;
     output.uv    = float2((id << 1) & 2, id & 2);
     output.pos   = float4(output.uv * 2.0 - 1.0, 0.0, 1.0);
     output.pos.y = -output.pos.y;
+    output.uv *= uvScale;
 
     return output;
 }
@@ -21,18 +30,14 @@ struct PSInput
 };
 
 Texture2D hdrTexture : register(t0);
-Texture2D bloomTextureL : register(t1);
-Texture2D bloomTextureM : register(t2);
+Texture2D bloomTexture : register(t1);
 
 SamplerState linearSampler : register(s0);
 
 float4 PSMain(PSInput input) : SV_Target
 {
-    float4 hdrColor    = hdrTexture.Sample(linearSampler, input.uv);
-    float4 bloomColorL = bloomTextureL.Sample(linearSampler, input.uv);
-    float4 bloomColorM = bloomTextureM.Sample(linearSampler, input.uv);
-
-    float4 bloom = (bloomColorL + bloomColorM);
+    float4 hdrColor   = hdrTexture.Sample(linearSampler, input.uv);
+    float4 bloomColor = bloomTexture.Sample(linearSampler, input.uv);
 
-    return hdrColor + bloom;
+    return hdrColor + bloomColor * bloomIntensity;
 }
\ No newline at end of file
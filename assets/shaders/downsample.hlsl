@@ -0,0 +1,39 @@
+struct PSInput
+{
+    float4 pos : SV_Position;
+    float2 uv : TEXCOORD0;
+};
+
+Texture2D sourceTexture : register(t0);
+
+SamplerState linearSampler : register(s0);
+
+// Halves the source with 13 bilinear taps, five overlapping 2x2 boxes with the center one weighted
+// most. Small bright spots don't flicker as they move across the texels of the smaller level.
+float4 PSMain(PSInput input) : SV_Target
+{
+    float2 texelSize;
+    sourceTexture.GetDimensions(texelSize.x, texelSize.y);
+    texelSize = 1.0 / texelSize;
+
+    float4 a = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(-2.0, -2.0));
+    float4 b = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(0.0, -2.0));
+    float4 c = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(2.0, -2.0));
+    float4 d = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(-1.0, -1.0));
+    float4 e = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(1.0, -1.0));
+    float4 f = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(-2.0, 0.0));
+    float4 g = sourceTexture.Sample(linearSampler, input.uv);
+    float4 h = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(2.0, 0.0));
+    float4 i = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(-1.0, 1.0));
+    float4 j = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(1.0, 1.0));
+    float4 k = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(-2.0, 2.0));
+    float4 l = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(0.0, 2.0));
+    float4 m = sourceTexture.Sample(linearSampler, input.uv + texelSize * float2(2.0, 2.0));
+
+    float4 result = (d + e + i + j) * 0.125;
+    result += (a + c + k + m) * 0.03125;
+    result += (b + f + h + l) * 0.0625;
+    result += g * 0.125;
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+struct PSInput
+{
+    float4 pos : SV_Position;
+    float2 uv : TEXCOORD0;
+};
+
+Texture2D levelTexture : register(t0); // Level of the downsample chain at the size of the target.
+Texture2D lowerTexture : register(t1); // Upsampled level below it, half the size.
+
+SamplerState linearSampler : register(s0);
+
+// Adds a 3x3 tent filtered upsample of the level below to the level itself.
+float4 PSMain(PSInput input) : SV_Target
+{
+    float2 texelSize;
+    lowerTexture.GetDimensions(texelSize.x, texelSize.y);
+    texelSize = 1.0 / texelSize;
+
+    float4 result = lowerTexture.Sample(linearSampler, input.uv) * 4.0;
+    result += lowerTexture.Sample(linearSampler, input.uv + texelSize * float2(-1.0, 0.0)) * 2.0;
+    result += lowerTexture.Sample(linearSampler, input.uv + texelSize * float2(1.0, 0.0)) * 2.0;
+    result += lowerTexture.Sample(linearSampler, input.uv + texelSize * float2(0.0, -1.0)) * 2.0;
+    result += lowerTexture.Sample(linearSampler, input.uv + texelSize * float2(0.0, 1.0)) * 2.0;
+    result += lowerTexture.Sample(linearSampler, input.uv + texelSize * float2(-1.0, -1.0));
+    result += lowerTexture.Sample(linearSampler, input.uv + texelSize * float2(1.0, -1.0));
+    result += lowerTexture.Sample(linearSampler, input.uv + texelSize * float2(-1.0, 1.0));
+    result += lowerTexture.Sample(linearSampler, input.uv + texelSize * float2(1.0, 1.0));
+
+    return levelTexture.Sample(linearSampler, input.uv) + result * (1.0 / 16.0);
+}
\ No newline at end of file
@@ -23,5 +23,31 @@ for %%F in (%SHADER_PATH%\*.hlsl) do (
     )
 )
 
+rem Permutations: <name>_<vs|ps>_<define>_<define>.cso, with every define set to 1.
+for /f "usebackq eol=# tokens=1,2,*" %%A in ("%SHADER_PATH%\permutations.txt") do (
+    set DEFINES=
+    set SUFFIX=
+    for %%D in (%%C) do (
+        set DEFINES=!DEFINES! /D %%D=1
+        set SUFFIX=!SUFFIX!_%%D
+    )
+
+    if /i "%%B"=="vs" (
+        set TARGET=%VS_TARGET%
+        set ENTRY=VSMain
+    ) else (
+        set TARGET=%PS_TARGET%
+        set ENTRY=PSMain
+    )
+
+    echo.
+    echo Compiling: %%A_%%B!SUFFIX!
+
+    fxc.exe /T !TARGET! /E !ENTRY! !DEFINES! /Fo "%SHADER_PATH%\%%A_%%B!SUFFIX!.cso" "%SHADER_PATH%\%%A.hlsl" >nul 2>&1
+    if errorlevel 1 (
+        echo Failed %%A_%%B!SUFFIX!
+    )
+)
+
 
 endlocal
\ No newline at end of file
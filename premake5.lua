@@ -5,7 +5,7 @@ require("ecc/ecc")
 -- =======================================
 workspace "LearnDX11"
 architecture "x64"
-configurations {"Debug", "Release"}
+configurations {"Debug", "Release", "Profile"}
 
 defines {"UNICODE", "_UNICODE"}
 
@@ -17,10 +17,15 @@ filter {"configurations:Release"}
 defines {"NDEBUG"}
 optimize "On"
 
-filter {"action:gmake", "configurations:Release"}
+-- Release with the profiler zones compiled in.
+filter {"configurations:Profile"}
+defines {"NDEBUG", "PROFILE"}
+optimize "On"
+
+filter {"action:gmake", "configurations:Release or Profile"}
 linkoptions {"-static"}
 
-filter {"action:vs*", "configurations:Release"}
+filter {"action:vs*", "configurations:Release or Profile"}
 staticruntime "On"
 
 filter {}
@@ -46,7 +51,7 @@ files {"%{prj.location}/include/**.h", "%{prj.location}/src/**.c"}
 includedirs {"%{prj.location}", "%{prj.location}/include"}
 
 defines {"DLL_EXPORTS"}
-links {"user32", "d3d11", "dxgi", "dxguid", "d3dcompiler"}
+links {"user32", "winmm", "d3d11", "dxgi", "dxguid", "d3dcompiler"}
 
 -- =======================================
 -- PROJECT(Test)
@@ -64,3 +69,55 @@ files {"%{prj.location}/*.c"}
 includedirs {"DLL"}
 
 links {"DLL"}
+
+-- =======================================
+-- PROJECT(Replay)
+-- =======================================
+project "Replay"
+location "Replay"
+kind "ConsoleApp"
+language "C"
+cdialect "C11"
+
+targetdir("bin/" .. outdir)
+objdir("bin-int/" .. outdir)
+
+files {"%{prj.location}/*.h", "%{prj.location}/*.c"}
+includedirs {"DLL/include"}
+
+filter "system:windows"
+links {"d3d11"}
+
+filter {}
+
+-- =======================================
+-- PROJECT(Bench)
+-- =======================================
+-- Tests and benchmarks, built from the DLL sources so they reach the internal functions, and from the
+-- replay loader and counter backend. Off Windows only the modules that don't need D3D are compiled.
+project "Bench"
+location "Bench"
+kind "ConsoleApp"
+language "C"
+cdialect "C11"
+
+targetdir("bin/" .. outdir)
+objdir("bin-int/" .. outdir)
+
+files {"%{prj.location}/*.h", "%{prj.location}/*.c", "DLL/src/**.c", "Replay/Replay.c", "Replay/CounterBackend.c"}
+removefiles {"DLL/src/EntryPoint.c", "DLL/src/GlobalVarSources.c", "DLL/src/pch.c"}
+includedirs {"DLL", "DLL/include", "Replay"}
+
+filter "system:windows"
+links {"user32", "winmm", "d3d11", "dxgi", "dxguid", "d3dcompiler"}
+
+filter "system:not windows"
+removefiles {
+    "DLL/src/Graphics/BatchRenderer.c", "DLL/src/Graphics/CommandCapture.c", "DLL/src/Graphics/FrameFence.c",
+    "DLL/src/Graphics/GpuTimer.c", "DLL/src/Graphics/Graphics.c", "DLL/src/Graphics/ImageCapture.c", "DLL/src/Graphics/InputLayoutCache.c",
+    "DLL/src/Graphics/PipelineState.c", "DLL/src/Graphics/RenderQueue.c", "DLL/src/Graphics/RenderTargetPool.c",
+    "DLL/src/Graphics/ShaderCache.c", "DLL/src/Resources/DynamicBuffer.c", "DLL/src/Resources/Mesh.c",
+    "DLL/src/Resources/Shaders.c", "DLL/src/Platform/Window.c"}
+links {"m", "pthread"}
+
+filter {}